@@ -0,0 +1,196 @@
+package com.hindu.calendar.cli;
+
+import com.hindu.calendar.core.*;
+import com.hindu.calendar.ephemeris.Ephemeris;
+import com.hindu.calendar.model.*;
+
+import java.io.BufferedWriter;
+import java.io.IOException;
+import java.io.OutputStreamWriter;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.util.ArrayList;
+import java.util.List;
+
+/**
+ * Java driver for the cross-port benchmark ({@code make bench-ports}).
+ *
+ * Reads a workload file (format in tools/bench_ports.workload), converts
+ * every (location, date) pair in every listed calendar and writes the
+ * canonical rows compared by tools/bench_ports.py. Only the conversions
+ * are timed.
+ */
+public class PortBench {
+
+    private static final String[] CALENDAR_NAMES = {
+            "lunisolar", "tamil", "bengali", "odia", "malayalam"
+    };
+    private static final SolarCalendarType[] SOLAR_TYPES = {
+            SolarCalendarType.TAMIL, SolarCalendarType.BENGALI,
+            SolarCalendarType.ODIA, SolarCalendarType.MALAYALAM
+    };
+
+    private static final class Workload {
+        double jd0 = -1, jd1 = -1;
+        final List<Location> locs = new ArrayList<>();
+        final List<Integer> calendars = new ArrayList<>();
+        boolean random;
+        int seed;
+    }
+
+    /** Peak resident set of this process in KiB (Linux VmHWM), or 0. */
+    private static long peakRssKb() {
+        try {
+            for (String line : Files.readAllLines(Path.of("/proc/self/status"))) {
+                if (line.startsWith("VmHWM:"))
+                    return Long.parseLong(line.substring(6).trim().split("\\s+")[0]);
+            }
+        } catch (IOException | NumberFormatException e) {
+            // not Linux
+        }
+        return 0;
+    }
+
+    private static double parseDay(Ephemeris eph, String s) {
+        String[] p = s.split("-");
+        if (p.length != 3) throw new IllegalArgumentException(s);
+        int y = Integer.parseInt(p[0]), m = Integer.parseInt(p[1]), d = Integer.parseInt(p[2]);
+        if (m < 1 || m > 12 || d < 1 || d > 31) throw new IllegalArgumentException(s);
+        return eph.gregorianToJd(y, m, d);
+    }
+
+    private static int calendarIndex(String name) {
+        for (int c = 0; c < CALENDAR_NAMES.length; c++)
+            if (CALENDAR_NAMES[c].equals(name)) return c;
+        throw new IllegalArgumentException(name);
+    }
+
+    private static Workload loadWorkload(Ephemeris eph, String path) throws IOException {
+        Workload w = new Workload();
+        List<String> lines = Files.readAllLines(Path.of(path));
+        int lineno = 0;
+        for (String line : lines) {
+            lineno++;
+            String[] tok = line.trim().split("\\s+");
+            if (tok[0].isEmpty() || tok[0].startsWith("#")) continue;
+            try {
+                switch (tok[0]) {
+                    case "from" -> w.jd0 = parseDay(eph, only(tok, 2)[1]);
+                    case "to" -> w.jd1 = parseDay(eph, only(tok, 2)[1]);
+                    case "location" -> w.locs.add(new Location(
+                            Double.parseDouble(only(tok, 4)[1]), Double.parseDouble(tok[2]),
+                            0.0, Double.parseDouble(tok[3])));
+                    case "calendars" -> {
+                        for (int i = 1; i < tok.length; i++)
+                            w.calendars.add(calendarIndex(tok[i]));
+                    }
+                    case "order" -> {
+                        if (tok.length == 2 && tok[1].equals("sequential")) {
+                            w.random = false;
+                        } else if (tok.length == 3 && tok[1].equals("random")) {
+                            w.random = true;
+                            w.seed = Integer.parseUnsignedInt(tok[2]);
+                        } else {
+                            throw new IllegalArgumentException(line);
+                        }
+                    }
+                    default -> throw new IllegalArgumentException(line);
+                }
+            } catch (IllegalArgumentException e) {
+                throw badLine(path, lineno);
+            }
+        }
+        if (w.jd0 < 0 || w.jd1 < w.jd0 || w.locs.isEmpty() || w.calendars.isEmpty())
+            throw badLine(path, lineno + 1);
+        return w;
+    }
+
+    private static String[] only(String[] tok, int n) {
+        if (tok.length != n) throw new IllegalArgumentException(String.join(" ", tok));
+        return tok;
+    }
+
+    private static IllegalStateException badLine(String path, int lineno) {
+        return new IllegalStateException(path + " line " + lineno + ": bad or missing workload entry");
+    }
+
+    public static void main(String[] args) throws IOException {
+        if (args.length != 1) {
+            System.err.println("Usage: PortBench WORKLOAD");
+            System.exit(1);
+        }
+        Ephemeris eph = new Ephemeris();
+        Workload w;
+        try {
+            w = loadWorkload(eph, args[0]);
+        } catch (IOException e) {
+            System.err.println("Error: cannot open '" + args[0] + "'");
+            System.exit(1);
+            return;
+        } catch (IllegalStateException e) {
+            System.err.println("Error: " + e.getMessage());
+            System.exit(1);
+            return;
+        }
+        Panchang panchang = new Panchang(eph);
+        Solar solar = new Solar(eph);
+
+        // (location, day) pairs, location-major, optionally shuffled
+        int nDays = (int) (w.jd1 - w.jd0) + 1;
+        int n = nDays * w.locs.size();
+        int[] order = new int[n];
+        for (int i = 0; i < n; i++) order[i] = i;
+        if (w.random) {
+            int x = w.seed;
+            for (int i = n - 1; i > 0; i--) {
+                x = x * 1103515245 + 12345;
+                int j = Integer.remainderUnsigned(x >>> 8, i + 1);
+                int tmp = order[i];
+                order[i] = order[j];
+                order[j] = tmp;
+            }
+        }
+
+        // loc, y, m, d, calendar, year, month, adhika, day per row
+        int nCal = w.calendars.size();
+        int[] rows = new int[n * nCal * 9];
+        int r = 0;
+        long start = System.nanoTime();
+        for (int k : order) {
+            int loc = k / nDays;
+            int[] ymd = eph.jdToGregorian(w.jd0 + k % nDays);
+            for (int c : w.calendars) {
+                rows[r++] = loc;
+                rows[r++] = ymd[0];
+                rows[r++] = ymd[1];
+                rows[r++] = ymd[2];
+                rows[r++] = c;
+                if (c == 0) {
+                    HinduDate hd = panchang.gregorianToHindu(ymd[0], ymd[1], ymd[2], w.locs.get(loc));
+                    rows[r++] = hd.yearSaka();
+                    rows[r++] = hd.masa().number();
+                    rows[r++] = hd.isAdhikaMasa() ? 1 : 0;
+                    rows[r++] = hd.tithi() + (hd.paksha() == Paksha.KRISHNA ? 15 : 0);
+                } else {
+                    SolarDate sd = solar.gregorianToSolar(ymd[0], ymd[1], ymd[2],
+                            w.locs.get(loc), SOLAR_TYPES[c - 1]);
+                    rows[r++] = sd.year();
+                    rows[r++] = sd.month();
+                    rows[r++] = 0;
+                    rows[r++] = sd.day();
+                }
+            }
+        }
+        long elapsed = System.nanoTime() - start;
+
+        BufferedWriter out = new BufferedWriter(new OutputStreamWriter(System.out), 1 << 16);
+        for (int i = 0; i < r; i += 9) {
+            out.write(String.format("%d,%04d-%02d-%02d,%s,%d,%d,%d,%d\n",
+                    rows[i], rows[i + 1], rows[i + 2], rows[i + 3], CALENDAR_NAMES[rows[i + 4]],
+                    rows[i + 5], rows[i + 6], rows[i + 7], rows[i + 8]));
+        }
+        out.flush();
+        System.err.println("rows=" + (r / 9) + " compute_ns=" + elapsed
+                + " peak_rss_kb=" + peakRssKb());
+    }
+}
@@ -15,6 +15,14 @@
 #ifndef MOSHIER_H
 #define MOSHIER_H
 
+/* Per-thread storage for the series scratch state (sin/cos tables, lunar
+ * mean elements), so the library can be called from several threads. */
+#if defined(_MSC_VER)
+#define MOSHIER_TLS __declspec(thread)
+#else
+#define MOSHIER_TLS __thread
+#endif
+
 /* JD <-> Gregorian (Meeus Ch.7) */
 double moshier_julday(int year, int month, int day, double hour);
 void   moshier_revjul(double jd, int *year, int *month, int *day, double *hour);
@@ -32,8 +32,8 @@ static double mod_arcsec(double x)
 }
 
 /* ---- sin/cos lookup table for multiples of angles ---- */
-static double sin_tbl[5][8];
-static double cos_tbl[5][8];
+static MOSHIER_TLS double sin_tbl[5][8];
+static MOSHIER_TLS double cos_tbl[5][8];
 
 static void precompute_sincos(int k, double arg, int n)
 {
@@ -386,15 +386,15 @@ static const short moon_lr_t2[6 * MOON_LR_T2_N] = {
  *         Moon's orbital plane crosses the ecliptic). ~483,202°/century.
  *         Controls latitude and some longitude terms.
  * ================================================================ */
-static double mean_lon_moon;  /* mean longitude of moon (L) */
-static double M_sun;          /* mean anomaly of sun (l') */
-static double mean_anom_moon; /* mean anomaly of moon (l) */
-static double D;              /* mean elongation */
-static double arg_latitude;   /* argument of latitude (F) */
-static double T, T2;
+static MOSHIER_TLS double mean_lon_moon;  /* mean longitude of moon (L) */
+static MOSHIER_TLS double M_sun;          /* mean anomaly of sun (l') */
+static MOSHIER_TLS double mean_anom_moon; /* mean anomaly of moon (l) */
+static MOSHIER_TLS double D;              /* mean elongation */
+static MOSHIER_TLS double arg_latitude;   /* argument of latitude (F) */
+static MOSHIER_TLS double T, T2;
 
 /* Planetary mean longitudes */
-static double lon_venus, lon_earth, lon_mars, lon_jupiter, lon_saturn;
+static MOSHIER_TLS double lon_venus, lon_earth, lon_mars, lon_jupiter, lon_saturn;
 
 /* (Perturbation accumulators are local to lunar_perturbations.) */
 
@@ -334,8 +334,8 @@ static const signed char earth_args[] = {
  * Extent: precompute_sincos(), vsop87_earth_longitude()
  */
 
-static double sin_tbl[9][24];
-static double cos_tbl[9][24];
+static MOSHIER_TLS double sin_tbl[9][24];
+static MOSHIER_TLS double cos_tbl[9][24];
 
 /* Precompute sin(k*arg) and cos(k*arg) for k=1..n using recurrence */
 static void precompute_sincos(int k, double arg, int n)
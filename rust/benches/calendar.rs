@@ -0,0 +1,110 @@
+//! Conversion benchmarks, printed next to the C numbers of
+//! Docs/PERFORMANCE_IMPROVEMENTS.md (Moshier, sequential = Phase 2, random =
+//! shuffled 1900-2050).
+//!
+//!   cargo bench                 (all)
+//!   cargo bench -- range        (names containing "range")
+//!   cargo bench --features ephemeris-tables   (new moons and sankrantis
+//!                                from build-time tables)
+
+use hindu_calendar::core::cache::{self, CacheId};
+use hindu_calendar::core::calendar::Calendar;
+use hindu_calendar::core::tables;
+use hindu_calendar::ephemeris::julian_day;
+use hindu_calendar::model::*;
+use std::hint::black_box;
+use std::time::Instant;
+
+const CALENDARS: [(&str, Option<SolarCalendarType>, f64, f64); 5] = [
+    ("lunisolar", None, 23.0, 112.0),
+    ("tamil", Some(SolarCalendarType::Tamil), 18.0, 160.0),
+    ("bengali", Some(SolarCalendarType::Bengali), 4.1, 125.0),
+    ("odia", Some(SolarCalendarType::Odia), 3.7, 117.0),
+    ("malayalam", Some(SolarCalendarType::Malayalam), 32.0, 201.0),
+];
+
+const RANDOM_DAYS: usize = 2000;
+
+fn days(from: (i32, i32, i32), to: (i32, i32, i32)) -> Vec<(i32, i32, i32)> {
+    let jd0 = julian_day::gregorian_to_jd(from.0, from.1, from.2);
+    let jd1 = julian_day::gregorian_to_jd(to.0, to.1, to.2);
+    (0..=(jd1 - jd0) as usize).map(|i| julian_day::jd_to_gregorian(jd0 + i as f64)).collect()
+}
+
+/// The first n of 1900-2050 shuffled (Fisher-Yates, LCG seed 42)
+fn random_days(n: usize) -> Vec<(i32, i32, i32)> {
+    let mut all = days((1900, 1, 1), (2050, 12, 31));
+    let mut x: u32 = 42;
+    for i in (1..all.len()).rev() {
+        x = x.wrapping_mul(1103515245).wrapping_add(12345);
+        all.swap(i, ((x >> 8) % (i as u32 + 1)) as usize);
+    }
+    all.truncate(n);
+    all
+}
+
+/// Microseconds per day for one pass over `days`
+fn time_days(cal: &Calendar, cal_type: Option<SolarCalendarType>, days: &[(i32, i32, i32)]) -> f64 {
+    let t0 = Instant::now();
+    for &(y, m, d) in days {
+        match cal_type {
+            None => { black_box(cal.gregorian_to_hindu(y, m, d)); }
+            Some(t) => { black_box(cal.gregorian_to_solar(y, m, d, t)); }
+        }
+    }
+    t0.elapsed().as_secs_f64() * 1e6 / days.len() as f64
+}
+
+fn main() {
+    let filter = std::env::args().skip(1).find(|a| !a.starts_with('-'));
+    let wanted = |name: &str| filter.as_deref().map_or(true, |f| name.contains(f));
+    let cal = Calendar::new(Location::NEW_DELHI);
+    match tables::years() {
+        Some((first, last)) => println!("ephemeris tables: {}-{}", first, last),
+        None => println!("ephemeris tables: off (series only)"),
+    }
+
+    if wanted("sequential") || wanted("random") {
+        let seq = days((2000, 1, 1), (2001, 12, 31));
+        let rnd = random_days(RANDOM_DAYS);
+        println!("us/day, New Delhi; sequential = 2000-2001, random = {} shuffled days of 1900-2050",
+                 RANDOM_DAYS);
+        println!("{:<10} {:>10} {:>8} {:>10} {:>12} {:>8}",
+                 "calendar", "sequential", "C", "random", "random tuned", "C");
+        for &(name, cal_type, c_seq, c_rnd) in &CALENDARS {
+            cache::clear();
+            let s = time_days(&cal, cal_type, &seq);
+            cache::clear();
+            let r = time_days(&cal, cal_type, &rnd);
+
+            // Capacities for all of 1900-2050: the second pass hits
+            cache::set_capacity(CacheId::Lunation, 2048);
+            cache::set_capacity(CacheId::Sankranti, 8192);
+            cache::set_capacity(CacheId::SolarYear, 1024);
+            cache::clear();
+            time_days(&cal, cal_type, &rnd);
+            let tuned = time_days(&cal, cal_type, &rnd);
+            cache::set_capacity(CacheId::Lunation, 1);
+            cache::set_capacity(CacheId::Sankranti, 4);
+            cache::set_capacity(CacheId::SolarYear, 4);
+
+            println!("{:<10} {:>10.1} {:>8.1} {:>10.1} {:>12.1} {:>8.1}",
+                     name, s, c_seq, r, tuned, c_rnd);
+        }
+    }
+
+    if wanted("range") {
+        let threads = std::thread::available_parallelism().map_or(1, |n| n.get());
+        println!("\nhindu_range 1990-2009, New Delhi");
+        let mut one = 0.0;
+        for n in [1, threads] {
+            let t0 = Instant::now();
+            let out = cal.hindu_range((1990, 1, 1), (2009, 12, 31), n);
+            let secs = t0.elapsed().as_secs_f64();
+            if n == 1 { one = secs; }
+            println!("{:>3} thread(s) {:>8.3} s {:>8.1} us/day {:>6.2}x",
+                     n, secs, secs * 1e6 / out.len() as f64, one / secs);
+            if threads == 1 { break; }
+        }
+    }
+}
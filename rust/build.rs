@@ -0,0 +1,145 @@
+//! With the `ephemeris-tables` feature, computes every new moon and every
+//! sankranti over a range of years with the crate's own Moshier series and
+//! writes them as const arrays to $OUT_DIR/ephemeris_tables.rs, which
+//! src/core/tables.rs includes.  The range defaults to 1900-2050; set
+//! HINDU_CALENDAR_TABLE_YEARS=FIRST-LAST to change it.
+//!
+//! The searches are those of masa.rs (new_moon_before) and solar.rs
+//! (sankranti_jd), started from the mean new moon and mean sankranti.
+
+fn main() {
+    println!("cargo:rerun-if-changed=build.rs");
+    #[cfg(feature = "ephemeris-tables")]
+    tables::generate();
+}
+
+#[cfg(feature = "ephemeris-tables")]
+#[path = "src/model.rs"]
+#[allow(dead_code)]
+mod model;
+
+#[cfg(feature = "ephemeris-tables")]
+#[path = "src/ephemeris/mod.rs"]
+#[allow(dead_code)]
+mod ephemeris;
+
+#[cfg(feature = "ephemeris-tables")]
+mod tables {
+    use crate::ephemeris::{julian_day, Ephemeris};
+    use std::fmt::Write;
+
+    const SYNODIC_MONTH: f64 = 29.530588853;
+    const NEW_MOON_EPOCH: f64 = 2451550.09766;   // mean new moon of 2000-01-06
+    const SOLAR_MONTH: f64 = 365.25636 / 12.0;
+    const MESHA_EPOCH: f64 = 2451648.0;          // ~ Mesha sankranti 2000
+    const DEFAULT_YEARS: (i32, i32) = (1900, 2050);
+
+    fn lunar_phase(eph: &mut Ephemeris, jd: f64) -> f64 {
+        let phase = (eph.lunar_longitude(jd) - eph.solar_longitude(jd)) % 360.0;
+        if phase < 0.0 { phase + 360.0 } else { phase }
+    }
+
+    /// New moon nearest jd_mean: inverse Lagrange on 9 phases 2 days around it
+    fn new_moon_near(eph: &mut Ephemeris, jd_mean: f64) -> f64 {
+        let mut x = [0.0f64; 9];
+        let mut y = [0.0f64; 9];
+        for i in 0..9 {
+            x[i] = -2.0 + i as f64 * 0.5;
+            y[i] = lunar_phase(eph, jd_mean + x[i]);
+        }
+        for i in 1..9 {
+            if y[i] < y[i - 1] { y[i] += 360.0; }
+        }
+        let mut total = 0.0;
+        for i in 0..9 {
+            let (mut numer, mut denom) = (1.0, 1.0);
+            for j in 0..9 {
+                if j != i {
+                    numer *= 360.0 - y[j];
+                    denom *= y[i] - y[j];
+                }
+            }
+            total += numer * x[i] / denom;
+        }
+        jd_mean + total
+    }
+
+    fn solar_rashi(eph: &mut Ephemeris, jd: f64) -> i32 {
+        let rashi = (eph.solar_longitude_sidereal(jd) / 30.0).ceil() as i32;
+        if rashi <= 0 { 12 } else if rashi > 12 { (rashi - 1) % 12 + 1 } else { rashi }
+    }
+
+    /// Sidereal longitude reaches target: bisection as in solar.rs
+    fn sankranti(eph: &mut Ephemeris, jd_approx: f64, target: f64) -> f64 {
+        let diff = |lon: f64| {
+            let d = lon - target;
+            if d > 180.0 { d - 360.0 } else if d < -180.0 { d + 360.0 } else { d }
+        };
+        let mut lo = jd_approx - 20.0;
+        let mut hi = jd_approx + 20.0;
+        if diff(eph.solar_longitude_sidereal(lo)) >= 0.0 { lo -= 30.0; }
+        for _ in 0..50 {
+            let mid = (lo + hi) / 2.0;
+            if diff(eph.solar_longitude_sidereal(mid)) >= 0.0 { hi = mid; } else { lo = mid; }
+            if hi - lo < 1e-3 / 86400.0 { break; }
+        }
+        (lo + hi) / 2.0
+    }
+
+    fn years() -> (i32, i32) {
+        println!("cargo:rerun-if-env-changed=HINDU_CALENDAR_TABLE_YEARS");
+        let spec = match std::env::var("HINDU_CALENDAR_TABLE_YEARS") {
+            Ok(spec) => spec,
+            Err(_) => return DEFAULT_YEARS,
+        };
+        let parsed = spec.split_once('-').and_then(|(a, b)| {
+            Some((a.trim().parse::<i32>().ok()?, b.trim().parse::<i32>().ok()?))
+        });
+        match parsed {
+            Some((first, last)) if first <= last => (first, last),
+            _ => panic!("HINDU_CALENDAR_TABLE_YEARS must be FIRST-LAST, got '{}'", spec),
+        }
+    }
+
+    pub fn generate() {
+        println!("cargo:rerun-if-changed=src/ephemeris");
+        let (first, last) = years();
+        let mut eph = Ephemeris::new();
+
+        // A lunation or solar month either side, so every day in range is
+        // bracketed by two table entries
+        let jd0 = julian_day::gregorian_to_jd(first, 1, 1) - 40.0;
+        let jd1 = julian_day::gregorian_to_jd(last, 12, 31) + 40.0;
+
+        let mut new_moons = Vec::new();
+        let mut rashis = Vec::new();
+        let k0 = ((jd0 - NEW_MOON_EPOCH) / SYNODIC_MONTH).floor() as i64;
+        let k1 = ((jd1 - NEW_MOON_EPOCH) / SYNODIC_MONTH).ceil() as i64;
+        for k in k0..=k1 {
+            let nm = new_moon_near(&mut eph, NEW_MOON_EPOCH + k as f64 * SYNODIC_MONTH);
+            new_moons.push(nm);
+            rashis.push(solar_rashi(&mut eph, nm));
+        }
+
+        // Sankranti k enters rashi k mod 12 + 1, counting k = 0 from Mesha 2000
+        let s0 = ((jd0 - MESHA_EPOCH) / SOLAR_MONTH).floor() as i64;
+        let s1 = ((jd1 - MESHA_EPOCH) / SOLAR_MONTH).ceil() as i64;
+        let mut sankrantis = Vec::new();
+        for k in s0..=s1 {
+            let rashi = k.rem_euclid(12);
+            sankrantis.push(sankranti(&mut eph, MESHA_EPOCH + k as f64 * SOLAR_MONTH, rashi as f64 * 30.0));
+        }
+
+        let mut out = String::new();
+        writeln!(out, "// Generated by build.rs for {}-{}; do not edit.", first, last).unwrap();
+        writeln!(out, "pub const FIRST_YEAR: i32 = {};", first).unwrap();
+        writeln!(out, "pub const LAST_YEAR: i32 = {};", last).unwrap();
+        writeln!(out, "pub const NEW_MOONS: [f64; {}] = {:?};", new_moons.len(), new_moons).unwrap();
+        writeln!(out, "pub const NEW_MOON_RASHIS: [u8; {}] = {:?};", rashis.len(), rashis).unwrap();
+        writeln!(out, "pub const SANKRANTI_FIRST_RASHI: i32 = {};", s0.rem_euclid(12) + 1).unwrap();
+        writeln!(out, "pub const SANKRANTIS: [f64; {}] = {:?};", sankrantis.len(), sankrantis).unwrap();
+
+        let path = std::path::Path::new(&std::env::var("OUT_DIR").unwrap()).join("ephemeris_tables.rs");
+        std::fs::write(path, out).unwrap();
+    }
+}
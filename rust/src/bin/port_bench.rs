@@ -0,0 +1,155 @@
+//! Rust driver for the cross-port benchmark (`make bench-ports`).
+//!
+//! Reads a workload file (format in tools/bench_ports.workload), converts
+//! every (location, date) pair in every listed calendar and writes the
+//! canonical rows compared by tools/bench_ports.py.  Only the conversions
+//! are timed.
+
+use hindu_calendar::core::{panchang, solar};
+use hindu_calendar::ephemeris::Ephemeris;
+use hindu_calendar::model::*;
+use std::io::{BufWriter, Write};
+use std::time::Instant;
+
+const CALENDAR_NAMES: [&str; 5] = ["lunisolar", "tamil", "bengali", "odia", "malayalam"];
+const SOLAR_TYPES: [SolarCalendarType; 4] = [
+    SolarCalendarType::Tamil,
+    SolarCalendarType::Bengali,
+    SolarCalendarType::Odia,
+    SolarCalendarType::Malayalam,
+];
+
+struct Workload {
+    jd0: f64,
+    jd1: f64,
+    locs: Vec<Location>,
+    calendars: Vec<usize>,
+    seed: Option<u32>,
+}
+
+/// Peak resident set of this process in KiB (Linux VmHWM), or 0
+fn peak_rss_kb() -> u64 {
+    std::fs::read_to_string("/proc/self/status")
+        .ok()
+        .and_then(|s| {
+            s.lines()
+                .find(|l| l.starts_with("VmHWM:"))
+                .and_then(|l| l.split_whitespace().nth(1)?.parse().ok())
+        })
+        .unwrap_or(0)
+}
+
+fn parse_day(eph: &Ephemeris, s: &str) -> Option<f64> {
+    let parts: Vec<i32> = s.split('-').filter_map(|p| p.parse().ok()).collect();
+    match parts[..] {
+        [y, m, d] if (1..=12).contains(&m) && (1..=31).contains(&d) => {
+            Some(eph.gregorian_to_jd(y, m, d))
+        }
+        _ => None,
+    }
+}
+
+/// The workload, or the line number of the first bad line
+fn load_workload(eph: &Ephemeris, text: &str) -> Result<Workload, usize> {
+    let mut w = Workload { jd0: -1.0, jd1: -1.0, locs: Vec::new(), calendars: Vec::new(), seed: None };
+    let mut lineno = 0;
+    for line in text.lines() {
+        lineno += 1;
+        let tok: Vec<&str> = line.split_whitespace().collect();
+        if tok.is_empty() || tok[0].starts_with('#') {
+            continue;
+        }
+        let ok = match (tok[0], &tok[1..]) {
+            ("from", [d]) => parse_day(eph, d).map(|jd| w.jd0 = jd).is_some(),
+            ("to", [d]) => parse_day(eph, d).map(|jd| w.jd1 = jd).is_some(),
+            ("location", [lat, lon, off]) => match (lat.parse(), lon.parse(), off.parse()) {
+                (Ok(latitude), Ok(longitude), Ok(utc_offset)) => {
+                    w.locs.push(Location { latitude, longitude, altitude: 0.0, utc_offset });
+                    true
+                }
+                _ => false,
+            },
+            ("calendars", names) => names.iter().all(|n| {
+                match CALENDAR_NAMES.iter().position(|c| c == n) {
+                    Some(c) => {
+                        w.calendars.push(c);
+                        true
+                    }
+                    None => false,
+                }
+            }),
+            ("order", ["sequential"]) => {
+                w.seed = None;
+                true
+            }
+            ("order", ["random", seed]) => seed.parse().map(|s| w.seed = Some(s)).is_ok(),
+            _ => false,
+        };
+        if !ok {
+            return Err(lineno);
+        }
+    }
+    if w.jd0 < 0.0 || w.jd1 < w.jd0 || w.locs.is_empty() || w.calendars.is_empty() {
+        return Err(lineno + 1);
+    }
+    Ok(w)
+}
+
+fn main() {
+    let args: Vec<String> = std::env::args().collect();
+    if args.len() != 2 {
+        eprintln!("Usage: {} WORKLOAD", args[0]);
+        std::process::exit(1);
+    }
+    let text = std::fs::read_to_string(&args[1]).unwrap_or_else(|_| {
+        eprintln!("Error: cannot open '{}'", args[1]);
+        std::process::exit(1);
+    });
+    let mut eph = Ephemeris::new();
+    let w = load_workload(&eph, &text).unwrap_or_else(|line| {
+        eprintln!("Error: {} line {}: bad or missing workload entry", args[1], line);
+        std::process::exit(1);
+    });
+
+    // (location, day) pairs, location-major, optionally shuffled
+    let n_days = (w.jd1 - w.jd0) as usize + 1;
+    let n = n_days * w.locs.len();
+    let mut order: Vec<usize> = (0..n).collect();
+    if let Some(seed) = w.seed {
+        let mut x = seed;
+        for i in (1..n).rev() {
+            x = x.wrapping_mul(1103515245).wrapping_add(12345);
+            let j = ((x >> 8) % (i as u32 + 1)) as usize;
+            order.swap(i, j);
+        }
+    }
+
+    // (loc, date, calendar, year, month, adhika, day)
+    let mut rows = Vec::with_capacity(n * w.calendars.len());
+    let start = Instant::now();
+    for &k in &order {
+        let loc = k / n_days;
+        let (y, m, d) = eph.jd_to_gregorian(w.jd0 + (k % n_days) as f64);
+        for &c in &w.calendars {
+            let fields = if c == 0 {
+                let hd = panchang::gregorian_to_hindu(&mut eph, y, m, d, &w.locs[loc]);
+                let tithi = hd.tithi + if hd.paksha == Paksha::Krishna { 15 } else { 0 };
+                (hd.year_saka, hd.masa.number(), hd.is_adhika_masa as i32, tithi)
+            } else {
+                let sd = solar::gregorian_to_solar(&mut eph, y, m, d, &w.locs[loc], SOLAR_TYPES[c - 1]);
+                (sd.year, sd.month, 0, sd.day)
+            };
+            rows.push((loc, y, m, d, c, fields));
+        }
+    }
+    let elapsed = start.elapsed();
+
+    let stdout = std::io::stdout();
+    let mut out = BufWriter::new(stdout.lock());
+    for (loc, y, m, d, c, (year, month, adhika, day)) in &rows {
+        writeln!(out, "{},{:04}-{:02}-{:02},{},{},{},{},{}", loc, y, m, d,
+                 CALENDAR_NAMES[*c], year, month, adhika, day).unwrap();
+    }
+    out.flush().unwrap();
+    eprintln!("rows={} compute_ns={} peak_rss_kb={}", rows.len(), elapsed.as_nanos(), peak_rss_kb());
+}
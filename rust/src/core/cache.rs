@@ -0,0 +1,278 @@
+//! Per-thread calendar caches, as in the C tree's cache.c.
+//!
+//! The new moon pair and lunisolar month starts (masa.rs), the previous
+//! day's sunrise tithi (panchang.rs) and solar year and month starts
+//! (solar.rs) are kept in thread-local LRU tables, most recently used
+//! entry first.  Capacities are process-wide and apply to every thread's
+//! tables from its next lookup.  The defaults suit walking consecutive
+//! days; random access over 1900-2050 needs about
+//!
+//!   set_capacity(CacheId::Lunation, 2048);    (1,868 lunations)
+//!   set_capacity(CacheId::Sankranti, 8192);   (4 calendars x 1,812 months)
+//!   set_capacity(CacheId::SolarYear, 1024);   (4 calendars x 151 years)
+
+use crate::model::{Location, LunisolarScheme, MasaName, SolarCalendarType};
+use std::cell::RefCell;
+use std::sync::atomic::{AtomicU64, AtomicUsize, Ordering};
+
+pub const MAX_ENTRIES: usize = 1 << 20;
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum CacheId {
+    Lunation = 0,
+    Month = 1,
+    PrevDay = 2,
+    SolarYear = 3,
+    Sankranti = 4,
+}
+
+pub const CACHE_IDS: [CacheId; 5] = [
+    CacheId::Lunation,
+    CacheId::Month,
+    CacheId::PrevDay,
+    CacheId::SolarYear,
+    CacheId::Sankranti,
+];
+
+impl CacheId {
+    pub fn name(self) -> &'static str {
+        match self {
+            CacheId::Lunation => "lunation",
+            CacheId::Month => "month",
+            CacheId::PrevDay => "prev_day",
+            CacheId::SolarYear => "solar_year",
+            CacheId::Sankranti => "sankranti",
+        }
+    }
+}
+
+/// Hits, misses and evictions are totals over all threads since the last
+/// `stats_reset()`; occupancy is the calling thread's.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct CacheStats {
+    pub hits: u64,
+    pub misses: u64,
+    pub evictions: u64,
+    pub occupancy: usize,
+    pub capacity: usize,
+}
+
+static CAPACITY: [AtomicUsize; 5] = [
+    AtomicUsize::new(1),
+    AtomicUsize::new(32),
+    AtomicUsize::new(1),
+    AtomicUsize::new(4),
+    AtomicUsize::new(4),
+];
+
+struct Counters {
+    hits: AtomicU64,
+    misses: AtomicU64,
+    evictions: AtomicU64,
+}
+
+const ZERO: Counters = Counters {
+    hits: AtomicU64::new(0),
+    misses: AtomicU64::new(0),
+    evictions: AtomicU64::new(0),
+};
+static COUNTERS: [Counters; 5] = [ZERO, ZERO, ZERO, ZERO, ZERO];
+
+/// Set the number of entries per thread for a cache (1 to MAX_ENTRIES).
+/// Returns false, changing nothing, if n is out of range.
+pub fn set_capacity(id: CacheId, n: usize) -> bool {
+    if n < 1 || n > MAX_ENTRIES {
+        return false;
+    }
+    CAPACITY[id as usize].store(n, Ordering::Relaxed);
+    true
+}
+
+pub fn capacity(id: CacheId) -> usize {
+    CAPACITY[id as usize].load(Ordering::Relaxed)
+}
+
+/// Set capacities from "name=N,name=N" (names as `CacheId::name()`).
+/// Returns false, changing nothing, on an unknown name or bad count.
+pub fn parse_capacities(spec: &str) -> bool {
+    let mut parsed = Vec::new();
+    for item in spec.split(',') {
+        let (name, n) = match item.split_once('=') {
+            Some(pair) => pair,
+            None => return false,
+        };
+        let id = match CACHE_IDS.iter().find(|id| id.name() == name.trim()) {
+            Some(&id) => id,
+            None => return false,
+        };
+        match n.trim().parse::<usize>() {
+            Ok(n) if (1..=MAX_ENTRIES).contains(&n) => parsed.push((id, n)),
+            _ => return false,
+        }
+    }
+    for (id, n) in parsed {
+        set_capacity(id, n);
+    }
+    true
+}
+
+pub fn stats(id: CacheId) -> CacheStats {
+    let c = &COUNTERS[id as usize];
+    CacheStats {
+        hits: c.hits.load(Ordering::Relaxed),
+        misses: c.misses.load(Ordering::Relaxed),
+        evictions: c.evictions.load(Ordering::Relaxed),
+        occupancy: with(|caches| caches.occupancy(id)),
+        capacity: capacity(id),
+    }
+}
+
+pub fn stats_reset() {
+    for c in &COUNTERS {
+        c.hits.store(0, Ordering::Relaxed);
+        c.misses.store(0, Ordering::Relaxed);
+        c.evictions.store(0, Ordering::Relaxed);
+    }
+}
+
+/// Empty the calling thread's tables (the counts are kept)
+pub fn clear() {
+    with(|caches| *caches = Caches::new());
+}
+
+// ---- Entries ----
+
+#[derive(Clone, Copy)]
+pub(crate) struct LunationEntry {
+    pub last_nm: f64,
+    pub next_nm: f64,
+    pub rashi_last: i32,
+    pub rashi_next: i32,
+}
+
+#[derive(Clone, Copy)]
+pub(crate) struct MonthEntry {
+    pub masa: MasaName,
+    pub saka_year: i32,
+    pub is_adhika: bool,
+    pub scheme: LunisolarScheme,
+    pub loc: Location,
+    pub jd_start: f64,
+    /// 0 until lunisolar_month_length() fills it
+    pub length: i32,
+}
+
+#[derive(Clone, Copy)]
+pub(crate) struct PrevDayEntry {
+    pub jd: f64,
+    pub loc: Location,
+    pub tithi: i32,
+}
+
+#[derive(Clone, Copy)]
+pub(crate) struct SolarYearEntry {
+    pub cal_type: SolarCalendarType,
+    pub greg_year: i32,
+    pub loc: Location,
+    pub jd_year_civil: f64,
+}
+
+#[derive(Clone, Copy)]
+pub(crate) struct SankrantiEntry {
+    pub cal_type: SolarCalendarType,
+    pub rashi: i32,
+    pub loc: Location,
+    pub jd_sankranti: f64,
+    pub jd_civil: f64,
+}
+
+/// One LRU table, most recently used entry first
+pub(crate) struct Lru<T> {
+    id: CacheId,
+    entries: Vec<T>,
+}
+
+impl<T: Copy> Lru<T> {
+    fn new(id: CacheId) -> Self {
+        Lru { id, entries: Vec::new() }
+    }
+
+    /// The first entry matching, made most recently used; counts a hit or miss
+    pub fn find(&mut self, matches: impl Fn(&T) -> bool) -> Option<&mut T> {
+        let c = &COUNTERS[self.id as usize];
+        match self.entries.iter().position(matches) {
+            Some(i) => {
+                c.hits.fetch_add(1, Ordering::Relaxed);
+                self.entries[..=i].rotate_right(1);
+                Some(&mut self.entries[0])
+            }
+            None => {
+                c.misses.fetch_add(1, Ordering::Relaxed);
+                None
+            }
+        }
+    }
+
+    /// Like find() but uncounted, for updating an entry just looked up
+    pub fn peek(&mut self, matches: impl Fn(&T) -> bool) -> Option<&mut T> {
+        self.entries.iter_mut().find(|e| matches(e))
+    }
+
+    /// Add an entry as most recently used, evicting the least recently used
+    pub fn insert(&mut self, entry: T) {
+        let cap = capacity(self.id);
+        if self.entries.len() >= cap {
+            let evicted = self.entries.len() + 1 - cap;
+            self.entries.truncate(cap - 1);
+            COUNTERS[self.id as usize].evictions.fetch_add(evicted as u64, Ordering::Relaxed);
+        }
+        self.entries.insert(0, entry);
+    }
+}
+
+pub(crate) struct Caches {
+    pub lunation: Lru<LunationEntry>,
+    pub month: Lru<MonthEntry>,
+    pub prev_day: Lru<PrevDayEntry>,
+    pub solar_year: Lru<SolarYearEntry>,
+    pub sankranti: Lru<SankrantiEntry>,
+}
+
+impl Caches {
+    fn new() -> Self {
+        Caches {
+            lunation: Lru::new(CacheId::Lunation),
+            month: Lru::new(CacheId::Month),
+            prev_day: Lru::new(CacheId::PrevDay),
+            solar_year: Lru::new(CacheId::SolarYear),
+            sankranti: Lru::new(CacheId::Sankranti),
+        }
+    }
+
+    fn occupancy(&self, id: CacheId) -> usize {
+        match id {
+            CacheId::Lunation => self.lunation.entries.len(),
+            CacheId::Month => self.month.entries.len(),
+            CacheId::PrevDay => self.prev_day.entries.len(),
+            CacheId::SolarYear => self.solar_year.entries.len(),
+            CacheId::Sankranti => self.sankranti.entries.len(),
+        }
+    }
+}
+
+thread_local! {
+    static CACHES: RefCell<Caches> = RefCell::new(Caches::new());
+}
+
+/// Run f on the calling thread's caches.  f must not call back into a
+/// function that uses the caches.
+pub(crate) fn with<R>(f: impl FnOnce(&mut Caches) -> R) -> R {
+    CACHES.with(|c| f(&mut c.borrow_mut()))
+}
+
+pub(crate) fn same_location(a: &Location, b: &Location) -> bool {
+    a.latitude == b.latitude
+        && a.longitude == b.longitude
+        && a.altitude == b.altitude
+        && a.utc_offset == b.utc_offset
+}
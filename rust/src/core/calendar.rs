@@ -0,0 +1,135 @@
+//! A calendar context that can be shared between threads, and date-range
+//! conversion split across worker threads.
+//!
+//! `Calendar` holds only a location.  Each thread that uses it gets its
+//! own `Ephemeris` and caches (see cache.rs), so one `Calendar` can be
+//! shared by reference or `Arc` between threads.  A range is cut into
+//! runs of days that share a mean lunation (or a mean solar month for
+//! the solar calendars), and each worker converts whole runs, so its
+//! caches hit for every day after a run's first.
+
+use crate::ephemeris::{julian_day, Ephemeris};
+use crate::model::*;
+use super::{panchang, solar};
+use std::cell::RefCell;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::Mutex;
+
+const SYNODIC_MONTH: f64 = 29.530588853;
+const NEW_MOON_EPOCH: f64 = 2451550.09766;   // mean new moon of 2000-01-06
+const SOLAR_MONTH: f64 = 365.25636 / 12.0;
+const MESHA_EPOCH: f64 = 2451648.0;          // ~ Mesha sankranti 2000
+
+thread_local! {
+    static EPHEMERIS: RefCell<Ephemeris> = RefCell::new(Ephemeris::new());
+}
+
+fn with_ephemeris<R>(f: impl FnOnce(&mut Ephemeris) -> R) -> R {
+    EPHEMERIS.with(|e| f(&mut e.borrow_mut()))
+}
+
+#[derive(Debug, Clone, Copy)]
+pub struct Calendar {
+    loc: Location,
+}
+
+impl Calendar {
+    pub fn new(loc: Location) -> Self {
+        Calendar { loc }
+    }
+
+    pub fn location(&self) -> &Location {
+        &self.loc
+    }
+
+    pub fn gregorian_to_hindu(&self, year: i32, month: i32, day: i32) -> HinduDate {
+        with_ephemeris(|eph| panchang::gregorian_to_hindu(eph, year, month, day, &self.loc))
+    }
+
+    pub fn gregorian_to_solar(&self, year: i32, month: i32, day: i32,
+                              cal_type: SolarCalendarType) -> SolarDate {
+        with_ephemeris(|eph| solar::gregorian_to_solar(eph, year, month, day, &self.loc, cal_type))
+    }
+
+    /// Hindu date of every day from `from` to `to` (inclusive, as
+    /// (year, month, day)), in date order, on `threads` workers (0 = one
+    /// per CPU).  Empty if `to` is before `from`.
+    pub fn hindu_range(&self, from: (i32, i32, i32), to: (i32, i32, i32),
+                       threads: usize) -> Vec<HinduDate> {
+        let runs = split_range(from, to, NEW_MOON_EPOCH, SYNODIC_MONTH);
+        run_parallel(&runs, threads, |y, m, d| self.gregorian_to_hindu(y, m, d))
+    }
+
+    /// Solar date of every day from `from` to `to`; as `hindu_range()`
+    pub fn solar_range(&self, from: (i32, i32, i32), to: (i32, i32, i32),
+                       cal_type: SolarCalendarType, threads: usize) -> Vec<SolarDate> {
+        let runs = split_range(from, to, MESHA_EPOCH, SOLAR_MONTH);
+        run_parallel(&runs, threads, |y, m, d| self.gregorian_to_solar(y, m, d, cal_type))
+    }
+}
+
+/// (first JD, number of days) of each run of days from `from` to `to`
+/// falling in the same period of length `period` counted from `epoch`.
+/// Mean periods are within a day or two of the true boundaries, which is
+/// close enough: a run that starts early only misses the cache once more.
+fn split_range(from: (i32, i32, i32), to: (i32, i32, i32),
+               epoch: f64, period: f64) -> Vec<(f64, usize)> {
+    let jd0 = julian_day::gregorian_to_jd(from.0, from.1, from.2);
+    let jd1 = julian_day::gregorian_to_jd(to.0, to.1, to.2);
+    let mut runs: Vec<(f64, usize)> = Vec::new();
+    let mut jd = jd0;
+    let mut prev = None;
+    while jd <= jd1 {
+        // Period of the day's noon UT
+        let k = ((jd + 0.5 - epoch) / period).floor() as i64;
+        match runs.last_mut() {
+            Some(run) if prev == Some(k) => run.1 += 1,
+            _ => runs.push((jd, 1)),
+        }
+        prev = Some(k);
+        jd += 1.0;
+    }
+    runs
+}
+
+/// convert(y, m, d) for every day of every run, in order.  Workers take
+/// the next unclaimed run until none are left.
+fn run_parallel<T, F>(runs: &[(f64, usize)], threads: usize, convert: F) -> Vec<T>
+where
+    T: Send,
+    F: Fn(i32, i32, i32) -> T + Sync,
+{
+    let convert_run = |&(jd, n): &(f64, usize)| -> Vec<T> {
+        (0..n)
+            .map(|i| {
+                let (y, m, d) = julian_day::jd_to_gregorian(jd + i as f64);
+                convert(y, m, d)
+            })
+            .collect()
+    };
+
+    let threads = match threads {
+        0 => std::thread::available_parallelism().map_or(1, |n| n.get()),
+        n => n,
+    }
+    .min(runs.len());
+    if threads <= 1 {
+        return runs.iter().flat_map(convert_run).collect();
+    }
+
+    let next = AtomicUsize::new(0);
+    let done: Mutex<Vec<Option<Vec<T>>>> = Mutex::new((0..runs.len()).map(|_| None).collect());
+    std::thread::scope(|s| {
+        for _ in 0..threads {
+            s.spawn(|| loop {
+                let i = next.fetch_add(1, Ordering::Relaxed);
+                if i >= runs.len() {
+                    break;
+                }
+                let out = convert_run(&runs[i]);
+                done.lock().unwrap()[i] = Some(out);
+            });
+        }
+    });
+    done.into_inner().unwrap().into_iter().flatten().flatten().collect()
+}
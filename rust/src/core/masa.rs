@@ -1,6 +1,7 @@
 use crate::ephemeris::Ephemeris;
 use crate::model::*;
-use super::tithi;
+use super::cache::{self, LunationEntry, MonthEntry};
+use super::{tables, tithi};
 
 /// Inverse Lagrange interpolation
 fn inverse_lagrange(x: &[f64], y: &[f64], n: usize, ya: f64) -> f64 {
@@ -86,18 +87,42 @@ pub fn masa_for_date(
     if jd_rise <= 0.0 {
         jd_rise = jd + 0.5 - loc.utc_offset / 24.0;
     }
+    masa_for_date_at(eph, jd_rise)
+}
 
-    let t = tithi::tithi_at_moment(eph, jd_rise);
-
-    let last_nm = new_moon_before(eph, jd_rise, t);
-    let next_nm = new_moon_after(eph, jd_rise, t);
-
-    let rashi_last = solar_rashi(eph, last_nm);
-    let rashi_next = solar_rashi(eph, next_nm);
+/// Masa for a day whose sunrise the caller already has.  Consecutive days
+/// share a pair of new moons, which are kept in the lunation cache.
+pub fn masa_for_date_at(eph: &mut Ephemeris, jd_rise: f64) -> MasaInfo {
+    let cached = cache::with(|c| {
+        c.lunation.find(|e| jd_rise > e.last_nm && jd_rise < e.next_nm).map(|e| *e)
+    });
+    let e = match cached {
+        Some(e) => e,
+        None => {
+            let e = match tables::lunation_at(jd_rise) {
+                Some((last_nm, next_nm, rashi_last, rashi_next)) => {
+                    LunationEntry { last_nm, next_nm, rashi_last, rashi_next }
+                }
+                None => {
+                    let t = tithi::tithi_at_moment(eph, jd_rise);
+                    let last_nm = new_moon_before(eph, jd_rise, t);
+                    let next_nm = new_moon_after(eph, jd_rise, t);
+                    LunationEntry {
+                        last_nm,
+                        next_nm,
+                        rashi_last: solar_rashi(eph, last_nm),
+                        rashi_next: solar_rashi(eph, next_nm),
+                    }
+                }
+            };
+            cache::with(|c| c.lunation.insert(e));
+            e
+        }
+    };
 
-    let is_adhika = rashi_last == rashi_next;
+    let is_adhika = e.rashi_last == e.rashi_next;
 
-    let mut masa_num = rashi_last + 1;
+    let mut masa_num = e.rashi_last + 1;
     if masa_num > 12 { masa_num -= 12; }
     let name = MasaName::from_number(masa_num);
 
@@ -109,8 +134,8 @@ pub fn masa_for_date(
         is_adhika,
         year_saka,
         year_vikram,
-        jd_start: last_nm,
-        jd_end: next_nm,
+        jd_start: e.last_nm,
+        jd_end: e.next_nm,
     }
 }
 
@@ -196,6 +221,18 @@ fn amanta_month_start(
     0.0
 }
 
+fn month_matches(
+    e: &MonthEntry,
+    masa: MasaName,
+    saka_year: i32,
+    is_adhika: bool,
+    scheme: LunisolarScheme,
+    loc: &Location,
+) -> bool {
+    e.masa == masa && e.saka_year == saka_year && e.is_adhika == is_adhika
+        && e.scheme == scheme && cache::same_location(&e.loc, loc)
+}
+
 pub fn lunisolar_month_start(
     eph: &mut Ephemeris,
     masa: MasaName,
@@ -203,6 +240,30 @@ pub fn lunisolar_month_start(
     is_adhika: bool,
     scheme: LunisolarScheme,
     loc: &Location,
+) -> f64 {
+    let cached = cache::with(|c| {
+        c.month.find(|e| month_matches(e, masa, saka_year, is_adhika, scheme, loc))
+            .map(|e| e.jd_start)
+    });
+    if let Some(jd_start) = cached {
+        return jd_start;
+    }
+    let jd_start = month_start_compute(eph, masa, saka_year, is_adhika, scheme, loc);
+    if jd_start != 0.0 {
+        cache::with(|c| c.month.insert(MonthEntry {
+            masa, saka_year, is_adhika, scheme, loc: *loc, jd_start, length: 0,
+        }));
+    }
+    jd_start
+}
+
+fn month_start_compute(
+    eph: &mut Ephemeris,
+    masa: MasaName,
+    saka_year: i32,
+    is_adhika: bool,
+    scheme: LunisolarScheme,
+    loc: &Location,
 ) -> f64 {
     if scheme == LunisolarScheme::Purnimanta {
         let amanta_start = amanta_month_start(eph, masa, saka_year, is_adhika, loc);
@@ -239,6 +300,32 @@ pub fn lunisolar_month_length(
     is_adhika: bool,
     scheme: LunisolarScheme,
     loc: &Location,
+) -> i32 {
+    let cached = cache::with(|c| {
+        c.month.find(|e| month_matches(e, masa, saka_year, is_adhika, scheme, loc) && e.length > 0)
+            .map(|e| e.length)
+    });
+    if let Some(length) = cached {
+        return length;
+    }
+    let length = month_length_compute(eph, masa, saka_year, is_adhika, scheme, loc);
+    if length > 0 {
+        cache::with(|c| {
+            if let Some(e) = c.month.peek(|e| month_matches(e, masa, saka_year, is_adhika, scheme, loc)) {
+                e.length = length;
+            }
+        });
+    }
+    length
+}
+
+fn month_length_compute(
+    eph: &mut Ephemeris,
+    masa: MasaName,
+    saka_year: i32,
+    is_adhika: bool,
+    scheme: LunisolarScheme,
+    loc: &Location,
 ) -> i32 {
     let jd_start = lunisolar_month_start(eph, masa, saka_year, is_adhika, scheme, loc);
     if jd_start == 0.0 { return 0; }
@@ -1,4 +1,7 @@
+pub mod cache;
+pub mod calendar;
 pub mod tithi;
 pub mod masa;
 pub mod panchang;
 pub mod solar;
+pub mod tables;
@@ -1,5 +1,6 @@
 use crate::ephemeris::Ephemeris;
 use crate::model::*;
+use super::cache::{self, PrevDayEntry};
 use super::{tithi, masa};
 
 fn days_in_month(year: i32, month: i32) -> i32 {
@@ -12,6 +13,13 @@ fn days_in_month(year: i32, month: i32) -> i32 {
     MDAYS[month as usize]
 }
 
+/// Sunrise JD for the civil day starting at jd, or 6h local where the sun
+/// does not rise
+fn day_sunrise(eph: &mut Ephemeris, jd: f64, loc: &Location) -> f64 {
+    let jd_rise = eph.sunrise_jd(jd, loc);
+    if jd_rise <= 0.0 { jd + 0.5 - loc.utc_offset / 24.0 } else { jd_rise }
+}
+
 pub fn gregorian_to_hindu(
     eph: &mut Ephemeris,
     year: i32,
@@ -19,23 +27,44 @@ pub fn gregorian_to_hindu(
     day: i32,
     loc: &Location,
 ) -> HinduDate {
-    let ti = tithi::tithi_at_sunrise(eph, year, month, day, loc);
-    let mi = masa::masa_for_date(eph, year, month, day, loc);
-
+    // Only the tithi number is needed, not its boundaries
+    let jd = eph.gregorian_to_jd(year, month, day);
+    let jd_rise = day_sunrise(eph, jd, loc);
+    let t = tithi::tithi_at_moment(eph, jd_rise);
+    let mi = masa::masa_for_date_at(eph, jd_rise);
+
+    // Adhika tithi: same tithi as the previous day's sunrise, which the
+    // previous call usually left in the cache
     let is_adhika_tithi = if day > 1 {
-        let ti_prev = tithi::tithi_at_sunrise(eph, year, month, day - 1, loc);
-        ti.tithi_num == ti_prev.tithi_num
+        let jd_prev = jd - 1.0;
+        let cached = cache::with(|c| {
+            c.prev_day.find(|e| e.jd == jd_prev && cache::same_location(&e.loc, loc))
+                .map(|e| e.tithi)
+        });
+        let t_prev = match cached {
+            Some(t_prev) => t_prev,
+            None => {
+                let jd_rise_prev = day_sunrise(eph, jd_prev, loc);
+                tithi::tithi_at_moment(eph, jd_rise_prev)
+            }
+        };
+        t == t_prev
     } else {
         false
     };
+    cache::with(|c| {
+        if c.prev_day.peek(|e| e.jd == jd && cache::same_location(&e.loc, loc)).is_none() {
+            c.prev_day.insert(PrevDayEntry { jd, loc: *loc, tithi: t });
+        }
+    });
 
     HinduDate {
         masa: mi.name,
         is_adhika_masa: mi.is_adhika,
         year_saka: mi.year_saka,
         year_vikram: mi.year_vikram,
-        paksha: ti.paksha,
-        tithi: ti.paksha_tithi,
+        paksha: if t <= 15 { Paksha::Shukla } else { Paksha::Krishna },
+        tithi: if t <= 15 { t } else { t - 15 },
         is_adhika_tithi,
     }
 }
@@ -1,6 +1,7 @@
 use crate::ephemeris::Ephemeris;
 use crate::model::*;
-use super::tithi;
+use super::cache::{self, SankrantiEntry, SolarYearEntry};
+use super::{tables, tithi};
 
 // Regional month names
 const BENGALI_MONTHS: [&str; 13] = [
@@ -130,6 +131,13 @@ fn bengali_rashi_correction(
 // ---- Sankranti finding ----
 
 pub fn sankranti_jd(eph: &mut Ephemeris, jd_approx: f64, target_longitude: f64) -> f64 {
+    match tables::sankranti_near(jd_approx, target_longitude) {
+        Some(jd) => jd,
+        None => sankranti_jd_series(eph, jd_approx, target_longitude),
+    }
+}
+
+pub(crate) fn sankranti_jd_series(eph: &mut Ephemeris, jd_approx: f64, target_longitude: f64) -> f64 {
     let mut lo = jd_approx - 20.0;
     let mut hi = jd_approx + 20.0;
 
@@ -224,6 +232,33 @@ fn solar_year(
     let cfg = get_config(cal_type);
     let (gy, _, _) = eph.jd_to_gregorian(jd_ut);
 
+    // Every day of a Gregorian year shares its regional year start
+    let cached = cache::with(|c| {
+        c.solar_year.find(|e| e.cal_type == cal_type && e.greg_year == gy
+                              && cache::same_location(&e.loc, loc))
+            .map(|e| e.jd_year_civil)
+    });
+    let jd_year_civil = match cached {
+        Some(jd) => jd,
+        None => {
+            let jd = year_start_civil(eph, gy, loc, cal_type);
+            cache::with(|c| c.solar_year.insert(SolarYearEntry {
+                cal_type, greg_year: gy, loc: *loc, jd_year_civil: jd,
+            }));
+            jd
+        }
+    };
+
+    if jd_greg_date >= jd_year_civil {
+        gy - cfg.gy_offset_on
+    } else {
+        gy - cfg.gy_offset_before
+    }
+}
+
+/// Civil day on which the regional year starting in Gregorian year gy begins
+fn year_start_civil(eph: &mut Ephemeris, gy: i32, loc: &Location, cal_type: SolarCalendarType) -> f64 {
+    let cfg = get_config(cal_type);
     let target_long = (cfg.year_start_rashi - 1) as f64 * 30.0;
     let mut approx_greg_month = 3 + cfg.year_start_rashi;
     if approx_greg_month > 12 { approx_greg_month -= 12; }
@@ -232,13 +267,7 @@ fn solar_year(
     let jd_year_start = sankranti_jd(eph, jd_year_start_est, target_long);
 
     let (ysy, ysm, ysd) = sankranti_to_civil_day(eph, jd_year_start, loc, cal_type, cfg.year_start_rashi);
-    let jd_year_civil = eph.gregorian_to_jd(ysy, ysm, ysd);
-
-    if jd_greg_date >= jd_year_civil {
-        gy - cfg.gy_offset_on
-    } else {
-        gy - cfg.gy_offset_before
-    }
+    eph.gregorian_to_jd(ysy, ysm, ysd)
 }
 
 // ---- Public API ----
@@ -261,26 +290,43 @@ pub fn gregorian_to_solar(
 
     bengali_rashi_correction(eph, cal_type, jd_crit, &mut rashi, &mut lon);
 
-    let target = (rashi - 1) as f64 * 30.0;
-    let mut degrees_past = lon - target;
-    if degrees_past < 0.0 { degrees_past += 360.0; }
-    let jd_est = jd_crit - degrees_past;
-    let jd_sankranti = sankranti_jd(eph, jd_est, target);
-
-    let (sy, sm, s_day) = sankranti_to_civil_day(eph, jd_sankranti, loc, cal_type, rashi);
-    let jd_month_start = eph.gregorian_to_jd(sy, sm, s_day);
-    let mut sd_day = (jd - jd_month_start) as i32 + 1;
-
-    let (rashi, jd_sankranti) = if sd_day <= 0 {
-        let new_rashi = if rashi == 1 { 12 } else { rashi - 1 };
-        let prev_target = (new_rashi - 1) as f64 * 30.0;
-        let new_jd_sank = sankranti_jd(eph, jd_sankranti - 28.0, prev_target);
-        let (sy2, sm2, sd2) = sankranti_to_civil_day(eph, new_jd_sank, loc, cal_type, new_rashi);
-        let jd_ms = eph.gregorian_to_jd(sy2, sm2, sd2);
-        sd_day = (jd - jd_ms) as i32 + 1;
-        (new_rashi, new_jd_sank)
-    } else {
-        (rashi, jd_sankranti)
+    // The month's sankranti and civil start hold for the ~30 days of the
+    // month; a cached month of the same rashi within 35 days is this one
+    let cached = cache::with(|c| {
+        c.sankranti.find(|e| e.cal_type == cal_type && e.rashi == rashi
+                             && cache::same_location(&e.loc, loc)
+                             && jd >= e.jd_civil && jd - e.jd_civil < 35.0)
+            .map(|e| *e)
+    });
+    let (rashi, jd_sankranti, sd_day) = match cached {
+        Some(e) => (rashi, e.jd_sankranti, (jd - e.jd_civil) as i32 + 1),
+        None => {
+            let target = (rashi - 1) as f64 * 30.0;
+            let mut degrees_past = lon - target;
+            if degrees_past < 0.0 { degrees_past += 360.0; }
+            let jd_est = jd_crit - degrees_past;
+            let jd_sankranti = sankranti_jd(eph, jd_est, target);
+
+            let (sy, sm, s_day) = sankranti_to_civil_day(eph, jd_sankranti, loc, cal_type, rashi);
+            let jd_month_start = eph.gregorian_to_jd(sy, sm, s_day);
+            let sd_day = (jd - jd_month_start) as i32 + 1;
+
+            // The Bengali tithi rule may push the month start past this
+            // day, which then belongs to the previous month
+            let (rashi, jd_sankranti, jd_month_start) = if sd_day <= 0 {
+                let new_rashi = if rashi == 1 { 12 } else { rashi - 1 };
+                let prev_target = (new_rashi - 1) as f64 * 30.0;
+                let new_jd_sank = sankranti_jd(eph, jd_sankranti - 28.0, prev_target);
+                let (sy2, sm2, sd2) = sankranti_to_civil_day(eph, new_jd_sank, loc, cal_type, new_rashi);
+                (new_rashi, new_jd_sank, eph.gregorian_to_jd(sy2, sm2, sd2))
+            } else {
+                (rashi, jd_sankranti, jd_month_start)
+            };
+            cache::with(|c| c.sankranti.insert(SankrantiEntry {
+                cal_type, rashi, loc: *loc, jd_sankranti, jd_civil: jd_month_start,
+            }));
+            (rashi, jd_sankranti, (jd - jd_month_start) as i32 + 1)
+        }
     };
 
     let reg_month = rashi_to_regional_month(rashi, cal_type);
@@ -0,0 +1,105 @@
+//! New moon and sankranti tables generated at build time (see build.rs).
+//!
+//! With the `ephemeris-tables` feature, masa.rs and solar.rs look new moons
+//! and sankrantis up here instead of evaluating the Moshier series.  Every
+//! lookup returns None outside the generated years, and always without the
+//! feature, and the caller then falls back to the series.
+
+#[cfg(feature = "ephemeris-tables")]
+mod generated {
+    include!(concat!(env!("OUT_DIR"), "/ephemeris_tables.rs"));
+}
+
+/// First and last Gregorian year of the tables, if compiled in
+pub fn years() -> Option<(i32, i32)> {
+    #[cfg(feature = "ephemeris-tables")]
+    return Some((generated::FIRST_YEAR, generated::LAST_YEAR));
+    #[cfg(not(feature = "ephemeris-tables"))]
+    None
+}
+
+/// The new moons before and after jd and the sidereal rashi at each
+#[cfg(feature = "ephemeris-tables")]
+pub fn lunation_at(jd: f64) -> Option<(f64, f64, i32, i32)> {
+    use generated::{NEW_MOONS, NEW_MOON_RASHIS};
+    let i = NEW_MOONS.partition_point(|&nm| nm < jd);
+    if i == 0 || i == NEW_MOONS.len() || NEW_MOONS[i] == jd {
+        return None;
+    }
+    Some((NEW_MOONS[i - 1], NEW_MOONS[i], NEW_MOON_RASHIS[i - 1] as i32, NEW_MOON_RASHIS[i] as i32))
+}
+
+#[cfg(not(feature = "ephemeris-tables"))]
+#[inline(always)]
+pub fn lunation_at(_jd: f64) -> Option<(f64, f64, i32, i32)> {
+    None
+}
+
+/// The moment the sidereal sun reaches target_longitude (a multiple of
+/// 30) within 20 days of jd_approx, which is where sankranti_jd() finds it
+#[cfg(feature = "ephemeris-tables")]
+pub fn sankranti_near(jd_approx: f64, target_longitude: f64) -> Option<f64> {
+    use generated::{SANKRANTIS, SANKRANTI_FIRST_RASHI};
+    let (lo, hi) = (jd_approx - 20.0, jd_approx + 20.0);
+    if SANKRANTIS.is_empty() || lo < SANKRANTIS[0] || hi > SANKRANTIS[SANKRANTIS.len() - 1] {
+        return None;
+    }
+    let target_rashi = (target_longitude / 30.0).round() as i32 + 1;
+    let first = SANKRANTIS.partition_point(|&jd| jd < lo);
+    (first..SANKRANTIS.len())
+        .take_while(|&i| SANKRANTIS[i] <= hi)
+        .find(|&i| (SANKRANTI_FIRST_RASHI - 1 + i as i32) % 12 + 1 == target_rashi)
+        .map(|i| SANKRANTIS[i])
+}
+
+#[cfg(not(feature = "ephemeris-tables"))]
+#[inline(always)]
+pub fn sankranti_near(_jd_approx: f64, _target_longitude: f64) -> Option<f64> {
+    None
+}
+
+#[cfg(all(test, feature = "ephemeris-tables"))]
+mod tests {
+    use super::*;
+    use crate::core::{masa, solar, tithi};
+    use crate::ephemeris::Ephemeris;
+
+    #[test]
+    fn lunations_match_series() {
+        // The series searches start from the sunrise tithi, so they land a
+        // second or so either side of the table's new moon
+        let mut eph = Ephemeris::new();
+        let (first, last) = years().unwrap();
+        let jd0 = eph.gregorian_to_jd(first, 1, 1);
+        let jd1 = eph.gregorian_to_jd(last, 12, 31);
+        let mut jd = jd0 + 0.3;
+        let mut worst: f64 = 0.0;
+        while jd <= jd1 {
+            let (last_nm, next_nm, r_last, r_next) = lunation_at(jd).unwrap();
+            let t = tithi::tithi_at_moment(&mut eph, jd);
+            worst = worst.max((last_nm - masa::new_moon_before(&mut eph, jd, t)).abs());
+            worst = worst.max((next_nm - masa::new_moon_after(&mut eph, jd, t)).abs());
+            assert_eq!(r_last, masa::solar_rashi(&mut eph, last_nm));
+            assert_eq!(r_next, masa::solar_rashi(&mut eph, next_nm));
+            jd += 7.3;
+        }
+        assert!(worst < 5.0 / 86400.0, "worst {} s", worst * 86400.0);
+    }
+
+    #[test]
+    fn sankrantis_match_series() {
+        let mut eph = Ephemeris::new();
+        let (first, last) = years().unwrap();
+        for gy in [first, (first + last) / 2, last] {
+            for m in 1..=12 {
+                let jd = eph.gregorian_to_jd(gy, m, 14);
+                // Sign entered around the 14th: Mesha (0) in April
+                let target = ((m + 8) % 12) as f64 * 30.0;
+                let table = sankranti_near(jd, target).unwrap();
+                let series = solar::sankranti_jd_series(&mut eph, jd, target);
+                assert!((table - series).abs() < 0.01 / 86400.0, "{}-{}: {} vs {}", gy, m, table, series);
+            }
+        }
+        assert!(sankranti_near(eph.gregorian_to_jd(first - 5, 6, 1), 60.0).is_none());
+    }
+}
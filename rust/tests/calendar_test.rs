@@ -0,0 +1,163 @@
+/// Calendar context, range API and cache tests.
+/// Cached results must equal cold ones for any access order and thread count.
+
+use hindu_calendar::core::cache::{self, CacheId};
+use hindu_calendar::core::calendar::Calendar;
+use hindu_calendar::model::*;
+use std::sync::Arc;
+
+const SOLAR_TYPES: [SolarCalendarType; 4] = [
+    SolarCalendarType::Tamil,
+    SolarCalendarType::Bengali,
+    SolarCalendarType::Odia,
+    SolarCalendarType::Malayalam,
+];
+
+fn hindu_key(hd: &HinduDate) -> (i32, i32, bool, Paksha, i32, bool) {
+    (hd.year_saka, hd.masa.number(), hd.is_adhika_masa, hd.paksha, hd.tithi, hd.is_adhika_tithi)
+}
+
+fn solar_key(sd: &SolarDate) -> (i32, i32, i32, i32) {
+    (sd.year, sd.month, sd.day, sd.rashi)
+}
+
+fn days(from: (i32, i32, i32), n: usize) -> Vec<(i32, i32, i32)> {
+    let jd0 = hindu_calendar::ephemeris::julian_day::gregorian_to_jd(from.0, from.1, from.2);
+    (0..n)
+        .map(|i| hindu_calendar::ephemeris::julian_day::jd_to_gregorian(jd0 + i as f64))
+        .collect()
+}
+
+/// Shuffled indices 0..n (Fisher-Yates, LCG as in tools/bench_ports.workload)
+fn shuffled(n: usize, seed: u32) -> Vec<usize> {
+    let mut order: Vec<usize> = (0..n).collect();
+    let mut x = seed;
+    for i in (1..n).rev() {
+        x = x.wrapping_mul(1103515245).wrapping_add(12345);
+        order.swap(i, ((x >> 8) % (i as u32 + 1)) as usize);
+    }
+    order
+}
+
+#[test]
+fn test_calendar_is_send_sync() {
+    fn check<T: Send + Sync>() {}
+    check::<Calendar>();
+}
+
+#[test]
+fn test_cached_equals_cold() {
+    // 2012 has an adhika month (Bhadrapada) and covers every solar month
+    let cal = Calendar::new(Location::NEW_DELHI);
+    let all = days((2012, 1, 1), 366);
+
+    let mut cold_hindu = Vec::new();
+    let mut cold_solar = Vec::new();
+    for &(y, m, d) in &all {
+        cache::clear();
+        cold_hindu.push(hindu_key(&cal.gregorian_to_hindu(y, m, d)));
+        for &t in &SOLAR_TYPES {
+            cache::clear();
+            cold_solar.push(solar_key(&cal.gregorian_to_solar(y, m, d, t)));
+        }
+    }
+
+    // Consecutive days, all calendars interleaved
+    for (i, &(y, m, d)) in all.iter().enumerate() {
+        assert_eq!(hindu_key(&cal.gregorian_to_hindu(y, m, d)), cold_hindu[i],
+                   "sequential lunisolar {}-{}-{}", y, m, d);
+        for (j, &t) in SOLAR_TYPES.iter().enumerate() {
+            assert_eq!(solar_key(&cal.gregorian_to_solar(y, m, d, t)), cold_solar[i * 4 + j],
+                       "sequential {:?} {}-{}-{}", t, y, m, d);
+        }
+    }
+
+    // Shuffled days with the default capacities
+    for &i in &shuffled(all.len(), 42) {
+        let (y, m, d) = all[i];
+        assert_eq!(hindu_key(&cal.gregorian_to_hindu(y, m, d)), cold_hindu[i],
+                   "random lunisolar {}-{}-{}", y, m, d);
+        for (j, &t) in SOLAR_TYPES.iter().enumerate() {
+            assert_eq!(solar_key(&cal.gregorian_to_solar(y, m, d, t)), cold_solar[i * 4 + j],
+                       "random {:?} {}-{}-{}", t, y, m, d);
+        }
+    }
+}
+
+#[test]
+fn test_ranges_match_single_days() {
+    let cal = Calendar::new(Location { latitude: 13.0827, longitude: 80.2707, altitude: 0.0, utc_offset: 5.5 });
+    let all = days((2024, 12, 20), 120);
+    let to = *all.last().unwrap();
+
+    let single: Vec<_> = all.iter().map(|&(y, m, d)| hindu_key(&cal.gregorian_to_hindu(y, m, d))).collect();
+    for threads in [1, 2, 3, 8, 0] {
+        let range: Vec<_> = cal.hindu_range(all[0], to, threads).iter().map(hindu_key).collect();
+        assert_eq!(range, single, "hindu_range with {} threads", threads);
+    }
+
+    for &t in &SOLAR_TYPES {
+        let single: Vec<_> = all.iter().map(|&(y, m, d)| solar_key(&cal.gregorian_to_solar(y, m, d, t))).collect();
+        for threads in [1, 4] {
+            let range: Vec<_> = cal.solar_range(all[0], to, t, threads).iter().map(solar_key).collect();
+            assert_eq!(range, single, "{:?} solar_range with {} threads", t, threads);
+        }
+    }
+
+    assert!(cal.hindu_range(to, all[0], 4).is_empty());
+    assert_eq!(cal.hindu_range(all[0], all[0], 4).len(), 1);
+}
+
+#[test]
+fn test_shared_between_threads() {
+    let cal = Arc::new(Calendar::new(Location::NEW_DELHI));
+    let expected: Vec<_> = days((2025, 3, 1), 60).iter()
+        .map(|&(y, m, d)| hindu_key(&cal.gregorian_to_hindu(y, m, d)))
+        .collect();
+    let handles: Vec<_> = (0..4)
+        .map(|k| {
+            let cal = Arc::clone(&cal);
+            std::thread::spawn(move || {
+                // Each thread walks the days in its own order
+                let all = days((2025, 3, 1), 60);
+                let mut got = vec![None; all.len()];
+                for &i in &shuffled(all.len(), k) {
+                    let (y, m, d) = all[i];
+                    got[i] = Some(hindu_key(&cal.gregorian_to_hindu(y, m, d)));
+                }
+                got.into_iter().map(Option::unwrap).collect::<Vec<_>>()
+            })
+        })
+        .collect();
+    for h in handles {
+        assert_eq!(h.join().unwrap(), expected);
+    }
+}
+
+#[test]
+fn test_capacities_and_stats() {
+    assert!(cache::parse_capacities("lunation=2048,sankranti=8192"));
+    assert_eq!(cache::capacity(CacheId::Lunation), 2048);
+    assert_eq!(cache::capacity(CacheId::Sankranti), 8192);
+    assert!(cache::parse_capacities("solar_year = 16"));
+    assert_eq!(cache::capacity(CacheId::SolarYear), 16);
+
+    // Bad specs change nothing
+    assert!(!cache::parse_capacities("lunation=64,bogus=3"));
+    assert!(!cache::parse_capacities("lunation=0"));
+    assert!(!cache::parse_capacities("month"));
+    assert!(!cache::set_capacity(CacheId::Month, cache::MAX_ENTRIES + 1));
+    assert_eq!(cache::capacity(CacheId::Lunation), 2048);
+
+    // A month of consecutive days misses the new moon pair about once
+    let cal = Calendar::new(Location::NEW_DELHI);
+    cache::clear();
+    let before = cache::stats(CacheId::Lunation);
+    for &(y, m, d) in &days((2025, 5, 1), 30) {
+        cal.gregorian_to_hindu(y, m, d);
+    }
+    let after = cache::stats(CacheId::Lunation);
+    assert!(after.hits - before.hits >= 27, "hits {}", after.hits - before.hits);
+    assert!(after.occupancy >= 1 && after.occupancy <= 3);
+    assert_eq!(after.capacity, 2048);
+}
@@ -0,0 +1,180 @@
+#include "annotate.h"
+#include "events.h"
+#include "tithi.h"
+#include "masa.h"
+#include "date_utils.h"
+#include <ctype.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+void annotator_init(Annotator *a)
+{
+    Location loc = DEFAULT_LOCATION;  /* angular events ignore location */
+    memset(a, 0, sizeof(*a));
+    event_cursor_init(&a->tithi_events, &loc);
+    event_cursor_init(&a->rashi_events, &loc);
+}
+
+/*
+ * Re-derive the interval [*from, *until) holding jd_ut for one event
+ * kind, where the value in force is the one the next event replaces.
+ * next_event() leaves the previous boundary in the cursor's bracket, so
+ * the prev_event() that widens the interval backwards is free.
+ */
+static void refresh_span(EventCursor *cur, EventType type, int count,
+                         double jd_ut, double *from, double *until, int *value)
+{
+    AstroEvent next, prev;
+    next_event(cur, jd_ut, type, &next);
+    *value = (next.value + count - 2) % count + 1;
+    *until = next.jd;
+
+    /* jd_ut exactly on a boundary: the previous event belongs to the
+     * value before, so the interval can only start here */
+    if (prev_event(cur, jd_ut, type, &prev) && prev.value == *value)
+        *from = prev.jd;
+    else
+        *from = jd_ut;
+}
+
+/* Rows further apart than this (or going backwards) are not treated as a
+ * stream: a bracket rebuild would cost more than direct evaluation. */
+#define TITHI_STREAM_GAP  1.0
+#define RASHI_STREAM_GAP 30.0
+
+void annotate_moment(Annotator *a, double jd_ut, MomentAnnotation *out)
+{
+    double gap = jd_ut - a->last_jd;
+    int t = a->tithi, r = a->rashi;
+
+    if (!(jd_ut >= a->tithi_from && jd_ut < a->tithi_until)) {
+        if (a->tithi == 0 || (gap >= 0 && gap < TITHI_STREAM_GAP)) {
+            refresh_span(&a->tithi_events, EVENT_TITHI, 30, jd_ut,
+                         &a->tithi_from, &a->tithi_until, &a->tithi);
+            t = a->tithi;
+            a->refreshes++;
+        } else {
+            t = tithi_at_moment(jd_ut);
+            a->direct++;
+        }
+    }
+    if (!(jd_ut >= a->rashi_from && jd_ut < a->rashi_until)) {
+        if (a->rashi == 0 || (gap >= 0 && gap < RASHI_STREAM_GAP)) {
+            refresh_span(&a->rashi_events, EVENT_SANKRANTI, 12, jd_ut,
+                         &a->rashi_from, &a->rashi_until, &a->rashi);
+            r = a->rashi;
+            a->refreshes++;
+        } else {
+            r = solar_rashi(jd_ut);
+            a->direct++;
+        }
+    }
+    a->last_jd = jd_ut;
+
+    out->tithi = t;
+    out->paksha = (t <= 15) ? SHUKLA_PAKSHA : KRISHNA_PAKSHA;
+    out->paksha_tithi = (t <= 15) ? t : t - 15;
+    out->rashi = r;
+}
+
+/* Parse exactly n digits; returns the value or -1 */
+static int parse_digits(const char **p, int n)
+{
+    int v = 0;
+    for (int i = 0; i < n; i++) {
+        if (!isdigit((unsigned char)**p)) return -1;
+        v = v * 10 + (**p - '0');
+        (*p)++;
+    }
+    return v;
+}
+
+/* JDs of 0000-01-01 and 10000-01-01: the years an ISO timestamp can spell */
+#define TIMESTAMP_JD_MIN 1721059.5
+#define TIMESTAMP_JD_MAX 5373484.5
+
+/* Days in a Gregorian month */
+static int days_in_month(int year, int month)
+{
+    static const int mdays[] = {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (month == 2) {
+        if ((year % 4 == 0 && year % 100 != 0) || year % 400 == 0)
+            return 29;
+    }
+    return mdays[month];
+}
+
+int parse_timestamp(const char *str, double *jd_ut)
+{
+    const char *p = str;
+    while (isspace((unsigned char)*p)) p++;
+
+    /* ISO 8601: YYYY-MM-DD[(T| )HH:MM[:SS[.fff]]][Z|(+|-)HH[:MM]] */
+    if (isdigit((unsigned char)p[0]) && isdigit((unsigned char)p[1]) &&
+        isdigit((unsigned char)p[2]) && isdigit((unsigned char)p[3]) && p[4] == '-') {
+        int year = parse_digits(&p, 4);
+        p++;
+        int month = parse_digits(&p, 2);
+        if (*p++ != '-') return 0;
+        int day = parse_digits(&p, 2);
+        if (month < 1 || month > 12 || day < 1 || day > days_in_month(year, month))
+            return 0;
+
+        double hours = 0.0;
+        if ((*p == 'T' || *p == ' ') && isdigit((unsigned char)p[1])) {
+            p++;
+            int hh = parse_digits(&p, 2);
+            if (*p++ != ':') return 0;
+            int mm = parse_digits(&p, 2);
+            if (hh < 0 || hh > 24 || mm < 0 || mm > 59) return 0;
+            double ss = 0.0;
+            if (*p == ':') {
+                p++;
+                /* SS[.fff]: plain digits only, like the other fields */
+                int si = parse_digits(&p, 2);
+                if (si < 0 || si > 60) return 0;
+                ss = si;
+                if (*p == '.' && isdigit((unsigned char)p[1])) {
+                    double scale = 0.1;
+                    for (p++; isdigit((unsigned char)*p); p++) {
+                        ss += (*p - '0') * scale;
+                        scale /= 10.0;
+                    }
+                }
+            }
+            /* 24:00 is the end of the day; 24:30 is not a time */
+            if (hh == 24 && (mm != 0 || ss != 0.0)) return 0;
+            hours = hh + mm / 60.0 + ss / 3600.0;
+        }
+
+        if (*p == 'Z') {
+            p++;
+        } else if (*p == '+' || *p == '-') {
+            int sign = (*p++ == '+') ? 1 : -1;
+            int oh = parse_digits(&p, 2);
+            int om = 0;
+            if (*p == ':') p++;
+            if (isdigit((unsigned char)*p)) om = parse_digits(&p, 2);
+            /* Real offsets run from -12:00 to +14:00 */
+            if (oh < 0 || om < 0 || oh > 14 || om > 59) return 0;
+            hours -= sign * (oh + om / 60.0);
+        }
+
+        while (isspace((unsigned char)*p)) p++;
+        if (*p != '\0') return 0;
+
+        *jd_ut = gregorian_to_jd(year, month, day) + hours / 24.0;
+        return 1;
+    }
+
+    /* Julian Day number */
+    char *end;
+    double jd = strtod(p, &end);
+    if (end == p || !isfinite(jd) || jd < TIMESTAMP_JD_MIN || jd >= TIMESTAMP_JD_MAX)
+        return 0;
+    while (isspace((unsigned char)*end)) end++;
+    if (*end != '\0') return 0;
+    *jd_ut = jd;
+    return 1;
+}
@@ -0,0 +1,53 @@
+/*
+ * annotate.h - Streaming tithi/rashi annotation of timestamps
+ *
+ * For large logs of instants (sorted or nearly so), labels each with the
+ * tithi, paksha and sidereal solar rashi in force, without evaluating
+ * the ephemeris per row.
+ *
+ * The Annotator holds the interval over which the current tithi (and
+ * rashi) is known to hold, ending at the next boundary from an
+ * EventCursor (events.h).  A row inside the interval is answered by a
+ * comparison; a row past it advances to the next boundary (one secant
+ * root find).  A row that goes backwards or jumps far ahead of the
+ * previous one is labelled directly with tithi_at_moment() and
+ * solar_rashi(), so shuffled input costs about what a per-row loop
+ * would; the next closely following row re-anchors the stream.
+ *
+ * Labels equal tithi_at_moment() / solar_rashi() except within ~0.01 s
+ * of a boundary, where the two root finders may disagree.
+ */
+#ifndef ANNOTATE_H
+#define ANNOTATE_H
+
+#include "types.h"
+
+/*
+ * annotator_init - Prepare an Annotator (no ephemeris calls).
+ */
+void annotator_init(Annotator *a);
+
+/*
+ * annotate_moment - Tithi and rashi in force at an instant.
+ *
+ *   a:     Annotator from annotator_init().
+ *   jd_ut: Instant (JD UT).  Fastest when non-decreasing across calls.
+ *   out:   Output labels.
+ */
+void annotate_moment(Annotator *a, double jd_ut, MomentAnnotation *out);
+
+/*
+ * parse_timestamp - Parse a Julian Day number or ISO 8601 timestamp.
+ *
+ *   str:   "2460676.25", "2025-01-01", "2025-01-01T06:00:00Z",
+ *          "2025-01-01 11:30:00+05:30", "2025-01-01T06:00:00.250".
+ *          A timestamp without a zone suffix is UTC.  Leading and
+ *          trailing whitespace is ignored.  Days past the end of the
+ *          month, hours past 24:00 and JDs outside years 0000-9999
+ *          (or not finite) are rejected.
+ *   jd_ut: Output JD (UT).
+ *   Returns: 1 on success, 0 if str is not a recognised timestamp.
+ */
+int parse_timestamp(const char *str, double *jd_ut);
+
+#endif /* ANNOTATE_H */
@@ -0,0 +1,566 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "archive.h"
+#include "masa.h"
+#include "date_utils.h"
+#include <fcntl.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define ARCHIVE_MAGIC      "HCPANCH\x01"
+#define ARCHIVE_FLAG_TIMES 1u
+#define INDEX_ENTRY_SIZE   16
+#define CHUNK_HEADER_SIZE  8
+#define STREAM_HEADER_SIZE 8
+#define EXCEPTION_SIZE     6
+
+/* Time unit: tenths of a second */
+#define DS_PER_DAY 864000
+/* Mean tithi length (1/30 of a synodic month) in DS units, used before
+ * any tithi length has been seen in a chunk */
+#define MEAN_TITHI_DS 850393
+
+/* Per-day flag bits */
+#define F_TITHI_MASK   0x001Fu
+#define F_MASA_SHIFT   5
+#define F_MASA_MASK    0x01E0u
+#define F_ADHIKA_MASA  0x0200u
+#define F_ADHIKA_TITHI 0x0400u
+#define F_KSHAYA       0x0800u
+#define F_SAKA_INC     0x1000u
+#define F_NO_SUNRISE   0x2000u
+
+enum { S_SUNRISE, S_START, S_END, N_STREAMS };
+
+/* Days in a Gregorian month */
+static int days_in_month(int year, int month)
+{
+    static const int mdays[] = {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (month == 2) {
+        if ((year % 4 == 0 && year % 100 != 0) || year % 400 == 0)
+            return 29;
+    }
+    return mdays[month];
+}
+
+static int days_in_year(int year)
+{
+    return ((year % 4 == 0 && year % 100 != 0) || year % 400 == 0) ? 366 : 365;
+}
+
+/* ---- Little-endian access ---- */
+
+static unsigned get_u16(const unsigned char *p)
+{
+    return (unsigned)p[0] | ((unsigned)p[1] << 8);
+}
+
+static uint32_t get_u32(const unsigned char *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static int32_t get_i32(const unsigned char *p)
+{
+    return (int32_t)get_u32(p);
+}
+
+static uint64_t get_u64(const unsigned char *p)
+{
+    return (uint64_t)get_u32(p) | ((uint64_t)get_u32(p + 4) << 32);
+}
+
+static double get_f64(const unsigned char *p)
+{
+    uint64_t bits = get_u64(p);
+    double v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+/* Growable output buffer */
+typedef struct {
+    unsigned char *p;
+    size_t len, cap;
+    int failed;
+} ByteBuf;
+
+static unsigned char *bb_grow(ByteBuf *b, size_t n)
+{
+    if (b->failed) return NULL;
+    if (b->len + n > b->cap) {
+        size_t cap = b->cap ? b->cap : 4096;
+        while (cap < b->len + n) cap *= 2;
+        unsigned char *grown = realloc(b->p, cap);
+        if (!grown) {
+            b->failed = 1;
+            return NULL;
+        }
+        b->p = grown;
+        b->cap = cap;
+    }
+    unsigned char *q = b->p + b->len;
+    b->len += n;
+    return q;
+}
+
+static void put_le(ByteBuf *b, uint64_t v, int bytes)
+{
+    unsigned char *q = bb_grow(b, (size_t)bytes);
+    if (!q) return;
+    for (int i = 0; i < bytes; i++)
+        q[i] = (unsigned char)(v >> (8 * i));
+}
+
+static void put_f64(ByteBuf *b, double v)
+{
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    put_le(b, bits, 8);
+}
+
+/* ---- Predictions (shared by encoder and decoder) ---- */
+
+/* Lengths of the last two complete tithis seen in a chunk */
+typedef struct {
+    int64_t len1, len2;
+    int n;
+} TithiLengths;
+
+static int32_t predict_sunrise(const int32_t *sr, int i)
+{
+    if (i == 0) return 0;
+    if (i == 1) return sr[0] + DS_PER_DAY;
+    return (int32_t)(2 * (int64_t)sr[i - 1] - sr[i - 2]);
+}
+
+static int32_t predict_start(const int *t, const int32_t *st, const int32_t *en, int i)
+{
+    if (i == 0) return 0;
+    if (t[i] == t[i - 1]) return st[i - 1];
+    if (t[i] == t[i - 1] % 30 + 1) return en[i - 1];
+    return (int32_t)(2 * (int64_t)en[i - 1] - st[i - 1]);
+}
+
+/* Call once per day, in order, before predict_end() for that day */
+static void track_lengths(TithiLengths *tl, const int *t, const int32_t *st,
+                          const int32_t *en, int i)
+{
+    if (i == 0 || t[i] == t[i - 1]) return;
+    tl->len2 = tl->len1;
+    tl->len1 = (int64_t)en[i - 1] - st[i - 1];
+    tl->n++;
+}
+
+static int32_t predict_end(const TithiLengths *tl, const int *t, const int32_t *st,
+                           const int32_t *en, int i)
+{
+    if (i == 0) return 0;
+    if (t[i] == t[i - 1]) return en[i - 1];
+    int64_t len = (tl->n >= 2) ? 2 * tl->len1 - tl->len2
+                : (tl->n == 1) ? tl->len1 : MEAN_TITHI_DS;
+    return (int32_t)(st[i] + len);
+}
+
+/* ---- Patched frame-of-reference streams ---- */
+
+static int cmp_i64(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Pick the base and width that minimise the packed size plus exceptions */
+static void choose_frame(const int32_t *res, int n, int32_t *base, int *width)
+{
+    int64_t sorted[ARCHIVE_MAX_DAYS];
+    for (int i = 0; i < n; i++) sorted[i] = res[i];
+    qsort(sorted, (size_t)n, sizeof(sorted[0]), cmp_i64);
+
+    long best_bits = -1;
+    *base = 0;
+    *width = 0;
+    for (int w = 0; w <= 32; w++) {
+        int64_t span = (int64_t)1 << w;
+        int best_fit = 0, best_lo = 0;
+        for (int lo = 0, hi = 0; lo < n; lo++) {
+            if (hi < lo) hi = lo;
+            while (hi < n && sorted[hi] - sorted[lo] < span) hi++;
+            if (hi - lo > best_fit) {
+                best_fit = hi - lo;
+                best_lo = lo;
+            }
+        }
+        long bits = (long)n * w + (long)(n - best_fit) * EXCEPTION_SIZE * 8;
+        if (best_bits < 0 || bits < best_bits) {
+            best_bits = bits;
+            *base = (int32_t)(n ? sorted[best_lo] : 0);
+            *width = w;
+        }
+    }
+}
+
+static void put_stream(ByteBuf *b, const int32_t *res, int n)
+{
+    int32_t base;
+    int w;
+    choose_frame(res, n, &base, &w);
+    uint64_t span = (uint64_t)1 << w;
+
+    int n_exc = 0;
+    for (int i = 0; i < n; i++)
+        if ((uint64_t)((int64_t)res[i] - base) >= span) n_exc++;
+
+    put_le(b, (uint32_t)base, 4);
+    put_le(b, (unsigned)w, 1);
+    put_le(b, 0, 1);
+    put_le(b, (unsigned)n_exc, 2);
+
+    uint64_t acc = 0;
+    int nbits = 0;
+    for (int i = 0; i < n; i++) {
+        uint64_t v = (uint64_t)((int64_t)res[i] - base);
+        if (v >= span) v = 0;
+        acc |= v << nbits;
+        nbits += w;
+        while (nbits >= 8) {
+            put_le(b, acc & 0xFF, 1);
+            acc >>= 8;
+            nbits -= 8;
+        }
+    }
+    if (nbits > 0) put_le(b, acc, 1);
+
+    for (int i = 0; i < n; i++) {
+        if ((uint64_t)((int64_t)res[i] - base) >= span) {
+            put_le(b, (unsigned)i, 2);
+            put_le(b, (uint32_t)res[i], 4);
+        }
+    }
+}
+
+/* Decode one stream of n residuals; returns the byte after it, or NULL */
+static const unsigned char *get_stream(const unsigned char *p, const unsigned char *end,
+                                       int n, int32_t *res)
+{
+    if (end - p < STREAM_HEADER_SIZE) return NULL;
+    int32_t base = get_i32(p);
+    int w = p[4];
+    int n_exc = (int)get_u16(p + 6);
+    p += STREAM_HEADER_SIZE;
+    if (w > 32) return NULL;
+
+    size_t packed = ((size_t)n * w + 7) / 8;
+    if ((size_t)(end - p) < packed + (size_t)n_exc * EXCEPTION_SIZE) return NULL;
+
+    uint64_t mask = ((uint64_t)1 << w) - 1;
+    uint64_t acc = 0;
+    int nbits = 0;
+    for (int i = 0; i < n; i++) {
+        while (nbits < w) {
+            acc |= (uint64_t)*p++ << nbits;
+            nbits += 8;
+        }
+        res[i] = (int32_t)(uint32_t)((uint32_t)base + (uint32_t)(acc & mask));
+        acc >>= w;
+        nbits -= w;
+    }
+
+    for (int k = 0; k < n_exc; k++, p += EXCEPTION_SIZE) {
+        unsigned day = get_u16(p);
+        if (day >= (unsigned)n) return NULL;
+        res[day] = get_i32(p + 2);
+    }
+    return p;
+}
+
+/* ---- Writing ---- */
+
+static int32_t to_ds(double jd, double jd0)
+{
+    return (int32_t)llround((jd - jd0) * DS_PER_DAY);
+}
+
+/* Encode one year starting at days[0]; returns 0, or -1 on a bad field */
+static int put_chunk(ByteBuf *b, const PanchangDay *days, int n, int has_times,
+                     const Location *loc)
+{
+    int t[ARCHIVE_MAX_DAYS];
+    int32_t v[N_STREAMS][ARCHIVE_MAX_DAYS], res[N_STREAMS][ARCHIVE_MAX_DAYS];
+    double jd0 = gregorian_to_jd(days[0].greg_year, 1, 1);
+
+    put_le(b, (unsigned)n, 2);
+    put_le(b, 0, 2);
+    put_le(b, (uint32_t)days[0].hindu_date.year_saka, 4);
+
+    for (int i = 0; i < n; i++) {
+        const PanchangDay *pd = &days[i];
+        const HinduDate *hd = &pd->hindu_date;
+        int tn = pd->tithi.tithi_num;
+        if (tn < 1 || tn > 30 || hd->masa < CHAITRA || hd->masa > PHALGUNA ||
+            hd->tithi != (tn <= 15 ? tn : tn - 15) ||
+            hd->paksha != (tn <= 15 ? SHUKLA_PAKSHA : KRISHNA_PAKSHA))
+            return -1;
+        unsigned flags = (unsigned)tn | ((unsigned)hd->masa << F_MASA_SHIFT);
+        if (hd->is_adhika_masa) flags |= F_ADHIKA_MASA;
+        if (hd->is_adhika_tithi) flags |= F_ADHIKA_TITHI;
+        if (pd->tithi.is_kshaya) flags |= F_KSHAYA;
+        if (i > 0) {
+            int inc = hd->year_saka - days[i - 1].hindu_date.year_saka;
+            if (inc < 0 || inc > 1) return -1;
+            if (inc) flags |= F_SAKA_INC;
+        }
+        if (has_times && pd->jd_sunrise <= 0) flags |= F_NO_SUNRISE;
+        put_le(b, flags, 2);
+
+        t[i] = tn;
+        if (has_times) {
+            /* Without a sunrise the tithi is taken at local noon (tithi.c) */
+            double jd = jd0 + i;
+            double rise = (pd->jd_sunrise > 0) ? pd->jd_sunrise
+                                               : jd + 0.5 - loc->utc_offset / 24.0;
+            v[S_SUNRISE][i] = to_ds(rise, jd0);
+            v[S_START][i] = to_ds(pd->tithi.jd_start, jd0);
+            v[S_END][i] = to_ds(pd->tithi.jd_end, jd0);
+        }
+    }
+    if (!has_times) return 0;
+
+    TithiLengths tl = {0, 0, 0};
+    for (int i = 0; i < n; i++) {
+        track_lengths(&tl, t, v[S_START], v[S_END], i);
+        res[S_SUNRISE][i] = (int32_t)((int64_t)v[S_SUNRISE][i] - predict_sunrise(v[S_SUNRISE], i));
+        res[S_START][i] = (int32_t)((int64_t)v[S_START][i] -
+                                    predict_start(t, v[S_START], v[S_END], i));
+        res[S_END][i] = (int32_t)((int64_t)v[S_END][i] -
+                                  predict_end(&tl, t, v[S_START], v[S_END], i));
+    }
+    for (int s = 0; s < N_STREAMS; s++)
+        put_stream(b, res[s], n);
+    return 0;
+}
+
+long archive_write(const char *path, const Location *loc,
+                   const PanchangDay *days, int count, int has_times)
+{
+    if (count <= 0 || days[0].greg_month != 1 || days[0].greg_day != 1)
+        return -1;
+
+    /* Check the days are consecutive whole years */
+    int first_year = days[0].greg_year, n_years = 0;
+    for (int i = 0; i < count; n_years++) {
+        int year = first_year + n_years;
+        if (count - i < days_in_year(year)) return -1;
+        for (int m = 1; m <= 12; m++) {
+            for (int d = 1; d <= days_in_month(year, m); d++, i++) {
+                if (days[i].greg_year != year || days[i].greg_month != m ||
+                    days[i].greg_day != d)
+                    return -1;
+            }
+        }
+    }
+
+    ByteBuf b = {NULL, 0, 0, 0};
+    put_le(&b, get_u64((const unsigned char *)ARCHIVE_MAGIC), 8);
+    put_le(&b, has_times ? ARCHIVE_FLAG_TIMES : 0, 4);
+    put_le(&b, (uint32_t)first_year, 4);
+    put_le(&b, (uint32_t)n_years, 4);
+    put_le(&b, 0, 4);
+    put_f64(&b, loc->latitude);
+    put_f64(&b, loc->longitude);
+    put_f64(&b, loc->altitude);
+    put_f64(&b, loc->utc_offset);
+    put_le(&b, 0, 8);
+
+    size_t index = b.len;
+    bb_grow(&b, (size_t)n_years * INDEX_ENTRY_SIZE);
+
+    for (int y = 0, i = 0; y < n_years && !b.failed; y++) {
+        int n = days_in_year(first_year + y);
+        size_t start = b.len;
+        if (put_chunk(&b, days + i, n, has_times, loc) != 0) {
+            free(b.p);
+            return -1;
+        }
+        if (b.failed) break;
+
+        unsigned char *e = b.p + index + (size_t)y * INDEX_ENTRY_SIZE;
+        uint64_t off = start;
+        uint32_t len = (uint32_t)(b.len - start);
+        for (int k = 0; k < 8; k++) e[k] = (unsigned char)(off >> (8 * k));
+        for (int k = 0; k < 4; k++) e[8 + k] = (unsigned char)(len >> (8 * k));
+        for (int k = 0; k < 4; k++) e[12 + k] = (unsigned char)((unsigned)n >> (8 * k));
+        i += n;
+    }
+    if (b.failed) {
+        free(b.p);
+        return -1;
+    }
+
+    FILE *f = fopen(path, "wb");
+    long size = (long)b.len;
+    if (!f || fwrite(b.p, 1, b.len, f) != b.len) size = -1;
+    if (f && fclose(f) != 0) size = -1;
+    free(b.p);
+    return size;
+}
+
+/* ---- Reading ---- */
+
+int archive_open(PanchangArchive *a, const char *path)
+{
+    memset(a, 0, sizeof(*a));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < ARCHIVE_HEADER_SIZE) {
+        close(fd);
+        return 0;
+    }
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return 0;
+
+    const unsigned char *p = map;
+    size_t size = (size_t)st.st_size;
+    int32_t n_years = get_i32(p + 16);
+    int ok = memcmp(p, ARCHIVE_MAGIC, 8) == 0 && n_years > 0 &&
+             (size - ARCHIVE_HEADER_SIZE) / INDEX_ENTRY_SIZE >= (size_t)n_years;
+    for (int32_t y = 0; ok && y < n_years; y++) {
+        const unsigned char *e = p + ARCHIVE_HEADER_SIZE + (size_t)y * INDEX_ENTRY_SIZE;
+        uint64_t off = get_u64(e), len = get_u32(e + 8);
+        ok = off <= size && len <= size - off;
+    }
+    if (!ok) {
+        munmap(map, size);
+        return 0;
+    }
+
+    a->data = p;
+    a->size = size;
+    a->has_times = (get_u32(p + 8) & ARCHIVE_FLAG_TIMES) != 0;
+    a->first_year = get_i32(p + 12);
+    a->n_years = n_years;
+    a->loc.latitude = get_f64(p + 24);
+    a->loc.longitude = get_f64(p + 32);
+    a->loc.altitude = get_f64(p + 40);
+    a->loc.utc_offset = get_f64(p + 48);
+    return 1;
+}
+
+void archive_close(PanchangArchive *a)
+{
+    if (a->data) munmap((void *)a->data, a->size);
+    memset(a, 0, sizeof(*a));
+}
+
+int archive_get_year(const PanchangArchive *a, int year, PanchangDay *days)
+{
+    if (!a->data || year < a->first_year || year - a->first_year >= a->n_years)
+        return 0;
+
+    const unsigned char *e = a->data + ARCHIVE_HEADER_SIZE +
+                             (size_t)(year - a->first_year) * INDEX_ENTRY_SIZE;
+    const unsigned char *p = a->data + get_u64(e);
+    const unsigned char *end = p + get_u32(e + 8);
+    int n = days_in_year(year);
+    if (end - p < CHUNK_HEADER_SIZE + 2 * n || (int)get_u16(p) != n)
+        return 0;
+    int saka = get_i32(p + 4);
+    const unsigned char *flags = p + CHUNK_HEADER_SIZE;
+
+    int t[ARCHIVE_MAX_DAYS];
+    int32_t v[N_STREAMS][ARCHIVE_MAX_DAYS], res[N_STREAMS][ARCHIVE_MAX_DAYS];
+    for (int i = 0; i < n; i++) {
+        t[i] = (int)(get_u16(flags + 2 * i) & F_TITHI_MASK);
+        if (t[i] < 1 || t[i] > 30) return 0;
+    }
+
+    double jd0 = gregorian_to_jd(year, 1, 1);
+    if (a->has_times) {
+        const unsigned char *q = flags + 2 * n;
+        for (int s = 0; s < N_STREAMS && q; s++)
+            q = get_stream(q, end, n, res[s]);
+        if (!q) return 0;
+
+        TithiLengths tl = {0, 0, 0};
+        for (int i = 0; i < n; i++) {
+            v[S_SUNRISE][i] = (int32_t)((int64_t)predict_sunrise(v[S_SUNRISE], i) +
+                                        res[S_SUNRISE][i]);
+            v[S_START][i] = (int32_t)((int64_t)predict_start(t, v[S_START], v[S_END], i) +
+                                      res[S_START][i]);
+            track_lengths(&tl, t, v[S_START], v[S_END], i);
+            v[S_END][i] = (int32_t)((int64_t)predict_end(&tl, t, v[S_START], v[S_END], i) +
+                                    res[S_END][i]);
+        }
+    }
+
+    const double day_per_ds = 1.0 / DS_PER_DAY;
+    int vikram = hindu_year_vikram(saka);
+    int m = 1, d = 1, month_len = 31;
+    for (int i = 0; i < n; i++) {
+        unsigned f = get_u16(flags + 2 * i);
+        int masa = (int)((f & F_MASA_MASK) >> F_MASA_SHIFT);
+        if (masa < CHAITRA || masa > PHALGUNA) return 0;
+        if (f & F_SAKA_INC) vikram = hindu_year_vikram(++saka);
+
+        int tn = t[i];
+        Paksha paksha = (tn <= 15) ? SHUKLA_PAKSHA : KRISHNA_PAKSHA;
+        int pt = (tn <= 15) ? tn : tn - 15;
+        PanchangDay *pd = &days[i];
+        pd->greg_year = year;
+        pd->greg_month = m;
+        pd->greg_day = d;
+        if (++d > month_len) {
+            d = 1;
+            if (++m <= 12) month_len = days_in_month(year, m);
+        }
+
+        pd->hindu_date.year_saka = saka;
+        pd->hindu_date.year_vikram = vikram;
+        pd->hindu_date.masa = (MasaName)masa;
+        pd->hindu_date.is_adhika_masa = (f & F_ADHIKA_MASA) != 0;
+        pd->hindu_date.paksha = paksha;
+        pd->hindu_date.tithi = pt;
+        pd->hindu_date.is_adhika_tithi = (f & F_ADHIKA_TITHI) != 0;
+
+        pd->tithi.tithi_num = tn;
+        pd->tithi.paksha = paksha;
+        pd->tithi.paksha_tithi = pt;
+        pd->tithi.is_kshaya = (f & F_KSHAYA) != 0;
+        if (a->has_times) {
+            pd->jd_sunrise = (f & F_NO_SUNRISE) ? 0.0 : jd0 + v[S_SUNRISE][i] * day_per_ds;
+            pd->tithi.jd_start = jd0 + v[S_START][i] * day_per_ds;
+            pd->tithi.jd_end = jd0 + v[S_END][i] * day_per_ds;
+        } else {
+            pd->jd_sunrise = pd->tithi.jd_start = pd->tithi.jd_end = 0.0;
+        }
+    }
+    return n;
+}
+
+int archive_get_day(PanchangArchive *a, int year, int month, int day,
+                    PanchangDay *out)
+{
+    if (month < 1 || month > 12 || day < 1 || day > days_in_month(year, month))
+        return 0;
+    if (a->cached_year != year || a->cached_count == 0) {
+        a->cached_year = year;
+        a->cached_count = archive_get_year(a, year, a->cache);
+        if (a->cached_count == 0) return 0;
+    }
+
+    int doy = day - 1;
+    for (int m = 1; m < month; m++)
+        doy += days_in_month(year, m);
+    *out = a->cache[doy];
+    return 1;
+}
@@ -0,0 +1,111 @@
+/*
+ * archive.h - Compact packed panchang archive with random access
+ *
+ * Stores consecutive PanchangDays (whole Gregorian years) for one
+ * location in a file roughly a tenth the size of the CSV or in-memory
+ * form, and reads any year or day back through a read-only mmap().
+ *
+ * Layout (all integers little-endian):
+ *
+ *   Header, 64 bytes:
+ *        0     8  "HCPANCH" 0x01
+ *        8     4  flags: 1 = sunrise and tithi boundary times stored
+ *       12     4  first year (int32)
+ *       16     4  number of years (int32)
+ *       20     4  zero
+ *       24    32  latitude, longitude, altitude, utc_offset (float64)
+ *       56     8  zero
+ *
+ *   Index, 16 bytes per year: chunk offset (uint64), chunk length
+ *   (uint32), number of days (uint32).
+ *
+ *   Year chunk:
+ *        0     2  number of days (365/366)
+ *        2     2  zero
+ *        4     4  Saka year of January 1 (int32)
+ *        8  2*n   per-day flags (uint16):
+ *                   bits 0-4   tithi at sunrise (1-30)
+ *                   bits 5-8   masa (1-12)
+ *                   bit  9     adhika masa
+ *                   bit  10    adhika tithi
+ *                   bit  11    kshaya (next tithi skipped)
+ *                   bit  12    Saka year increments on this day
+ *                   bit  13    no sunrise (polar day/night)
+ *        then, with times, three streams: sunrise, tithi start, tithi end.
+ *
+ * Times are stored in tenths of a second from 0h UT of January 1 of the
+ * chunk's year, so decoded times are within 0.05 s of the originals.
+ * Each stream stores the residual of a prediction from the already
+ * decoded days:
+ *
+ *   sunrise:     second difference (2 * yesterday - day before)
+ *   tithi start: yesterday's start if the tithi continues, else
+ *                yesterday's end (plus one tithi length if one was
+ *                skipped)
+ *   tithi end:   yesterday's end if the tithi continues, else start
+ *                plus the length extrapolated from the last two tithis
+ *
+ * Residuals are frame-of-reference bit-packed ("patched"): int32 base,
+ * uint8 width, uint8 zero, uint16 exception count, ceil(n*width/8)
+ * bytes of (residual - base) packed LSB first, then the residuals that
+ * do not fit as {uint16 day, int32 residual} pairs.  The width is the
+ * one giving the smallest stream for that year.
+ */
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include "types.h"
+
+#define ARCHIVE_HEADER_SIZE 64
+
+/*
+ * archive_write - Encode consecutive days into an archive file.
+ *
+ *   path:      Output file.
+ *   loc:       Location the days were computed for (stored in the header).
+ *   days:      Days from January 1 of the first year through December 31
+ *              of the last year, in order.
+ *   count:     Number of days.
+ *   has_times: Non-zero to store jd_sunrise and the tithi boundaries;
+ *              zero for calendar-only data (e.g. the reference CSVs).
+ *   Returns: File size in bytes, or -1 if days do not cover whole
+ *            consecutive years, a field is out of range, or the file
+ *            could not be written.
+ */
+long archive_write(const char *path, const Location *loc,
+                   const PanchangDay *days, int count, int has_times);
+
+/*
+ * archive_open - Map an archive read-only.
+ *   Returns: 1 on success, 0 if the file cannot be mapped or its header
+ *            or index is invalid.
+ */
+int archive_open(PanchangArchive *a, const char *path);
+
+/* archive_close - Unmap an archive opened with archive_open(). */
+void archive_close(PanchangArchive *a);
+
+/*
+ * archive_get_year - Decode one Gregorian year.
+ *
+ *   days: Output array of at least ARCHIVE_MAX_DAYS entries.
+ *   Returns: Number of days (365/366), or 0 if the year is not in the
+ *            archive or its chunk is corrupt.
+ *
+ * Does not modify the handle, so threads may share one archive.  In a
+ * calendar-only archive jd_sunrise and the tithi boundaries are 0.
+ */
+int archive_get_year(const PanchangArchive *a, int year, PanchangDay *days);
+
+/*
+ * archive_get_day - Look up one Gregorian date.
+ *   Returns: 1 on success, 0 if the date is not in the archive.
+ *
+ * Decodes the date's year into the handle's cache on first use, so
+ * lookups within a year cost a copy.  Not safe to call concurrently on
+ * one handle.
+ */
+int archive_get_day(PanchangArchive *a, int year, int month, int day,
+                    PanchangDay *out);
+
+#endif /* ARCHIVE_H */
@@ -1,4 +1,5 @@
 #include "astro.h"
+#include "cache.h"
 #include <math.h>
 #include <stdio.h>
 
@@ -16,6 +17,9 @@ void astro_init(const char *ephe_path)
 
 void astro_close(void)
 {
+    call_stats_retire();
+    latency_retire();
+    cache_release();
     swe_close();
 }
 
@@ -37,11 +41,13 @@ static double tropical_longitude(double jd_ut, int planet)
 
 double solar_longitude(double jd_ut)
 {
+    CALL_STAT(CS_SOLAR_LONGITUDE);
     return tropical_longitude(jd_ut, SE_SUN);
 }
 
 double lunar_longitude(double jd_ut)
 {
+    CALL_STAT(CS_LUNAR_LONGITUDE);
     return tropical_longitude(jd_ut, SE_MOON);
 }
 
@@ -49,6 +55,7 @@ double solar_longitude_sidereal(double jd_ut)
 {
     double sayana = solar_longitude(jd_ut);
     if (sayana < 0) return sayana;
+    CALL_STAT(CS_AYANAMSA);
     double ayan = swe_get_ayanamsa_ut(jd_ut);
     double nirayana = fmod(sayana - ayan, 360.0);
     if (nirayana < 0) nirayana += 360.0;
@@ -57,6 +64,7 @@ double solar_longitude_sidereal(double jd_ut)
 
 double get_ayanamsa(double jd_ut)
 {
+    CALL_STAT(CS_AYANAMSA);
     return swe_get_ayanamsa_ut(jd_ut);
 }
 
@@ -66,6 +74,8 @@ double sunrise_jd(double jd_ut, const Location *loc)
     double trise;
     char serr[256];
 
+    CALL_STAT(CS_SUNRISE);
+    LATENCY_BEGIN(lat);
     geopos[0] = loc->longitude;
     geopos[1] = loc->latitude;
     geopos[2] = loc->altitude;
@@ -79,8 +89,9 @@ double sunrise_jd(double jd_ut, const Location *loc)
                              &trise, serr);
     if (ret < 0) {
         fprintf(stderr, "swe_rise_trans (sunrise) error: %s\n", serr);
-        return 0.0;
+        trise = 0.0;
     }
+    LATENCY_END(lat, LAT_SUNRISE);
     return trise;
 }
 
@@ -90,6 +101,8 @@ double sunset_jd(double jd_ut, const Location *loc)
     double tset;
     char serr[256];
 
+    CALL_STAT(CS_SUNSET);
+    LATENCY_BEGIN(lat);
     geopos[0] = loc->longitude;
     geopos[1] = loc->latitude;
     geopos[2] = loc->altitude;
@@ -102,8 +115,9 @@ double sunset_jd(double jd_ut, const Location *loc)
                              &tset, serr);
     if (ret < 0) {
         fprintf(stderr, "swe_rise_trans (sunset) error: %s\n", serr);
-        return 0.0;
+        tset = 0.0;
     }
+    LATENCY_END(lat, LAT_SUNSET);
     return tset;
 }
 
@@ -118,22 +132,27 @@ void astro_init(const char *ephe_path)
 
 void astro_close(void)
 {
-    /* Nothing to clean up */
+    call_stats_retire();
+    latency_retire();
+    cache_release();
 }
 
 double solar_longitude(double jd_ut)
 {
+    CALL_STAT(CS_SOLAR_LONGITUDE);
     return moshier_solar_longitude(jd_ut);
 }
 
 double lunar_longitude(double jd_ut)
 {
+    CALL_STAT(CS_LUNAR_LONGITUDE);
     return moshier_lunar_longitude(jd_ut);
 }
 
 double solar_longitude_sidereal(double jd_ut)
 {
     double sayana = solar_longitude(jd_ut);
+    CALL_STAT(CS_AYANAMSA);
     double ayan = moshier_ayanamsa(jd_ut);
     double nirayana = fmod(sayana - ayan, 360.0);
     if (nirayana < 0) nirayana += 360.0;
@@ -142,19 +161,28 @@ double solar_longitude_sidereal(double jd_ut)
 
 double get_ayanamsa(double jd_ut)
 {
+    CALL_STAT(CS_AYANAMSA);
     return moshier_ayanamsa(jd_ut);
 }
 
 double sunrise_jd(double jd_ut, const Location *loc)
 {
-    return moshier_sunrise(jd_ut - loc->utc_offset / 24.0,
-                           loc->longitude, loc->latitude, loc->altitude);
+    CALL_STAT(CS_SUNRISE);
+    LATENCY_BEGIN(lat);
+    double jd = moshier_sunrise(jd_ut - loc->utc_offset / 24.0,
+                                loc->longitude, loc->latitude, loc->altitude);
+    LATENCY_END(lat, LAT_SUNRISE);
+    return jd;
 }
 
 double sunset_jd(double jd_ut, const Location *loc)
 {
-    return moshier_sunset(jd_ut - loc->utc_offset / 24.0,
-                          loc->longitude, loc->latitude, loc->altitude);
+    CALL_STAT(CS_SUNSET);
+    LATENCY_BEGIN(lat);
+    double jd = moshier_sunset(jd_ut - loc->utc_offset / 24.0,
+                               loc->longitude, loc->latitude, loc->altitude);
+    LATENCY_END(lat, LAT_SUNSET);
+    return jd;
 }
 
 #endif /* USE_SWISSEPH */
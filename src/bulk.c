@@ -0,0 +1,285 @@
+#include "bulk.h"
+#include "writer.h"
+#include "astro.h"
+#include "panchang.h"
+#include "solar.h"
+#include "date_utils.h"
+#include <ctype.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Units a worker may run ahead of the writer, per thread */
+#define UNITS_AHEAD_PER_THREAD 4
+
+int parse_calendar_set(const char *str, unsigned *mask)
+{
+    unsigned m = 0;
+    const char *p = str;
+    while (*p) {
+        size_t len = strcspn(p, ",");
+        int found = 0;
+        if (len == 3 && strncmp(p, "all", 3) == 0) {
+            m |= CALSET_ALL;
+            found = 1;
+        } else if (len == 5 && strncmp(p, "solar", 5) == 0) {
+            m |= CALSET_ALL & ~CALSET_LUNISOLAR;
+            found = 1;
+        }
+        for (int c = 0; c < CALENDAR_COUNT && !found; c++) {
+            const char *name = calendar_name(c);
+            if (strlen(name) == len && strncmp(p, name, len) == 0) {
+                m |= 1u << c;
+                found = 1;
+            }
+        }
+        if (!found) return 0;
+        p += len;
+        if (*p == ',') p++;
+    }
+    if (m == 0) return 0;
+    *mask = m;
+    return 1;
+}
+
+int load_locations(FILE *in, NamedLocation **locs, int *count)
+{
+    int n = 0, cap = 16, line_num = 0;
+    NamedLocation *arr = malloc(cap * sizeof(NamedLocation));
+    char line[512];
+
+    *locs = NULL;
+    *count = 0;
+    if (!arr) return -1;
+
+    while (fgets(line, sizeof(line), in)) {
+        line_num++;
+        line[strcspn(line, "\r\n")] = '\0';
+        const char *p = line;
+        while (isspace((unsigned char)*p)) p++;
+        if (*p == '\0' || *p == '#') continue;
+
+        NamedLocation nl;
+        size_t name_len = strcspn(p, ",");
+        char rest;
+        int fields;
+        nl.loc.altitude = 0.0;
+        if (p[name_len] != ',' || name_len == 0)
+            goto bad_line;
+        fields = sscanf(p + name_len + 1, "%lf,%lf,%lf,%lf %c",
+                        &nl.loc.latitude, &nl.loc.longitude,
+                        &nl.loc.utc_offset, &nl.loc.altitude, &rest);
+        if (fields != 3 && fields != 4)
+            goto bad_line;
+        if (nl.loc.latitude < -90.0 || nl.loc.latitude > 90.0 ||
+            nl.loc.longitude < -180.0 || nl.loc.longitude > 180.0 ||
+            nl.loc.utc_offset < -14.0 || nl.loc.utc_offset > 14.0)
+            goto bad_line;
+        if (name_len >= sizeof(nl.name)) name_len = sizeof(nl.name) - 1;
+        memcpy(nl.name, p, name_len);
+        nl.name[name_len] = '\0';
+
+        if (n == cap) {
+            NamedLocation *grown = realloc(arr, 2 * cap * sizeof(NamedLocation));
+            if (!grown) {
+                free(arr);
+                return -1;
+            }
+            arr = grown;
+            cap *= 2;
+        }
+        arr[n++] = nl;
+    }
+
+    *locs = arr;
+    *count = n;
+    return 0;
+
+bad_line:
+    free(arr);
+    return line_num;
+}
+
+/* ---- Row generation ---- */
+
+static void emit_unit(const BulkRequest *req, int unit, int months_per_loc,
+                      double jd_first, double jd_last, RecordWriter *w)
+{
+    int loc_index = unit / months_per_loc;
+    const NamedLocation *nl = &req->locations[loc_index];
+    int month_index = req->y0 * 12 + (req->m0 - 1) + unit % months_per_loc;
+    int y = month_index / 12, m = month_index % 12 + 1;
+
+    double jd = gregorian_to_jd(y, m, 1);
+    double jd_end = (m == 12) ? gregorian_to_jd(y + 1, 1, 1) : gregorian_to_jd(y, m + 1, 1);
+    if (jd < jd_first) jd = jd_first;
+    if (jd_end > jd_last + 1) jd_end = jd_last + 1;
+
+    writer_set_location(w, loc_index, nl->name);
+    for (; jd < jd_end && !w->failed; jd += 1.0) {
+        int gy, gm, gd;
+        jd_to_gregorian(jd, &gy, &gm, &gd);
+
+        for (int c = 0; c < CALENDAR_COUNT; c++) {
+            if (!(req->calendars & (1u << c))) continue;
+            CalendarRecord rec;
+            if (c == CALENDAR_LUNISOLAR) {
+                HinduDate hd = gregorian_to_hindu(gy, gm, gd, &nl->loc);
+                calendar_record_lunisolar(&rec, gy, gm, gd, &hd);
+            } else {
+                SolarCalendarType type = (SolarCalendarType)(c - 1);
+                SolarDate sd = gregorian_to_solar(gy, gm, gd, &nl->loc, type);
+                calendar_record_solar(&rec, gy, gm, gd, type, &sd);
+            }
+            writer_record(w, &rec);
+        }
+    }
+}
+
+/* ---- Worker pool ---- */
+
+typedef struct {
+    const BulkRequest *req;
+    int n_units, months_per_loc, window;
+    double jd_first, jd_last;
+    RecordWriter *bufs;  /* in-memory writer per unit */
+    int *done;
+    int next_unit;       /* next unit to claim */
+    int written;         /* units already handed to the writer */
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+} BulkJob;
+
+static void *bulk_worker(void *arg)
+{
+    BulkJob *job = arg;
+
+    /* Backend state such as the sidereal mode may be per thread */
+    astro_init(NULL);
+
+    pthread_mutex_lock(&job->lock);
+    for (;;) {
+        while (job->next_unit < job->n_units &&
+               job->next_unit >= job->written + job->window)
+            pthread_cond_wait(&job->cond, &job->lock);
+        if (job->next_unit >= job->n_units) break;
+        int unit = job->next_unit++;
+        pthread_mutex_unlock(&job->lock);
+
+        /* A unit that cannot be buffered fails the job instead of vanishing */
+        RecordWriter *w = &job->bufs[unit];
+        if (writer_init(w, NULL, job->req->format))
+            emit_unit(job->req, unit, job->months_per_loc,
+                      job->jd_first, job->jd_last, w);
+        else
+            w->failed = 1;
+
+        pthread_mutex_lock(&job->lock);
+        job->done[unit] = 1;
+        pthread_cond_broadcast(&job->cond);
+    }
+    pthread_mutex_unlock(&job->lock);
+
+    astro_close();
+    return NULL;
+}
+
+static int valid_date(int y, int m, int d)
+{
+    if (m < 1 || m > 12 || d < 1) return 0;
+    double jd = gregorian_to_jd(y, m, d);
+    int cy, cm, cd;
+    jd_to_gregorian(jd, &cy, &cm, &cd);
+    return cy == y && cm == m && cd == d;
+}
+
+long bulk_generate(const BulkRequest *req, FILE *out)
+{
+    if (req->n_locations <= 0 || !(req->calendars & CALSET_ALL) ||
+        (req->format == OUTPUT_BINARY && req->n_locations > WRITER_BINARY_MAX_LOCATIONS) ||
+        !valid_date(req->y0, req->m0, req->d0) ||
+        !valid_date(req->y1, req->m1, req->d1))
+        return -1;
+
+    BulkJob job;
+    memset(&job, 0, sizeof(job));
+    job.req = req;
+    job.jd_first = gregorian_to_jd(req->y0, req->m0, req->d0);
+    job.jd_last = gregorian_to_jd(req->y1, req->m1, req->d1);
+    if (job.jd_last < job.jd_first) return -1;
+    job.months_per_loc = (req->y1 * 12 + req->m1) - (req->y0 * 12 + req->m0) + 1;
+    job.n_units = job.months_per_loc * req->n_locations;
+
+    RecordWriter w;
+    if (!writer_init(&w, out, req->format)) return -1;
+
+    if (req->threads <= 1) {
+        for (int u = 0; u < job.n_units && !w.failed; u++)
+            emit_unit(req, u, job.months_per_loc, job.jd_first, job.jd_last, &w);
+        long rows = w.records;
+        return (writer_close(&w) == 0) ? rows : -1;
+    }
+
+    int n_threads = req->threads;
+    if (n_threads > job.n_units) n_threads = job.n_units;
+    job.window = n_threads * UNITS_AHEAD_PER_THREAD;
+    job.bufs = calloc(job.n_units, sizeof(RecordWriter));
+    job.done = calloc(job.n_units, sizeof(int));
+    pthread_t *tids = malloc(n_threads * sizeof(pthread_t));
+    if (!job.bufs || !job.done || !tids) {
+        free(job.bufs);
+        free(job.done);
+        free(tids);
+        writer_close(&w);
+        return -1;
+    }
+    pthread_mutex_init(&job.lock, NULL);
+    pthread_cond_init(&job.cond, NULL);
+
+    int started = 0;
+    for (; started < n_threads; started++)
+        if (pthread_create(&tids[started], NULL, bulk_worker, &job) != 0)
+            break;
+
+    int failed = (started == 0);
+    for (int u = 0; u < job.n_units && !failed; u++) {
+        pthread_mutex_lock(&job.lock);
+        while (!job.done[u])
+            pthread_cond_wait(&job.cond, &job.lock);
+        pthread_mutex_unlock(&job.lock);
+
+        if (job.bufs[u].failed) {
+            failed = 1;
+        } else {
+            writer_append(&w, &job.bufs[u]);
+            failed = w.failed;
+        }
+        writer_close(&job.bufs[u]);
+
+        pthread_mutex_lock(&job.lock);
+        job.written = u + 1;
+        pthread_cond_broadcast(&job.cond);
+        pthread_mutex_unlock(&job.lock);
+    }
+
+    if (failed) {
+        /* Let the workers drain without waiting on the writer */
+        pthread_mutex_lock(&job.lock);
+        job.next_unit = job.n_units;
+        pthread_cond_broadcast(&job.cond);
+        pthread_mutex_unlock(&job.lock);
+    }
+    for (int t = 0; t < started; t++)
+        pthread_join(tids[t], NULL);
+    for (int u = 0; u < job.n_units; u++)
+        free(job.bufs[u].buf);
+
+    pthread_mutex_destroy(&job.lock);
+    pthread_cond_destroy(&job.cond);
+    free(job.bufs);
+    free(job.done);
+    free(tids);
+    long rows = w.records;
+    if (writer_close(&w) != 0) failed = 1;
+    return failed ? -1 : rows;
+}
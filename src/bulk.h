@@ -0,0 +1,59 @@
+/*
+ * bulk.h - Date range x locations x calendars in one pass
+ *
+ * Produces one stream of calendar dates (CSV, JSON Lines or binary
+ * CalendarRecords, see writer.h) for every day of a Gregorian range, at
+ * every location of a list, for a set of calendars.
+ *
+ * Work is split into (location, Gregorian month) units.  Each unit walks
+ * its days in order, so the day-to-day caches in masa.c, panchang.c and
+ * solar.c stay warm; those caches are thread-local, so units can run on
+ * worker threads.  Finished units are written strictly in unit order,
+ * and workers stay at most a few units ahead of the writer, so the
+ * output is byte-identical for any thread count and memory stays bounded.
+ */
+#ifndef BULK_H
+#define BULK_H
+
+#include "types.h"
+#include <stdio.h>
+
+/*
+ * bulk_generate - Write the header and every record for a request.
+ *
+ *   req: Range, locations, CALSET_* calendars, thread count and format.
+ *   out: Output stream (written only from the calling thread).
+ *   Returns: Number of rows written, or -1 if the request is invalid
+ *            (empty range, no locations or calendars, bad date, more
+ *            than WRITER_BINARY_MAX_LOCATIONS locations in binary) or a
+ *            buffer/thread could not be allocated.
+ */
+long bulk_generate(const BulkRequest *req, FILE *out);
+
+/*
+ * parse_calendar_set - Parse a comma-separated calendar list.
+ *
+ *   str:  e.g. "lunisolar,tamil", "solar" (all four solar calendars)
+ *         or "all".
+ *   mask: Output CALSET_* mask.
+ *   Returns: 1 on success, 0 on an unknown name or empty list.
+ */
+int parse_calendar_set(const char *str, unsigned *mask);
+
+/*
+ * load_locations - Read a locations file.
+ *
+ * One location per line: NAME,LAT,LON,UTC_OFFSET[,ALTITUDE].  Blank
+ * lines and lines starting with '#' are skipped.  NAME may not contain
+ * commas and is truncated to 63 characters.
+ *
+ *   in:    Open file.
+ *   locs:  Output array, allocated with malloc(); the caller frees it.
+ *   count: Output number of locations.
+ *   Returns: 0 on success, otherwise the 1-based line number of the
+ *            first malformed line (or -1 if allocation failed); *locs is
+ *            NULL on failure.
+ */
+int load_locations(FILE *in, NamedLocation **locs, int *count);
+
+#endif /* BULK_H */
@@ -0,0 +1,235 @@
+#include "cache.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *CACHE_NAMES[CACHE_COUNT] = {
+    "lunation", "month", "prev_day", "solar_year", "sankranti",
+};
+
+/* Defaults: enough for consecutive days in every calendar at one place */
+static unsigned capacities[CACHE_COUNT] = { 1, 32, 1, 4, 4 };
+static unsigned generation = 1;   /* bumped by cache_set_capacity() */
+
+typedef struct {
+    unsigned char *entries;    /* nsets * ways entries of entry_size */
+    uint64_t *stamp;           /* LRU stamp per entry, 0 = empty */
+    unsigned *mru;             /* most recently used way per set */
+    size_t entry_size;
+    unsigned ways, nsets;
+    uint64_t clock;            /* 64 bits: never wraps back to 0 */
+    unsigned used;
+    unsigned generation;       /* 0 = not allocated */
+} CacheTable;
+
+static THREAD_LOCAL CacheTable tables[CACHE_COUNT];
+THREAD_LOCAL CacheStats cache_thread_stats[CACHE_COUNT];
+
+/* Counts handed over by cache_release(), updated atomically */
+static CacheStats retired[CACHE_COUNT];
+
+static void table_free(CacheTable *t)
+{
+    free(t->entries);
+    free(t->stamp);
+    free(t->mru);
+    memset(t, 0, sizeof(*t));
+}
+
+/* This thread's table for id, sized for the current capacity */
+static CacheTable *table_get(CacheId id, size_t entry_size)
+{
+    CacheTable *t = &tables[id];
+    unsigned gen = __atomic_load_n(&generation, __ATOMIC_ACQUIRE);
+    if (t->generation == gen && t->entry_size == entry_size)
+        return t->entries ? t : NULL;
+
+    table_free(t);
+    unsigned cap = __atomic_load_n(&capacities[id], __ATOMIC_RELAXED);
+    t->ways = cap < CACHE_WAYS ? cap : CACHE_WAYS;
+    t->nsets = (cap + t->ways - 1) / t->ways;
+    t->entry_size = entry_size;
+    t->generation = gen;
+    size_t n = (size_t)t->nsets * t->ways;
+    t->entries = calloc(n, entry_size);
+    t->stamp = calloc(n, sizeof(uint64_t));
+    t->mru = calloc(t->nsets, sizeof(unsigned));
+    if (!t->entries || !t->stamp || !t->mru) {
+        /* Behave as an empty table that never keeps anything */
+        free(t->entries);
+        free(t->stamp);
+        free(t->mru);
+        t->entries = NULL;
+        t->stamp = NULL;
+        t->mru = NULL;
+        return NULL;
+    }
+    return t;
+}
+
+void *cache_find(CacheId id, size_t entry_size, unsigned hash,
+                 CacheMatchFn match, const void *key)
+{
+    CacheTable *t = table_get(id, entry_size);
+    if (!t) return NULL;
+
+    unsigned set = hash % t->nsets;
+    unsigned base = set * t->ways;
+    unsigned first = t->mru[set];
+    for (unsigned k = 0; k < t->ways; k++) {
+        unsigned way = (k == 0) ? first : (k <= first ? k - 1 : k);
+        unsigned i = base + way;
+        if (!t->stamp[i]) continue;
+        void *e = t->entries + (size_t)i * t->entry_size;
+        if (match(e, key)) {
+            t->stamp[i] = ++t->clock;
+            t->mru[set] = way;
+            return e;
+        }
+    }
+    return NULL;
+}
+
+void *cache_insert(CacheId id, size_t entry_size, unsigned hash)
+{
+    CacheTable *t = table_get(id, entry_size);
+    if (!t) return NULL;
+
+    unsigned set = hash % t->nsets;
+    unsigned base = set * t->ways;
+    unsigned victim = 0;
+    for (unsigned way = 0; way < t->ways; way++) {
+        if (!t->stamp[base + way]) {
+            victim = way;
+            break;
+        }
+        if (t->stamp[base + way] < t->stamp[base + victim])
+            victim = way;
+    }
+
+    unsigned i = base + victim;
+    if (t->stamp[i])
+        cache_thread_stats[id].evictions++;
+    else
+        t->used++;
+    t->stamp[i] = ++t->clock;
+    t->mru[set] = victim;
+    void *e = t->entries + (size_t)i * t->entry_size;
+    memset(e, 0, t->entry_size);
+    return e;
+}
+
+int cache_set_capacity(CacheId id, unsigned entries)
+{
+    if (id < 0 || id >= CACHE_COUNT || entries < 1 || entries > CACHE_MAX_ENTRIES)
+        return -1;
+    if (entries > CACHE_WAYS)
+        entries = (entries + CACHE_WAYS - 1) / CACHE_WAYS * CACHE_WAYS;
+    __atomic_store_n(&capacities[id], entries, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&generation, 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+unsigned cache_capacity(CacheId id)
+{
+    if (id < 0 || id >= CACHE_COUNT) return 0;
+    return __atomic_load_n(&capacities[id], __ATOMIC_RELAXED);
+}
+
+int cache_parse_capacities(const char *spec)
+{
+    unsigned want[CACHE_COUNT];
+    int set[CACHE_COUNT] = {0};
+    const char *p = spec;
+
+    while (*p) {
+        const char *eq = strchr(p, '=');
+        if (!eq) return -1;
+        int id = -1;
+        for (int c = 0; c < CACHE_COUNT; c++)
+            if (strlen(CACHE_NAMES[c]) == (size_t)(eq - p) &&
+                strncmp(p, CACHE_NAMES[c], eq - p) == 0)
+                id = c;
+        if (id < 0) return -1;
+
+        char *end;
+        unsigned long n = strtoul(eq + 1, &end, 10);
+        if (end == eq + 1 || (*end && *end != ',') || n < 1 || n > CACHE_MAX_ENTRIES)
+            return -1;
+        want[id] = (unsigned)n;
+        set[id] = 1;
+        p = *end ? end + 1 : end;
+    }
+
+    for (int c = 0; c < CACHE_COUNT; c++)
+        if (set[c])
+            cache_set_capacity((CacheId)c, want[c]);
+    return 0;
+}
+
+const char *cache_name(CacheId id)
+{
+    return (id >= 0 && id < CACHE_COUNT) ? CACHE_NAMES[id] : "unknown";
+}
+
+void cache_stats(CacheStats out[CACHE_COUNT])
+{
+    unsigned gen = __atomic_load_n(&generation, __ATOMIC_ACQUIRE);
+    for (int c = 0; c < CACHE_COUNT; c++) {
+        const CacheStats *mine = &cache_thread_stats[c];
+        out[c].hits = __atomic_load_n(&retired[c].hits, __ATOMIC_RELAXED) + mine->hits;
+        out[c].misses = __atomic_load_n(&retired[c].misses, __ATOMIC_RELAXED) + mine->misses;
+        out[c].evictions = __atomic_load_n(&retired[c].evictions, __ATOMIC_RELAXED) +
+                           mine->evictions;
+        /* A table from before a resize is emptied at its next lookup */
+        unsigned used = (tables[c].generation == gen) ? tables[c].used : 0;
+        unsigned peak = __atomic_load_n(&retired[c].occupancy, __ATOMIC_RELAXED);
+        out[c].occupancy = used > peak ? used : peak;
+        out[c].capacity = cache_capacity((CacheId)c);
+    }
+}
+
+void cache_stats_reset(void)
+{
+    for (int c = 0; c < CACHE_COUNT; c++) {
+        __atomic_store_n(&retired[c].hits, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&retired[c].misses, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&retired[c].evictions, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&retired[c].occupancy, 0, __ATOMIC_RELAXED);
+    }
+    memset(cache_thread_stats, 0, sizeof(cache_thread_stats));
+}
+
+void cache_release(void)
+{
+    for (int c = 0; c < CACHE_COUNT; c++) {
+        CacheStats *mine = &cache_thread_stats[c];
+        __atomic_fetch_add(&retired[c].hits, mine->hits, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&retired[c].misses, mine->misses, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&retired[c].evictions, mine->evictions, __ATOMIC_RELAXED);
+        unsigned peak = __atomic_load_n(&retired[c].occupancy, __ATOMIC_RELAXED);
+        while (tables[c].used > peak &&
+               !__atomic_compare_exchange_n(&retired[c].occupancy, &peak, tables[c].used,
+                                            0, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            ;
+        table_free(&tables[c]);
+    }
+    memset(cache_thread_stats, 0, sizeof(cache_thread_stats));
+}
+
+void cache_print_stats(FILE *out, const CacheStats stats[CACHE_COUNT])
+{
+    fprintf(out, "%-12s %9s %9s %12s %12s %9s %12s\n", "cache", "capacity",
+            "used", "hits", "misses", "hit rate", "evictions");
+    for (int c = 0; c < CACHE_COUNT; c++) {
+        const CacheStats *s = &stats[c];
+        unsigned long lookups = s->hits + s->misses;
+        fprintf(out, "%-12s %9u %9u %12lu %12lu", CACHE_NAMES[c], s->capacity,
+                s->occupancy, s->hits, s->misses);
+        if (lookups > 0)
+            fprintf(out, " %8.1f%%", 100.0 * s->hits / lookups);
+        else
+            fprintf(out, " %9s", "-");
+        fprintf(out, " %12lu\n", s->evictions);
+    }
+}
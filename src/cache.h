@@ -0,0 +1,100 @@
+/*
+ * cache.h - Per-thread calendar caches: lookup, statistics and capacities
+ *
+ * The new moon pair (masa.c), lunisolar month starts (masa.c), previous
+ * day's sunrise tithi (panchang.c) and solar year and month starts
+ * (solar.c) are cached per thread in LRU tables kept here.  Each table
+ * holds up to its capacity in fixed-size entries; up to CACHE_WAYS
+ * entries are searched linearly, larger tables are split into sets of
+ * CACHE_WAYS picked by a hash of the key.  The default capacities
+ * suit walking consecutive days; random access over a long range needs
+ * more, e.g. for 1900-2050:
+ *
+ *   cache_set_capacity(CACHE_LUNATION, 2048);    (1,868 lunations)
+ *   cache_set_capacity(CACHE_SANKRANTI, 8192);   (4 calendars x 1,812 months)
+ *   cache_set_capacity(CACHE_SOLAR_YEAR, 1024);  (4 calendars x 151 years)
+ *
+ * Every lookup is counted as a hit or miss, and every entry replaced as
+ * an eviction.  Counts are per thread without atomics; astro_close()
+ * adds a thread's counts to a process-wide total and frees its tables.
+ */
+#ifndef CACHE_H
+#define CACHE_H
+
+#include "types.h"
+#include "callstats.h"
+#include "latency.h"
+#include <stddef.h>
+#include <stdio.h>
+
+#define CACHE_WAYS 32
+#define CACHE_MAX_ENTRIES (1u << 20)
+
+extern THREAD_LOCAL CacheStats cache_thread_stats[CACHE_COUNT];
+
+/* Count a lookup; a miss also feeds the call counters and latency split */
+#define CACHE_HIT(id) \
+    (cache_thread_stats[(id)].hits++, CALL_STAT(CS_LUNATION_HIT + 2 * (id)))
+#define CACHE_MISS(id) \
+    (cache_thread_stats[(id)].misses++, CALL_STAT(CS_LUNATION_MISS + 2 * (id)), \
+     LATENCY_MISS())
+
+/*
+ * cache_find - Entry of the calling thread's table for id that matches
+ * key, or NULL.  Only the set for hash is searched, most recently used
+ * entry first; a found entry becomes the most recently used.
+ *
+ *   entry_size: Size of the cache's entries (the same on every call).
+ */
+void *cache_find(CacheId id, size_t entry_size, unsigned hash,
+                 CacheMatchFn match, const void *key);
+
+/*
+ * cache_insert - Zeroed entry to fill for a key with this hash, evicting
+ * the least recently used entry of its set when the set is full.
+ *   Returns: The entry, or NULL if the table cannot be allocated.
+ */
+void *cache_insert(CacheId id, size_t entry_size, unsigned hash);
+
+/*
+ * cache_set_capacity - Entries per thread for cache id (1 to
+ * CACHE_MAX_ENTRIES; rounded up to a multiple of CACHE_WAYS above it).
+ * Each thread empties and resizes its table at its next lookup.
+ *   Returns: 0, or -1 if entries is out of range.
+ */
+int cache_set_capacity(CacheId id, unsigned entries);
+
+/* cache_capacity - Current entries per thread for cache id. */
+unsigned cache_capacity(CacheId id);
+
+/*
+ * cache_parse_capacities - Apply "NAME=N[,NAME=N...]" (names as from
+ * cache_name()), e.g. "lunation=2048,sankranti=8192".
+ *   Returns: 0, or -1 on an unknown name or bad size (nothing applied).
+ */
+int cache_parse_capacities(const char *spec);
+
+/* cache_name - "lunation", "month", "prev_day", "solar_year", "sankranti". */
+const char *cache_name(CacheId id);
+
+/*
+ * cache_stats - Hits, misses and evictions of the calling thread plus
+ * those retired by finished threads; occupancy of the fullest table,
+ * the calling thread's or a finished thread's; configured capacities.
+ */
+void cache_stats(CacheStats out[CACHE_COUNT]);
+
+/* cache_stats_reset - Zero this thread's counts and the retired ones. */
+void cache_stats_reset(void);
+
+/*
+ * cache_release - Add this thread's counts to the retired total and free
+ * its tables.  Called by astro_close().
+ */
+void cache_release(void);
+
+/* cache_print_stats - One line per cache: capacity, occupancy, hits,
+ * misses, hit rate and evictions. */
+void cache_print_stats(FILE *out, const CacheStats stats[CACHE_COUNT]);
+
+#endif /* CACHE_H */
@@ -0,0 +1,88 @@
+#include "callstats.h"
+#include <string.h>
+
+static const char *STAT_NAMES[CS_COUNT] = {
+    "solar_longitude", "lunar_longitude", "ayanamsa", "sunrise", "sunset",
+    "lunar_phase", "tithi_boundary", "new_moon", "sankranti",
+    "lunation_hit", "lunation_miss", "month_hit", "month_miss",
+    "prev_day_hit", "prev_day_miss", "solar_year_hit", "solar_year_miss",
+    "sankranti_hit", "sankranti_miss",
+};
+
+/* Counts handed over by call_stats_retire(), updated atomically */
+static CallStats retired;
+
+#ifdef USE_CALL_STATS
+THREAD_LOCAL CallStats call_stats_thread;
+#endif
+
+int call_stats_enabled(void)
+{
+#ifdef USE_CALL_STATS
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+void call_stats_snapshot(CallStats *out)
+{
+    for (int i = 0; i < CS_COUNT; i++) {
+        out->count[i] = __atomic_load_n(&retired.count[i], __ATOMIC_RELAXED);
+#ifdef USE_CALL_STATS
+        out->count[i] += call_stats_thread.count[i];
+#endif
+    }
+}
+
+void call_stats_reset(void)
+{
+    for (int i = 0; i < CS_COUNT; i++)
+        __atomic_store_n(&retired.count[i], 0, __ATOMIC_RELAXED);
+#ifdef USE_CALL_STATS
+    memset(&call_stats_thread, 0, sizeof(call_stats_thread));
+#endif
+}
+
+void call_stats_retire(void)
+{
+#ifdef USE_CALL_STATS
+    for (int i = 0; i < CS_COUNT; i++)
+        if (call_stats_thread.count[i])
+            __atomic_fetch_add(&retired.count[i], call_stats_thread.count[i],
+                               __ATOMIC_RELAXED);
+    memset(&call_stats_thread, 0, sizeof(call_stats_thread));
+#endif
+}
+
+const char *call_stat_name(CallStat id)
+{
+    return (id >= 0 && id < CS_COUNT) ? STAT_NAMES[id] : "unknown";
+}
+
+void call_stats_print(FILE *out, const CallStats *stats, long days)
+{
+    if (!call_stats_enabled()) {
+        fprintf(out, "Call counters not compiled in (rebuild with make CALL_STATS=1)\n");
+        return;
+    }
+
+    fprintf(out, "%-18s %12s %12s\n", "call", "count", "per day");
+    for (int i = 0; i < CS_LUNATION_HIT; i++) {
+        fprintf(out, "%-18s %12lu", STAT_NAMES[i], stats->count[i]);
+        if (days > 0)
+            fprintf(out, " %12.2f", (double)stats->count[i] / days);
+        fprintf(out, "\n");
+    }
+
+    /* HIT/MISS pairs follow the searches */
+    fprintf(out, "%-18s %12s %12s\n", "cache", "lookups", "hit rate");
+    for (int i = CS_LUNATION_HIT; i + 1 < CS_COUNT; i += 2) {
+        unsigned long hit = stats->count[i], miss = stats->count[i + 1];
+        int len = (int)(strlen(STAT_NAMES[i]) - strlen("_hit"));
+        fprintf(out, "%-18.*s %12lu", len, STAT_NAMES[i], hit + miss);
+        if (hit + miss > 0)
+            fprintf(out, " %11.1f%%", 100.0 * hit / (hit + miss));
+        fprintf(out, "\n");
+    }
+}
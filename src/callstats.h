@@ -0,0 +1,60 @@
+/*
+ * callstats.h - Ephemeris call counters
+ *
+ * A profiler says where the time goes; these counters say why: how many
+ * solar/lunar longitudes, ayanamsas and sunrises one calendar day costs,
+ * and how often each cache saved a search.  Every ephemeris entry point
+ * in astro.c, the searches in tithi.c, masa.c and solar.c, and each
+ * cache lookup bump a CALL_STAT() counter.
+ *
+ * Counting is compiled in only with USE_CALL_STATS (make CALL_STATS=1,
+ * in a clean build directory); otherwise CALL_STAT() expands to nothing
+ * and the snapshot is all zeros.  When enabled, each thread increments
+ * its own counters without atomics; astro_close() adds a thread's counts
+ * to a process-wide total, so worker threads that have finished are
+ * included in later snapshots.
+ */
+#ifndef CALLSTATS_H
+#define CALLSTATS_H
+
+#include "types.h"
+#include <stdio.h>
+
+#ifdef USE_CALL_STATS
+extern THREAD_LOCAL CallStats call_stats_thread;
+#define CALL_STAT(id) (call_stats_thread.count[(id)]++)
+#else
+#define CALL_STAT(id) ((void)0)
+#endif
+
+/* call_stats_enabled - 1 if this build counts calls, 0 otherwise. */
+int call_stats_enabled(void);
+
+/*
+ * call_stats_snapshot - Counts of the calling thread plus those retired
+ * by threads that called astro_close().
+ */
+void call_stats_snapshot(CallStats *out);
+
+/*
+ * call_stats_reset - Zero the calling thread's counters and the retired
+ * total.  Other running threads keep theirs.
+ */
+void call_stats_reset(void);
+
+/*
+ * call_stats_retire - Add the calling thread's counters to the retired
+ * total and zero them.  Called by astro_close().
+ */
+void call_stats_retire(void);
+
+/* call_stat_name - Short name of a counter ("solar_longitude", ...). */
+const char *call_stat_name(CallStat id);
+
+/*
+ * call_stats_print - Write one line per counter: name, count and count
+ * per day (if days > 0), then the hit rate of each cache.
+ */
+void call_stats_print(FILE *out, const CallStats *stats, long days);
+
+#endif /* CALLSTATS_H */
@@ -0,0 +1,180 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "csvmap.h"
+#include "date_utils.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Split [p, eol) at commas into fields/lens; returns the field count */
+static int split_line(const char *p, const char *eol, const char **fields, int *lens)
+{
+    if (eol > p && eol[-1] == '\r') eol--;
+    int n = 0;
+    for (;;) {
+        const char *comma = memchr(p, ',', eol - p);
+        const char *end = comma ? comma : eol;
+        if (n < CSV_MAX_FIELDS) {
+            fields[n] = p;
+            lens[n] = (int)(end - p);
+        }
+        n++;
+        if (!comma) break;
+        p = comma + 1;
+    }
+    return n < CSV_MAX_FIELDS ? n : CSV_MAX_FIELDS;
+}
+
+/* Next non-blank line at or after *pos: sets [*line, *eol), advances *pos */
+static int next_line(const CsvFile *c, const char **pos, const char **line,
+                     const char **eol, long *line_no)
+{
+    const char *end = c->data + c->size;
+    while (*pos < end) {
+        const char *p = *pos;
+        const char *nl = memchr(p, '\n', end - p);
+        const char *e = nl ? nl : end;
+        *pos = nl ? nl + 1 : end;
+        (*line_no)++;
+        if (e > p && !(e - p == 1 && *p == '\r')) {
+            *line = p;
+            *eol = e;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int csv_open(CsvFile *c, const char *path)
+{
+    memset(c, 0, sizeof(*c));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return 0;
+
+    c->data = map;
+    c->size = (size_t)st.st_size;
+    c->pos = c->data;
+    const char *line, *eol;
+    if (!next_line(c, &c->pos, &line, &eol, &c->line)) {
+        csv_close(c);
+        return 0;
+    }
+    c->n_columns = split_line(line, eol, c->header, c->header_len);
+    return 1;
+}
+
+void csv_close(CsvFile *c)
+{
+    if (c->data) munmap((void *)c->data, c->size);
+    memset(c, 0, sizeof(*c));
+}
+
+int csv_column(const CsvFile *c, const char *name)
+{
+    size_t n = strlen(name);
+    for (int i = 0; i < c->n_columns; i++)
+        if ((size_t)c->header_len[i] == n && memcmp(c->header[i], name, n) == 0)
+            return i;
+    return -1;
+}
+
+long csv_count_rows(const CsvFile *c)
+{
+    CsvFile tmp = *c;
+    csv_rewind(&tmp);
+    const char *line, *eol;
+    long rows = 0;
+    while (next_line(&tmp, &tmp.pos, &line, &eol, &tmp.line))
+        rows++;
+    return rows;
+}
+
+void csv_rewind(CsvFile *c)
+{
+    const char *line, *eol;
+    c->pos = c->data;
+    c->line = 0;
+    c->n_fields = 0;
+    next_line(c, &c->pos, &line, &eol, &c->line);  /* header */
+}
+
+int csv_next(CsvFile *c)
+{
+    const char *line, *eol;
+    if (!c->data || !next_line(c, &c->pos, &line, &eol, &c->line)) {
+        c->n_fields = 0;
+        return 0;
+    }
+    c->n_fields = split_line(line, eol, c->field, c->field_len);
+    return 1;
+}
+
+int csv_int(const CsvFile *c, int col, int *out)
+{
+    if (col < 0 || col >= c->n_fields) return 0;
+    const char *p = c->field[col], *end = p + c->field_len[col];
+    int neg = 0;
+    if (p < end && (*p == '-' || *p == '+')) neg = (*p++ == '-');
+    if (p == end) return 0;
+    long val = 0;
+    for (; p < end; p++) {
+        if (*p < '0' || *p > '9' || val > 214748364L) return 0;
+        val = val * 10 + (*p - '0');
+    }
+    if (val > 2147483647L) return 0;
+    *out = (int)(neg ? -val : val);
+    return 1;
+}
+
+int csv_double(const CsvFile *c, int col, double *out)
+{
+    if (col < 0 || col >= c->n_fields) return 0;
+    /* strtod needs a terminated string; fields in these files are short */
+    char buf[64];
+    int len = c->field_len[col];
+    if (len == 0 || len >= (int)sizeof(buf)) return 0;
+    memcpy(buf, c->field[col], len);
+    buf[len] = '\0';
+    char *end;
+    double v = strtod(buf, &end);
+    if (end != buf + len) return 0;
+    *out = v;
+    return 1;
+}
+
+int csv_date_jd(const CsvFile *c, int col_year, int col_month, int col_day,
+                double *jd)
+{
+    int y, m, d;
+    if (!csv_int(c, col_year, &y) || !csv_int(c, col_month, &m) ||
+        !csv_int(c, col_day, &d) || m < 1 || m > 12 || d < 1 || d > 31)
+        return 0;
+    *jd = gregorian_to_jd(y, m, d);
+    return 1;
+}
+
+const char *csv_str(const CsvFile *c, int col, int *len)
+{
+    if (col < 0 || col >= c->n_fields) return NULL;
+    *len = c->field_len[col];
+    return c->field[col];
+}
+
+int csv_str_eq(const CsvFile *c, int col, const char *s)
+{
+    int len;
+    const char *f = csv_str(c, col, &len);
+    return f && (size_t)len == strlen(s) && memcmp(f, s, len) == 0;
+}
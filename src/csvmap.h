@@ -0,0 +1,81 @@
+/*
+ * csvmap.h - Zero-copy reader for the reference CSVs
+ *
+ * Maps a CSV file read-only and splits each row into fields in place:
+ * no line buffer, no per-row allocation.  Fields are addressed by column
+ * index (csv_column() looks one up by header name) and read through
+ * typed accessors.
+ *
+ * The reference files are plain comma-separated text with a header row:
+ * no quoting or embedded commas.  Lines may end in LF or CRLF; blank
+ * lines are skipped; fields past CSV_MAX_FIELDS are ignored.
+ *
+ *   CsvFile c;
+ *   if (!csv_open(&c, "validation/moshier/ref_1900_2050.csv")) ...
+ *   int col_tithi = csv_column(&c, "tithi");
+ *   while (csv_next(&c)) {
+ *       double jd;
+ *       int tithi;
+ *       if (csv_date_jd(&c, 0, 1, 2, &jd) && csv_int(&c, col_tithi, &tithi)) ...
+ *   }
+ *   csv_close(&c);
+ */
+#ifndef CSVMAP_H
+#define CSVMAP_H
+
+#include "types.h"
+
+/*
+ * csv_open - Map a CSV file and read its header row.
+ *   Returns: 1 on success, 0 if the file cannot be opened or is empty.
+ */
+int csv_open(CsvFile *c, const char *path);
+
+/* csv_close - Unmap a file opened with csv_open(). */
+void csv_close(CsvFile *c);
+
+/*
+ * csv_column - Index of the header field equal to name.
+ *   Returns: 0-based column, or -1 if there is none.
+ */
+int csv_column(const CsvFile *c, const char *name);
+
+/* csv_count_rows - Data rows (non-blank lines after the header). */
+long csv_count_rows(const CsvFile *c);
+
+/*
+ * csv_next - Advance to the next data row and split it into fields.
+ *   Returns: 1 if a row was read, 0 at the end of the file.
+ */
+int csv_next(CsvFile *c);
+
+/* csv_rewind - Go back to the first data row. */
+void csv_rewind(CsvFile *c);
+
+/*
+ * Typed accessors for the current row.  Each returns 1 and stores the
+ * value if the column exists and holds exactly one value of that type,
+ * 0 otherwise (the output is left unchanged).
+ *
+ *   csv_int:     decimal integer with optional sign
+ *   csv_double:  floating-point number, e.g. a Julian Day
+ *   csv_date_jd: Julian Day (0h UT) of the Gregorian date in three
+ *                integer columns
+ */
+int csv_int(const CsvFile *c, int col, int *out);
+int csv_double(const CsvFile *c, int col, double *out);
+int csv_date_jd(const CsvFile *c, int col_year, int col_month, int col_day,
+                double *jd);
+
+/*
+ * csv_str - A field's text, for names and labels.
+ *   Returns: Pointer into the mapping (not NUL-terminated; print with
+ *            "%.*s") and its length in *len, or NULL if the column does
+ *            not exist.
+ */
+const char *csv_str(const CsvFile *c, int col, int *len);
+
+/* csv_str_eq - 1 if the field's text equals s. */
+int csv_str_eq(const CsvFile *c, int col, const char *s);
+
+#endif /* CSVMAP_H */
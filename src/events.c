@@ -0,0 +1,318 @@
+#include "events.h"
+#include "tithi.h"
+#include "astro.h"
+#include <math.h>
+#include <string.h>
+
+/* Days to search for a sunrise/sunset before giving up (polar regions) */
+#define MAX_RISE_SEARCH_DAYS 370
+
+/* Kind index = bit position of the EventType flag */
+enum {
+    KIND_TITHI = 0, KIND_NAKSHATRA, KIND_SANKRANTI, KIND_NEW_MOON,
+    KIND_FULL_MOON, KIND_SUNRISE, KIND_SUNSET
+};
+
+static double moon_sidereal(double jd_ut)
+{
+    double lon = fmod(lunar_longitude(jd_ut) - get_ayanamsa(jd_ut), 360.0);
+    if (lon < 0) lon += 360.0;
+    return lon;
+}
+
+/* Events at longitude(jd) = offset + k * step, k = 0 .. count-1 */
+typedef struct {
+    double (*longitude)(double jd_ut);
+    double step;           /* degrees between events */
+    double offset;         /* longitude of event k = 0 */
+    double rate;           /* mean degrees/day, to seed the root finder */
+    int count;             /* events per revolution */
+} AngularKind;
+
+static const AngularKind ANGULAR[] = {
+    { lunar_phase,              12.0,         0.0,   12.190749, 30 },  /* tithi */
+    { moon_sidereal,            360.0 / 27.0, 0.0,   13.176358, 27 },  /* nakshatra */
+    { solar_longitude_sidereal, 30.0,         0.0,    0.985600, 12 },  /* sankranti */
+    { lunar_phase,              360.0,        0.0,   12.190749,  1 },  /* new moon */
+    { lunar_phase,              360.0,        180.0, 12.190749,  1 },  /* full moon */
+};
+
+static const char *EVENT_NAMES[EVENT_KIND_COUNT] = {
+    "Tithi", "Nakshatra", "Sankranti", "New moon", "Full moon", "Sunrise", "Sunset"
+};
+
+const char *event_type_name(EventType type)
+{
+    for (int k = 0; k < EVENT_KIND_COUNT; k++) {
+        if (type == (EventType)(1 << k))
+            return EVENT_NAMES[k];
+    }
+    return "???";
+}
+
+/* Signed angular distance a - b, wrapped to [-180, 180) */
+static double angle_diff(double a, double b)
+{
+    double d = fmod(a - b, 360.0);
+    if (d >= 180.0) d -= 360.0;
+    if (d < -180.0) d += 360.0;
+    return d;
+}
+
+double longitude_crossing(double (*longitude)(double jd_ut), double target,
+                          double rate, double jd_guess)
+{
+    double x0 = jd_guess;
+    double f0 = angle_diff(longitude(x0), target);
+    double x1 = x0 - f0 / rate;
+
+    for (int i = 0; i < 10; i++) {
+        if (fabs(x1 - x0) < 1e-7) break;
+        double f1 = angle_diff(longitude(x1), target);
+        if (f1 == f0) break;
+        double x2 = x1 - f1 * (x1 - x0) / (f1 - f0);
+        x0 = x1;
+        f0 = f1;
+        x1 = x2;
+    }
+    return x1;
+}
+
+/* JD of event k of an angular kind, from a guess within a few days of it */
+static double angular_event_jd(const AngularKind *ak, int k, double jd_guess)
+{
+    return longitude_crossing(ak->longitude, ak->offset + k * ak->step,
+                              ak->rate, jd_guess);
+}
+
+static int angular_value(const AngularKind *ak, int k)
+{
+    return (ak->count > 1) ? k + 1 : 0;
+}
+
+static int angular_index(const AngularKind *ak, int value)
+{
+    return (ak->count > 1) ? value - 1 : 0;
+}
+
+static void angular_init(const AngularKind *ak, EventBracket *b, double jd)
+{
+    double rel = fmod(ak->longitude(jd) - ak->offset + 360.0, 360.0);
+    int k = (int)(rel / ak->step);
+    if (k >= ak->count) k = ak->count - 1;
+    double past = rel - k * ak->step;
+    int k_next = (k + 1) % ak->count;
+
+    b->lo_jd = angular_event_jd(ak, k, jd - past / ak->rate);
+    b->hi_jd = angular_event_jd(ak, k_next, jd + (ak->step - past) / ak->rate);
+    b->lo_value = angular_value(ak, k);
+    b->hi_value = angular_value(ak, k_next);
+    b->valid = 1;
+}
+
+static void angular_step_forward(const AngularKind *ak, EventBracket *b)
+{
+    int k = (angular_index(ak, b->hi_value) + 1) % ak->count;
+    b->lo_jd = b->hi_jd;
+    b->lo_value = b->hi_value;
+    b->hi_jd = angular_event_jd(ak, k, b->lo_jd + ak->step / ak->rate);
+    b->hi_value = angular_value(ak, k);
+}
+
+static void angular_step_back(const AngularKind *ak, EventBracket *b)
+{
+    int k = (angular_index(ak, b->lo_value) + ak->count - 1) % ak->count;
+    b->hi_jd = b->lo_jd;
+    b->hi_value = b->lo_value;
+    b->lo_jd = angular_event_jd(ak, k, b->hi_jd - ak->step / ak->rate);
+    b->lo_value = angular_value(ak, k);
+}
+
+/* ---------------------------------------------------------------------------
+ * Sunrise / sunset.  lo_jd or hi_jd = 0 means none within the search span.
+ * --------------------------------------------------------------------------- */
+
+double local_civil_day(double jd_ut, const Location *loc)
+{
+    return floor(jd_ut + 0.5 + loc->utc_offset / 24.0) - 0.5;
+}
+
+static double rise_set_on(int kind, double jd_day, const Location *loc)
+{
+    return (kind == KIND_SUNRISE) ? sunrise_jd(jd_day, loc) : sunset_jd(jd_day, loc);
+}
+
+/* First event after jd_ut, scanning local days forward from jd_day */
+static double rise_set_after(int kind, double jd_ut, double jd_day,
+                             const Location *loc)
+{
+    for (int i = 0; i <= MAX_RISE_SEARCH_DAYS; i++) {
+        double t = rise_set_on(kind, jd_day + i, loc);
+        if (t > jd_ut) return t;
+    }
+    return 0;
+}
+
+/* Last event at or before jd_ut, scanning local days back from jd_day */
+static double rise_set_at_or_before(int kind, double jd_ut, double jd_day,
+                                    const Location *loc)
+{
+    for (int i = 0; i <= MAX_RISE_SEARCH_DAYS; i++) {
+        double t = rise_set_on(kind, jd_day - i, loc);
+        if (t > 0 && t <= jd_ut) return t;
+    }
+    return 0;
+}
+
+static void rise_set_bracket(int kind, EventBracket *b, double jd,
+                             const Location *loc)
+{
+    if (b->valid && b->lo_jd > 0 && b->hi_jd > 0) {
+        if (jd >= b->lo_jd && jd < b->hi_jd)
+            return;
+
+        /* Just past the bracket: one day forward */
+        if (jd >= b->hi_jd && jd < b->hi_jd + 1.0) {
+            double next = rise_set_after(kind, b->hi_jd,
+                                         local_civil_day(b->hi_jd, loc) + 1.0, loc);
+            if (next == 0 || jd < next) {
+                b->lo_jd = b->hi_jd;
+                b->hi_jd = next;
+                return;
+            }
+        }
+    }
+
+    double day = local_civil_day(jd, loc);
+    b->lo_jd = rise_set_at_or_before(kind, jd, day, loc);
+    b->hi_jd = rise_set_after(kind, jd, day, loc);
+    b->lo_value = b->hi_value = 0;
+    b->valid = 1;
+}
+
+static void rise_set_step_back(int kind, EventBracket *b, const Location *loc)
+{
+    b->hi_jd = b->lo_jd;
+    b->lo_jd = rise_set_at_or_before(kind, b->hi_jd - 1e-6,
+                                     local_civil_day(b->hi_jd, loc) - 1.0, loc);
+}
+
+/* ---------------------------------------------------------------------------
+ * Cursor
+ * --------------------------------------------------------------------------- */
+
+void event_cursor_init(EventCursor *cur, const Location *loc)
+{
+    memset(cur, 0, sizeof(*cur));
+    cur->loc = *loc;
+}
+
+/* Make bracket[kind] satisfy lo_jd <= jd < hi_jd */
+static void ensure_bracket(EventCursor *cur, int kind, double jd)
+{
+    EventBracket *b = &cur->bracket[kind];
+
+    if (kind >= KIND_SUNRISE) {
+        rise_set_bracket(kind, b, jd, &cur->loc);
+        return;
+    }
+
+    const AngularKind *ak = &ANGULAR[kind];
+    double span = 2.0 * ak->step / ak->rate;
+    if (!b->valid || jd < b->lo_jd - span || jd >= b->hi_jd + span)
+        angular_init(ak, b, jd);
+
+    while (jd >= b->hi_jd)
+        angular_step_forward(ak, b);
+    while (jd < b->lo_jd)
+        angular_step_back(ak, b);
+}
+
+static void step_back(EventCursor *cur, int kind)
+{
+    if (kind >= KIND_SUNRISE)
+        rise_set_step_back(kind, &cur->bracket[kind], &cur->loc);
+    else
+        angular_step_back(&ANGULAR[kind], &cur->bracket[kind]);
+}
+
+/* (jd_a, type_a) < (jd_b, type_b) */
+static int event_before(double jd_a, EventType type_a, double jd_b, EventType type_b)
+{
+    return (jd_a < jd_b) || (jd_a == jd_b && type_a < type_b);
+}
+
+int next_event(EventCursor *cur, double jd_ut, unsigned event_mask,
+               AstroEvent *ev)
+{
+    int found = 0;
+
+    for (int kind = 0; kind < EVENT_KIND_COUNT; kind++) {
+        EventType type = (EventType)(1 << kind);
+        if (!(event_mask & type)) continue;
+
+        ensure_bracket(cur, kind, jd_ut);
+        const EventBracket *b = &cur->bracket[kind];
+
+        /* Same instant as the event just returned, but later in order */
+        double jd;
+        int value;
+        if (b->lo_jd == jd_ut && jd_ut == cur->last_jd && type > cur->last_type) {
+            jd = b->lo_jd;
+            value = b->lo_value;
+        } else {
+            jd = b->hi_jd;
+            value = b->hi_value;
+        }
+        if (jd <= 0) continue;
+
+        if (!found || event_before(jd, type, ev->jd, ev->type)) {
+            ev->type = type;
+            ev->jd = jd;
+            ev->value = value;
+            found = 1;
+        }
+    }
+
+    if (found) {
+        cur->last_jd = ev->jd;
+        cur->last_type = ev->type;
+    }
+    return found;
+}
+
+int prev_event(EventCursor *cur, double jd_ut, unsigned event_mask,
+               AstroEvent *ev)
+{
+    int found = 0;
+
+    for (int kind = 0; kind < EVENT_KIND_COUNT; kind++) {
+        EventType type = (EventType)(1 << kind);
+        if (!(event_mask & type)) continue;
+
+        ensure_bracket(cur, kind, jd_ut);
+        const EventBracket *b = &cur->bracket[kind];
+
+        /* An event exactly at jd_ut counts only as a same-instant tie
+         * earlier in order than the event just returned */
+        if (b->lo_jd == jd_ut &&
+            !(jd_ut == cur->last_jd && type < cur->last_type)) {
+            step_back(cur, kind);
+        }
+        double jd = b->lo_jd;
+        if (jd <= 0) continue;
+
+        if (!found || event_before(ev->jd, ev->type, jd, type)) {
+            ev->type = type;
+            ev->jd = jd;
+            ev->value = b->lo_value;
+            found = 1;
+        }
+    }
+
+    if (found) {
+        cur->last_jd = ev->jd;
+        cur->last_type = ev->type;
+    }
+    return found;
+}
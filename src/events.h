@@ -0,0 +1,98 @@
+/*
+ * events.h - Next/previous astronomical event queries
+ *
+ * Answers "when does the current tithi end", "next sankranti", "previous
+ * new moon", "next sunrise" from an arbitrary instant, for any mix of
+ * event kinds (see EventType in types.h).
+ *
+ * Each kind is kept as a bracket of two consecutive events around the
+ * last query.  A query inside the bracket is answered without any
+ * ephemeris call; one just past it costs a single root find seeded from
+ * the previous event (secant on the longitude, ~3-4 evaluations), or
+ * one sunrise_jd()/sunset_jd() call.  Queries far from the bracket
+ * rebuild it from scratch, so random access works but is not amortized.
+ *
+ * Angular events are located to ~0.01 s.  Sunrise/sunset are those of
+ * sunrise_jd()/sunset_jd(); days without one (polar day/night) are
+ * skipped, up to a year ahead or behind.
+ */
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include "types.h"
+
+/*
+ * event_cursor_init - Prepare a cursor for next_event()/prev_event().
+ *
+ *   cur: Cursor to initialise.
+ *   loc: Observer location (used only by EVENT_SUNRISE/EVENT_SUNSET).
+ */
+void event_cursor_init(EventCursor *cur, const Location *loc);
+
+/*
+ * next_event - First event of the requested kinds after a moment.
+ *
+ *   cur:        Cursor from event_cursor_init().
+ *   jd_ut:      Moment (JD UT).
+ *   event_mask: OR of EVENT_* flags.
+ *   ev:         Output event.
+ *   Returns: 1 if an event was found, 0 otherwise (empty mask, or no
+ *            sunrise/sunset within a year at the location).
+ *
+ * Returns the earliest event strictly after jd_ut.  Passing the jd of
+ * the event just returned continues to the next one, including other
+ * kinds at the same instant:
+ *
+ *   AstroEvent ev;
+ *   double jd = gregorian_to_jd(2025, 1, 1);
+ *   while (next_event(&cur, jd, EVENT_TITHI | EVENT_NEW_MOON, &ev) &&
+ *          ev.jd < jd_end) {
+ *       ...
+ *       jd = ev.jd;
+ *   }
+ */
+int next_event(EventCursor *cur, double jd_ut, unsigned event_mask,
+               AstroEvent *ev);
+
+/*
+ * prev_event - Last event of the requested kinds before a moment.
+ *
+ *   cur, jd_ut, event_mask, ev: As for next_event().
+ *   Returns: 1 if found, 0 otherwise.
+ *
+ * Returns the latest event strictly before jd_ut; passing the jd of the
+ * event just returned walks backwards through same-instant ties.  For
+ * "when did the current tithi start", use prev_event(.., EVENT_TITHI, ..).
+ */
+int prev_event(EventCursor *cur, double jd_ut, unsigned event_mask,
+               AstroEvent *ev);
+
+/*
+ * event_type_name - Short name of an event type ("Tithi", "Sunrise", ...).
+ */
+const char *event_type_name(EventType type);
+
+/*
+ * longitude_crossing - JD when longitude(jd) reaches target degrees.
+ *
+ *   longitude: Angle in degrees as a function of JD (UT), e.g. lunar_phase.
+ *   target:    Angle to reach, in degrees.
+ *   rate:      Mean motion in degrees/day, to seed the search.
+ *   jd_guess:  Moment within a few days of the crossing.
+ *   Returns: JD (UT) of the crossing, to ~0.01 s.
+ *
+ * Secant iteration on the wrapped angle difference: 3-4 evaluations,
+ * where a bisection such as find_tithi_boundary() needs ~18.
+ */
+double longitude_crossing(double (*longitude)(double jd_ut), double target,
+                          double rate, double jd_guess);
+
+/*
+ * local_civil_day - JD at 0h UT of the local civil day containing a moment.
+ *
+ *   jd_ut: Moment (JD UT).
+ *   loc:   Location whose utc_offset defines the civil day.
+ */
+double local_civil_day(double jd_ut, const Location *loc);
+
+#endif /* EVENTS_H */
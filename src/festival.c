@@ -0,0 +1,219 @@
+#include "festival.h"
+#include "events.h"
+#include "tithi.h"
+#include "masa.h"
+#include "solar.h"
+#include "astro.h"
+#include "date_utils.h"
+#include <math.h>
+
+/* Mean motions (degrees/day) used only to seed the root finders */
+#define MEAN_LUNATION    29.530589
+#define MEAN_PHASE_RATE  (360.0 / MEAN_LUNATION)   /* moon - sun */
+#define MEAN_SIGN_DAYS   (365.256363 / 12.0)   /* sidereal sun, per rashi */
+
+/* JD when lunar_phase() crosses target_phase, from a guess within
+ * about a day of the crossing */
+static double phase_crossing(double jd_guess, double target_phase)
+{
+    return longitude_crossing(lunar_phase, target_phase, MEAN_PHASE_RATE, jd_guess);
+}
+
+/* Sunrise of a civil day, with the same local-noon fallback as
+ * gregorian_to_hindu() so polar days classify identically. */
+static double sunrise_or_noon(double jd_day, const Location *loc)
+{
+    double jd_rise = sunrise_jd(jd_day, loc);
+    if (jd_rise <= 0)
+        jd_rise = jd_day + 0.5 - loc->utc_offset / 24.0;
+    return jd_rise;
+}
+
+static int tithi_matches(const TithiQuery *q, int t)
+{
+    int paksha = (t <= 15) ? SHUKLA_PAKSHA : KRISHNA_PAKSHA;
+    int pt = (t <= 15) ? t : t - 15;
+    if (q->paksha >= 0 && q->paksha != paksha) return 0;
+    if (q->tithi > 0 && q->tithi != pt) return 0;
+    return 1;
+}
+
+/* Sunrises closer than this to a tithi boundary are classified with
+ * tithi_at_moment(), exactly as gregorian_to_hindu() does; farther ones
+ * by comparing JDs against the (0.01 s accurate) boundaries. */
+#define BOUNDARY_GUARD  (60.0 / 86400.0)
+
+/* Day-to-day sunrise drift stays well under this outside the polar
+ * circles, so a next sunrise estimated as rise + 1 day is trusted when
+ * the tithi end is farther away than this. */
+#define NEXT_RISE_GUARD (60.0 / 1440.0)
+
+/* Where a sunrise falls relative to tithi t: -1 before, 0 inside, 1 after */
+static int rise_vs_tithi(double jd_rise, int t, double jd_start, double jd_end)
+{
+    if (fabs(jd_rise - jd_start) < BOUNDARY_GUARD ||
+        fabs(jd_rise - jd_end) < BOUNDARY_GUARD) {
+        int tr = tithi_at_moment(jd_rise);
+        if (tr == t) return 0;
+        return ((tr - t + 30) % 30 == 29) ? -1 : 1;
+    }
+    if (jd_rise < jd_start) return -1;
+    return (jd_rise < jd_end) ? 0 : 1;
+}
+
+/*
+ * Place tithi t (jd_start .. jd_end) on its civil day.
+ * Returns the civil day's JD (0h UT) and sets *sunrises and *jd_rise
+ * (the sunrise used for the year computation).
+ */
+static double tithi_civil_day(int t, double jd_start, double jd_end,
+                              const Location *loc, int *sunrises,
+                              double *jd_rise)
+{
+    double jd_day = local_civil_day(jd_start, loc);
+    double rise = sunrise_or_noon(jd_day, loc);
+    int pos = rise_vs_tithi(rise, t, jd_start, jd_end);
+
+    /* Sunrise of the start day still in the previous tithi: move on */
+    for (int i = 0; i < 2 && pos < 0; i++) {
+        jd_day += 1.0;
+        rise = sunrise_or_noon(jd_day, loc);
+        pos = rise_vs_tithi(rise, t, jd_start, jd_end);
+    }
+
+    if (pos == 0) {
+        double rise_next = rise + 1.0;
+        if (fabs(rise_next - jd_end) < NEXT_RISE_GUARD)
+            rise_next = sunrise_or_noon(jd_day + 1.0, loc);
+        *sunrises = (rise_vs_tithi(rise_next, t, jd_start, jd_end) == 0) ? 2 : 1;
+        *jd_rise = rise;
+        return jd_day;
+    }
+
+    /* No sunrise inside the tithi: kshaya, observed on the day whose
+     * sunrise-to-sunrise span contains it. */
+    *sunrises = 0;
+    *jd_rise = jd_start;
+    return jd_day - 1.0;
+}
+
+int find_tithi_dates(const TithiQuery *q, double jd_from, double jd_to,
+                     const Location *loc, TithiOccurrence *out, int max_out)
+{
+    int count = 0;
+
+    /* Start one lunation early: the last tithis of the previous lunation
+     * can still be observed on jd_from. */
+    double nm = new_moon_before(jd_from, tithi_at_moment(jd_from));
+    nm = phase_crossing(nm - MEAN_LUNATION, 0.0);
+    int rashi_nm = solar_rashi(nm);
+
+    while (nm - 2.0 <= jd_to) {
+        /* Secant new moons agree with new_moon_after()'s Lagrange fit to
+         * ~0.1 s over 1900-2050, at half the lunar_phase() calls. */
+        double nm_next = phase_crossing(nm + MEAN_LUNATION, 0.0);
+        int rashi_next = solar_rashi(nm_next);
+
+        int is_adhika = (rashi_nm == rashi_next) ? 1 : 0;
+        int masa = rashi_nm + 1;
+        if (masa > 12) masa -= 12;
+
+        if ((q->masa <= 0 || q->masa == masa) &&
+            (q->is_adhika < 0 || q->is_adhika == is_adhika)) {
+            double span = nm_next - nm;
+
+            for (int t = 1; t <= 30; t++) {
+                if (!tithi_matches(q, t)) continue;
+
+                double jd_start = (t == 1) ? nm
+                    : phase_crossing(nm + span * (t - 1) / 30.0, (t - 1) * 12.0);
+                double jd_end = (t == 30) ? nm_next
+                    : phase_crossing(nm + span * t / 30.0, t * 12.0);
+
+                int sunrises;
+                double jd_rise;
+                double jd_day = tithi_civil_day(t, jd_start, jd_end, loc,
+                                                &sunrises, &jd_rise);
+                if (jd_day < jd_from || jd_day > jd_to) continue;
+
+                if (count < max_out) {
+                    TithiOccurrence *o = &out[count];
+                    jd_to_gregorian(jd_day, &o->greg_year, &o->greg_month,
+                                    &o->greg_day);
+                    o->hindu_date.masa = (MasaName)masa;
+                    o->hindu_date.is_adhika_masa = is_adhika;
+                    o->hindu_date.year_saka = hindu_year_saka(jd_rise, masa);
+                    o->hindu_date.year_vikram =
+                        hindu_year_vikram(o->hindu_date.year_saka);
+                    o->hindu_date.paksha = (t <= 15) ? SHUKLA_PAKSHA : KRISHNA_PAKSHA;
+                    o->hindu_date.tithi = (t <= 15) ? t : t - 15;
+                    o->hindu_date.is_adhika_tithi = 0;
+                    o->jd_start = jd_start;
+                    o->jd_end = jd_end;
+                    o->sunrises = sunrises;
+                }
+                count++;
+            }
+        }
+
+        nm = nm_next;
+        rashi_nm = rashi_next;
+    }
+
+    return count;
+}
+
+int find_sankranti_dates(SolarCalendarType type, int rashi,
+                         double jd_from, double jd_to, const Location *loc,
+                         SankrantiOccurrence *out, int max_out)
+{
+    int count = 0;
+
+    /* Sankranti in effect a few days before the range: its civil day may
+     * fall on jd_from. */
+    double jd_seed = jd_from - 3.0;
+    int cur = (int)floor(solar_longitude_sidereal(jd_seed) / 30.0) + 1;
+    if (cur > 12) cur = 12;
+    double jd_sank = sankranti_before(jd_seed);
+
+    /* Jump straight to the first wanted rashi */
+    if (rashi >= 1 && rashi <= 12 && rashi != cur) {
+        int steps = (rashi - cur + 12) % 12;
+        jd_sank = sankranti_jd(jd_sank + steps * MEAN_SIGN_DAYS,
+                               (rashi - 1) * 30.0);
+        cur = rashi;
+    }
+
+    while (jd_sank - 3.0 <= jd_to) {
+        /* Owning civil day is the local date of the sankranti or the
+         * next one (rarely the previous, for tuned Bengali boundaries). */
+        double jd_local = local_civil_day(jd_sank, loc);
+        static const double offsets[] = { 0.0, 1.0, -1.0, 2.0 };
+        for (int k = 0; k < 4; k++) {
+            double jd_day = jd_local + offsets[k];
+            int y, m, d;
+            jd_to_gregorian(jd_day, &y, &m, &d);
+            SolarDate sd = gregorian_to_solar(y, m, d, loc, type);
+            if (sd.day != 1 || sd.rashi != cur) continue;
+
+            if (jd_day >= jd_from && jd_day <= jd_to) {
+                if (count < max_out) {
+                    SankrantiOccurrence *o = &out[count];
+                    o->greg_year = y;
+                    o->greg_month = m;
+                    o->greg_day = d;
+                    o->solar_date = sd;
+                }
+                count++;
+            }
+            break;
+        }
+
+        int steps = (rashi >= 1 && rashi <= 12) ? 12 : 1;
+        cur = (cur + steps - 1) % 12 + 1;
+        jd_sank = sankranti_jd(jd_sank + steps * MEAN_SIGN_DAYS,
+                               (cur - 1) * 30.0);
+    }
+
+    return count;
+}
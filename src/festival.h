@@ -0,0 +1,62 @@
+/*
+ * festival.h - Range search for tithis and sankrantis
+ *
+ * Finds every civil day in a range that carries a given lunisolar date
+ * (e.g. all Ekadashis, every Kartika Purnima) or starts a solar month,
+ * without converting each day of the range.
+ *
+ * Tithi search walks lunations instead of days:
+ *   1. Step from new moon to new moon across the range; the solar rashi
+ *      at the two new moons gives the masa and adhika flag (the same rule
+ *      as masa_for_date()), so non-matching months are skipped whole.
+ *   2. Within a matching lunation, locate only the requested tithis'
+ *      boundaries (secant iteration on lunar_phase()).
+ *   3. Assign each tithi to its civil day by the sunrise rule used in
+ *      gregorian_to_hindu(): the tithi prevailing at sunrise names the
+ *      day.  A tithi spanning two sunrises is adhika (sunrises = 2); one
+ *      that falls between two sunrises is kshaya (sunrises = 0) and is
+ *      reported on the day during which it runs.
+ *
+ * A search for one tithi per paksha costs ~8 lunar_phase() and ~2
+ * sunrise evaluations per lunation, against ~30 sunrises per lunation
+ * for a day-by-day gregorian_to_hindu() scan.
+ */
+#ifndef FESTIVAL_H
+#define FESTIVAL_H
+
+#include "types.h"
+
+/*
+ * find_tithi_dates - All civil days in a range matching a lunisolar query.
+ *
+ *   q:       Query (see TithiQuery in types.h for wildcards).
+ *   jd_from: First civil day of the range (JD at 0h UT, gregorian_to_jd()).
+ *   jd_to:   Last civil day of the range (inclusive).
+ *   loc:     Observer location.
+ *   out:     Output array (may be NULL if max_out is 0).
+ *   max_out: Capacity of out.
+ *   Returns: Total number of matches, in chronological order.  At most
+ *            max_out are written; call with max_out = 0 to size a buffer.
+ *
+ * The masa reported is that of the lunation containing the tithi.
+ */
+int find_tithi_dates(const TithiQuery *q, double jd_from, double jd_to,
+                     const Location *loc, TithiOccurrence *out, int max_out);
+
+/*
+ * find_sankranti_dates - All solar month starts in a range.
+ *
+ *   type:    Regional calendar whose critical-time rule assigns each
+ *            sankranti to a civil day.
+ *   rashi:   1-12 to select one sankranti (e.g. 10 = Makara), 0 = all.
+ *   jd_from, jd_to, loc, out, max_out: As for find_tithi_dates().
+ *   Returns: Total number of matches, in chronological order.
+ *
+ * Steps from sankranti to sankranti (one bisection each) and confirms the
+ * owning civil day with gregorian_to_solar().
+ */
+int find_sankranti_dates(SolarCalendarType type, int rashi,
+                         double jd_from, double jd_to, const Location *loc,
+                         SankrantiOccurrence *out, int max_out);
+
+#endif /* FESTIVAL_H */
@@ -0,0 +1,199 @@
+#include "hinducalendar.h"
+#include "astro.h"
+#include "cache.h"
+#include "date_utils.h"
+#include "events.h"
+#include "panchang.h"
+#include "solar.h"
+#include <stdlib.h>
+
+#define STR2(x) #x
+#define STR(x) STR2(x)
+
+/* The public constants are the internal enums' values */
+typedef char check_event_mask[(HCAL_EVENT_ALL == EVENT_ALL &&
+                               HCAL_EVENT_SUNSET == EVENT_SUNSET) ? 1 : -1];
+typedef char check_calendars[(HCAL_TAMIL == SOLAR_CAL_TAMIL &&
+                              HCAL_MALAYALAM == SOLAR_CAL_MALAYALAM) ? 1 : -1];
+
+struct hcal_context {
+    Location loc;
+    EventCursor cursor;
+};
+
+/* The Swiss Ephemeris keeps its sidereal mode per thread, so every
+ * thread that computes runs astro_init() once */
+static THREAD_LOCAL int thread_ready;
+
+static void init_thread(void)
+{
+    if (thread_ready) return;
+    astro_init(NULL);
+    thread_ready = 1;
+}
+
+/* A real date, with count days from it inside HCAL_YEAR_MIN..HCAL_YEAR_MAX */
+static int valid_days(int y, int m, int d, int count)
+{
+    if (y < HCAL_YEAR_MIN || y > HCAL_YEAR_MAX || m < 1 || m > 12 || d < 1)
+        return 0;
+    double jd = gregorian_to_jd(y, m, d);
+    int cy, cm, cd;
+    jd_to_gregorian(jd, &cy, &cm, &cd);
+    if (cy != y || cm != m || cd != d) return 0;
+    if (count > 0) jd_to_gregorian(jd + count - 1, &cy, &cm, &cd);
+    return cy <= HCAL_YEAR_MAX;
+}
+
+const char *hcal_version(void)
+{
+    return STR(HCAL_VERSION_MAJOR) "." STR(HCAL_VERSION_MINOR) "." STR(HCAL_VERSION_PATCH);
+}
+
+const char *hcal_strerror(int err)
+{
+    switch (err) {
+    case 0:            return "Success";
+    case HCAL_EINVAL:  return "Invalid argument";
+    case HCAL_ENOMEM:  return "Out of memory";
+    default:           return "Unknown error";
+    }
+}
+
+hcal_context *hcal_create(double latitude, double longitude,
+                          double altitude, double utc_offset)
+{
+    /* Written so that NaN fails too */
+    if (!(latitude >= -90.0 && latitude <= 90.0) ||
+        !(longitude >= -180.0 && longitude <= 180.0) ||
+        !(utc_offset >= -14.0 && utc_offset <= 14.0) ||
+        !(altitude > -1000.0 && altitude < 100000.0))
+        return NULL;
+
+    init_thread();
+    hcal_context *ctx = malloc(sizeof(*ctx));
+    if (!ctx) return NULL;
+    ctx->loc.latitude = latitude;
+    ctx->loc.longitude = longitude;
+    ctx->loc.altitude = altitude;
+    ctx->loc.utc_offset = utc_offset;
+    event_cursor_init(&ctx->cursor, &ctx->loc);
+    return ctx;
+}
+
+void hcal_destroy(hcal_context *ctx)
+{
+    free(ctx);
+}
+
+int hcal_lunisolar_days(hcal_context *ctx, int year, int month, int day,
+                        int count, hcal_lunisolar_date *out)
+{
+    if (!ctx || count < 0 || (count > 0 && !out) || !valid_days(year, month, day, count))
+        return HCAL_EINVAL;
+
+    init_thread();
+    /* Consecutive days, so the lunation and previous-day caches hit */
+    double jd = gregorian_to_jd(year, month, day);
+    for (int i = 0; i < count; i++, jd += 1.0) {
+        int y, m, d;
+        jd_to_gregorian(jd, &y, &m, &d);
+        HinduDate hd = gregorian_to_hindu(y, m, d, &ctx->loc);
+        hcal_lunisolar_date *o = &out[i];
+        o->year_saka = hd.year_saka;
+        o->year_vikram = hd.year_vikram;
+        o->masa = hd.masa;
+        o->is_adhika_masa = hd.is_adhika_masa;
+        o->paksha = hd.paksha;
+        o->tithi = hd.tithi;
+        o->is_adhika_tithi = hd.is_adhika_tithi;
+        o->reserved = 0;
+    }
+    return count;
+}
+
+int hcal_solar_days(hcal_context *ctx, int calendar, int year, int month, int day,
+                    int count, hcal_solar_date *out)
+{
+    if (!ctx || calendar < HCAL_TAMIL || calendar > HCAL_MALAYALAM ||
+        count < 0 || (count > 0 && !out) || !valid_days(year, month, day, count))
+        return HCAL_EINVAL;
+
+    init_thread();
+    double jd = gregorian_to_jd(year, month, day);
+    for (int i = 0; i < count; i++, jd += 1.0) {
+        int y, m, d;
+        jd_to_gregorian(jd, &y, &m, &d);
+        SolarDate sd = gregorian_to_solar(y, m, d, &ctx->loc, (SolarCalendarType)calendar);
+        out[i].year = sd.year;
+        out[i].month = sd.month;
+        out[i].day = sd.day;
+        out[i].rashi = sd.rashi;
+        out[i].jd_sankranti = sd.jd_sankranti;
+    }
+    return count;
+}
+
+int hcal_events(hcal_context *ctx, double jd_from, double jd_to,
+                unsigned mask, hcal_event *out, int max)
+{
+    if (!ctx || max < 0 || (max > 0 && !out) || (mask & ~HCAL_EVENT_ALL) ||
+        !(jd_from <= jd_to))
+        return HCAL_EINVAL;
+
+    init_thread();
+    int n = 0;
+    double jd = jd_from;
+    AstroEvent ev;
+    while (n < max && next_event(&ctx->cursor, jd, mask, &ev) && ev.jd < jd_to) {
+        out[n].jd = ev.jd;
+        out[n].type = ev.type;
+        out[n].value = ev.value;
+        n++;
+        jd = ev.jd;
+    }
+    return n;
+}
+
+double hcal_gregorian_to_jd(int year, int month, int day)
+{
+    init_thread();
+    return gregorian_to_jd(year, month, day);
+}
+
+void hcal_jd_to_gregorian(double jd, int *year, int *month, int *day)
+{
+    init_thread();
+    jd_to_gregorian(jd, year, month, day);
+}
+
+const char *hcal_masa_name(int masa)
+{
+    return (masa >= CHAITRA && masa <= PHALGUNA) ? MASA_NAMES[masa] : "???";
+}
+
+const char *hcal_solar_month_name(int calendar, int month)
+{
+    if (calendar < HCAL_TAMIL || calendar > HCAL_MALAYALAM) return "???";
+    return solar_month_name(month, (SolarCalendarType)calendar);
+}
+
+const char *hcal_event_name(unsigned type)
+{
+    return event_type_name((EventType)type);
+}
+
+int hcal_set_cache_capacities(const char *spec)
+{
+    if (!spec || cache_parse_capacities(spec) != 0) return HCAL_EINVAL;
+    return 0;
+}
+
+/* astro_close() without the Swiss Ephemeris swe_close(), which is global */
+void hcal_thread_release(void)
+{
+    thread_ready = 0;
+    call_stats_retire();
+    latency_retire();
+    cache_release();
+}
@@ -0,0 +1,196 @@
+/*
+ * hinducalendar.h - Public C API of libhinducalendar
+ *
+ * The interface exported by the shared library (make lib), for callers in
+ * other languages (ctypes, cffi, JNI, Rust FFI, ...) and for C programs
+ * that link with `pkg-config --cflags --libs hinducalendar`.  Only the
+ * hcal_* functions below are exported; everything else in the library is
+ * hidden.  The header is self-contained: it does not include types.h, and
+ * every struct is built from fixed-width fields so its layout is the same
+ * for any compiler.
+ *
+ * A context (hcal_context) holds an observer location and an event cursor.
+ * Conversions work on batches: one call fills a caller-provided array for
+ * a run of consecutive days, so a foreign caller pays the call overhead
+ * once per batch, and the day-to-day caches stay warm across the batch.
+ *
+ *   hcal_context *ctx = hcal_create(28.6139, 77.2090, 0.0, 5.5);
+ *   hcal_lunisolar_date days[366];
+ *   int n = hcal_lunisolar_days(ctx, 2024, 1, 1, 366, days);
+ *   ...
+ *   hcal_destroy(ctx);
+ *
+ * Threads: a context may be used by one thread at a time; different
+ * contexts may be used concurrently.  The caches are per thread, so a
+ * thread that is done with the library (e.g. a pool thread of the host
+ * runtime) can free its share with hcal_thread_release().
+ *
+ * ABI: the soname carries HCAL_VERSION_MAJOR, and exported symbols are
+ * versioned HCAL_1.0 (src/hinducalendar.map).  Minor versions only add
+ * functions and constants.
+ */
+#ifndef HINDUCALENDAR_H
+#define HINDUCALENDAR_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(HCAL_BUILD) && defined(__GNUC__)
+#define HCAL_API __attribute__((visibility("default")))
+#else
+#define HCAL_API
+#endif
+
+#define HCAL_VERSION_MAJOR 1
+#define HCAL_VERSION_MINOR 0
+#define HCAL_VERSION_PATCH 0
+
+/* Error codes, returned as negative counts */
+#define HCAL_EINVAL  (-1)  /* NULL context or array, bad or out-of-range date,
+                              calendar, count */
+#define HCAL_ENOMEM  (-2)  /* Allocation failed */
+
+/* Gregorian years accepted by the day conversions: the span the
+ * ephemeris precision is stated for.  Every day of a batch must fall in it. */
+#define HCAL_YEAR_MIN 1900
+#define HCAL_YEAR_MAX 2100
+
+/* Regional solar calendars (hcal_solar_days) */
+#define HCAL_TAMIL      0
+#define HCAL_BENGALI    1
+#define HCAL_ODIA       2
+#define HCAL_MALAYALAM  3
+
+/* Event kinds (hcal_events), OR-ed into a mask */
+#define HCAL_EVENT_TITHI      (1u << 0)  /* Moon-sun elongation crosses a multiple of 12 deg */
+#define HCAL_EVENT_NAKSHATRA  (1u << 1)  /* Sidereal moon crosses a multiple of 13 deg 20' */
+#define HCAL_EVENT_SANKRANTI  (1u << 2)  /* Sidereal sun crosses a multiple of 30 deg */
+#define HCAL_EVENT_NEW_MOON   (1u << 3)
+#define HCAL_EVENT_FULL_MOON  (1u << 4)
+#define HCAL_EVENT_SUNRISE    (1u << 5)  /* Upper limb, at the context's location */
+#define HCAL_EVENT_SUNSET     (1u << 6)
+#define HCAL_EVENT_ALL        0x7Fu
+
+typedef struct hcal_context hcal_context;
+
+/* Lunisolar (Amanta) date of a civil day, at sunrise */
+typedef struct {
+    int32_t year_saka;
+    int32_t year_vikram;
+    int32_t masa;              /* 1 = Chaitra .. 12 = Phalguna */
+    int32_t is_adhika_masa;    /* 1 in a leap month */
+    int32_t paksha;            /* 0 = Shukla, 1 = Krishna */
+    int32_t tithi;             /* 1-15 within the paksha */
+    int32_t is_adhika_tithi;   /* 1 if the same tithi as the previous day */
+    int32_t reserved;          /* 0 */
+} hcal_lunisolar_date;
+
+/* Regional solar date of a civil day */
+typedef struct {
+    int32_t year;              /* Regional era year */
+    int32_t month;             /* 1-12, regional numbering */
+    int32_t day;               /* 1-32 */
+    int32_t rashi;             /* Sidereal sign 1-12 at the critical time */
+    double jd_sankranti;       /* JD (UT) of the sankranti that began the month */
+} hcal_solar_date;
+
+typedef struct {
+    double jd;                 /* JD (UT) */
+    uint32_t type;             /* One HCAL_EVENT_* flag */
+    int32_t value;             /* Tithi (1-30), nakshatra (1-27) or rashi (1-12)
+                                  entered; 0 for the other kinds */
+} hcal_event;
+
+/* hcal_version - "MAJOR.MINOR.PATCH" of the loaded library. */
+HCAL_API const char *hcal_version(void);
+
+/* hcal_strerror - Message for an HCAL_E* code. */
+HCAL_API const char *hcal_strerror(int err);
+
+/*
+ * hcal_create - New context for an observer location.
+ *
+ *   latitude:   -90 to 90 degrees, north positive.
+ *   longitude:  -180 to 180 degrees, east positive.
+ *   altitude:   Metres above sea level.
+ *   utc_offset: Hours east of UTC (-14 to 14), e.g. 5.5 for IST.
+ *   Returns: The context, or NULL if an argument is out of range or
+ *            allocation failed.
+ */
+HCAL_API hcal_context *hcal_create(double latitude, double longitude,
+                                   double altitude, double utc_offset);
+
+/* hcal_destroy - Free a context (NULL is ignored). */
+HCAL_API void hcal_destroy(hcal_context *ctx);
+
+/*
+ * hcal_lunisolar_days - Lunisolar dates of count consecutive days.
+ *
+ *   year, month, day: First Gregorian day.
+ *   count: Days to convert (>= 0); the last day must not pass
+ *          HCAL_YEAR_MAX.
+ *   out:   Array of at least count entries.
+ *   Returns: count, or a negative HCAL_E* code (out untouched).
+ */
+HCAL_API int hcal_lunisolar_days(hcal_context *ctx, int year, int month, int day,
+                                 int count, hcal_lunisolar_date *out);
+
+/*
+ * hcal_solar_days - Solar dates of count consecutive days in a regional
+ * calendar (HCAL_TAMIL .. HCAL_MALAYALAM).
+ *   Returns: count, or a negative HCAL_E* code (out untouched).
+ */
+HCAL_API int hcal_solar_days(hcal_context *ctx, int calendar,
+                             int year, int month, int day,
+                             int count, hcal_solar_date *out);
+
+/*
+ * hcal_events - Events of the kinds in mask, in time order, with
+ * jd_from < jd < jd_to.
+ *
+ *   out: Array of max entries.
+ *   Returns: Number of events written, or a negative HCAL_E* code.
+ *
+ * When the result is max, more may follow: call again from the jd of the
+ * last event returned.  The context keeps the bracketing events of its
+ * last query, so successive calls over a period cost about one root find
+ * per event.
+ */
+HCAL_API int hcal_events(hcal_context *ctx, double jd_from, double jd_to,
+                         unsigned mask, hcal_event *out, int max);
+
+/* hcal_gregorian_to_jd - JD (UT) of 0h UT on a Gregorian date. */
+HCAL_API double hcal_gregorian_to_jd(int year, int month, int day);
+
+/* hcal_jd_to_gregorian - Gregorian date of a JD (UT). */
+HCAL_API void hcal_jd_to_gregorian(double jd, int *year, int *month, int *day);
+
+/* hcal_masa_name - "Chaitra" .. "Phalguna" for 1-12, else "???". */
+HCAL_API const char *hcal_masa_name(int masa);
+
+/* hcal_solar_month_name - Regional month name for 1-12, else "???". */
+HCAL_API const char *hcal_solar_month_name(int calendar, int month);
+
+/* hcal_event_name - "Tithi", "Sunrise", ... for one HCAL_EVENT_* flag. */
+HCAL_API const char *hcal_event_name(unsigned type);
+
+/*
+ * hcal_set_cache_capacities - Apply "NAME=N[,NAME=N...]" to the calendar
+ * caches of every thread, e.g. "lunation=2048,sankranti=8192" before
+ * converting days in random order over a long range.
+ *   Returns: 0, or HCAL_EINVAL on an unknown name or bad size.
+ */
+HCAL_API int hcal_set_cache_capacities(const char *spec);
+
+/* hcal_thread_release - Free the calling thread's caches; its next call
+ * sets them up again. */
+HCAL_API void hcal_thread_release(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HINDUCALENDAR_H */
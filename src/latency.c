@@ -0,0 +1,225 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "latency.h"
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+static const char *API_NAMES[LAT_COUNT] = {
+    "gregorian_to_hindu", "gregorian_to_solar", "lunisolar_month_start",
+    "sunrise", "sunset",
+};
+
+/* Histograms handed over by latency_retire() */
+static LatencyStats retired;
+static pthread_mutex_t retired_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static LatencyTraceFn tracer;
+static void *tracer_ctx;
+
+#ifdef USE_LATENCY
+static THREAD_LOCAL LatencyStats thread_stats;
+THREAD_LOCAL int latency_miss_flag;
+#endif
+
+/* ---- Histogram ---- */
+
+static int bucket_index(unsigned long long ns)
+{
+    if (ns < LAT_SUB_BUCKETS) return (int)ns;
+    int e = 63 - __builtin_clzll(ns);
+    if (e > LAT_MAX_EXP) return LAT_BUCKETS - 1;
+    int sub = (int)(ns >> (e - LAT_SUB_BITS)) & (LAT_SUB_BUCKETS - 1);
+    return LAT_SUB_BUCKETS * (e - LAT_SUB_BITS + 1) + sub;
+}
+
+/* Highest value that falls in bucket i */
+static unsigned long long bucket_high(int i)
+{
+    if (i < LAT_SUB_BUCKETS) return (unsigned long long)i;
+    int e = i / LAT_SUB_BUCKETS + LAT_SUB_BITS - 1;
+    unsigned long long sub = (unsigned long long)(i % LAT_SUB_BUCKETS);
+    unsigned long long width = 1ULL << (e - LAT_SUB_BITS);
+    return ((LAT_SUB_BUCKETS + sub) << (e - LAT_SUB_BITS)) + width - 1;
+}
+
+void latency_hist_add(LatencyHistogram *h, unsigned long long ns)
+{
+    h->count[bucket_index(ns)]++;
+    if (h->total == 0 || ns < h->min_ns) h->min_ns = ns;
+    if (ns > h->max_ns) h->max_ns = ns;
+    h->total++;
+    h->sum_ns += (double)ns;
+}
+
+void latency_hist_merge(LatencyHistogram *dst, const LatencyHistogram *src)
+{
+    if (src->total == 0) return;
+    for (int i = 0; i < LAT_BUCKETS; i++)
+        dst->count[i] += src->count[i];
+    if (dst->total == 0 || src->min_ns < dst->min_ns) dst->min_ns = src->min_ns;
+    if (src->max_ns > dst->max_ns) dst->max_ns = src->max_ns;
+    dst->total += src->total;
+    dst->sum_ns += src->sum_ns;
+}
+
+unsigned long long latency_percentile(const LatencyHistogram *h, double pct)
+{
+    if (h->total == 0) return 0;
+    if (pct <= 0.0) return h->min_ns;
+
+    unsigned long rank = (unsigned long)(pct / 100.0 * h->total + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > h->total) rank = h->total;
+
+    unsigned long seen = 0;
+    for (int i = 0; i < LAT_BUCKETS; i++) {
+        seen += h->count[i];
+        if (seen >= rank) {
+            if (i == LAT_BUCKETS - 1) return h->max_ns;  /* open-ended */
+            unsigned long long v = bucket_high(i);
+            return v < h->max_ns ? v : h->max_ns;
+        }
+    }
+    return h->max_ns;
+}
+
+/* ---- Timing ---- */
+
+int latency_enabled(void)
+{
+#ifdef USE_LATENCY
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+unsigned long long latency_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+}
+
+void latency_set_tracer(LatencyTraceFn fn, void *ctx)
+{
+    tracer = fn;
+    tracer_ctx = ctx;
+}
+
+#ifdef USE_LATENCY
+void latency_begin(LatencyScope *scope)
+{
+    scope->outer_miss = latency_miss_flag;
+    latency_miss_flag = 0;
+    scope->start_ns = latency_now_ns();
+}
+
+void latency_end(LatencyScope *scope, LatencyApi api)
+{
+    unsigned long long dur = latency_now_ns() - scope->start_ns;
+    int miss = latency_miss_flag || api >= LAT_SUNRISE;
+    latency_hist_add(&thread_stats.h[api][miss], dur);
+    if (tracer)
+        tracer(api, miss, scope->start_ns, dur, tracer_ctx);
+    /* Only cache misses propagate to the caller */
+    latency_miss_flag |= scope->outer_miss;
+}
+#endif
+
+/* ---- Snapshots ---- */
+
+void latency_snapshot(LatencyStats *out)
+{
+    pthread_mutex_lock(&retired_lock);
+    *out = retired;
+    pthread_mutex_unlock(&retired_lock);
+#ifdef USE_LATENCY
+    for (int a = 0; a < LAT_COUNT; a++)
+        for (int k = 0; k < 2; k++)
+            latency_hist_merge(&out->h[a][k], &thread_stats.h[a][k]);
+#endif
+}
+
+void latency_reset(void)
+{
+    pthread_mutex_lock(&retired_lock);
+    memset(&retired, 0, sizeof(retired));
+    pthread_mutex_unlock(&retired_lock);
+#ifdef USE_LATENCY
+    memset(&thread_stats, 0, sizeof(thread_stats));
+#endif
+}
+
+void latency_retire(void)
+{
+#ifdef USE_LATENCY
+    pthread_mutex_lock(&retired_lock);
+    for (int a = 0; a < LAT_COUNT; a++)
+        for (int k = 0; k < 2; k++)
+            latency_hist_merge(&retired.h[a][k], &thread_stats.h[a][k]);
+    pthread_mutex_unlock(&retired_lock);
+    memset(&thread_stats, 0, sizeof(thread_stats));
+#endif
+}
+
+const char *latency_api_name(LatencyApi api)
+{
+    return (api >= 0 && api < LAT_COUNT) ? API_NAMES[api] : "unknown";
+}
+
+/* ---- Export ---- */
+
+static const double PERCENTILES[] = { 50.0, 90.0, 99.0, 99.9 };
+#define N_PERCENTILES (int)(sizeof(PERCENTILES) / sizeof(PERCENTILES[0]))
+
+int latency_write_text(FILE *out, const LatencyStats *stats)
+{
+    fprintf(out, "%-22s %-4s %10s %9s %9s %9s %9s %9s %9s %9s\n",
+            "api (us)", "", "count", "min", "p50", "p90", "p99", "p99.9",
+            "max", "mean");
+    for (int a = 0; a < LAT_COUNT; a++) {
+        for (int k = 0; k < 2; k++) {
+            const LatencyHistogram *h = &stats->h[a][k];
+            if (h->total == 0) continue;
+            fprintf(out, "%-22s %-4s %10lu %9.2f", API_NAMES[a],
+                    k == LAT_MISS ? "miss" : "hit", h->total, h->min_ns / 1e3);
+            for (int p = 0; p < N_PERCENTILES; p++)
+                fprintf(out, " %9.2f", latency_percentile(h, PERCENTILES[p]) / 1e3);
+            fprintf(out, " %9.2f %9.2f\n", h->max_ns / 1e3, h->sum_ns / h->total / 1e3);
+        }
+    }
+    return ferror(out) ? -1 : 0;
+}
+
+int latency_write_json(FILE *out, const LatencyStats *stats)
+{
+    fprintf(out, "{\"unit\": \"ns\", \"histograms\": [");
+    int first = 1;
+    for (int a = 0; a < LAT_COUNT; a++) {
+        for (int k = 0; k < 2; k++) {
+            const LatencyHistogram *h = &stats->h[a][k];
+            if (h->total == 0) continue;
+            fprintf(out, "%s\n  {\"api\": \"%s\", \"outcome\": \"%s\", \"count\": %lu, "
+                    "\"min\": %llu, \"p50\": %llu, \"p90\": %llu, \"p99\": %llu, "
+                    "\"p999\": %llu, \"max\": %llu, \"mean\": %.1f, \"buckets\": [",
+                    first ? "" : ",", API_NAMES[a], k == LAT_MISS ? "miss" : "hit",
+                    h->total, h->min_ns,
+                    latency_percentile(h, 50.0), latency_percentile(h, 90.0),
+                    latency_percentile(h, 99.0), latency_percentile(h, 99.9),
+                    h->max_ns, h->sum_ns / h->total);
+            int first_bucket = 1;
+            for (int i = 0; i < LAT_BUCKETS; i++) {
+                if (!h->count[i]) continue;
+                fprintf(out, "%s[%llu, %lu]", first_bucket ? "" : ", ",
+                        bucket_high(i), h->count[i]);
+                first_bucket = 0;
+            }
+            fprintf(out, "]}");
+            first = 0;
+        }
+    }
+    fprintf(out, "\n]}\n");
+    return ferror(out) ? -1 : 0;
+}
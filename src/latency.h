@@ -0,0 +1,118 @@
+/*
+ * latency.h - Latency histograms and tracing hooks for the public API
+ *
+ * Built with USE_LATENCY (make LATENCY=1, in a clean build directory),
+ * gregorian_to_hindu(), gregorian_to_solar(), lunisolar_month_start(),
+ * sunrise_jd() and sunset_jd() time every call with the monotonic clock
+ * and add it to a log-linear histogram (types.h) for that API, split by
+ * whether one of the per-thread caches missed during the call:
+ *
+ *   gregorian_to_hindu:     new moon pair or previous day's tithi
+ *   gregorian_to_solar:     month start sankranti or year start
+ *   lunisolar_month_start:  month LRU
+ *
+ * Any cache missing during a call makes it a miss, including the caches
+ * behind the calls it makes (the new moon pair inside
+ * lunisolar_month_start()).  Nested timed calls such as sunrise_jd()
+ * inside gregorian_to_hindu() are recorded on their own as well.
+ * sunrise_jd() and sunset_jd() have no cache; all their calls are filed
+ * as misses.
+ *
+ * Histograms are per thread and need no locking; astro_close() merges a
+ * thread's histograms into a process-wide set, so latency_snapshot()
+ * sees the calling thread plus every thread that has finished.  Without
+ * USE_LATENCY the timing macros expand to nothing, snapshots are empty
+ * and the histogram helpers still work on caller-owned histograms.
+ */
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include "types.h"
+#include <stdio.h>
+
+#ifdef USE_LATENCY
+typedef struct {
+    unsigned long long start_ns;
+    int outer_miss;            /* caller's miss flag, restored at the end */
+} LatencyScope;
+
+extern THREAD_LOCAL int latency_miss_flag;
+
+void latency_begin(LatencyScope *scope);
+void latency_end(LatencyScope *scope, LatencyApi api);
+
+#define LATENCY_BEGIN(scope) LatencyScope scope; latency_begin(&scope)
+#define LATENCY_END(scope, api) latency_end(&(scope), (api))
+#define LATENCY_MISS() (latency_miss_flag = 1)
+#else
+#define LATENCY_BEGIN(scope) ((void)0)
+#define LATENCY_END(scope, api) ((void)0)
+#define LATENCY_MISS() ((void)0)
+#endif
+
+/* latency_enabled - 1 if this build times API calls, 0 otherwise. */
+int latency_enabled(void);
+
+/* latency_now_ns - Monotonic clock in nanoseconds (CLOCK_MONOTONIC). */
+unsigned long long latency_now_ns(void);
+
+/*
+ * latency_set_tracer - Call fn after every timed API call, on the thread
+ * that made it, with the start time and duration (ns) and whether it
+ * missed.  NULL removes the hook.  Set it before starting threads.
+ */
+void latency_set_tracer(LatencyTraceFn fn, void *ctx);
+
+/*
+ * latency_snapshot - Histograms of the calling thread plus those merged
+ * by threads that called astro_close().  LatencyStats is ~50 KB; keep it
+ * off small stacks.
+ */
+void latency_snapshot(LatencyStats *out);
+
+/*
+ * latency_reset - Clear the calling thread's histograms and the merged
+ * set.  Other running threads keep theirs.
+ */
+void latency_reset(void);
+
+/*
+ * latency_retire - Merge the calling thread's histograms into the
+ * process-wide set and clear them.  Called by astro_close().
+ */
+void latency_retire(void);
+
+/* latency_api_name - "gregorian_to_hindu", ..., or "unknown". */
+const char *latency_api_name(LatencyApi api);
+
+/* latency_hist_add - Record one value (ns). */
+void latency_hist_add(LatencyHistogram *h, unsigned long long ns);
+
+/* latency_hist_merge - Add the samples of src to dst. */
+void latency_hist_merge(LatencyHistogram *dst, const LatencyHistogram *src);
+
+/*
+ * latency_percentile - Value at or below which pct percent (0-100) of the
+ * samples fall: the highest value of the bucket holding that rank,
+ * capped at the largest sample.  0 for an empty histogram.
+ */
+unsigned long long latency_percentile(const LatencyHistogram *h, double pct);
+
+/*
+ * latency_write_text - Table of count, min, p50, p90, p99, p99.9, max and
+ * mean (us) for each non-empty histogram.
+ *
+ *   Returns: 0 on success, -1 on a write error.
+ */
+int latency_write_text(FILE *out, const LatencyStats *stats);
+
+/*
+ * latency_write_json - The same figures in ns as a JSON object, one
+ * histogram per line, each with its non-empty buckets as
+ * [highest_value, count] pairs so runs can be merged later.
+ *
+ *   Returns: 0 on success, -1 on a write error.
+ */
+int latency_write_json(FILE *out, const LatencyStats *stats);
+
+#endif /* LATENCY_H */
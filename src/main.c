@@ -4,6 +4,15 @@
 #include "panchang.h"
 #include "solar.h"
 #include "date_utils.h"
+#include "annotate.h"
+#include "bulk.h"
+#include "writer.h"
+#include "server.h"
+#include "shmcache.h"
+#include "snapshot.h"
+#include "callstats.h"
+#include "cache.h"
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -20,6 +29,38 @@ static void print_usage(const char *prog)
         "               (if omitted, shows lunisolar panchang)\n"
         "  -l LAT,LON   Location (default: New Delhi 28.6139,77.2090)\n"
         "  -u OFFSET    UTC offset in hours (default: 5.5)\n"
+        "  -a           Annotate timestamps read from stdin, one per line\n"
+        "               (Julian Day or ISO 8601, UTC unless zoned), writing\n"
+        "               CSV: input,tithi,paksha,tithi_name,rashi,rashi_name\n"
+        "  -S NAME      Share computed dates with other processes through the\n"
+        "               POSIX shared-memory cache NAME (e.g. /hindu-calendar,\n"
+        "               created if missing)\n"
+        "  -W FILE      Warm start: load computed new moons, sankrantis and\n"
+        "               sunrises from FILE if it exists, save them on exit\n"
+        "  -E           Print ephemeris evaluations per day (builds with\n"
+        "               CALL_STATS=1) and cache statistics to stderr on exit\n"
+        "  -K SPEC      Cache capacities per thread, NAME=N comma-separated;\n"
+        "               names: lunation, month, prev_day, solar_year,\n"
+        "               sankranti (e.g. lunation=2048,sankranti=8192)\n"
+        "\n"
+        "Bulk mode (any of -f, -t, -L, -c, -j, -o):\n"
+        "  -f DATE      First date YYYY-MM-DD (default: first day of -y/-m,\n"
+        "               or -d if given)\n"
+        "  -t DATE      Last date YYYY-MM-DD, inclusive (default: last day\n"
+        "               of -y/-m, or -d if given)\n"
+        "  -L FILE      Locations file, one NAME,LAT,LON,UTC_OFFSET[,ALT]\n"
+        "               per line (default: -l/-u, named LAT:LON)\n"
+        "  -c LIST      Calendars: lunisolar, tamil, bengali, odia,\n"
+        "               malayalam, solar or all, comma-separated\n"
+        "               (default: lunisolar, or the -s calendar)\n"
+        "  -j N         Worker threads (default: 1); output order does not\n"
+        "               depend on N\n"
+        "  -o FORMAT    csv (default), jsonl or bin (16-byte records)\n"
+        "\n"
+        "Daemon mode:\n"
+        "  -D ADDRESS   Serve line-delimited JSON requests (see server.h) on\n"
+        "               unix:PATH or tcp:HOST:PORT until SIGINT/SIGTERM;\n"
+        "               -j sets the worker threads\n"
         "  -h           Show this help\n",
         prog);
 }
@@ -104,6 +145,124 @@ static void print_solar_day(int year, int month, int day, const Location *loc,
            sd.rashi >= 1 && sd.rashi <= 12 ? RASHI_NAMES[sd.rashi] : "???");
 }
 
+/*
+ * Streaming annotation: one output row per input line.  Sorted input
+ * costs a comparison per row (see annotate.h); unparseable lines are
+ * reported on stderr and skipped.
+ */
+static int annotate_stream(FILE *in, FILE *out)
+{
+    Annotator an;
+    annotator_init(&an);
+
+    char line[256];
+    long line_num = 0, bad = 0;
+
+    fputs("input,tithi,paksha,tithi_name,rashi,rashi_name\n", out);
+    while (fgets(line, sizeof(line), in)) {
+        line_num++;
+        if (!strchr(line, '\n') && !feof(in)) {
+            /* Longer than any timestamp: drop the rest, report it once */
+            int c;
+            while ((c = fgetc(in)) != EOF && c != '\n')
+                ;
+            fprintf(stderr, "line %ld: line too long\n", line_num);
+            bad++;
+            continue;
+        }
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0') continue;
+
+        double jd;
+        if (!parse_timestamp(line, &jd)) {
+            fprintf(stderr, "line %ld: cannot parse '%s'\n", line_num, line);
+            bad++;
+            continue;
+        }
+
+        MomentAnnotation ma;
+        annotate_moment(&an, jd, &ma);
+        const char *tithi_name = (ma.tithi == 30) ? "Amavasya"
+                                                  : TITHI_NAMES[ma.paksha_tithi];
+        fprintf(out, "%s,%d,%s,%s,%d,%s\n", line, ma.tithi,
+                ma.paksha == SHUKLA_PAKSHA ? "Shukla" : "Krishna",
+                tithi_name, ma.rashi, RASHI_NAMES[ma.rashi]);
+    }
+    return (bad == 0) ? 0 : 1;
+}
+
+/* Snapshot file for -W, written back at exit */
+static const char *snapshot_path = NULL;
+
+static void save_snapshot(void)
+{
+    snapshot_save(snapshot_path);
+}
+
+/* Load the -W snapshot (a missing or unusable one means a cold start) */
+static void warm_start(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (f) {
+        fclose(f);
+        if (snapshot_load(path) < 0)
+            fprintf(stderr, "Starting with an empty snapshot\n");
+    }
+    snapshot_enable();
+    snapshot_path = path;
+    atexit(save_snapshot);
+}
+
+static void stop_server(int sig)
+{
+    (void)sig;
+    server_stop();
+}
+
+/* Serve until SIGINT/SIGTERM; returns the exit status */
+static int run_daemon(const char *address, int threads)
+{
+    int fd = server_listen(address);
+    if (fd < 0) return 1;
+
+    signal(SIGINT, stop_server);
+    signal(SIGTERM, stop_server);
+    ServerConfig cfg = { threads > 0 ? threads : 1, 64 };
+    ServerStats st;
+    fprintf(stderr, "Listening on %s with %d worker thread(s)\n", address, cfg.threads);
+    int rc = server_run(fd, &cfg, &st);
+    server_close(fd, address);
+    fprintf(stderr, "%ld connections, %ld requests (%ld malformed) in %ld batches\n",
+            st.connections, st.requests, st.errors, st.batches);
+    ShmCacheStats cs;
+    if (shmcache_stats(&cs) == 0)
+        fprintf(stderr, "Shared cache: %lu hits, %lu misses, %lu evictions (all processes)\n",
+                cs.hits, cs.misses, cs.evictions);
+    return rc == 0 ? 0 : 1;
+}
+
+/* Parse YYYY-MM-DD */
+static int parse_date(const char *str, int *y, int *m, int *d)
+{
+    char rest;
+    return sscanf(str, "%d-%d-%d%c", y, m, d, &rest) == 3 &&
+           *m >= 1 && *m <= 12 && *d >= 1 && *d <= days_in_greg_month(*y, *m);
+}
+
+/* -E: counters of this run (worker threads retire theirs at astro_close) */
+static void report_call_stats(long days)
+{
+    CallStats stats;
+    call_stats_snapshot(&stats);
+    fprintf(stderr, "\nEphemeris calls for %ld day%s:\n", days, days == 1 ? "" : "s");
+    call_stats_print(stderr, &stats, days);
+
+    CacheStats caches[CACHE_COUNT];
+    cache_stats(caches);
+    fprintf(stderr, "\nCaches:\n");
+    cache_print_stats(stderr, caches);
+}
+
 int main(int argc, char *argv[])
 {
     /* Defaults: current date, New Delhi */
@@ -114,7 +273,16 @@ int main(int argc, char *argv[])
     int day = 0;  /* 0 = show full month */
     Location loc = DEFAULT_LOCATION;
     int solar_mode = 0;
+    int annotate_mode = 0;
     SolarCalendarType solar_type = SOLAR_CAL_TAMIL;
+    int bulk_mode = 0;
+    int from_set = 0, to_set = 0;
+    BulkRequest bulk = {0};
+    const char *locations_file = NULL;
+    const char *daemon_address = NULL;
+    const char *cache_name = NULL;
+    const char *warm_path = NULL;
+    int call_stats_mode = 0;
 
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-y") == 0 && i + 1 < argc) {
@@ -139,6 +307,62 @@ int main(int argc, char *argv[])
             }
         } else if (strcmp(argv[i], "-u") == 0 && i + 1 < argc) {
             loc.utc_offset = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-a") == 0) {
+            annotate_mode = 1;
+        } else if ((strcmp(argv[i], "-f") == 0 || strcmp(argv[i], "-t") == 0) &&
+                   i + 1 < argc) {
+            int is_from = (argv[i][1] == 'f');
+            i++;
+            if (is_from ? !parse_date(argv[i], &bulk.y0, &bulk.m0, &bulk.d0)
+                        : !parse_date(argv[i], &bulk.y1, &bulk.m1, &bulk.d1)) {
+                fprintf(stderr, "Error: invalid date '%s'. Use YYYY-MM-DD\n", argv[i]);
+                return 1;
+            }
+            if (is_from) from_set = 1; else to_set = 1;
+            bulk_mode = 1;
+        } else if (strcmp(argv[i], "-L") == 0 && i + 1 < argc) {
+            locations_file = argv[++i];
+            bulk_mode = 1;
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            i++;
+            if (!parse_calendar_set(argv[i], &bulk.calendars)) {
+                fprintf(stderr, "Error: unknown calendar in '%s'\n", argv[i]);
+                fprintf(stderr, "Valid calendars: lunisolar, tamil, bengali, odia, "
+                                "malayalam, solar, all\n");
+                return 1;
+            }
+            bulk_mode = 1;
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            i++;
+            if (!parse_output_format(argv[i], &bulk.format)) {
+                fprintf(stderr, "Error: unknown output format '%s'\n", argv[i]);
+                fprintf(stderr, "Valid formats: csv, jsonl, bin\n");
+                return 1;
+            }
+            bulk_mode = 1;
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            bulk.threads = atoi(argv[++i]);
+            if (bulk.threads < 1) {
+                fprintf(stderr, "Error: -j needs a positive thread count\n");
+                return 1;
+            }
+            bulk_mode = 1;
+        } else if (strcmp(argv[i], "-W") == 0 && i + 1 < argc) {
+            warm_path = argv[++i];
+        } else if (strcmp(argv[i], "-S") == 0 && i + 1 < argc) {
+            cache_name = argv[++i];
+        } else if (strcmp(argv[i], "-E") == 0) {
+            call_stats_mode = 1;
+        } else if (strcmp(argv[i], "-K") == 0 && i + 1 < argc) {
+            i++;
+            if (cache_parse_capacities(argv[i]) != 0) {
+                fprintf(stderr, "Error: invalid cache capacities '%s'\n", argv[i]);
+                fprintf(stderr, "Use NAME=N,...; names: lunation, month, prev_day, "
+                                "solar_year, sankranti\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-D") == 0 && i + 1 < argc) {
+            daemon_address = argv[++i];
         } else if (strcmp(argv[i], "-h") == 0) {
             print_usage(argv[0]);
             return 0;
@@ -154,8 +378,93 @@ int main(int argc, char *argv[])
         return 1;
     }
 
+    if (cache_name && shmcache_open(cache_name, 0) != 0)
+        return 1;
+    if (warm_path)
+        warm_start(warm_path);
+
+    if (daemon_address)
+        return run_daemon(daemon_address, bulk.threads);
+
+    if (bulk_mode && !annotate_mode) {
+        NamedLocation single;
+        NamedLocation *locs = &single;
+        int n_locs = 1;
+
+        if (locations_file) {
+            FILE *f = fopen(locations_file, "r");
+            if (!f) {
+                fprintf(stderr, "Error: cannot open '%s'\n", locations_file);
+                return 1;
+            }
+            int rc = load_locations(f, &locs, &n_locs);
+            fclose(f);
+            if (rc != 0) {
+                if (rc > 0)
+                    fprintf(stderr, "Error: %s line %d: expected NAME,LAT,LON,UTC_OFFSET[,ALT]\n",
+                            locations_file, rc);
+                else
+                    fprintf(stderr, "Error: out of memory reading '%s'\n", locations_file);
+                return 1;
+            }
+            if (n_locs == 0) {
+                fprintf(stderr, "Error: no locations in '%s'\n", locations_file);
+                free(locs);
+                return 1;
+            }
+        } else {
+            single.loc = loc;
+            snprintf(single.name, sizeof(single.name), "%.4f:%.4f",
+                     loc.latitude, loc.longitude);
+        }
+
+        if (!from_set) {
+            bulk.y0 = year; bulk.m0 = month; bulk.d0 = (day > 0) ? day : 1;
+        }
+        if (!to_set) {
+            bulk.y1 = year; bulk.m1 = month;
+            bulk.d1 = (day > 0) ? day : days_in_greg_month(year, month);
+        }
+        if (bulk.calendars == 0)  /* CALSET_* solar bits follow SolarCalendarType */
+            bulk.calendars = solar_mode ? (CALSET_TAMIL << (int)solar_type) : CALSET_LUNISOLAR;
+        if (bulk.format == OUTPUT_BINARY && n_locs > WRITER_BINARY_MAX_LOCATIONS) {
+            fprintf(stderr, "Error: binary output holds at most %d locations, '%s' has %d\n",
+                    WRITER_BINARY_MAX_LOCATIONS, locations_file, n_locs);
+            free(locs);
+            return 1;
+        }
+        bulk.locations = locs;
+        bulk.n_locations = n_locs;
+
+        astro_init(NULL);
+        long rows = bulk_generate(&bulk, stdout);
+        astro_close();
+        if (locs != &single) free(locs);
+        if (rows < 0) {
+            fprintf(stderr, "Error: empty date range or out of memory\n");
+            return 1;
+        }
+        if (call_stats_mode) {
+            double jd_span = gregorian_to_jd(bulk.y1, bulk.m1, bulk.d1) -
+                             gregorian_to_jd(bulk.y0, bulk.m0, bulk.d0) + 1.0;
+            report_call_stats((long)jd_span * n_locs);
+        }
+        return 0;
+    }
+
     astro_init(NULL);
 
+    if (annotate_mode) {
+        int rc = annotate_stream(stdin, stdout);
+        astro_close();
+        if (call_stats_mode)
+            report_call_stats(0);
+        return rc;
+    }
+
+    /* Civil days shown, for -E */
+    long n_days = (day > 0) ? 1 : days_in_greg_month(year, month);
+
     if (solar_mode) {
         if (day > 0) {
             print_solar_day(year, month, day, &loc, solar_type);
@@ -187,5 +496,7 @@ int main(int argc, char *argv[])
     }
 
     astro_close();
+    if (call_stats_mode)
+        report_call_stats(n_days);
     return 0;
 }
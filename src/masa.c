@@ -1,7 +1,9 @@
 #include "masa.h"
 #include "tithi.h"
 #include "astro.h"
+#include "cache.h"
 #include "date_utils.h"
+#include "snapshot.h"
 #include <math.h>
 #include <stdio.h>
 
@@ -42,6 +44,7 @@ double new_moon_before(double jd_ut, int tithi_hint)
 {
     /* Approximate start: go back roughly tithi_hint days */
     double start = jd_ut - tithi_hint;
+    CALL_STAT(CS_NEW_MOON);
 
     /* Sample lunar phase at 9 points spanning (start-2) to (start+2).
      * 9 points with 0.5-day spacing covers a 4-day window, sufficient
@@ -62,6 +65,7 @@ double new_moon_after(double jd_ut, int tithi_hint)
 {
     /* Approximate start: go forward roughly (30 - tithi_hint) days */
     double start = jd_ut + (30 - tithi_hint);
+    CALL_STAT(CS_NEW_MOON);
 
     double x[9], y[9];
     for (int i = 0; i < 9; i++) {
@@ -77,6 +81,7 @@ double new_moon_after(double jd_ut, int tithi_hint)
 double full_moon_near(double jd_ut)
 {
     /* Same interpolation approach as new_moon, but targeting 180° */
+    CALL_STAT(CS_NEW_MOON);
     double x[9], y[9];
     for (int i = 0; i < 9; i++) {
         x[i] = -2.0 + i * 0.5;
@@ -98,10 +103,42 @@ int solar_rashi(double jd_ut)
     return rashi;
 }
 
-/* Static new moon cache: consecutive days usually bracket the same pair.
- * Extended with rashi cache to avoid redundant solar_rashi() calls. */
-static double cached_last_nm = 0, cached_next_nm = 0;
-static int cached_rashi_last = 0, cached_rashi_next = 0;
+/* New moon cache: consecutive days usually bracket the same pair.
+ * Extended with the rashis to avoid redundant solar_rashi() calls.
+ * New moons are location-independent; entries are keyed by lunation
+ * number counted from the mean new moon of 2000-01-06. */
+#define SYNODIC_MONTH 29.530588853
+#define NEW_MOON_EPOCH 2451550.09766
+
+typedef struct {
+    double last_nm, next_nm;
+    int rashi_last, rashi_next;
+} LunationEntry;
+
+static int lunation_match(const void *entry, const void *key)
+{
+    const LunationEntry *e = entry;
+    double jd = *(const double *)key;
+    return jd > e->last_nm && jd < e->next_nm;
+}
+
+/* A true new moon is within a day of the mean one, so the lunation
+ * holding jd is the one it falls in by mean motion, or a neighbour
+ * when jd is near a mean new moon. */
+static const LunationEntry *lunation_find(double jd)
+{
+    double x = (jd - NEW_MOON_EPOCH) / SYNODIC_MONTH;
+    long k = (long)floor(x);
+    const LunationEntry *e = cache_find(CACHE_LUNATION, sizeof(LunationEntry),
+                                        (unsigned)k, lunation_match, &jd);
+    if (!e && x - k < 0.05)
+        e = cache_find(CACHE_LUNATION, sizeof(LunationEntry), (unsigned)(k - 1),
+                       lunation_match, &jd);
+    if (!e && x - k > 0.95)
+        e = cache_find(CACHE_LUNATION, sizeof(LunationEntry), (unsigned)(k + 1),
+                       lunation_match, &jd);
+    return e;
+}
 
 static MasaInfo masa_compute(double jd_rise)
 {
@@ -113,20 +150,31 @@ static MasaInfo masa_compute(double jd_rise)
     /* Check cache: if jd_rise is between cached new moons, reuse them */
     double last_nm, next_nm;
     int rashi_last, rashi_next;
-    if (cached_last_nm > 0 && jd_rise > cached_last_nm && jd_rise < cached_next_nm) {
-        last_nm = cached_last_nm;
-        next_nm = cached_next_nm;
-        rashi_last = cached_rashi_last;
-        rashi_next = cached_rashi_next;
+    const LunationEntry *cached = lunation_find(jd_rise);
+    if (cached) {
+        CACHE_HIT(CACHE_LUNATION);
+        last_nm = cached->last_nm;
+        next_nm = cached->next_nm;
+        rashi_last = cached->rashi_last;
+        rashi_next = cached->rashi_next;
     } else {
-        last_nm = new_moon_before(jd_rise, t);
-        next_nm = new_moon_after(jd_rise, t);
-        rashi_last = solar_rashi(last_nm);
-        rashi_next = solar_rashi(next_nm);
-        cached_last_nm = last_nm;
-        cached_next_nm = next_nm;
-        cached_rashi_last = rashi_last;
-        cached_rashi_next = rashi_next;
+        CACHE_MISS(CACHE_LUNATION);
+        if (!snapshot_get_lunation(jd_rise, &last_nm, &next_nm, &rashi_last, &rashi_next)) {
+            last_nm = new_moon_before(jd_rise, t);
+            next_nm = new_moon_after(jd_rise, t);
+            rashi_last = solar_rashi(last_nm);
+            rashi_next = solar_rashi(next_nm);
+            snapshot_put_lunation(last_nm, next_nm, rashi_last, rashi_next);
+        }
+        long k = (long)floor((last_nm - NEW_MOON_EPOCH) / SYNODIC_MONTH + 0.5);
+        LunationEntry *e = cache_insert(CACHE_LUNATION, sizeof(LunationEntry),
+                                        (unsigned)k);
+        if (e) {
+            e->last_nm = last_nm;
+            e->next_nm = next_nm;
+            e->rashi_last = rashi_last;
+            e->rashi_next = rashi_next;
+        }
     }
 
     info.jd_start = last_nm;
@@ -189,63 +237,43 @@ int hindu_year_vikram(int saka_year)
 }
 
 /* ---------------------------------------------------------------------------
- * LRU cache for lunisolar_month_start / lunisolar_month_length
- * 32 entries covers ~2.5 years of months — more than enough for typical use.
+ * Cache for lunisolar_month_start / lunisolar_month_length
+ * The default 32 entries cover ~2.5 years of months (see cache.h).
  * --------------------------------------------------------------------------- */
-#define LRU_MONTH_SIZE 32
-
 typedef struct {
     MasaName masa;
     int saka_year;
     int is_adhika;
     LunisolarScheme scheme;
-    double jd_start;      /* cached month start (JD at 0h UT), 0 = empty */
+    Location loc;         /* civil days depend on sunrise at loc */
+    double jd_start;      /* cached month start (JD at 0h UT) */
     int length;           /* cached month length (29 or 30), 0 = not yet computed */
-    unsigned int lru_seq; /* LRU sequence counter */
 } LuniMonthCache;
 
-static LuniMonthCache lru_month[LRU_MONTH_SIZE];
-static unsigned int lru_month_seq = 0;
+static int month_match(const void *entry, const void *key)
+{
+    const LuniMonthCache *e = entry, *k = key;
+    return e->masa == k->masa && e->saka_year == k->saka_year &&
+           e->is_adhika == k->is_adhika && e->scheme == k->scheme &&
+           LOCATION_EQUAL(&e->loc, &k->loc);
+}
 
-/* Find cache entry matching (masa, saka_year, is_adhika, scheme), or NULL */
-static LuniMonthCache *lru_month_find(MasaName masa, int saka_year,
-                                       int is_adhika, LunisolarScheme scheme)
+static unsigned month_hash(MasaName masa, int saka_year, int is_adhika,
+                           LunisolarScheme scheme)
 {
-    for (int i = 0; i < LRU_MONTH_SIZE; i++) {
-        LuniMonthCache *e = &lru_month[i];
-        if (e->jd_start != 0 &&
-            e->masa == masa && e->saka_year == saka_year &&
-            e->is_adhika == is_adhika && e->scheme == scheme) {
-            e->lru_seq = ++lru_month_seq;
-            return e;
-        }
-    }
-    return NULL;
+    return (((unsigned)saka_year * 13 + (unsigned)masa) * 2 + (unsigned)is_adhika) * 2 +
+           (unsigned)scheme;
 }
 
-/* Insert/update entry, evicting lowest lru_seq on full cache */
-static LuniMonthCache *lru_month_insert(MasaName masa, int saka_year,
-                                         int is_adhika, LunisolarScheme scheme)
+/* Find cache entry matching (masa, saka_year, is_adhika, scheme, loc), or NULL */
+static LuniMonthCache *month_cache_find(MasaName masa, int saka_year,
+                                        int is_adhika, LunisolarScheme scheme,
+                                        const Location *loc)
 {
-    /* Find empty slot or LRU victim */
-    LuniMonthCache *victim = &lru_month[0];
-    for (int i = 0; i < LRU_MONTH_SIZE; i++) {
-        LuniMonthCache *e = &lru_month[i];
-        if (e->jd_start == 0) {
-            victim = e;
-            break;
-        }
-        if (e->lru_seq < victim->lru_seq)
-            victim = e;
-    }
-    victim->masa = masa;
-    victim->saka_year = saka_year;
-    victim->is_adhika = is_adhika;
-    victim->scheme = scheme;
-    victim->jd_start = 0;
-    victim->length = 0;
-    victim->lru_seq = ++lru_month_seq;
-    return victim;
+    LuniMonthCache key = { masa, saka_year, is_adhika, scheme, *loc, 0, 0 };
+    return cache_find(CACHE_MONTH, sizeof(LuniMonthCache),
+                      month_hash(masa, saka_year, is_adhika, scheme),
+                      month_match, &key);
 }
 
 /* Amanta month start — find first civil day after new moon */
@@ -320,13 +348,16 @@ static double amanta_month_start(MasaName masa, int saka_year, int is_adhika,
     return 0;
 }
 
-double lunisolar_month_start(MasaName masa, int saka_year, int is_adhika,
-                             LunisolarScheme scheme, const Location *loc)
+static double month_start_compute(MasaName masa, int saka_year, int is_adhika,
+                                  LunisolarScheme scheme, const Location *loc)
 {
     /* Check cache */
-    LuniMonthCache *cached = lru_month_find(masa, saka_year, is_adhika, scheme);
-    if (cached && cached->jd_start > 0)
+    LuniMonthCache *cached = month_cache_find(masa, saka_year, is_adhika, scheme, loc);
+    if (cached) {
+        CACHE_HIT(CACHE_MONTH);
         return cached->jd_start;
+    }
+    CACHE_MISS(CACHE_MONTH);
 
     double result;
 
@@ -376,21 +407,45 @@ double lunisolar_month_start(MasaName masa, int saka_year, int is_adhika,
 
 cache_and_return:
     {
-        LuniMonthCache *e = lru_month_insert(masa, saka_year, is_adhika, scheme);
-        e->jd_start = result;
+        LuniMonthCache *e = cache_insert(CACHE_MONTH, sizeof(LuniMonthCache),
+                                         month_hash(masa, saka_year, is_adhika, scheme));
+        if (e) {
+            e->masa = masa;
+            e->saka_year = saka_year;
+            e->is_adhika = is_adhika;
+            e->scheme = scheme;
+            e->loc = *loc;
+            e->jd_start = result;
+        }
     }
     return result;
 }
 
+double lunisolar_month_start(MasaName masa, int saka_year, int is_adhika,
+                             LunisolarScheme scheme, const Location *loc)
+{
+    LATENCY_BEGIN(lat);
+    double jd = month_start_compute(masa, saka_year, is_adhika, scheme, loc);
+    LATENCY_END(lat, LAT_LUNISOLAR_MONTH_START);
+    return jd;
+}
+
 int lunisolar_month_length(MasaName masa, int saka_year, int is_adhika,
                            LunisolarScheme scheme, const Location *loc)
 {
-    /* Check cache for pre-computed length */
-    LuniMonthCache *cached = lru_month_find(masa, saka_year, is_adhika, scheme);
-    if (cached && cached->length > 0)
+    /* Check cache for pre-computed length; one hit or miss per call */
+    LuniMonthCache *cached = month_cache_find(masa, saka_year, is_adhika, scheme, loc);
+    double jd_start;
+    if (cached && cached->length > 0) {
+        CACHE_HIT(CACHE_MONTH);
         return cached->length;
-
-    double jd_start = lunisolar_month_start(masa, saka_year, is_adhika, scheme, loc);
+    } else if (cached) {
+        CACHE_MISS(CACHE_MONTH);
+        jd_start = cached->jd_start;
+    } else {
+        /* Not cached at all: lunisolar_month_start() records the miss */
+        jd_start = lunisolar_month_start(masa, saka_year, is_adhika, scheme, loc);
+    }
     if (jd_start == 0) return 0;
 
     int length = 0;
@@ -425,7 +480,7 @@ int lunisolar_month_length(MasaName masa, int saka_year, int is_adhika,
 
     /* Store length in cache */
     if (length > 0) {
-        LuniMonthCache *e = lru_month_find(masa, saka_year, is_adhika, scheme);
+        LuniMonthCache *e = month_cache_find(masa, saka_year, is_adhika, scheme, loc);
         if (e)
             e->length = length;
     }
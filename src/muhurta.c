@@ -0,0 +1,113 @@
+#include "muhurta.h"
+#include "astro.h"
+#include "date_utils.h"
+#include <string.h>
+
+/* Daytime eighth (1-8) holding each window, indexed Monday..Sunday */
+static const int RAHU_SEGMENT[7]      = { 2, 7, 5, 6, 4, 3, 8 };
+static const int YAMAGANDA_SEGMENT[7] = { 4, 3, 2, 1, 7, 6, 5 };
+static const int GULIKA_SEGMENT[7]    = { 6, 5, 4, 3, 2, 1, 7 };
+
+/* First day choghadiya (ruled by the weekday lord), indexed Monday..Sunday */
+static const Choghadiya DAY_FIRST_CHOGHADIYA[7] = {
+    CHOGHADIYA_AMRIT,   /* Monday    - Moon */
+    CHOGHADIYA_ROG,     /* Tuesday   - Mars */
+    CHOGHADIYA_LABH,    /* Wednesday - Mercury */
+    CHOGHADIYA_SHUBH,   /* Thursday  - Jupiter */
+    CHOGHADIYA_CHAR,    /* Friday    - Venus */
+    CHOGHADIYA_KAAL,    /* Saturday  - Saturn */
+    CHOGHADIYA_UDVEG,   /* Sunday    - Sun */
+};
+
+static const char *CHOGHADIYA_NAMES[] = {
+    "Udveg", "Char", "Labh", "Amrit", "Kaal", "Shubh", "Rog"
+};
+
+const char *choghadiya_name(Choghadiya c)
+{
+    if (c < CHOGHADIYA_UDVEG || c > CHOGHADIYA_ROG) return "???";
+    return CHOGHADIYA_NAMES[c];
+}
+
+/* Window for daytime eighth `segment` (1-8) */
+static TimeWindow eighth(double jd_start, double part, int segment)
+{
+    TimeWindow w;
+    w.jd_start = jd_start + (segment - 1) * part;
+    w.jd_end = w.jd_start + part;
+    return w;
+}
+
+void muhurta_from_rise_set(double jd_sunrise, double jd_sunset,
+                           double jd_next_sunrise, int weekday,
+                           MuhurtaDay *out)
+{
+    out->weekday = weekday;
+    out->jd_sunrise = jd_sunrise;
+    out->jd_sunset = jd_sunset;
+    out->jd_next_sunrise = jd_next_sunrise;
+
+    memset(&out->rahu_kalam, 0, sizeof(TimeWindow));
+    memset(&out->yamaganda, 0, sizeof(TimeWindow));
+    memset(&out->gulika_kalam, 0, sizeof(TimeWindow));
+    memset(&out->abhijit, 0, sizeof(TimeWindow));
+    memset(out->day_choghadiya, 0, sizeof(out->day_choghadiya));
+    memset(out->night_choghadiya, 0, sizeof(out->night_choghadiya));
+
+    out->is_valid = (jd_sunrise > 0 && jd_sunset > jd_sunrise &&
+                     jd_next_sunrise > jd_sunset &&
+                     weekday >= 0 && weekday <= 6);
+    if (!out->is_valid) return;
+
+    double day_part = (jd_sunset - jd_sunrise) / 8.0;
+    double night_part = (jd_next_sunrise - jd_sunset) / 8.0;
+
+    out->rahu_kalam = eighth(jd_sunrise, day_part, RAHU_SEGMENT[weekday]);
+    out->yamaganda = eighth(jd_sunrise, day_part, YAMAGANDA_SEGMENT[weekday]);
+    out->gulika_kalam = eighth(jd_sunrise, day_part, GULIKA_SEGMENT[weekday]);
+
+    /* Abhijit = 8th of 15 daytime muhurtas */
+    double muhurta = (jd_sunset - jd_sunrise) / 15.0;
+    out->abhijit.jd_start = jd_sunrise + 7.0 * muhurta;
+    out->abhijit.jd_end = jd_sunrise + 8.0 * muhurta;
+
+    /* Day choghadiyas step +1 through the hora order; night choghadiyas
+     * start 5 places on from the day's first and step +5 (i.e. -2). */
+    int first = (int)DAY_FIRST_CHOGHADIYA[weekday];
+    for (int i = 0; i < 8; i++) {
+        out->day_choghadiya[i].name = (Choghadiya)((first + i) % 7);
+        out->day_choghadiya[i].window = eighth(jd_sunrise, day_part, i + 1);
+
+        out->night_choghadiya[i].name = (Choghadiya)((first + 5 + 5 * i) % 7);
+        out->night_choghadiya[i].window = eighth(jd_sunset, night_part, i + 1);
+    }
+}
+
+MuhurtaDay muhurta_for_date(int year, int month, int day, const Location *loc)
+{
+    MuhurtaDay md;
+    generate_muhurta_range(year, month, day, 1, loc, &md);
+    return md;
+}
+
+void generate_muhurta_range(int year, int month, int day, int ndays,
+                            const Location *loc, MuhurtaDay *days)
+{
+    if (ndays <= 0) return;
+
+    double jd = gregorian_to_jd(year, month, day);
+    double jd_rise = sunrise_jd(jd, loc);
+
+    for (int i = 0; i < ndays; i++, jd += 1.0) {
+        MuhurtaDay *md = &days[i];
+        jd_to_gregorian(jd, &md->greg_year, &md->greg_month, &md->greg_day);
+
+        /* Tomorrow's sunrise closes tonight and opens the next entry */
+        double jd_set = sunset_jd(jd, loc);
+        double jd_next_rise = sunrise_jd(jd + 1.0, loc);
+
+        muhurta_from_rise_set(jd_rise, jd_set, jd_next_rise,
+                              day_of_week(jd), md);
+        jd_rise = jd_next_rise;
+    }
+}
@@ -0,0 +1,72 @@
+/*
+ * muhurta.h - Daily time divisions (Rahu Kalam, Yamaganda, Gulika,
+ *             Abhijit, Choghadiya)
+ *
+ * Every window is a fixed fraction of the daytime (sunrise -> sunset)
+ * or nighttime (sunset -> next sunrise) of a civil day, so the only
+ * astronomy needed is three rise/set values per day.  The range API
+ * computes them in a single pass: day N's "next sunrise" is day N+1's
+ * sunrise, so a range of n days costs n + 1 sunrises and n sunsets.
+ *
+ * Weekday rules (segment 1-8 of daytime, Monday..Sunday):
+ *   Rahu Kalam:   2, 7, 5, 6, 4, 3, 8
+ *   Yamaganda:    4, 3, 2, 1, 7, 6, 5
+ *   Gulika Kalam: 6, 5, 4, 3, 2, 1, 7
+ *
+ * The weekday (vara) is that of the civil date; the Hindu day runs from
+ * its sunrise to the next sunrise, so night choghadiyas belong to the
+ * same weekday.
+ */
+#ifndef MUHURTA_H
+#define MUHURTA_H
+
+#include "types.h"
+
+/*
+ * muhurta_from_rise_set - Fill time divisions from known rise/set times.
+ *
+ *   jd_sunrise:      JD (UT) of sunrise on the civil day.
+ *   jd_sunset:       JD (UT) of sunset on the civil day.
+ *   jd_next_sunrise: JD (UT) of sunrise on the following civil day.
+ *   weekday:         0 = Monday .. 6 = Sunday (as from day_of_week()).
+ *   out:             Output; the Gregorian date fields are left untouched.
+ *
+ * Pure arithmetic, no ephemeris calls.  Use this when sunrise/sunset are
+ * already at hand (e.g. PanchangDay.jd_sunrise).  If any JD is <= 0,
+ * out->is_valid is set to 0 and the windows are zeroed.
+ */
+void muhurta_from_rise_set(double jd_sunrise, double jd_sunset,
+                           double jd_next_sunrise, int weekday,
+                           MuhurtaDay *out);
+
+/*
+ * muhurta_for_date - Time divisions for a single civil day.
+ *
+ *   year, month, day: Gregorian date.
+ *   loc: Observer location.
+ *   Returns: MuhurtaDay (3 rise/set computations).
+ */
+MuhurtaDay muhurta_for_date(int year, int month, int day, const Location *loc);
+
+/*
+ * generate_muhurta_range - Time divisions for consecutive civil days.
+ *
+ *   year, month, day: First Gregorian date of the range.
+ *   ndays: Number of consecutive days to fill.
+ *   loc:   Observer location.
+ *   days:  Output array with space for ndays entries.
+ *
+ * Computes ndays + 1 sunrises and ndays sunsets in one pass.
+ */
+void generate_muhurta_range(int year, int month, int day, int ndays,
+                            const Location *loc, MuhurtaDay *days);
+
+/*
+ * choghadiya_name - English transliteration of a choghadiya name.
+ *
+ *   c: Choghadiya value.
+ *   Returns: "Udveg", "Char", "Labh", "Amrit", "Kaal", "Shubh" or "Rog".
+ */
+const char *choghadiya_name(Choghadiya c);
+
+#endif /* MUHURTA_H */
@@ -2,7 +2,10 @@
 #include "tithi.h"
 #include "masa.h"
 #include "astro.h"
+#include "cache.h"
 #include "date_utils.h"
+#include "shmcache.h"
+#include "snapshot.h"
 #include <stdio.h>
 #include <math.h>
 
@@ -17,19 +20,52 @@ static int days_in_month(int year, int month)
     return mdays[month];
 }
 
-/* Cache for previous day's sunrise and tithi, avoiding redundant
- * sunrise_jd() + tithi_num_at_jd() when iterating consecutive days. */
-static double cached_jd_base = 0;     /* JD at 0h of cached day */
-static double cached_jd_rise = 0;     /* sunrise JD of cached day */
-static int    cached_tithi = 0;       /* tithi at cached sunrise */
+/* Sunrise of the civil day starting at jd, from the warm-start store
+ * when it has it */
+static double day_sunrise(double jd, const Location *loc)
+{
+    double jd_rise;
+    if (!snapshot_get_sunrise(jd, loc, &jd_rise)) {
+        jd_rise = sunrise_jd(jd, loc);
+        snapshot_put_sunrise(jd, loc, jd_rise);
+    }
+    return jd_rise;
+}
 
-HinduDate gregorian_to_hindu(int year, int month, int day, const Location *loc)
+/* Cache of a day's sunrise and tithi, avoiding redundant sunrise_jd()
+ * + tithi_num_at_jd() for the previous day when iterating consecutive
+ * days (only for the location it was filled for). */
+typedef struct {
+    double   jd_base;   /* JD at 0h of cached day */
+    double   jd_rise;   /* sunrise JD of cached day */
+    int      tithi;     /* tithi at cached sunrise */
+    Location loc;       /* location of cached day */
+} PrevDayEntry;
+
+static int prev_day_match(const void *entry, const void *key)
+{
+    const PrevDayEntry *e = entry, *k = key;
+    return fabs(e->jd_base - k->jd_base) < 0.01 && LOCATION_EQUAL(&e->loc, &k->loc);
+}
+
+static PrevDayEntry *prev_day_find(double jd, const Location *loc)
+{
+    PrevDayEntry key = { jd, 0, 0, *loc };
+    return cache_find(CACHE_PREV_DAY, sizeof(PrevDayEntry), (unsigned)(long)floor(jd),
+                      prev_day_match, &key);
+}
+
+static HinduDate hindu_date_compute(int year, int month, int day, const Location *loc)
 {
     HinduDate hd = {0};
 
+    /* Another process may already have computed this day */
+    if (shmcache_get_hindu(year, month, day, loc, &hd))
+        return hd;
+
     /* Compute sunrise once for today */
     double jd = gregorian_to_jd(year, month, day);
-    double jd_rise = sunrise_jd(jd, loc);
+    double jd_rise = day_sunrise(jd, loc);
     if (jd_rise <= 0) {
         jd_rise = jd + 0.5 - loc->utc_offset / 24.0;
     }
@@ -51,10 +87,13 @@ HinduDate gregorian_to_hindu(int year, int month, int day, const Location *loc)
      * Use cache to avoid redundant sunrise computation on consecutive days. */
     int t_prev;
     double jd_prev = jd - 1.0;
-    if (cached_jd_base > 0 && fabs(jd_prev - cached_jd_base) < 0.01) {
-        t_prev = cached_tithi;
+    const PrevDayEntry *cached = prev_day_find(jd_prev, loc);
+    if (cached) {
+        CACHE_HIT(CACHE_PREV_DAY);
+        t_prev = cached->tithi;
     } else {
-        double jd_rise_prev = sunrise_jd(jd_prev, loc);
+        CACHE_MISS(CACHE_PREV_DAY);
+        double jd_rise_prev = day_sunrise(jd_prev, loc);
         if (jd_rise_prev <= 0) {
             jd_rise_prev = jd_prev + 0.5 - loc->utc_offset / 24.0;
         }
@@ -63,13 +102,105 @@ HinduDate gregorian_to_hindu(int year, int month, int day, const Location *loc)
     hd.is_adhika_tithi = (t == t_prev) ? 1 : 0;
 
     /* Save today's data for tomorrow's adhika check */
-    cached_jd_base = jd;
-    cached_jd_rise = jd_rise;
-    cached_tithi = t;
+    if (!prev_day_find(jd, loc)) {
+        PrevDayEntry *e = cache_insert(CACHE_PREV_DAY, sizeof(PrevDayEntry),
+                                       (unsigned)(long)floor(jd));
+        if (e) {
+            e->jd_base = jd;
+            e->jd_rise = jd_rise;
+            e->tithi = t;
+            e->loc = *loc;
+        }
+    }
+
+    shmcache_put_hindu(year, month, day, loc, &hd);
+    return hd;
+}
 
+HinduDate gregorian_to_hindu(int year, int month, int day, const Location *loc)
+{
+    LATENCY_BEGIN(lat);
+    HinduDate hd = hindu_date_compute(year, month, day, loc);
+    LATENCY_END(lat, LAT_GREGORIAN_TO_HINDU);
     return hd;
 }
 
+/* Sunrise tithi of the civil day jd_ref + offset, unwrapped to an ordinal
+ * counted from the lunation whose first civil day is jd_ref (so the
+ * previous lunation's tithis are <= 0 and the next one's > 30). */
+static int sunrise_tithi_ordinal(double jd_ref, int offset, const Location *loc)
+{
+    double jd = jd_ref + offset;
+    double jd_rise = day_sunrise(jd, loc);
+    if (jd_rise <= 0) {
+        jd_rise = jd + 0.5 - loc->utc_offset / 24.0;
+    }
+    int t = tithi_num_at_jd(jd_rise);
+
+    /* Sunrise tithi stays within a few of offset + 1 */
+    int expect = offset + 1;
+    while (t - expect > 15) t -= 30;
+    while (expect - t > 15) t += 30;
+    return t;
+}
+
+HinduDateMatch hindu_to_gregorian(const HinduDate *hd, LunisolarScheme scheme,
+                                  const Location *loc,
+                                  int *year, int *month, int *day)
+{
+    *year = *month = *day = 0;
+
+    if (hd->tithi < 1 || hd->tithi > 15 || hd->masa < CHAITRA || hd->masa > PHALGUNA)
+        return HINDU_MATCH_NONE;
+
+    /* Target as an ordinal within the Amanta lunation of hd->masa.
+     * Purnimanta Krishna paksha precedes that lunation (ordinals -14..0). */
+    int target = (hd->paksha == KRISHNA_PAKSHA) ? hd->tithi + 15 : hd->tithi;
+    if (scheme == LUNISOLAR_PURNIMANTA && hd->paksha == KRISHNA_PAKSHA)
+        target -= 30;
+
+    double jd_month = lunisolar_month_start(hd->masa, hd->year_saka,
+                                            hd->is_adhika_masa,
+                                            LUNISOLAR_AMANTA, loc);
+    if (jd_month == 0)
+        return HINDU_MATCH_NONE;
+
+    /* Find the first day whose sunrise ordinal is >= target: jump by the
+     * remaining tithi count (kshaya tithis may overshoot), then back up. */
+    int offset = target - 1;
+    int ord = sunrise_tithi_ordinal(jd_month, offset, loc);
+    while (ord < target) {
+        offset += target - ord;
+        ord = sunrise_tithi_ordinal(jd_month, offset, loc);
+    }
+    for (;;) {
+        int ord_prev = sunrise_tithi_ordinal(jd_month, offset - 1, loc);
+        if (ord_prev < target) break;
+        offset--;
+        ord = ord_prev;
+    }
+
+    HinduDateMatch match;
+    if (ord > target) {
+        /* No sunrise inside the tithi: it runs during the previous day */
+        if (hd->is_adhika_tithi)
+            return HINDU_MATCH_NONE;
+        offset--;
+        match = HINDU_MATCH_KSHAYA_TITHI;
+    } else if (sunrise_tithi_ordinal(jd_month, offset + 1, loc) == target) {
+        if (hd->is_adhika_tithi)
+            offset++;
+        match = HINDU_MATCH_ADHIKA_TITHI;
+    } else {
+        if (hd->is_adhika_tithi)
+            return HINDU_MATCH_NONE;
+        match = HINDU_MATCH_EXACT;
+    }
+
+    jd_to_gregorian(jd_month + offset, year, month, day);
+    return match;
+}
+
 void generate_month_panchang(int year, int month, const Location *loc,
                              PanchangDay *days, int *count)
 {
@@ -83,7 +214,7 @@ void generate_month_panchang(int year, int month, const Location *loc,
         pd->greg_day = d;
 
         double jd = gregorian_to_jd(year, month, d);
-        pd->jd_sunrise = sunrise_jd(jd, loc);
+        pd->jd_sunrise = day_sunrise(jd, loc);
 
         pd->tithi = tithi_at_sunrise(year, month, d, loc);
         pd->hindu_date = gregorian_to_hindu(year, month, d, loc);
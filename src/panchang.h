@@ -25,6 +25,30 @@
  */
 HinduDate gregorian_to_hindu(int year, int month, int day, const Location *loc);
 
+/*
+ * hindu_to_gregorian - Convert a Hindu date to a Gregorian date.
+ *
+ *   hd:     Hindu date (year_saka, masa, is_adhika_masa, paksha, tithi,
+ *           is_adhika_tithi; year_vikram is ignored).
+ *   scheme: Month convention hd->masa is expressed in.  For Purnimanta,
+ *           a Krishna paksha date belongs to the Amanta month before.
+ *   loc:    Observer location.
+ *   year, month, day: Output Gregorian date (0 if no match).
+ *   Returns: HinduDateMatch describing how the date maps to civil days.
+ *
+ * Inverse of gregorian_to_hindu(): for any day it returns, feeding the
+ * result back gives that day with HINDU_MATCH_EXACT or
+ * HINDU_MATCH_ADHIKA_TITHI.  A kshaya tithi, which gregorian_to_hindu()
+ * never returns, maps to the day whose sunrise precedes it.
+ *
+ * Jumps to the month with lunisolar_month_start() (LRU cached), then to
+ * the day from the mean tithi length, correcting with the sunrise tithi
+ * sequence — typically 3-4 sunrise evaluations.
+ */
+HinduDateMatch hindu_to_gregorian(const HinduDate *hd, LunisolarScheme scheme,
+                                  const Location *loc,
+                                  int *year, int *month, int *day);
+
 /*
  * generate_month_panchang - Generate panchang for a full Gregorian month.
  *
@@ -0,0 +1,230 @@
+#include "scan.h"
+#include "events.h"
+#include "astro.h"
+#include "date_utils.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Days per work chunk; fixed so the result does not depend on threads */
+#define SCAN_CHUNK_DAYS 365.25
+
+/* ---- Ranking ---- */
+
+/* 1 if a ranks before (is closer to the boundary than) b */
+static int hit_before(const ScanHit *a, const ScanHit *b)
+{
+    double da = fabs(a->metric), db = fabs(b->metric);
+    if (da != db) return da < db;
+    if (a->ev.jd != b->ev.jd) return a->ev.jd < b->ev.jd;
+    return a->ev.type < b->ev.type;
+}
+
+static int cmp_hits(const void *a, const void *b)
+{
+    if (hit_before(a, b)) return -1;
+    if (hit_before(b, a)) return 1;
+    return 0;
+}
+
+/* ---- Bounded heap: root is the worst of the kept hits ---- */
+
+typedef struct {
+    ScanHit *hits;
+    int n, cap;
+    long n_events, n_matched;
+} HitHeap;
+
+static void heap_swap(ScanHit *a, ScanHit *b)
+{
+    ScanHit t = *a;
+    *a = *b;
+    *b = t;
+}
+
+static void heap_sift_down(HitHeap *h, int i)
+{
+    for (;;) {
+        int l = 2 * i + 1, r = l + 1, worst = i;
+        if (l < h->n && hit_before(&h->hits[worst], &h->hits[l])) worst = l;
+        if (r < h->n && hit_before(&h->hits[worst], &h->hits[r])) worst = r;
+        if (worst == i) return;
+        heap_swap(&h->hits[i], &h->hits[worst]);
+        i = worst;
+    }
+}
+
+static void heap_push(HitHeap *h, const ScanHit *hit)
+{
+    if (h->n < h->cap) {
+        int i = h->n++;
+        h->hits[i] = *hit;
+        while (i > 0) {
+            int parent = (i - 1) / 2;
+            if (!hit_before(&h->hits[parent], &h->hits[i])) break;
+            heap_swap(&h->hits[parent], &h->hits[i]);
+            i = parent;
+        }
+    } else if (hit_before(hit, &h->hits[0])) {
+        h->hits[0] = *hit;
+        heap_sift_down(h, 0);
+    }
+}
+
+/* ---- Chunks ---- */
+
+static void scan_chunk(const ScanRequest *req, int chunk, EventCursor *cur,
+                       HitHeap *heap)
+{
+    double lo = req->jd_start + chunk * SCAN_CHUNK_DAYS;
+    double hi = lo + SCAN_CHUNK_DAYS;
+    if (hi > req->jd_end) hi = req->jd_end;
+
+    AstroEvent ev;
+    double jd = lo;
+    while (next_event(cur, jd, req->event_mask, &ev) && ev.jd <= hi) {
+        ScanHit hit;
+        hit.ev = ev;
+        hit.metric = 0.0;
+        hit.row[0] = '\0';
+        heap->n_events++;
+        if (req->metric(&ev, &req->loc, req->ctx, &hit)) {
+            heap->n_matched++;
+            heap_push(heap, &hit);
+        }
+        jd = ev.jd;
+    }
+}
+
+typedef struct {
+    const ScanRequest *req;
+    int n_chunks;
+    int next_chunk;        /* claimed with __atomic_fetch_add */
+} ScanJob;
+
+typedef struct {
+    ScanJob *job;
+    HitHeap heap;
+} ScanWorker;
+
+static void scan_chunks(ScanJob *job, HitHeap *heap)
+{
+    EventCursor cur;
+    event_cursor_init(&cur, &job->req->loc);
+    for (;;) {
+        int chunk = __atomic_fetch_add(&job->next_chunk, 1, __ATOMIC_RELAXED);
+        if (chunk >= job->n_chunks) break;
+        scan_chunk(job->req, chunk, &cur, heap);
+    }
+}
+
+static void *scan_worker(void *arg)
+{
+    ScanWorker *w = arg;
+
+    /* Backend state such as the sidereal mode may be per thread */
+    astro_init(NULL);
+    scan_chunks(w->job, &w->heap);
+    astro_close();
+    return NULL;
+}
+
+int scan_run(const ScanRequest *req, ScanResult *res)
+{
+    memset(res, 0, sizeof(*res));
+    if (!req->metric || !(req->event_mask & EVENT_ALL) || req->top_n < 1 ||
+        !(req->jd_end > req->jd_start))
+        return 0;
+
+    ScanJob job;
+    job.req = req;
+    job.n_chunks = (int)ceil((req->jd_end - req->jd_start) / SCAN_CHUNK_DAYS);
+    job.next_chunk = 0;
+
+    int n_threads = req->threads > 1 ? req->threads : 1;
+    if (n_threads > job.n_chunks) n_threads = job.n_chunks;
+
+    ScanWorker *workers = calloc(n_threads, sizeof(ScanWorker));
+    pthread_t *tids = malloc(n_threads * sizeof(pthread_t));
+    ScanHit *pool = malloc((size_t)n_threads * req->top_n * sizeof(ScanHit));
+    if (!workers || !tids || !pool) {
+        free(workers);
+        free(tids);
+        free(pool);
+        return 0;
+    }
+    for (int t = 0; t < n_threads; t++) {
+        workers[t].job = &job;
+        workers[t].heap.hits = pool + (size_t)t * req->top_n;
+        workers[t].heap.cap = req->top_n;
+    }
+
+    int failed = 0;
+    if (req->threads <= 1) {
+        scan_chunks(&job, &workers[0].heap);
+    } else {
+        int started = 0;
+        for (; started < n_threads; started++)
+            if (pthread_create(&tids[started], NULL, scan_worker, &workers[started]) != 0)
+                break;
+        /* Threads that did start still cover every chunk */
+        failed = (started == 0);
+        for (int t = 0; t < started; t++)
+            pthread_join(tids[t], NULL);
+    }
+
+    /* Gather the per-thread heaps at the front of the pool and rank them */
+    int n = 0;
+    for (int t = 0; t < n_threads; t++) {
+        HitHeap *h = &workers[t].heap;
+        memmove(pool + n, h->hits, h->n * sizeof(ScanHit));
+        n += h->n;
+        res->n_events += h->n_events;
+        res->n_matched += h->n_matched;
+    }
+    qsort(pool, n, sizeof(ScanHit), cmp_hits);
+
+    free(workers);
+    free(tids);
+    if (failed) {
+        free(pool);
+        memset(res, 0, sizeof(*res));
+        return 0;
+    }
+    res->hits = pool;
+    res->n_hits = n < req->top_n ? n : req->top_n;
+    return 1;
+}
+
+void scan_free(ScanResult *res)
+{
+    free(res->hits);
+    memset(res, 0, sizeof(*res));
+}
+
+int scan_write_csv(FILE *out, const ScanRequest *req, const ScanResult *res,
+                   const char *columns)
+{
+    int has_cols = columns && columns[0];
+    fprintf(out, "event,value,jd_ut,local_time,metric%s%s\n",
+            has_cols ? "," : "", has_cols ? columns : "");
+
+    for (int i = 0; i < res->n_hits; i++) {
+        const ScanHit *h = &res->hits[i];
+        double local = h->ev.jd + req->loc.utc_offset / 24.0 + 0.5;
+        double day = floor(local);
+        long secs = lround((local - day) * 86400.0);
+        if (secs >= 86400) {
+            day += 1.0;
+            secs -= 86400;
+        }
+        int y, m, d;
+        jd_to_gregorian(day, &y, &m, &d);
+        fprintf(out, "%s,%d,%.6f,%04d-%02d-%02d %02ld:%02ld:%02ld,%.4f%s%s\n",
+                event_type_name(h->ev.type), h->ev.value, h->ev.jd,
+                y, m, d, secs / 3600, secs / 60 % 60, secs % 60, h->metric,
+                h->row[0] ? "," : "", h->row);
+    }
+    return ferror(out) ? -1 : 0;
+}
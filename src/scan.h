@@ -0,0 +1,65 @@
+/*
+ * scan.h - Parallel boundary scans over astronomical events
+ *
+ * The diagnostic tools keep asking the same question: over 150 years of
+ * sankrantis (or tithis, or sunsets), which events fall closest to some
+ * rule's boundary?  scan_run() enumerates the events with an EventCursor
+ * (events.h), hands each one to a metric callback, and keeps the top_n
+ * hits with the smallest |metric| in a bounded heap, so a new diagnostic
+ * is one callback:
+ *
+ *   static int near_sunset(const AstroEvent *ev, const Location *loc,
+ *                          void *ctx, ScanHit *hit)
+ *   {
+ *       hit->metric = (ev->jd - sunset_jd(floor(ev->jd - 0.5) + 0.5, loc)) * 1440.0;
+ *       return 1;
+ *   }
+ *
+ *   ScanRequest req = { jd0, jd1, EVENT_SANKRANTI, DEFAULT_LOCATION,
+ *                       near_sunset, NULL, 100, 8 };
+ *   ScanResult res;
+ *   if (scan_run(&req, &res)) {
+ *       scan_write_csv(stdout, &req, &res, NULL);
+ *       scan_free(&res);
+ *   }
+ *
+ * The range is cut into fixed one-year chunks that worker threads claim
+ * in turn; each thread has its own cursor and heap, merged at the end.
+ * The chunking does not depend on the thread count and ties are broken
+ * by (jd, type), so the hits are identical for any number of threads.
+ */
+#ifndef SCAN_H
+#define SCAN_H
+
+#include "types.h"
+#include <stdio.h>
+
+/*
+ * scan_run - Enumerate events, apply the metric, keep the closest hits.
+ *
+ *   req: Range, event kinds, location, callback, top_n and threads.
+ *        Worker threads call astro_init()/astro_close() themselves;
+ *        with threads <= 1 the caller's ephemeris state is used.
+ *   res: Output; release with scan_free().
+ *   Returns: 1 on success, 0 if the request is invalid (empty range or
+ *            mask, no callback, top_n < 1) or memory/threads could not
+ *            be allocated.
+ */
+int scan_run(const ScanRequest *req, ScanResult *res);
+
+/* scan_free - Release the hits of a scan_run() result. */
+void scan_free(ScanResult *res);
+
+/*
+ * scan_write_csv - Write the hits as CSV, closest first.
+ *
+ * Columns: event,value,jd_ut,local_time,metric followed by the caller's
+ * columns (may be NULL) and each hit's row.  local_time is
+ * "YYYY-MM-DD HH:MM:SS" at req->loc's UTC offset.
+ *
+ *   Returns: 0 on success, -1 on a write error.
+ */
+int scan_write_csv(FILE *out, const ScanRequest *req, const ScanResult *res,
+                   const char *columns);
+
+#endif /* SCAN_H */
@@ -0,0 +1,1070 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "server.h"
+#include "astro.h"
+#include "bulk.h"
+#include "panchang.h"
+#include "solar.h"
+#include "tithi.h"
+#include "writer.h"
+#include "date_utils.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Longest request line accepted; longer lines close the connection */
+#define SERVER_MAX_LINE 65536
+#define SERVER_MAX_CONNS 1024
+
+#define STR2(x) #x
+#define STR(x) STR2(x)
+
+/* Days in a Gregorian month */
+static int days_in_month(int year, int month)
+{
+    static const int mdays[] = {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (month == 2) {
+        if ((year % 4 == 0 && year % 100 != 0) || year % 400 == 0)
+            return 29;
+    }
+    return mdays[month];
+}
+
+/* ---- Request parsing ---- */
+
+static void skip_ws(const char **p)
+{
+    while (**p == ' ' || **p == '\t' || **p == '\r' || **p == '\n') (*p)++;
+}
+
+/* JSON string at *p into out (escapes decoded, \u limited to ASCII);
+ * out == NULL just skips it */
+static int parse_string(const char **p, char *out, size_t cap)
+{
+    const char *s = *p;
+    size_t n = 0;
+    if (*s++ != '"') return 0;
+    while (*s != '"') {
+        char c = *s++;
+        if (c == '\0') return 0;
+        if (c == '\\') {
+            c = *s++;
+            switch (c) {
+            case '"': case '\\': case '/': break;
+            case 'n': c = '\n'; break;
+            case 't': c = '\t'; break;
+            case 'r': c = '\r'; break;
+            case 'b': c = '\b'; break;
+            case 'f': c = '\f'; break;
+            case 'u': {
+                unsigned v;
+                if (sscanf(s, "%4x", &v) != 1 || v > 0x7F) return 0;
+                c = (char)v;
+                s += 4;
+                break;
+            }
+            default: return 0;
+            }
+        }
+        if (!out) continue;
+        if (n + 1 >= cap) return 0;
+        out[n++] = c;
+    }
+    if (out) out[n] = '\0';
+    *p = s + 1;
+    return 1;
+}
+
+static int parse_number(const char **p, double *v)
+{
+    char *end;
+    *v = strtod(*p, &end);
+    if (end == *p || !isfinite(*v) || fabs(*v) > 1e9) return 0;
+    *p = end;
+    return 1;
+}
+
+/* Skip a scalar value; nested objects and arrays are not accepted */
+static int skip_value(const char **p)
+{
+    double v;
+    if (**p == '"') return parse_string(p, NULL, 0);
+    if (strncmp(*p, "true", 4) == 0) { *p += 4; return 1; }
+    if (strncmp(*p, "false", 5) == 0) { *p += 5; return 1; }
+    if (strncmp(*p, "null", 4) == 0) { *p += 4; return 1; }
+    return parse_number(p, &v);
+}
+
+static int year_in_range(int y)
+{
+    return y >= SERVER_YEAR_MIN && y <= SERVER_YEAR_MAX;
+}
+
+static int parse_date(const char *str, int *y, int *m, int *d)
+{
+    char rest;
+    return sscanf(str, "%d-%d-%d%c", y, m, d, &rest) == 3 &&
+           *m >= 1 && *m <= 12 && *d >= 1 && *d <= days_in_month(*y, *m);
+}
+
+static int parse_solar_type(const char *str, SolarCalendarType *out)
+{
+    for (int t = 0; t < 4; t++) {
+        if (strcmp(str, calendar_name(CALENDAR_SOLAR(t))) == 0) {
+            *out = (SolarCalendarType)t;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int server_parse_request(const char *line, ServerRequest *req, const char **err)
+{
+    static const char *OPS[] = {"day", "month", "range", "solar", "stats", "ping"};
+    Location def = DEFAULT_LOCATION;
+    char key[32], str[64];
+    int have_op = 0, have_date = 0, have_from = 0, have_to = 0;
+    int have_year = 0, have_month = 0;
+    double num;
+
+    memset(req, 0, sizeof(*req));
+    req->loc = def;
+    req->calendars = CALSET_LUNISOLAR;
+    req->solar_type = SOLAR_CAL_TAMIL;
+    *err = "malformed JSON";
+
+    const char *p = line;
+    skip_ws(&p);
+    if (*p++ != '{') return 0;
+    skip_ws(&p);
+    while (*p != '}') {
+        if (!parse_string(&p, key, sizeof(key))) {
+            if (*p != '"') return 0;
+            key[0] = '\0';  /* over-long key: skip as unknown */
+            if (!skip_value(&p)) return 0;
+        }
+        skip_ws(&p);
+        if (*p++ != ':') return 0;
+        skip_ws(&p);
+
+        if (strcmp(key, "id") == 0) {
+            const char *start = p;
+            if (!skip_value(&p)) return 0;
+            if ((size_t)(p - start) >= sizeof(req->id)) {
+                *err = "id too long";
+                return 0;
+            }
+            memcpy(req->id, start, (size_t)(p - start));
+            req->id[p - start] = '\0';
+        } else if (strcmp(key, "op") == 0 || strcmp(key, "date") == 0 ||
+                   strcmp(key, "from") == 0 || strcmp(key, "to") == 0 ||
+                   strcmp(key, "calendar") == 0 || strcmp(key, "calendars") == 0) {
+            if (!parse_string(&p, str, sizeof(str))) return 0;
+            if (key[0] == 'o') {
+                for (int i = 0; i < (int)(sizeof(OPS) / sizeof(OPS[0])); i++)
+                    if (strcmp(str, OPS[i]) == 0) {
+                        req->op = (ServerOp)i;
+                        have_op = 1;
+                    }
+                if (!have_op) {
+                    *err = "unknown op";
+                    return 0;
+                }
+            } else if (strcmp(key, "calendar") == 0) {
+                if (!parse_solar_type(str, &req->solar_type)) {
+                    *err = "unknown solar calendar";
+                    return 0;
+                }
+            } else if (strcmp(key, "calendars") == 0) {
+                if (!parse_calendar_set(str, &req->calendars)) {
+                    *err = "unknown calendar";
+                    return 0;
+                }
+            } else if (key[0] == 't') {
+                if (!parse_date(str, &req->y1, &req->m1, &req->d1)) goto bad_date;
+                have_to = 1;
+            } else {
+                if (!parse_date(str, &req->y0, &req->m0, &req->d0)) goto bad_date;
+                if (key[0] == 'd') have_date = 1; else have_from = 1;
+            }
+        } else if (strcmp(key, "year") == 0 || strcmp(key, "month") == 0 ||
+                   strcmp(key, "lat") == 0 || strcmp(key, "lon") == 0 ||
+                   strcmp(key, "utc_offset") == 0 || strcmp(key, "alt") == 0) {
+            if (!parse_number(&p, &num)) return 0;
+            if (strcmp(key, "year") == 0) {
+                req->y0 = (int)num;
+                have_year = 1;
+            } else if (strcmp(key, "month") == 0) {
+                req->m0 = (int)num;
+                have_month = 1;
+            } else if (strcmp(key, "lat") == 0) {
+                req->loc.latitude = num;
+            } else if (strcmp(key, "lon") == 0) {
+                req->loc.longitude = num;
+            } else if (strcmp(key, "utc_offset") == 0) {
+                req->loc.utc_offset = num;
+            } else {
+                req->loc.altitude = num;
+            }
+        } else if (!skip_value(&p)) {
+            return 0;
+        }
+
+        skip_ws(&p);
+        if (*p == ',') {
+            p++;
+            skip_ws(&p);
+        } else if (*p != '}') {
+            return 0;
+        }
+    }
+    p++;
+    skip_ws(&p);
+    if (*p != '\0') return 0;
+
+    if (!have_op) {
+        *err = "missing op";
+        return 0;
+    }
+    if (req->loc.latitude < -90.0 || req->loc.latitude > 90.0 ||
+        req->loc.longitude < -180.0 || req->loc.longitude > 180.0 ||
+        req->loc.utc_offset < -14.0 || req->loc.utc_offset > 14.0) {
+        *err = "location out of range";
+        return 0;
+    }
+
+    switch (req->op) {
+    case SERVER_OP_DAY:
+    case SERVER_OP_SOLAR:
+        if (!have_date) {
+            *err = "missing date";
+            return 0;
+        }
+        if (!year_in_range(req->y0)) goto bad_year;
+        break;
+    case SERVER_OP_MONTH:
+        if (have_date) {
+            have_year = have_month = 1;
+        }
+        if (!have_year || !have_month || req->m0 < 1 || req->m0 > 12) {
+            *err = "missing or invalid year/month";
+            return 0;
+        }
+        if (!year_in_range(req->y0)) goto bad_year;
+        req->d0 = 1;
+        break;
+    case SERVER_OP_RANGE: {
+        if (!have_from || !have_to) {
+            *err = "missing from/to";
+            return 0;
+        }
+        if (!year_in_range(req->y0) || !year_in_range(req->y1)) goto bad_year;
+        double days = gregorian_to_jd(req->y1, req->m1, req->d1) -
+                      gregorian_to_jd(req->y0, req->m0, req->d0) + 1;
+        if (days < 1 || days > SERVER_MAX_RANGE_DAYS) {
+            *err = "range must be 1-366 days";
+            return 0;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    return 1;
+
+bad_date:
+    *err = "invalid date, expected YYYY-MM-DD";
+    return 0;
+
+bad_year:
+    *err = "year out of range (" STR(SERVER_YEAR_MIN) "-" STR(SERVER_YEAR_MAX) ")";
+    return 0;
+}
+
+/* ---- Responses ---- */
+
+static int append(char **buf, size_t *len, size_t *cap, const char *fmt, ...)
+{
+    for (;;) {
+        va_list ap;
+        va_start(ap, fmt);
+        size_t room = *cap - *len;
+        int n = vsnprintf(*buf ? *buf + *len : NULL, *buf ? room : 0, fmt, ap);
+        va_end(ap);
+        if (n < 0) return 0;
+        if (*buf && (size_t)n < room) {
+            *len += (size_t)n;
+            return 1;
+        }
+        size_t want = *cap ? *cap : 4096;
+        while (want < *len + (size_t)n + 1) want *= 2;
+        char *grown = realloc(*buf, want);
+        if (!grown) return 0;
+        *buf = grown;
+        *cap = want;
+    }
+}
+
+/* Local date-time "YYYY-MM-DDTHH:MM:SS" (or just the time) of a UT JD */
+static void local_time(double jd_ut, double utc_offset, int with_date, char *out, size_t cap)
+{
+    double local = jd_ut + utc_offset / 24.0 + 0.5;
+    double day = floor(local);
+    int secs = (int)lround((local - day) * 86400.0);
+    if (secs >= 86400) {
+        secs -= 86400;
+        day += 1.0;
+    }
+    int y, m, d;
+    jd_to_gregorian(day, &y, &m, &d);
+    if (with_date)
+        snprintf(out, cap, "%04d-%02d-%02dT%02d:%02d:%02d",
+                 y, m, d, secs / 3600, secs / 60 % 60, secs % 60);
+    else
+        snprintf(out, cap, "%02d:%02d:%02d", secs / 3600, secs / 60 % 60, secs % 60);
+}
+
+static int append_day(char **buf, size_t *len, size_t *cap, const PanchangDay *pd,
+                      double utc_offset)
+{
+    char rise[40] = "null", start[40], end[40];
+    if (pd->jd_sunrise > 0) {
+        rise[0] = '"';
+        local_time(pd->jd_sunrise, utc_offset, 0, rise + 1, sizeof(rise) - 2);
+        strcat(rise, "\"");
+    }
+    local_time(pd->tithi.jd_start, utc_offset, 1, start, sizeof(start));
+    local_time(pd->tithi.jd_end, utc_offset, 1, end, sizeof(end));
+
+    const TithiInfo *ti = &pd->tithi;
+    const HinduDate *hd = &pd->hindu_date;
+    const char *tithi_name = (ti->tithi_num == 30) ? "Amavasya"
+                           : (ti->tithi_num == 15) ? "Purnima"
+                           : TITHI_NAMES[ti->paksha_tithi];
+    int dow = day_of_week(gregorian_to_jd(pd->greg_year, pd->greg_month, pd->greg_day));
+    return append(buf, len, cap,
+                  "{\"date\":\"%04d-%02d-%02d\",\"weekday\":\"%s\",\"sunrise\":%s,"
+                  "\"tithi\":%d,\"paksha\":\"%s\",\"paksha_tithi\":%d,\"tithi_name\":\"%s\","
+                  "\"tithi_start\":\"%s\",\"tithi_end\":\"%s\",\"kshaya\":%d,"
+                  "\"masa\":\"%s\",\"masa_num\":%d,\"adhika_masa\":%d,\"adhika_tithi\":%d,"
+                  "\"saka\":%d,\"vikram\":%d}",
+                  pd->greg_year, pd->greg_month, pd->greg_day, day_of_week_short(dow), rise,
+                  ti->tithi_num, ti->paksha == SHUKLA_PAKSHA ? "Shukla" : "Krishna",
+                  ti->paksha_tithi, tithi_name, start, end, ti->is_kshaya,
+                  MASA_NAMES[hd->masa], (int)hd->masa, hd->is_adhika_masa,
+                  hd->is_adhika_tithi, hd->year_saka, hd->year_vikram);
+}
+
+/* Calendar records for a range, as a JSON array of writer.h JSONL objects */
+static int append_range(char **buf, size_t *len, size_t *cap, const ServerRequest *req)
+{
+    RecordWriter w;
+    char name[64];
+    if (!writer_init(&w, NULL, OUTPUT_JSONL)) return 0;
+    snprintf(name, sizeof(name), "%.4f:%.4f", req->loc.latitude, req->loc.longitude);
+    writer_set_location(&w, 0, name);
+
+    double jd = gregorian_to_jd(req->y0, req->m0, req->d0);
+    double jd_last = gregorian_to_jd(req->y1, req->m1, req->d1);
+    for (; jd <= jd_last && !w.failed; jd += 1.0) {
+        int y, m, d;
+        jd_to_gregorian(jd, &y, &m, &d);
+        for (int c = 0; c < CALENDAR_COUNT; c++) {
+            if (!(req->calendars & (1u << c))) continue;
+            CalendarRecord rec;
+            if (c == CALENDAR_LUNISOLAR) {
+                HinduDate hd = gregorian_to_hindu(y, m, d, &req->loc);
+                calendar_record_lunisolar(&rec, y, m, d, &hd);
+            } else {
+                SolarCalendarType type = (SolarCalendarType)(c - 1);
+                SolarDate sd = gregorian_to_solar(y, m, d, &req->loc, type);
+                calendar_record_solar(&rec, y, m, d, type, &sd);
+            }
+            writer_record(&w, &rec);
+        }
+    }
+
+    /* One object per line -> array elements */
+    int ok = !w.failed && append(buf, len, cap, "[");
+    for (size_t i = 0; ok && i < w.len; i++)
+        if (w.buf[i] == '\n') w.buf[i] = (i + 1 < w.len) ? ',' : ']';
+    if (ok && w.len == 0) ok = append(buf, len, cap, "]");
+    if (ok && w.len > 0) ok = append(buf, len, cap, "%.*s", (int)w.len, w.buf);
+    writer_close(&w);
+    return ok;
+}
+
+static int append_header(char **buf, size_t *len, size_t *cap, const char *id)
+{
+    return append(buf, len, cap, "{\"id\":%s,\"ok\":true,\"result\":",
+                  id[0] ? id : "null");
+}
+
+static int append_error(char **buf, size_t *len, size_t *cap, const char *id,
+                        const char *err)
+{
+    return append(buf, len, cap, "{\"id\":%s,\"ok\":false,\"error\":\"%s\"}\n",
+                  id[0] ? id : "null", err);
+}
+
+int server_execute(const ServerRequest *req, char **buf, size_t *len, size_t *cap)
+{
+    int ok = append_header(buf, len, cap, req->id);
+    switch (req->op) {
+    case SERVER_OP_DAY: {
+        PanchangDay pd;
+        pd.greg_year = req->y0;
+        pd.greg_month = req->m0;
+        pd.greg_day = req->d0;
+        pd.jd_sunrise = sunrise_jd(gregorian_to_jd(req->y0, req->m0, req->d0), &req->loc);
+        pd.tithi = tithi_at_sunrise(req->y0, req->m0, req->d0, &req->loc);
+        pd.hindu_date = gregorian_to_hindu(req->y0, req->m0, req->d0, &req->loc);
+        ok = ok && append_day(buf, len, cap, &pd, req->loc.utc_offset);
+        break;
+    }
+    case SERVER_OP_MONTH: {
+        PanchangDay days[31];
+        int count;
+        generate_month_panchang(req->y0, req->m0, &req->loc, days, &count);
+        ok = ok && append(buf, len, cap, "[");
+        for (int i = 0; ok && i < count; i++) {
+            ok = append_day(buf, len, cap, &days[i], req->loc.utc_offset) &&
+                 append(buf, len, cap, i + 1 < count ? "," : "]");
+        }
+        break;
+    }
+    case SERVER_OP_RANGE:
+        ok = ok && append_range(buf, len, cap, req);
+        break;
+    case SERVER_OP_SOLAR: {
+        SolarDate sd = gregorian_to_solar(req->y0, req->m0, req->d0, &req->loc,
+                                          req->solar_type);
+        ok = ok && append(buf, len, cap,
+                          "{\"date\":\"%04d-%02d-%02d\",\"calendar\":\"%s\",\"year\":%d,"
+                          "\"month\":%d,\"month_name\":\"%s\",\"day\":%d,\"rashi\":%d,"
+                          "\"era\":\"%s\"}",
+                          req->y0, req->m0, req->d0,
+                          calendar_name(CALENDAR_SOLAR(req->solar_type)), sd.year,
+                          sd.month, solar_month_name(sd.month, req->solar_type), sd.day,
+                          sd.rashi, solar_era_name(req->solar_type));
+        break;
+    }
+    case SERVER_OP_STATS:
+        ok = ok && append(buf, len, cap,
+                          "{\"connections\":0,\"requests\":0,\"errors\":0,\"batches\":0}");
+        break;
+    case SERVER_OP_PING:
+        ok = ok && append(buf, len, cap, "\"pong\"");
+        break;
+    }
+    return ok && append(buf, len, cap, "}\n");
+}
+
+/* ---- Server ---- */
+
+/* Requests queued or running, per connection and in all.  A connection
+ * at either limit, or with SERVER_MAX_OUTPUT bytes of responses its
+ * client has not read, is not read from until that drops. */
+#define SERVER_MAX_CONN_JOBS 64
+#define SERVER_MAX_JOBS 1024
+#define SERVER_MAX_OUTPUT (1 << 20)
+/* How long server_run() keeps sending responses after server_stop() */
+#define SERVER_DRAIN_MS 2000
+
+typedef struct Conn {
+    int fd;                     /* non-blocking */
+    int refs;                   /* reader + queued jobs, under srv.lock */
+    int jobs;                   /* queued or running requests, under srv.lock */
+    int eof;                    /* nothing more is read (reader thread) */
+    int backlog;                /* complete lines held back by a limit (reader) */
+    pthread_mutex_t out_lock;   /* guards out and dead */
+    char *out;                  /* responses not yet written */
+    size_t out_len, out_cap;
+    int dead;                   /* write failed; responses are dropped */
+    char *in;                   /* unparsed input */
+    size_t in_len, in_cap;
+    struct Conn *next;          /* open connections (reader thread) */
+} Conn;
+
+typedef struct {
+    Conn *conn;
+    ServerRequest req;
+    double jd;                  /* first date, for batch ordering */
+    long seq;                   /* arrival order, for stable sorting */
+} Job;
+
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    Job *pending;               /* SERVER_MAX_JOBS slots */
+    int n_pending;
+    int n_jobs;                 /* queued or running */
+    int stopping;
+    int woken;                  /* a wake-up byte is in the pipe */
+    ServerConfig cfg;
+    ServerStats stats;
+} srv;
+
+/* Wakes the reader thread, for server_stop() and finished batches */
+static int wake_pipe[2] = {-1, -1};
+static volatile sig_atomic_t stop_requested;
+
+void server_stop(void)
+{
+    stop_requested = 1;
+    if (wake_pipe[1] >= 0) {
+        ssize_t rc = write(wake_pipe[1], "x", 1);
+        (void)rc;
+    }
+}
+
+/* Have the reader thread look at limits and output again; call with
+ * srv.lock held */
+static void wake_reader_locked(void)
+{
+    if (srv.woken) return;
+    srv.woken = 1;
+    ssize_t rc = write(wake_pipe[1], "w", 1);
+    (void)rc;
+}
+
+/* Write what the socket takes without blocking; call with out_lock held */
+static void conn_flush_locked(Conn *c)
+{
+    size_t off = 0;
+    while (off < c->out_len) {
+        ssize_t n = write(c->fd, c->out + off, c->out_len - off);
+        if (n > 0) {
+            off += (size_t)n;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            c->dead = 1;  /* client gone; the reader will notice */
+            off = c->out_len;
+        }
+    }
+    c->out_len -= off;
+    memmove(c->out, c->out + off, c->out_len);
+}
+
+static void conn_flush(Conn *c)
+{
+    pthread_mutex_lock(&c->out_lock);
+    conn_flush_locked(c);
+    pthread_mutex_unlock(&c->out_lock);
+}
+
+/* Queue a response line and send what the socket takes now; the reader
+ * thread writes the rest when the socket has room */
+static void conn_write(Conn *c, const char *buf, size_t len)
+{
+    pthread_mutex_lock(&c->out_lock);
+    if (!c->dead && c->out_len + len > c->out_cap) {
+        size_t cap = c->out_cap ? c->out_cap : 4096;
+        while (cap < c->out_len + len) cap *= 2;
+        char *grown = realloc(c->out, cap);
+        if (grown) {
+            c->out = grown;
+            c->out_cap = cap;
+        } else {
+            c->dead = 1;  /* a response would go missing; drop the client */
+        }
+    }
+    if (!c->dead) {
+        memcpy(c->out + c->out_len, buf, len);
+        c->out_len += len;
+        conn_flush_locked(c);
+    }
+    pthread_mutex_unlock(&c->out_lock);
+}
+
+/* Bytes waiting to be written; *dead set if the client is gone */
+static size_t conn_unsent(Conn *c, int *dead)
+{
+    pthread_mutex_lock(&c->out_lock);
+    size_t n = c->out_len;
+    *dead = c->dead;
+    pthread_mutex_unlock(&c->out_lock);
+    return n;
+}
+
+/* Give up on a client: drop its output and close it soon */
+static void conn_kill(Conn *c)
+{
+    pthread_mutex_lock(&c->out_lock);
+    c->dead = 1;
+    c->out_len = 0;
+    pthread_mutex_unlock(&c->out_lock);
+}
+
+/* At a limit, so no more of its lines are taken?  Call with srv.lock held */
+static int conn_full_locked(Conn *c)
+{
+    int dead;
+    return c->jobs >= SERVER_MAX_CONN_JOBS || srv.n_jobs >= SERVER_MAX_JOBS ||
+           conn_unsent(c, &dead) > SERVER_MAX_OUTPUT;
+}
+
+/* Drop one reference; call with srv.lock held */
+static void conn_release_locked(Conn *c)
+{
+    if (--c->refs > 0) return;
+    close(c->fd);
+    pthread_mutex_destroy(&c->out_lock);
+    free(c->out);
+    free(c->in);
+    free(c);
+}
+
+static int cmp_job(const void *a, const void *b)
+{
+    const Job *x = a, *y = b;
+    if (x->jd != y->jd) return (x->jd < y->jd) ? -1 : 1;
+    return (x->seq > y->seq) - (x->seq < y->seq);
+}
+
+static void *server_worker(void *arg)
+{
+    (void)arg;
+    Job *batch = malloc((size_t)srv.cfg.max_batch * sizeof(Job));
+    char *out = NULL;
+    size_t out_len = 0, out_cap = 0;
+    Location last = DEFAULT_LOCATION;
+    int have_last = 0;
+
+    astro_init(NULL);
+    pthread_mutex_lock(&srv.lock);
+    for (;;) {
+        while (srv.n_pending == 0 && !srv.stopping)
+            pthread_cond_wait(&srv.cond, &srv.lock);
+        if (srv.n_pending == 0 || !batch) break;
+
+        /* Stay on the last location if it has queued work, else take the
+         * oldest request's location */
+        int found = 0;
+        for (int i = 0; have_last && i < srv.n_pending && !found; i++)
+            found = LOCATION_EQUAL(&srv.pending[i].req.loc, &last);
+        if (!found) last = srv.pending[0].req.loc;
+        have_last = 1;
+
+        int n = 0, kept = 0;
+        for (int i = 0; i < srv.n_pending; i++) {
+            if (n < srv.cfg.max_batch && LOCATION_EQUAL(&srv.pending[i].req.loc, &last))
+                batch[n++] = srv.pending[i];
+            else
+                srv.pending[kept++] = srv.pending[i];
+        }
+        srv.n_pending = kept;
+        srv.stats.batches++;
+        pthread_mutex_unlock(&srv.lock);
+
+        qsort(batch, (size_t)n, sizeof(Job), cmp_job);
+        for (int i = 0; i < n; i++) {
+            out_len = 0;
+            if (!server_execute(&batch[i].req, &out, &out_len, &out_cap)) {
+                out_len = 0;
+                append_error(&out, &out_len, &out_cap, batch[i].req.id, "out of memory");
+            }
+            conn_write(batch[i].conn, out, out_len);
+        }
+
+        pthread_mutex_lock(&srv.lock);
+        for (int i = 0; i < n; i++) {
+            batch[i].conn->jobs--;
+            conn_release_locked(batch[i].conn);
+        }
+        srv.n_jobs -= n;
+        wake_reader_locked();
+    }
+    pthread_mutex_unlock(&srv.lock);
+
+    astro_close();
+    free(out);
+    free(batch);
+    return NULL;
+}
+
+/* Answer locally-handled lines and queue the rest, stopping at a limit
+ * (c->backlog is then set); returns jobs queued */
+static int handle_lines(Conn *c, long *seq)
+{
+    char *out = NULL;
+    size_t out_len = 0, out_cap = 0;
+    char *line = c->in, *nl;
+    int queued = 0;
+
+    c->backlog = 0;
+    while ((nl = memchr(line, '\n', c->in_len - (size_t)(line - c->in))) != NULL) {
+        *nl = '\0';
+        ServerRequest req;
+        const char *err;
+        int ok = server_parse_request(line, &req, &err);
+
+        pthread_mutex_lock(&srv.lock);
+        if (conn_full_locked(c)) {
+            /* Taken again once requests finish or the client reads */
+            pthread_mutex_unlock(&srv.lock);
+            *nl = '\n';
+            c->backlog = 1;
+            break;
+        }
+        line = nl + 1;
+        srv.stats.requests++;
+        if (!ok) {
+            srv.stats.errors++;
+            pthread_mutex_unlock(&srv.lock);
+            out_len = 0;
+            append_error(&out, &out_len, &out_cap, req.id, err);
+            conn_write(c, out, out_len);
+        } else if (req.op == SERVER_OP_STATS) {
+            ServerStats st = srv.stats;
+            pthread_mutex_unlock(&srv.lock);
+            out_len = 0;
+            if (append_header(&out, &out_len, &out_cap, req.id) &&
+                append(&out, &out_len, &out_cap,
+                       "{\"connections\":%ld,\"requests\":%ld,\"errors\":%ld,"
+                       "\"batches\":%ld,\"threads\":%d}}\n",
+                       st.connections, st.requests, st.errors, st.batches,
+                       srv.cfg.threads))
+                conn_write(c, out, out_len);
+        } else if (req.op == SERVER_OP_PING) {
+            pthread_mutex_unlock(&srv.lock);
+            out_len = 0;
+            if (server_execute(&req, &out, &out_len, &out_cap))
+                conn_write(c, out, out_len);
+        } else {
+            /* conn_full_locked() keeps n_pending below SERVER_MAX_JOBS */
+            Job *j = &srv.pending[srv.n_pending++];
+            j->conn = c;
+            j->req = req;
+            j->jd = gregorian_to_jd(req.y0, req.m0, req.d0);
+            j->seq = (*seq)++;
+            c->refs++;
+            c->jobs++;
+            srv.n_jobs++;
+            queued++;
+            pthread_mutex_unlock(&srv.lock);
+        }
+    }
+
+    /* Keep the unterminated tail and any held-back lines */
+    c->in_len -= (size_t)(line - c->in);
+    memmove(c->in, line, c->in_len);
+    free(out);
+    return queued;
+}
+
+static void wake_workers(void)
+{
+    pthread_mutex_lock(&srv.lock);
+    pthread_cond_broadcast(&srv.cond);
+    pthread_mutex_unlock(&srv.lock);
+}
+
+/* Read what is available; returns 0 when the connection should close */
+static int conn_read(Conn *c, long *seq)
+{
+    if (c->in_cap - c->in_len < 4096) {
+        size_t cap = c->in_cap ? 2 * c->in_cap : 8192;
+        if (cap > SERVER_MAX_LINE + 8192) {
+            static const char msg[] = "{\"id\":null,\"ok\":false,\"error\":\"line too long\"}\n";
+            conn_write(c, msg, sizeof(msg) - 1);
+            c->in_len = 0;
+            c->eof = 1;  /* closed once the error is sent */
+            return 1;
+        }
+        char *grown = realloc(c->in, cap);
+        if (!grown) return 0;
+        c->in = grown;
+        c->in_cap = cap;
+    }
+    ssize_t n = read(c->fd, c->in + c->in_len, c->in_cap - c->in_len);
+    if (n < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) return 1;
+    if (n < 0) return 0;
+    if (n == 0) {
+        c->eof = 1;  /* closed once queued requests are answered */
+        return 1;
+    }
+    c->in_len += (size_t)n;
+    if (handle_lines(c, seq) > 0) wake_workers();
+    return 1;
+}
+
+static int set_nonblocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+/* Keep sending queued responses for up to SERVER_DRAIN_MS */
+static void drain_output(Conn *conns, struct pollfd *fds, Conn **fd_conn)
+{
+    struct timespec t0, t;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (;;) {
+        int nfds = 0, dead;
+        for (Conn *c = conns; c; c = c->next) {
+            if (conn_unsent(c, &dead) == 0 || dead) continue;
+            fd_conn[nfds] = c;
+            fds[nfds].fd = c->fd;
+            fds[nfds++].events = POLLOUT;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t);
+        long left = SERVER_DRAIN_MS - ((t.tv_sec - t0.tv_sec) * 1000 +
+                                       (t.tv_nsec - t0.tv_nsec) / 1000000);
+        if (nfds == 0 || left <= 0) return;
+        if (poll(fds, (nfds_t)nfds, (int)left) < 0 && errno != EINTR) return;
+        for (int i = 0; i < nfds; i++) {
+            if (fds[i].revents & POLLOUT)
+                conn_flush(fd_conn[i]);
+            else if (fds[i].revents)
+                conn_kill(fd_conn[i]);
+        }
+    }
+}
+
+int server_run(int listen_fd, const ServerConfig *cfg, ServerStats *stats)
+{
+    pthread_mutex_init(&srv.lock, NULL);
+    pthread_cond_init(&srv.cond, NULL);
+    srv.cfg = *cfg;
+    if (srv.cfg.threads < 1) srv.cfg.threads = 1;
+    if (srv.cfg.max_batch < 1) srv.cfg.max_batch = 64;
+    memset(&srv.stats, 0, sizeof(srv.stats));
+    srv.n_pending = srv.n_jobs = 0;
+    srv.stopping = srv.woken = 0;
+    stop_requested = 0;
+    if (pipe(wake_pipe) != 0) {
+        wake_pipe[0] = wake_pipe[1] = -1;
+        pthread_mutex_destroy(&srv.lock);
+        pthread_cond_destroy(&srv.cond);
+        return -1;
+    }
+    set_nonblocking(wake_pipe[0]);
+    set_nonblocking(wake_pipe[1]);
+    signal(SIGPIPE, SIG_IGN);
+
+    srv.pending = malloc(SERVER_MAX_JOBS * sizeof(Job));
+    pthread_t *tids = malloc((size_t)srv.cfg.threads * sizeof(pthread_t));
+    int started = 0;
+    while (srv.pending && tids && started < srv.cfg.threads &&
+           pthread_create(&tids[started], NULL, server_worker, NULL) == 0)
+        started++;
+    int rc = (started == 0) ? -1 : 0;
+
+    Conn *conns = NULL;
+    int n_conns = 0;
+    long seq = 0;
+    struct pollfd *fds = malloc((SERVER_MAX_CONNS + 2) * sizeof(struct pollfd));
+    Conn **fd_conn = malloc((SERVER_MAX_CONNS + 2) * sizeof(Conn *));
+    if (!fds || !fd_conn) rc = -1;
+
+    while (rc == 0) {
+        /* Take held-back lines where the limits now allow, and close
+         * connections that are finished or gone */
+        int queued = 0;
+        for (Conn **pp = &conns; *pp;) {
+            Conn *c = *pp;
+            int dead;
+            conn_unsent(c, &dead);
+            if (c->backlog && !dead) queued += handle_lines(c, &seq);
+            size_t unsent = conn_unsent(c, &dead);
+            pthread_mutex_lock(&srv.lock);
+            int done = dead || (c->eof && !c->backlog && c->jobs == 0 && unsent == 0);
+            if (done) {
+                *pp = c->next;
+                n_conns--;
+                conn_release_locked(c);
+            }
+            pthread_mutex_unlock(&srv.lock);
+            if (!done) pp = &c->next;
+        }
+        if (queued > 0) wake_workers();
+
+        int nfds = 0;
+        fds[nfds].fd = wake_pipe[0];
+        fds[nfds++].events = POLLIN;
+        fds[nfds].fd = listen_fd;
+        fds[nfds++].events = (n_conns < SERVER_MAX_CONNS) ? POLLIN : 0;
+        pthread_mutex_lock(&srv.lock);
+        for (Conn *c = conns; c; c = c->next) {
+            int dead;
+            fd_conn[nfds] = c;
+            fds[nfds].fd = c->fd;
+            fds[nfds].events = (!c->eof && !c->backlog && !conn_full_locked(c)) ? POLLIN : 0;
+            if (conn_unsent(c, &dead) > 0) fds[nfds].events |= POLLOUT;
+            nfds++;
+        }
+        pthread_mutex_unlock(&srv.lock);
+        if (poll(fds, (nfds_t)nfds, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[0].revents) {
+            char drain[64];
+            pthread_mutex_lock(&srv.lock);
+            srv.woken = 0;
+            pthread_mutex_unlock(&srv.lock);
+            while (read(wake_pipe[0], drain, sizeof(drain)) > 0)
+                ;
+            if (stop_requested) break;
+        }
+
+        if (fds[1].revents & POLLIN) {
+            int fd = accept(listen_fd, NULL, NULL);
+            Conn *c = (fd >= 0 && set_nonblocking(fd)) ? calloc(1, sizeof(Conn)) : NULL;
+            if (c) {
+                int one = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                c->fd = fd;
+                c->refs = 1;
+                pthread_mutex_init(&c->out_lock, NULL);
+                c->next = conns;
+                conns = c;
+                n_conns++;
+                pthread_mutex_lock(&srv.lock);
+                srv.stats.connections++;
+                pthread_mutex_unlock(&srv.lock);
+            } else if (fd >= 0) {
+                close(fd);
+            }
+        }
+
+        for (int i = 2; i < nfds; i++) {
+            Conn *c = fd_conn[i];
+            short ev = fds[i].revents;
+            if (ev & POLLOUT) conn_flush(c);
+            if ((fds[i].events & POLLIN) && (ev & (POLLIN | POLLHUP | POLLERR))) {
+                if (!conn_read(c, &seq)) conn_kill(c);
+            } else if (ev & (POLLHUP | POLLERR)) {
+                conn_kill(c);  /* client gone while it was not being read */
+            }
+        }
+    }
+
+    /* Answer what is queued, then close everything */
+    pthread_mutex_lock(&srv.lock);
+    srv.stopping = 1;
+    pthread_cond_broadcast(&srv.cond);
+    pthread_mutex_unlock(&srv.lock);
+    for (int t = 0; t < started; t++)
+        pthread_join(tids[t], NULL);
+    if (fds && fd_conn) drain_output(conns, fds, fd_conn);
+    while (conns) {
+        Conn *next = conns->next;
+        pthread_mutex_lock(&srv.lock);
+        conn_release_locked(conns);
+        pthread_mutex_unlock(&srv.lock);
+        conns = next;
+    }
+
+    if (stats) *stats = srv.stats;
+    free(srv.pending);
+    srv.pending = NULL;
+    srv.n_pending = srv.n_jobs = 0;
+    free(fds);
+    free(fd_conn);
+    free(tids);
+    close(wake_pipe[0]);
+    close(wake_pipe[1]);
+    wake_pipe[0] = wake_pipe[1] = -1;
+    pthread_mutex_destroy(&srv.lock);
+    pthread_cond_destroy(&srv.cond);
+    return rc;
+}
+
+/* Socket path of a Unix address, or NULL for TCP */
+static const char *unix_path(const char *address)
+{
+    if (strncmp(address, "unix:", 5) == 0) return address + 5;
+    if (strncmp(address, "tcp:", 4) == 0) return NULL;
+    return strchr(address, '/') ? address : NULL;
+}
+
+void server_close(int listen_fd, const char *address)
+{
+    const char *path = unix_path(address);
+    close(listen_fd);
+    if (path) unlink(path);
+}
+
+int server_listen(const char *address)
+{
+    const char *path = unix_path(address), *hostport = NULL;
+    if (!path)
+        hostport = (strncmp(address, "tcp:", 4) == 0) ? address + 4 : address;
+
+    if (path) {
+        struct sockaddr_un sa;
+        struct stat st;
+        if (strlen(path) >= sizeof(sa.sun_path)) {
+            fprintf(stderr, "Error: socket path too long: %s\n", path);
+            return -1;
+        }
+        if (stat(path, &st) == 0 && S_ISSOCK(st.st_mode)) unlink(path);
+        memset(&sa, 0, sizeof(sa));
+        sa.sun_family = AF_UNIX;
+        strcpy(sa.sun_path, path);
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0 || bind(fd, (struct sockaddr *)&sa, sizeof(sa)) != 0 ||
+            listen(fd, 128) != 0) {
+            fprintf(stderr, "Error: cannot listen on %s: %s\n", path, strerror(errno));
+            if (fd >= 0) close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    char host[256];
+    const char *colon = strrchr(hostport, ':');
+    if (!colon || (size_t)(colon - hostport) >= sizeof(host)) {
+        fprintf(stderr, "Error: expected HOST:PORT, got '%s'\n", hostport);
+        return -1;
+    }
+    memcpy(host, hostport, (size_t)(colon - hostport));
+    host[colon - hostport] = '\0';
+
+    /* No AI_PASSIVE: an empty host is loopback, and listening on every
+     * interface takes an explicit 0.0.0.0 or :: */
+    struct addrinfo hints, *res, *ai;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    int gai = getaddrinfo(host[0] ? host : NULL, colon + 1, &hints, &res);
+    if (gai != 0) {
+        fprintf(stderr, "Error: %s: %s\n", hostport, gai_strerror(gai));
+        return -1;
+    }
+    int fd = -1;
+    for (ai = res; ai; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) continue;
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (bind(fd, ai->ai_addr, ai->ai_addrlen) == 0 && listen(fd, 128) == 0)
+            break;
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    if (fd < 0)
+        fprintf(stderr, "Error: cannot listen on %s: %s\n", hostport, strerror(errno));
+    return fd;
+}
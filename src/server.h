@@ -0,0 +1,96 @@
+/*
+ * server.h - Long-running calendar daemon over a Unix or TCP socket
+ *
+ * Clients send one JSON object per line and get one JSON object per line
+ * back.  Requests:
+ *
+ *   {"id":1,"op":"day","date":"2025-01-14"}
+ *   {"id":2,"op":"month","year":2025,"month":1}
+ *   {"id":3,"op":"range","from":"2025-01-01","to":"2025-01-31",
+ *    "calendars":"lunisolar,tamil"}
+ *   {"id":4,"op":"solar","date":"2025-01-14","calendar":"tamil"}
+ *   {"id":5,"op":"stats"}   {"id":6,"op":"ping"}
+ *
+ * Any request may carry "lat", "lon", "utc_offset" and "alt" (default
+ * New Delhi).  Dates must fall in SERVER_YEAR_MIN..SERVER_YEAR_MAX.
+ * "id" (any number or string) is echoed back verbatim.
+ * Responses are {"id":...,"ok":true,"result":...} or
+ * {"id":...,"ok":false,"error":"..."}.  A connection's responses may
+ * come back in a different order from its requests; match them by id.
+ *
+ * One thread reads all connections and queues parsed requests.  Each
+ * worker takes a batch: up to max_batch queued requests for one
+ * location, preferring the location it served last, and runs them in
+ * date order.  The per-thread day-to-day caches in masa.c, panchang.c
+ * and solar.c therefore keep hitting while concurrent clients ask about
+ * nearby dates for the same place.
+ *
+ * Sockets are non-blocking: responses go to a per-connection buffer
+ * that the reader thread drains, so a client that stops reading holds
+ * up only itself.  A connection with 64 requests in flight (1024 across
+ * the server) or 1 MiB of unread responses is not read until that
+ * drops.
+ */
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "types.h"
+#include <stddef.h>
+
+/*
+ * server_listen - Bind and listen.
+ *
+ *   address: "unix:PATH", "tcp:HOST:PORT", or a bare PATH (contains '/')
+ *            or HOST:PORT.  An existing socket file at PATH is replaced.
+ *            An empty HOST (":PORT") means loopback; every interface
+ *            needs an explicit 0.0.0.0 or ::.
+ *   Returns: Listening socket, or -1 (message on stderr).
+ */
+int server_listen(const char *address);
+
+/*
+ * server_close - Close a socket from server_listen() and remove its
+ * socket file, if any.
+ */
+void server_close(int listen_fd, const char *address);
+
+/*
+ * server_run - Serve connections until server_stop() is called.
+ *
+ *   listen_fd: Socket from server_listen() (not closed).
+ *   cfg:       Worker threads and batch size.
+ *   stats:     Counters at exit (may be NULL).
+ *   Returns: 0 after server_stop(), -1 if the workers or the wake-up
+ *            pipe could not be created.
+ *
+ * Queued requests are answered before returning.  One server per
+ * process.
+ */
+int server_run(int listen_fd, const ServerConfig *cfg, ServerStats *stats);
+
+/* server_stop - Ask server_run() to return (async-signal-safe). */
+void server_stop(void);
+
+/*
+ * server_parse_request - Parse one request line.
+ *
+ *   err: Set to a message when the line is rejected.
+ *   Returns: 1 on success, 0 on malformed JSON, an unknown op or field
+ *            value, or a range longer than SERVER_MAX_RANGE_DAYS.
+ *            req->id is filled whenever it could be read, so errors can
+ *            still be matched.
+ */
+int server_parse_request(const char *line, ServerRequest *req, const char **err);
+
+/*
+ * server_execute - Compute a request and append its response line
+ * (with trailing newline) to a malloc()ed buffer.
+ *
+ *   buf, len, cap: Buffer, bytes used and capacity; updated.
+ *   Returns: 1 on success, 0 if the buffer could not grow.
+ *
+ * SERVER_OP_STATS reports zeros here; server_run() answers it itself.
+ */
+int server_execute(const ServerRequest *req, char **buf, size_t *len, size_t *cap);
+
+#endif /* SERVER_H */
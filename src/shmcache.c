@@ -0,0 +1,376 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "shmcache.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SHMCACHE_LAYOUT 1
+#define HEADER_SIZE 128
+
+#ifdef USE_SWISSEPH
+#define SHMCACHE_BACKEND 2
+#else
+#define SHMCACHE_BACKEND 1
+#endif
+
+static const unsigned char MAGIC[8] = {'H', 'C', 'S', 'H', 'M', 'C', 1, 0};
+
+typedef struct {
+    uint64_t magic;        /* written last by the creator */
+    uint32_t layout;
+    uint32_t backend;
+    uint32_t slots;
+    uint32_t generation;
+    uint64_t hits, misses, inserts, evictions, contended, bypassed;
+} Header;
+
+typedef struct {
+    uint64_t seq;          /* bit 0 busy, 1-31 version, 32-63 generation */
+    uint64_t key[2];
+    uint64_t val[2];
+} Slot;
+
+/* Attached segment, shared by all threads of the process */
+static Header *shm_hdr = NULL;
+static Slot *shm_slots = NULL;
+static size_t shm_size = 0;
+static uint32_t shm_mask = 0;
+
+/* Round-robin eviction cursor (per thread, so no shared writes) */
+static THREAD_LOCAL unsigned evict_next = 0;
+
+#define LOAD(p)        __atomic_load_n((p), __ATOMIC_RELAXED)
+#define LOAD_ACQ(p)    __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STORE(p, v)    __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+#define STORE_REL(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define COUNT(field)   __atomic_fetch_add(&shm_hdr->field, 1, __ATOMIC_RELAXED)
+
+static uint64_t magic_word(void)
+{
+    uint64_t m;
+    memcpy(&m, MAGIC, sizeof(m));
+    return m;
+}
+
+int shmcache_open(const char *name, unsigned slots)
+{
+    if (shm_hdr) shmcache_close();
+
+    uint32_t n = 1;
+    if (slots == 0) slots = SHMCACHE_DEFAULT_SLOTS;
+    while (n < slots && n < (1u << 30)) n <<= 1;
+
+    int created = 1;
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0 && errno == EEXIST) {
+        created = 0;
+        fd = shm_open(name, O_RDWR, 0);
+    }
+    if (fd < 0) {
+        fprintf(stderr, "shmcache: cannot open '%s': %s\n", name, strerror(errno));
+        return -1;
+    }
+
+    size_t size = HEADER_SIZE + (size_t)n * sizeof(Slot);
+    if (created) {
+        if (ftruncate(fd, (off_t)size) != 0) {
+            fprintf(stderr, "shmcache: cannot size '%s': %s\n", name, strerror(errno));
+            close(fd);
+            shm_unlink(name);
+            return -1;
+        }
+    } else {
+        /* The creator sizes the segment before writing anything; wait
+         * up to a second for it */
+        struct stat st;
+        struct timespec pause = {0, 10000000};
+        int tries = 0;
+        while (fstat(fd, &st) == 0 && st.st_size < HEADER_SIZE && tries++ < 100)
+            nanosleep(&pause, NULL);
+        if (st.st_size < HEADER_SIZE) {
+            fprintf(stderr, "shmcache: '%s' was never initialised\n", name);
+            close(fd);
+            return -1;
+        }
+        size = (size_t)st.st_size;
+    }
+
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "shmcache: cannot map '%s': %s\n", name, strerror(errno));
+        if (created) shm_unlink(name);
+        return -1;
+    }
+    Header *h = map;
+
+    if (created) {
+        /* A new segment is zero-filled: every slot empty */
+        h->layout = SHMCACHE_LAYOUT;
+        h->backend = SHMCACHE_BACKEND;
+        h->slots = n;
+        h->generation = 1;
+        STORE_REL(&h->magic, magic_word());
+    } else {
+        struct timespec pause = {0, 10000000};
+        for (int tries = 0; LOAD_ACQ(&h->magic) != magic_word() && tries < 100; tries++)
+            nanosleep(&pause, NULL);
+        const char *why = NULL;
+        if (LOAD_ACQ(&h->magic) != magic_word())
+            why = "not a calendar cache";
+        else if (h->layout != SHMCACHE_LAYOUT)
+            why = "different layout version";
+        else if (h->backend != SHMCACHE_BACKEND)
+            why = "different ephemeris backend";
+        else if (h->slots == 0 || (h->slots & (h->slots - 1)) != 0 ||
+                 size != HEADER_SIZE + (size_t)h->slots * sizeof(Slot))
+            why = "bad table size";
+        if (why) {
+            fprintf(stderr, "shmcache: '%s': %s (remove it with shmcache_unlink)\n", name, why);
+            munmap(map, size);
+            return -1;
+        }
+        n = h->slots;
+    }
+
+    shm_hdr = h;
+    shm_slots = (Slot *)((char *)map + HEADER_SIZE);
+    shm_size = size;
+    shm_mask = n - 1;
+    return 0;
+}
+
+void shmcache_close(void)
+{
+    if (!shm_hdr) return;
+    munmap(shm_hdr, shm_size);
+    shm_hdr = NULL;
+    shm_slots = NULL;
+    shm_size = 0;
+}
+
+int shmcache_unlink(const char *name)
+{
+    return shm_unlink(name) == 0 ? 0 : -1;
+}
+
+unsigned shmcache_invalidate(void)
+{
+    if (!shm_hdr) return 0;
+    uint32_t gen = __atomic_add_fetch(&shm_hdr->generation, 1, __ATOMIC_ACQ_REL);
+    if (gen == 0)  /* 0 marks never-written slots */
+        gen = __atomic_add_fetch(&shm_hdr->generation, 1, __ATOMIC_ACQ_REL);
+    return gen;
+}
+
+int shmcache_stats(ShmCacheStats *stats)
+{
+    if (!shm_hdr) return -1;
+    stats->hits = LOAD(&shm_hdr->hits);
+    stats->misses = LOAD(&shm_hdr->misses);
+    stats->inserts = LOAD(&shm_hdr->inserts);
+    stats->evictions = LOAD(&shm_hdr->evictions);
+    stats->contended = LOAD(&shm_hdr->contended);
+    stats->bypassed = LOAD(&shm_hdr->bypassed);
+    stats->capacity = shm_hdr->slots;
+    stats->generation = LOAD(&shm_hdr->generation);
+    return 0;
+}
+
+/* ---- Keys ---- */
+
+/*
+ * Pack (kind, date, location) into two words; kind 0 is lunisolar and
+ * 1 + SolarCalendarType the solar calendars.  Returns 0 when a field does
+ * not quantize exactly or is out of range.
+ *
+ *   key[0]: latitude, longitude in 1e-6 degree (int32 each)
+ *   key[1]: bits 0-2 kind, 3-18 year + 32768, 19-22 month, 23-27 day,
+ *           28-38 UTC offset minutes + 1024, 39-53 altitude m + 16384
+ */
+static int make_key(int kind, int year, int month, int day, const Location *loc,
+                    uint64_t key[2])
+{
+    double lat = loc->latitude, lon = loc->longitude;
+    if (!(fabs(lat) <= 90.0 && fabs(lon) <= 180.0)) return 0;
+    long lat_q = lround(lat * 1e6), lon_q = lround(lon * 1e6);
+    long off_q = lround(loc->utc_offset * 60.0);
+    long alt_q = lround(loc->altitude);
+    if (lat_q / 1e6 != lat || lon_q / 1e6 != lon ||
+        off_q / 60.0 != loc->utc_offset || (double)alt_q != loc->altitude)
+        return 0;
+    if (year < -32768 || year > 32767 || month < 1 || month > 12 || day < 1 || day > 31 ||
+        off_q < -1024 || off_q > 1023 || alt_q < -16384 || alt_q > 16383)
+        return 0;
+
+    key[0] = ((uint64_t)(uint32_t)(int32_t)lat_q << 32) | (uint32_t)(int32_t)lon_q;
+    key[1] = (uint64_t)kind | (uint64_t)(year + 32768) << 3 | (uint64_t)month << 19 |
+             (uint64_t)day << 23 | (uint64_t)(off_q + 1024) << 28 |
+             (uint64_t)(alt_q + 16384) << 39;
+    return 1;
+}
+
+static uint32_t slot_index(const uint64_t key[2])
+{
+    /* splitmix64 finalizer */
+    uint64_t h = key[0] ^ (key[1] * 0x9E3779B97F4A7C15ull);
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+    return (uint32_t)(h ^ (h >> 31)) & shm_mask;
+}
+
+/* ---- Table ---- */
+
+static int table_get(int kind, int year, int month, int day, const Location *loc,
+                     uint64_t val[2])
+{
+    uint64_t key[2];
+    if (!make_key(kind, year, month, day, loc, key)) {
+        COUNT(bypassed);
+        return 0;
+    }
+    uint64_t gen = LOAD_ACQ(&shm_hdr->generation);
+    uint32_t idx = slot_index(key);
+
+    for (int i = 0; i < SHMCACHE_PROBE; i++) {
+        Slot *s = &shm_slots[(idx + (uint32_t)i) & shm_mask];
+        uint64_t seq = LOAD_ACQ(&s->seq);
+        if (seq == 0) break;  /* never written: nothing further along */
+        if ((seq & 1) || (seq >> 32) != gen) continue;
+        uint64_t k0 = LOAD(&s->key[0]), k1 = LOAD(&s->key[1]);
+        uint64_t v0 = LOAD(&s->val[0]), v1 = LOAD(&s->val[1]);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (LOAD(&s->seq) != seq) continue;  /* rewritten while reading */
+        if (k0 == key[0] && k1 == key[1]) {
+            val[0] = v0;
+            val[1] = v1;
+            COUNT(hits);
+            return 1;
+        }
+    }
+    COUNT(misses);
+    return 0;
+}
+
+static void table_put(int kind, int year, int month, int day, const Location *loc,
+                      const uint64_t val[2])
+{
+    uint64_t key[2];
+    if (!make_key(kind, year, month, day, loc, key)) return;
+    uint64_t gen = LOAD_ACQ(&shm_hdr->generation);
+    uint32_t idx = slot_index(key);
+
+    /* First empty or stale slot in the window, unless the key is there */
+    Slot *target = NULL;
+    uint64_t seen = 0;
+    for (int i = 0; i < SHMCACHE_PROBE; i++) {
+        Slot *s = &shm_slots[(idx + (uint32_t)i) & shm_mask];
+        uint64_t seq = LOAD_ACQ(&s->seq);
+        if (seq & 1) continue;
+        if (seq == 0 || (seq >> 32) != gen) {
+            if (!target) {
+                target = s;
+                seen = seq;
+            }
+            if (seq == 0) break;
+            continue;
+        }
+        if (LOAD(&s->key[0]) == key[0] && LOAD(&s->key[1]) == key[1]) return;
+    }
+    int evict = (target == NULL);
+    if (evict) {
+        target = &shm_slots[(idx + evict_next++ % SHMCACHE_PROBE) & shm_mask];
+        seen = LOAD_ACQ(&target->seq);
+        if (seen & 1) {
+            COUNT(contended);
+            return;
+        }
+    }
+
+    /* Claim the slot; if another writer got there first, drop this insert */
+    if (!__atomic_compare_exchange_n(&target->seq, &seen, seen | 1, 0,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+        COUNT(contended);
+        return;
+    }
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    STORE(&target->key[0], key[0]);
+    STORE(&target->key[1], key[1]);
+    STORE(&target->val[0], val[0]);
+    STORE(&target->val[1], val[1]);
+    uint64_t version = ((seen & 0xFFFFFFFFull) + 2) & 0xFFFFFFFEull;
+    STORE_REL(&target->seq, gen << 32 | version);
+
+    COUNT(inserts);
+    if (evict && (seen >> 32) == gen) COUNT(evictions);
+}
+
+/* ---- Calendar values ---- */
+
+/*
+ * HinduDate: val[0] = year_saka (int32) | year_vikram (int32) << 32,
+ *            val[1] = masa | adhika masa << 4 | paksha << 5 | tithi << 6 |
+ *                     adhika tithi << 10
+ */
+int shmcache_get_hindu(int year, int month, int day, const Location *loc,
+                       HinduDate *out)
+{
+    uint64_t v[2];
+    if (!shm_hdr || !table_get(0, year, month, day, loc, v)) return 0;
+    out->year_saka = (int32_t)(uint32_t)v[0];
+    out->year_vikram = (int32_t)(uint32_t)(v[0] >> 32);
+    out->masa = (MasaName)(v[1] & 0xF);
+    out->is_adhika_masa = (int)(v[1] >> 4 & 1);
+    out->paksha = (Paksha)(v[1] >> 5 & 1);
+    out->tithi = (int)(v[1] >> 6 & 0xF);
+    out->is_adhika_tithi = (int)(v[1] >> 10 & 1);
+    return 1;
+}
+
+void shmcache_put_hindu(int year, int month, int day, const Location *loc,
+                        const HinduDate *hd)
+{
+    if (!shm_hdr) return;
+    uint64_t v[2];
+    v[0] = (uint32_t)hd->year_saka | (uint64_t)(uint32_t)hd->year_vikram << 32;
+    v[1] = (uint64_t)hd->masa | (uint64_t)(hd->is_adhika_masa != 0) << 4 |
+           (uint64_t)hd->paksha << 5 | (uint64_t)hd->tithi << 6 |
+           (uint64_t)(hd->is_adhika_tithi != 0) << 10;
+    table_put(0, year, month, day, loc, v);
+}
+
+/*
+ * SolarDate: val[0] = jd_sankranti bits,
+ *            val[1] = year (int32) | month << 32 | day << 36 | rashi << 42
+ */
+int shmcache_get_solar(int year, int month, int day, const Location *loc,
+                       SolarCalendarType type, SolarDate *out)
+{
+    uint64_t v[2];
+    if (!shm_hdr || !table_get(1 + (int)type, year, month, day, loc, v)) return 0;
+    memcpy(&out->jd_sankranti, &v[0], sizeof(double));
+    out->year = (int32_t)(uint32_t)v[1];
+    out->month = (int)(v[1] >> 32 & 0xF);
+    out->day = (int)(v[1] >> 36 & 0x3F);
+    out->rashi = (int)(v[1] >> 42 & 0xF);
+    return 1;
+}
+
+void shmcache_put_solar(int year, int month, int day, const Location *loc,
+                        SolarCalendarType type, const SolarDate *sd)
+{
+    if (!shm_hdr) return;
+    uint64_t v[2];
+    memcpy(&v[0], &sd->jd_sankranti, sizeof(double));
+    v[1] = (uint32_t)sd->year | (uint64_t)sd->month << 32 | (uint64_t)sd->day << 36 |
+           (uint64_t)sd->rashi << 42;
+    table_put(1 + (int)type, year, month, day, loc, v);
+}
@@ -0,0 +1,91 @@
+/*
+ * shmcache.h - Cross-process shared-memory cache of daily calendar dates
+ *
+ * Once a process attaches with shmcache_open(), gregorian_to_hindu() and
+ * gregorian_to_solar() look their result up in a POSIX shared-memory
+ * table first and store it there after computing it, so every process
+ * on the host attached to the same name shares the work.  Until then
+ * (and after shmcache_close()) both functions behave as before.
+ *
+ * Keys are (calendar, date, location) with the location quantized to
+ * 1e-6 degree, whole metres and whole minutes of UTC offset.  A location
+ * that does not survive the round trip exactly is not cached, so a hit
+ * always returns what the computation would for the same arguments.
+ *
+ * The table is open addressing with linear probing over a window of
+ * SHMCACHE_PROBE slots and no locks.  Each slot has a sequence word
+ * (a seqlock): writers claim it with compare-and-swap, readers retry on
+ * nothing and treat a slot that changed under them as a miss, and an
+ * insert that finds its slot busy is dropped.  When the window is full
+ * a slot chosen round-robin is evicted.
+ *
+ * The segment header records a layout version and the ephemeris backend;
+ * processes built differently refuse to attach.  Entries are stamped
+ * with the segment's generation, and shmcache_invalidate() bumps it,
+ * which drops every entry at once without blocking readers.
+ *
+ * Layout (native byte order, one host):
+ *
+ *   Header, 128 bytes:
+ *        0     8  "HCSHMC" 0x01 0x00
+ *        8     4  layout version
+ *       12     4  backend (1 = Moshier, 2 = Swiss Ephemeris)
+ *       16     4  slots (power of two)
+ *       20     4  generation
+ *       24    48  hits, misses, inserts, evictions, contended, bypassed
+ *                 (uint64)
+ *
+ *   Slot, 40 bytes: sequence (uint64: bit 0 busy, bits 1-31 version,
+ *   bits 32-63 generation), key (2 x uint64), value (2 x uint64).
+ */
+#ifndef SHMCACHE_H
+#define SHMCACHE_H
+
+#include "types.h"
+
+#define SHMCACHE_DEFAULT_SLOTS (1u << 18)
+#define SHMCACHE_PROBE 8
+
+/*
+ * shmcache_open - Create or attach to the segment called name.
+ *
+ *   name:  POSIX shared memory name, e.g. "/hindu-calendar".
+ *   slots: Table size when creating (rounded up to a power of two,
+ *          0 = SHMCACHE_DEFAULT_SLOTS); an existing segment keeps its
+ *          own size.
+ *   Returns: 0 on success, -1 (message on stderr) if the segment cannot
+ *            be opened or was made by an incompatible build.
+ *
+ * Attaches for the whole process; call before starting threads.
+ */
+int shmcache_open(const char *name, unsigned slots);
+
+/* shmcache_close - Detach (the segment stays for other processes). */
+void shmcache_close(void);
+
+/* shmcache_unlink - Remove the segment name; returns 0 or -1. */
+int shmcache_unlink(const char *name);
+
+/*
+ * shmcache_invalidate - Make every entry stale, in all processes.
+ * Returns: The new generation, or 0 if not attached.
+ */
+unsigned shmcache_invalidate(void);
+
+/* shmcache_stats - Counters for the attached segment; returns 0 or -1. */
+int shmcache_stats(ShmCacheStats *stats);
+
+/*
+ * Lookups and inserts used by panchang.c and solar.c.  get returns 1 and
+ * fills *out on a hit, 0 otherwise (including when not attached).
+ */
+int shmcache_get_hindu(int year, int month, int day, const Location *loc,
+                       HinduDate *out);
+void shmcache_put_hindu(int year, int month, int day, const Location *loc,
+                        const HinduDate *hd);
+int shmcache_get_solar(int year, int month, int day, const Location *loc,
+                       SolarCalendarType type, SolarDate *out);
+void shmcache_put_solar(int year, int month, int day, const Location *loc,
+                        SolarCalendarType type, const SolarDate *sd);
+
+#endif /* SHMCACHE_H */
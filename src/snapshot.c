@@ -0,0 +1,578 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "snapshot.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef USE_SWISSEPH
+#define SNAPSHOT_BACKEND 2
+#else
+#define SNAPSHOT_BACKEND 1
+#endif
+
+/* The store stops growing at this many month starts plus sunrises */
+#define MAX_DAY_ENTRIES (1L << 21)
+
+static const unsigned char MAGIC[8] = {'H', 'C', 'S', 'N', 'A', 'P', 1, 0};
+
+typedef struct {
+    double before, after;      /* new moons bracketing the lunation */
+    int rashi_before, rashi_after;
+} Lunation;
+
+typedef struct {
+    double jd;
+    int rashi;                 /* rashi entered */
+} Sankranti;
+
+typedef struct {
+    double jd;                 /* civil day (sunrise) or sankranti */
+    double value;              /* sunrise JD or month start civil JD */
+    uint32_t loc;              /* index into locs[] + 1, 0 = empty slot */
+    uint32_t kind;             /* 0 = sunrise, 1 + SolarCalendarType */
+} DayEntry;
+
+/* Process-wide store; readers share the lock, inserts take it alone */
+static pthread_rwlock_t store_lock = PTHREAD_RWLOCK_INITIALIZER;
+static int store_enabled = 0;
+
+static Lunation *lunations = NULL;
+static long n_lunations = 0, cap_lunations = 0;
+static Sankranti *sankrantis = NULL;
+static long n_sankrantis = 0, cap_sankrantis = 0;
+
+static Location *locs = NULL;          /* distinct locations, in first-seen order */
+static uint32_t *loc_table = NULL;     /* open addressing: index + 1, 0 = empty */
+static long n_locs = 0, loc_table_size = 0;
+
+static DayEntry *day_table = NULL;     /* open addressing */
+static long n_day_entries = 0, day_table_size = 0;
+static long n_month_starts = 0, n_sunrises = 0;
+
+static long n_hits = 0, n_misses = 0;
+
+#define COUNT(var) __atomic_fetch_add(&(var), 1, __ATOMIC_RELAXED)
+
+/* ---- Hashing ---- */
+
+static uint64_t mix(uint64_t h, double v)
+{
+    uint64_t bits;
+    v += 0.0;  /* -0.0 and 0.0 hash alike */
+    memcpy(&bits, &v, sizeof(bits));
+    h ^= bits + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+    return h ^ (h >> 27);
+}
+
+static uint64_t hash_location(const Location *loc)
+{
+    uint64_t h = mix(0, loc->latitude);
+    h = mix(h, loc->longitude);
+    h = mix(h, loc->altitude);
+    return mix(h, loc->utc_offset);
+}
+
+static uint64_t hash_day(uint32_t loc, uint32_t kind, double jd)
+{
+    return mix((uint64_t)loc << 32 | kind, jd);
+}
+
+/* ---- Locations ---- */
+
+/* Index + 1 of loc, or 0 */
+static uint32_t find_location(const Location *loc)
+{
+    if (loc_table_size == 0) return 0;
+    long mask = loc_table_size - 1;
+    for (long i = (long)(hash_location(loc) & (uint64_t)mask);; i = (i + 1) & mask) {
+        uint32_t idx = loc_table[i];
+        if (idx == 0) return 0;
+        if (LOCATION_EQUAL(&locs[idx - 1], loc)) return idx;
+    }
+}
+
+static void loc_table_insert(uint32_t idx)
+{
+    long mask = loc_table_size - 1;
+    long i = (long)(hash_location(&locs[idx - 1]) & (uint64_t)mask);
+    while (loc_table[i] != 0) i = (i + 1) & mask;
+    loc_table[i] = idx;
+}
+
+/* Index + 1 of loc, adding it if new; 0 if out of memory */
+static uint32_t add_location(const Location *loc)
+{
+    uint32_t idx = find_location(loc);
+    if (idx) return idx;
+
+    if ((n_locs + 1) * 2 > loc_table_size) {
+        long size = loc_table_size ? loc_table_size * 2 : 64;
+        uint32_t *table = calloc((size_t)size, sizeof(uint32_t));
+        Location *grown = realloc(locs, (size_t)size / 2 * sizeof(Location));
+        if (!table || !grown) {
+            free(table);
+            if (grown) locs = grown;
+            return 0;
+        }
+        free(loc_table);
+        locs = grown;
+        loc_table = table;
+        loc_table_size = size;
+        for (long i = 0; i < n_locs; i++) loc_table_insert((uint32_t)i + 1);
+    }
+    locs[n_locs++] = *loc;
+    loc_table_insert((uint32_t)n_locs);
+    return (uint32_t)n_locs;
+}
+
+/* ---- Day entries ---- */
+
+static DayEntry *find_day(uint32_t loc, uint32_t kind, double jd)
+{
+    if (day_table_size == 0) return NULL;
+    long mask = day_table_size - 1;
+    for (long i = (long)(hash_day(loc, kind, jd) & (uint64_t)mask);; i = (i + 1) & mask) {
+        DayEntry *e = &day_table[i];
+        if (e->loc == 0) return NULL;
+        if (e->loc == loc && e->kind == kind && e->jd == jd) return e;
+    }
+}
+
+static void day_table_insert(const DayEntry *entry)
+{
+    long mask = day_table_size - 1;
+    long i = (long)(hash_day(entry->loc, entry->kind, entry->jd) & (uint64_t)mask);
+    while (day_table[i].loc != 0) i = (i + 1) & mask;
+    day_table[i] = *entry;
+}
+
+static void add_day(const Location *loc, uint32_t kind, double jd, double value)
+{
+    if (n_day_entries >= MAX_DAY_ENTRIES) return;
+    uint32_t li = add_location(loc);
+    if (li == 0 || find_day(li, kind, jd)) return;
+
+    if ((n_day_entries + 1) * 2 > day_table_size) {
+        long size = day_table_size ? day_table_size * 2 : 4096;
+        DayEntry *old = day_table, *table = calloc((size_t)size, sizeof(DayEntry));
+        if (!table) return;
+        long old_size = day_table_size;
+        day_table = table;
+        day_table_size = size;
+        for (long i = 0; i < old_size; i++)
+            if (old[i].loc != 0) day_table_insert(&old[i]);
+        free(old);
+    }
+    DayEntry e = { jd, value, li, kind };
+    day_table_insert(&e);
+    n_day_entries++;
+    if (kind == 0) n_sunrises++; else n_month_starts++;
+}
+
+static int get_day(const Location *loc, uint32_t kind, double jd, double *value)
+{
+    if (!store_enabled) return 0;
+    pthread_rwlock_rdlock(&store_lock);
+    uint32_t li = find_location(loc);
+    DayEntry *e = li ? find_day(li, kind, jd) : NULL;
+    if (e) *value = e->value;
+    pthread_rwlock_unlock(&store_lock);
+    if (e) COUNT(n_hits); else COUNT(n_misses);
+    return e != NULL;
+}
+
+/* ---- Lunations and sankrantis (sorted arrays) ---- */
+
+/* Number of lunations with before < jd */
+static long lunation_rank(double jd)
+{
+    long lo = 0, hi = n_lunations;
+    while (lo < hi) {
+        long mid = (lo + hi) / 2;
+        if (lunations[mid].before < jd) lo = mid + 1; else hi = mid;
+    }
+    return lo;
+}
+
+static void add_lunation(double before, double after, int rashi_before, int rashi_after)
+{
+    long pos = lunation_rank(before);
+    /* The same new moon found from another starting point differs in
+     * its last bits: keep the first */
+    if ((pos > 0 && before - lunations[pos - 1].before < 1.0) ||
+        (pos < n_lunations && lunations[pos].before - before < 1.0))
+        return;
+    if (n_lunations == cap_lunations) {
+        long cap = cap_lunations ? cap_lunations * 2 : 256;
+        Lunation *grown = realloc(lunations, (size_t)cap * sizeof(Lunation));
+        if (!grown) return;
+        lunations = grown;
+        cap_lunations = cap;
+    }
+    memmove(&lunations[pos + 1], &lunations[pos],
+            (size_t)(n_lunations - pos) * sizeof(Lunation));
+    Lunation l = { before, after, rashi_before, rashi_after };
+    lunations[pos] = l;
+    n_lunations++;
+}
+
+/* Number of sankrantis with JD < jd */
+static long sankranti_rank(double jd)
+{
+    long lo = 0, hi = n_sankrantis;
+    while (lo < hi) {
+        long mid = (lo + hi) / 2;
+        if (sankrantis[mid].jd < jd) lo = mid + 1; else hi = mid;
+    }
+    return lo;
+}
+
+static double add_sankranti(double jd, int rashi)
+{
+    long pos = sankranti_rank(jd);
+    if (pos > 0 && jd - sankrantis[pos - 1].jd < 1.0) return sankrantis[pos - 1].jd;
+    if (pos < n_sankrantis && sankrantis[pos].jd - jd < 1.0) return sankrantis[pos].jd;
+    if (n_sankrantis == cap_sankrantis) {
+        long cap = cap_sankrantis ? cap_sankrantis * 2 : 256;
+        Sankranti *grown = realloc(sankrantis, (size_t)cap * sizeof(Sankranti));
+        if (!grown) return jd;
+        sankrantis = grown;
+        cap_sankrantis = cap;
+    }
+    memmove(&sankrantis[pos + 1], &sankrantis[pos],
+            (size_t)(n_sankrantis - pos) * sizeof(Sankranti));
+    sankrantis[pos].jd = jd;
+    sankrantis[pos].rashi = rashi;
+    n_sankrantis++;
+    return jd;
+}
+
+/* ---- Public lookups ---- */
+
+int snapshot_get_lunation(double jd, double *nm_before, double *nm_after,
+                          int *rashi_before, int *rashi_after)
+{
+    if (!store_enabled) return 0;
+    pthread_rwlock_rdlock(&store_lock);
+    long pos = lunation_rank(jd) - 1;
+    int found = pos >= 0 && jd < lunations[pos].after;
+    if (found) {
+        *nm_before = lunations[pos].before;
+        *nm_after = lunations[pos].after;
+        *rashi_before = lunations[pos].rashi_before;
+        *rashi_after = lunations[pos].rashi_after;
+    }
+    pthread_rwlock_unlock(&store_lock);
+    if (found) COUNT(n_hits); else COUNT(n_misses);
+    return found;
+}
+
+void snapshot_put_lunation(double nm_before, double nm_after,
+                           int rashi_before, int rashi_after)
+{
+    if (!store_enabled) return;
+    pthread_rwlock_wrlock(&store_lock);
+    add_lunation(nm_before, nm_after, rashi_before, rashi_after);
+    pthread_rwlock_unlock(&store_lock);
+}
+
+int snapshot_get_sankranti(int rashi, double lo, double hi, double *jd)
+{
+    if (!store_enabled) return 0;
+    int found = 0;
+    pthread_rwlock_rdlock(&store_lock);
+    for (long i = sankranti_rank(lo); i < n_sankrantis && sankrantis[i].jd < hi; i++) {
+        if (sankrantis[i].rashi == rashi && sankrantis[i].jd > lo) {
+            *jd = sankrantis[i].jd;
+            found = 1;
+            break;
+        }
+    }
+    pthread_rwlock_unlock(&store_lock);
+    if (found) COUNT(n_hits); else COUNT(n_misses);
+    return found;
+}
+
+double snapshot_put_sankranti(double jd, int rashi)
+{
+    if (!store_enabled) return jd;
+    pthread_rwlock_wrlock(&store_lock);
+    double stored = add_sankranti(jd, rashi);
+    pthread_rwlock_unlock(&store_lock);
+    return stored;
+}
+
+int snapshot_get_month_start(SolarCalendarType type, const Location *loc,
+                             double jd_sankranti, double *jd_civil)
+{
+    return get_day(loc, 1 + (uint32_t)type, jd_sankranti, jd_civil);
+}
+
+void snapshot_put_month_start(SolarCalendarType type, const Location *loc,
+                              double jd_sankranti, double jd_civil)
+{
+    if (!store_enabled) return;
+    pthread_rwlock_wrlock(&store_lock);
+    add_day(loc, 1 + (uint32_t)type, jd_sankranti, jd_civil);
+    pthread_rwlock_unlock(&store_lock);
+}
+
+int snapshot_get_sunrise(double jd, const Location *loc, double *jd_rise)
+{
+    return get_day(loc, 0, jd, jd_rise);
+}
+
+void snapshot_put_sunrise(double jd, const Location *loc, double jd_rise)
+{
+    if (!store_enabled) return;
+    pthread_rwlock_wrlock(&store_lock);
+    add_day(loc, 0, jd, jd_rise);
+    pthread_rwlock_unlock(&store_lock);
+}
+
+/* ---- Control ---- */
+
+void snapshot_enable(void)
+{
+    store_enabled = 1;
+}
+
+void snapshot_disable(void)
+{
+    pthread_rwlock_wrlock(&store_lock);
+    store_enabled = 0;
+    free(lunations);
+    free(sankrantis);
+    free(locs);
+    free(loc_table);
+    free(day_table);
+    lunations = NULL;
+    sankrantis = NULL;
+    locs = NULL;
+    loc_table = NULL;
+    day_table = NULL;
+    n_lunations = cap_lunations = n_sankrantis = cap_sankrantis = 0;
+    n_locs = loc_table_size = 0;
+    n_day_entries = day_table_size = n_month_starts = n_sunrises = 0;
+    n_hits = n_misses = 0;
+    pthread_rwlock_unlock(&store_lock);
+}
+
+void snapshot_stats(SnapshotStats *stats)
+{
+    pthread_rwlock_rdlock(&store_lock);
+    stats->lunations = n_lunations;
+    stats->sankrantis = n_sankrantis;
+    stats->month_starts = n_month_starts;
+    stats->sunrises = n_sunrises;
+    pthread_rwlock_unlock(&store_lock);
+    stats->hits = __atomic_load_n(&n_hits, __ATOMIC_RELAXED);
+    stats->misses = __atomic_load_n(&n_misses, __ATOMIC_RELAXED);
+}
+
+/* ---- File I/O ---- */
+
+static void put_u32(unsigned char *p, uint32_t v)
+{
+    for (int i = 0; i < 4; i++) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static void put_f64(unsigned char *p, double v)
+{
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    for (int i = 0; i < 8; i++) p[i] = (unsigned char)(bits >> (8 * i));
+}
+
+static uint32_t get_u32(const unsigned char *p)
+{
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static double get_f64(const unsigned char *p)
+{
+    uint64_t bits = (uint64_t)get_u32(p) | (uint64_t)get_u32(p + 4) << 32;
+    double v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+long snapshot_save(const char *path)
+{
+    pthread_rwlock_rdlock(&store_lock);
+    size_t size = SNAPSHOT_HEADER_SIZE + (size_t)n_lunations * 24 +
+                  (size_t)n_sankrantis * 16 + (size_t)n_locs * 32 +
+                  (size_t)n_day_entries * 24;
+    unsigned char *buf = calloc(1, size);
+    if (!buf) {
+        pthread_rwlock_unlock(&store_lock);
+        fprintf(stderr, "snapshot: out of memory writing '%s'\n", path);
+        return -1;
+    }
+
+    unsigned char *p = buf;
+    memcpy(p, MAGIC, 8);
+    put_u32(p + 8, SNAPSHOT_VERSION);
+    put_u32(p + 12, SNAPSHOT_BACKEND);
+    put_u32(p + 16, (uint32_t)n_lunations);
+    put_u32(p + 20, (uint32_t)n_sankrantis);
+    put_u32(p + 24, (uint32_t)n_locs);
+    put_u32(p + 28, (uint32_t)n_day_entries);
+    p += SNAPSHOT_HEADER_SIZE;
+    for (long i = 0; i < n_lunations; i++, p += 24) {
+        put_f64(p, lunations[i].before);
+        put_f64(p + 8, lunations[i].after);
+        p[16] = (unsigned char)lunations[i].rashi_before;
+        p[17] = (unsigned char)lunations[i].rashi_after;
+    }
+    for (long i = 0; i < n_sankrantis; i++, p += 16) {
+        put_f64(p, sankrantis[i].jd);
+        p[8] = (unsigned char)sankrantis[i].rashi;
+    }
+    for (long i = 0; i < n_locs; i++, p += 32) {
+        put_f64(p, locs[i].latitude);
+        put_f64(p + 8, locs[i].longitude);
+        put_f64(p + 16, locs[i].altitude);
+        put_f64(p + 24, locs[i].utc_offset);
+    }
+    for (long i = 0; i < day_table_size; i++) {
+        const DayEntry *e = &day_table[i];
+        if (e->loc == 0) continue;
+        put_u32(p, e->loc - 1);
+        put_u32(p + 4, e->kind);
+        put_f64(p + 8, e->jd);
+        put_f64(p + 16, e->value);
+        p += 24;
+    }
+    long records = n_lunations + n_sankrantis + n_day_entries;
+    pthread_rwlock_unlock(&store_lock);
+
+    /* Write beside the target and rename, so a crash never leaves a
+     * half-written snapshot under the real name */
+    char tmp[4096];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE *f = fopen(tmp, "wb");
+    int ok = f && fwrite(buf, 1, size, f) == size;
+    if (f && fclose(f) != 0) ok = 0;
+    free(buf);
+    if (!ok || rename(tmp, path) != 0) {
+        fprintf(stderr, "snapshot: cannot write '%s'\n", path);
+        remove(tmp);
+        return -1;
+    }
+    return records;
+}
+
+static int valid_jd(double jd)
+{
+    return isfinite(jd) && jd > -1e7 && jd < 1e8;
+}
+
+long snapshot_load(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "snapshot: cannot open '%s'\n", path);
+        return -1;
+    }
+    size_t cap = 1 << 16, size = 0;
+    unsigned char *buf = malloc(cap);
+    for (;;) {
+        if (buf && size == cap) {
+            unsigned char *grown = realloc(buf, cap * 2);
+            if (!grown) {
+                free(buf);
+                buf = NULL;
+            }
+            buf = grown;
+            cap *= 2;
+        }
+        if (!buf) break;
+        size_t n = fread(buf + size, 1, cap - size, f);
+        size += n;
+        if (n == 0) break;
+    }
+    fclose(f);
+    if (!buf) {
+        fprintf(stderr, "snapshot: out of memory reading '%s'\n", path);
+        return -1;
+    }
+
+    /* Validate everything before touching the store */
+    const char *why = NULL;
+    uint32_t nl = 0, ns = 0, nloc = 0, nd = 0;
+    if (size < SNAPSHOT_HEADER_SIZE || memcmp(buf, MAGIC, 8) != 0) {
+        why = "not a snapshot file";
+    } else if (get_u32(buf + 8) != SNAPSHOT_VERSION) {
+        why = "different layout version";
+    } else if (get_u32(buf + 12) != SNAPSHOT_BACKEND) {
+        why = "different ephemeris backend";
+    } else {
+        nl = get_u32(buf + 16);
+        ns = get_u32(buf + 20);
+        nloc = get_u32(buf + 24);
+        nd = get_u32(buf + 28);
+        if (size != SNAPSHOT_HEADER_SIZE + (size_t)nl * 24 + (size_t)ns * 16 +
+                    (size_t)nloc * 32 + (size_t)nd * 24)
+            why = "truncated or wrong size";
+    }
+    const unsigned char *lp = buf + SNAPSHOT_HEADER_SIZE;
+    const unsigned char *sp = lp + (size_t)nl * 24;
+    const unsigned char *cp = sp + (size_t)ns * 16;
+    const unsigned char *dp = cp + (size_t)nloc * 32;
+    for (uint32_t i = 0; !why && i < nl; i++) {
+        const unsigned char *r = lp + (size_t)i * 24;
+        double b = get_f64(r), a = get_f64(r + 8);
+        if (!valid_jd(b) || !valid_jd(a) || !(a > b && a - b < 31.0) ||
+            r[16] < 1 || r[16] > 12 || r[17] < 1 || r[17] > 12)
+            why = "bad lunation record";
+    }
+    for (uint32_t i = 0; !why && i < ns; i++) {
+        const unsigned char *r = sp + (size_t)i * 16;
+        if (!valid_jd(get_f64(r)) || r[8] < 1 || r[8] > 12)
+            why = "bad sankranti record";
+    }
+    for (uint32_t i = 0; !why && i < nloc; i++) {
+        const unsigned char *r = cp + (size_t)i * 32;
+        if (!(fabs(get_f64(r)) <= 90.0) || !(fabs(get_f64(r + 8)) <= 180.0) ||
+            !isfinite(get_f64(r + 16)) || !(fabs(get_f64(r + 24)) <= 24.0))
+            why = "bad location record";
+    }
+    for (uint32_t i = 0; !why && i < nd; i++) {
+        const unsigned char *r = dp + (size_t)i * 24;
+        if (get_u32(r) >= nloc || get_u32(r + 4) > 1 + (uint32_t)SOLAR_CAL_MALAYALAM ||
+            !valid_jd(get_f64(r + 8)) || !isfinite(get_f64(r + 16)))
+            why = "bad day record";
+    }
+    if (why) {
+        fprintf(stderr, "snapshot: '%s': %s\n", path, why);
+        free(buf);
+        return -1;
+    }
+
+    pthread_rwlock_wrlock(&store_lock);
+    store_enabled = 1;
+    for (uint32_t i = 0; i < nl; i++) {
+        const unsigned char *r = lp + (size_t)i * 24;
+        add_lunation(get_f64(r), get_f64(r + 8), r[16], r[17]);
+    }
+    for (uint32_t i = 0; i < ns; i++) {
+        const unsigned char *r = sp + (size_t)i * 16;
+        add_sankranti(get_f64(r), r[8]);
+    }
+    for (uint32_t i = 0; i < nd; i++) {
+        const unsigned char *r = dp + (size_t)i * 24;
+        const unsigned char *c = cp + (size_t)get_u32(r) * 32;
+        Location loc = { get_f64(c), get_f64(c + 8), get_f64(c + 16), get_f64(c + 24) };
+        add_day(&loc, get_u32(r + 4), get_f64(r + 8), get_f64(r + 16));
+    }
+    pthread_rwlock_unlock(&store_lock);
+
+    free(buf);
+    return (long)nl + ns + nd;
+}
@@ -0,0 +1,112 @@
+/*
+ * snapshot.h - Warm-start store for computed lunations, sankrantis,
+ * solar month starts and sunrises
+ *
+ * The per-thread caches in masa.c, panchang.c and solar.c only help
+ * while a thread walks consecutive days; a fresh process (or a thread
+ * jumping around the calendar) pays for new moons, sankrantis and
+ * sunrises again.  Once snapshot_enable() is called, those results are
+ * also kept in one process-wide store that every thread consults before
+ * computing, and snapshot_save() / snapshot_load() carry the store
+ * across restarts.
+ *
+ *   lunations:    new moon before and after, with the rashi at each
+ *                 (location independent), used by masa_for_date()
+ *   sankrantis:   sidereal sign entries (location independent), used by
+ *                 gregorian_to_solar() for month and year starts
+ *   month starts: first civil day of the solar month begun by a
+ *                 sankranti, per calendar and location
+ *   sunrises:     sunrise JD of a civil day, per location, used by
+ *                 gregorian_to_hindu()
+ *
+ * A stored new moon or sankranti may differ in its last bits from the
+ * value a cold computation starting elsewhere would find, exactly as
+ * with the per-thread caches; calendar fields are unaffected.
+ *
+ * File layout (all integers little-endian):
+ *
+ *   Header, 48 bytes:
+ *        0     8  "HCSNAP" 0x01 0x00
+ *        8     4  layout version (SNAPSHOT_VERSION)
+ *       12     4  backend (1 = Moshier, 2 = Swiss Ephemeris)
+ *       16     4  lunations
+ *       20     4  sankrantis
+ *       24     4  locations
+ *       28     4  day entries (month starts and sunrises)
+ *       32    16  zero
+ *
+ *   Lunation, 24 bytes:  new moon before, after (float64), rashi at
+ *                        each (uint8), 6 zero bytes; sorted by the first.
+ *   Sankranti, 16 bytes: JD (float64), rashi (uint8), 7 zero bytes;
+ *                        sorted by JD.
+ *   Location, 32 bytes:  latitude, longitude, altitude, utc_offset.
+ *   Day entry, 24 bytes: location index (uint32), kind (uint32: 0 =
+ *                        sunrise of the civil day at JD, 1 + type =
+ *                        SolarCalendarType month start of the sankranti
+ *                        at JD), JD, value (float64).
+ *
+ * Files from another layout version or ephemeris backend are refused;
+ * bump SNAPSHOT_VERSION whenever a change to the calculations would
+ * change stored values.
+ */
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "types.h"
+
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_HEADER_SIZE 48
+
+/*
+ * snapshot_enable - Start consulting and filling the store.  Call before
+ * starting threads.  snapshot_load() enables it too.
+ */
+void snapshot_enable(void);
+
+/* snapshot_disable - Stop using the store and free its contents. */
+void snapshot_disable(void);
+
+/*
+ * snapshot_save - Write the store to path.
+ *   Returns: Number of records written, or -1 (message on stderr).
+ */
+long snapshot_save(const char *path);
+
+/*
+ * snapshot_load - Merge a file written by snapshot_save() into the store
+ * and enable it.
+ *
+ *   Returns: Number of records read, or -1 (message on stderr) if the
+ *            file cannot be read, is truncated or corrupt, or comes from
+ *            another layout version or ephemeris backend.  On error the
+ *            store is left as it was.
+ */
+long snapshot_load(const char *path);
+
+/* snapshot_stats - Store sizes and lookup counters. */
+void snapshot_stats(SnapshotStats *stats);
+
+/*
+ * Lookups and inserts used by masa.c, panchang.c and solar.c.  get
+ * returns 1 and fills the outputs when the store has the value, 0
+ * otherwise (always 0 while disabled).
+ */
+int snapshot_get_lunation(double jd, double *nm_before, double *nm_after,
+                          int *rashi_before, int *rashi_after);
+void snapshot_put_lunation(double nm_before, double nm_after,
+                           int rashi_before, int rashi_after);
+
+/* Sankranti into rashi with lo < JD < hi */
+int snapshot_get_sankranti(int rashi, double lo, double hi, double *jd);
+/* Returns the stored JD of this sankranti (jd itself if it is new) */
+double snapshot_put_sankranti(double jd, int rashi);
+
+int snapshot_get_month_start(SolarCalendarType type, const Location *loc,
+                             double jd_sankranti, double *jd_civil);
+void snapshot_put_month_start(SolarCalendarType type, const Location *loc,
+                              double jd_sankranti, double jd_civil);
+
+int snapshot_get_sunrise(double jd, const Location *loc, double *jd_rise);
+void snapshot_put_sunrise(double jd, const Location *loc, double jd_rise);
+
+#endif /* SNAPSHOT_H */
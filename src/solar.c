@@ -1,8 +1,11 @@
 #include "solar.h"
 #include "astro.h"
+#include "cache.h"
 #include "masa.h"
 #include "tithi.h"
 #include "date_utils.h"
+#include "shmcache.h"
+#include "snapshot.h"
 #include <math.h>
 #include <string.h>
 
@@ -177,6 +180,7 @@ double sankranti_jd(double jd_approx, double target_longitude)
     /* Bracket: target should be within this range */
     double lo = jd_approx - 20.0;
     double hi = jd_approx + 20.0;
+    CALL_STAT(CS_SANKRANTI);
 
     /* Verify bracket: longitude at lo should be before target,
      * longitude at hi should be after target. */
@@ -403,6 +407,20 @@ static void sankranti_to_civil_day(double jd_sankranti, const Location *loc,
     }
 }
 
+/* sankranti_to_civil_day(), from the warm-start store when it has it */
+static void month_start_civil_day(double jd_sankranti, const Location *loc,
+                                  SolarCalendarType type, int rashi,
+                                  int *gy, int *gm, int *gd)
+{
+    double jd_civil;
+    if (snapshot_get_month_start(type, loc, jd_sankranti, &jd_civil)) {
+        jd_to_gregorian(jd_civil, gy, gm, gd);
+        return;
+    }
+    sankranti_to_civil_day(jd_sankranti, loc, type, rashi, gy, gm, gd);
+    snapshot_put_month_start(type, loc, jd_sankranti, gregorian_to_jd(*gy, *gm, *gd));
+}
+
 /* ---- Rashi to regional month number ---- */
 
 static int rashi_to_regional_month(int rashi, SolarCalendarType type)
@@ -414,17 +432,29 @@ static int rashi_to_regional_month(int rashi, SolarCalendarType type)
 }
 
 /* ---- Solar year cache ----
- * Cache the year-start civil JD for a (calendar_type, gregorian_year) pair.
- * The civil JD is the same for all dates in the same Gregorian year;
- * the before/after comparison still runs per call. */
-
-static struct {
+ * Cache the year-start civil JD for a (calendar, gregorian_year, location)
+ * key; the default four entries hold one year of each calendar, so
+ * interleaving calendars does not evict.  The civil JD is the same for
+ * all dates in the same Gregorian year; the before/after comparison
+ * still runs per call. */
+typedef struct {
     SolarCalendarType type;
     int greg_year;
+    Location loc;
     double jd_year_civil;
-    int gy_offset_on;
-    int gy_offset_before;
-} year_cache = {0, 0, 0, 0, 0};
+} SolarYearCache;
+
+static int year_cache_match(const void *entry, const void *key)
+{
+    const SolarYearCache *e = entry, *k = key;
+    return e->type == k->type && e->greg_year == k->greg_year &&
+           LOCATION_EQUAL(&e->loc, &k->loc);
+}
+
+static unsigned year_cache_hash(SolarCalendarType type, int gy)
+{
+    return (unsigned)gy * 4 + (unsigned)(get_config(type) - SOLAR_CONFIGS);
+}
 
 /* ---- Solar year computation ----
  *
@@ -443,28 +473,40 @@ static int solar_year(double jd_ut, const Location *loc,
 
     double jd_year_civil;
 
-    /* Check cache: same calendar type and Gregorian year */
-    if (year_cache.type == type && year_cache.greg_year == gy) {
-        jd_year_civil = year_cache.jd_year_civil;
+    /* Check cache: same Gregorian year and location */
+    SolarYearCache key = { type, gy, *loc, 0 };
+    const SolarYearCache *yc = cache_find(CACHE_SOLAR_YEAR, sizeof(SolarYearCache),
+                                          year_cache_hash(type, gy),
+                                          year_cache_match, &key);
+    if (yc) {
+        CACHE_HIT(CACHE_SOLAR_YEAR);
+        jd_year_civil = yc->jd_year_civil;
     } else {
+        CACHE_MISS(CACHE_SOLAR_YEAR);
         /* Find the year-start sankranti for this Gregorian year. */
         double target_long = (double)(cfg->year_start_rashi - 1) * 30.0;
         int approx_greg_month = 3 + cfg->year_start_rashi;
         if (approx_greg_month > 12) approx_greg_month -= 12;
 
         double jd_year_start_est = gregorian_to_jd(gy, approx_greg_month, 14);
-        double jd_year_start = sankranti_jd(jd_year_start_est, target_long);
+        double jd_year_start;
+        if (!snapshot_get_sankranti(cfg->year_start_rashi, jd_year_start_est - 20.0,
+                                    jd_year_start_est + 20.0, &jd_year_start)) {
+            jd_year_start = sankranti_jd(jd_year_start_est, target_long);
+            jd_year_start = snapshot_put_sankranti(jd_year_start, cfg->year_start_rashi);
+        }
 
         int ysy, ysm, ysd;
-        sankranti_to_civil_day(jd_year_start, loc, type, cfg->year_start_rashi,
-                               &ysy, &ysm, &ysd);
+        month_start_civil_day(jd_year_start, loc, type, cfg->year_start_rashi,
+                              &ysy, &ysm, &ysd);
         jd_year_civil = gregorian_to_jd(ysy, ysm, ysd);
 
-        year_cache.type = type;
-        year_cache.greg_year = gy;
-        year_cache.jd_year_civil = jd_year_civil;
-        year_cache.gy_offset_on = cfg->gy_offset_on;
-        year_cache.gy_offset_before = cfg->gy_offset_before;
+        SolarYearCache *e = cache_insert(CACHE_SOLAR_YEAR, sizeof(SolarYearCache),
+                                         year_cache_hash(type, gy));
+        if (e) {
+            key.jd_year_civil = jd_year_civil;
+            *e = key;
+        }
     }
 
     if (jd_greg_date >= jd_year_civil) {
@@ -477,24 +519,59 @@ static int solar_year(double jd_ut, const Location *loc,
 /* ---- Sankranti cache ----
  *
  * Consecutive days almost always share the same rashi (~30/31 days per sign).
- * Cache the last (type, rashi, sankranti_jd, civil_day_jd) to avoid redundant
- * 50-iteration bisections. Keyed on (calendar_type, rashi). */
+ * Cache (rashi, sankranti_jd, civil_day_jd) to avoid redundant 50-iteration
+ * bisections.  Keyed on (calendar, rashi, location) and valid for the ~35
+ * days after the civil month start; entries are hashed by the sidereal
+ * year the month falls in, so a larger cache keeps many years of months. */
 
-static struct {
+#define SIDEREAL_YEAR 365.25636
+#define MESHA_EPOCH 2451648.0   /* ~ Mesha sankranti 2000 */
+
+typedef struct {
     SolarCalendarType type;
     int rashi;
+    Location loc;
     double jd_sankranti;
     int civil_y, civil_m, civil_d;
     double jd_civil;
-} sank_cache = {0, 0, 0, 0, 0, 0, 0};
+} SankrantiCache;
+
+typedef struct {
+    SolarCalendarType type;
+    int rashi;
+    const Location *loc;
+    double jd;
+} SankrantiKey;
+
+static int sank_cache_match(const void *entry, const void *key)
+{
+    const SankrantiCache *e = entry;
+    const SankrantiKey *k = key;
+    return e->type == k->type && e->rashi == k->rashi &&
+           LOCATION_EQUAL(&e->loc, k->loc) &&
+           k->jd >= e->jd_civil && k->jd - e->jd_civil < 35.0;
+}
+
+/* jd is any day of the rashi's month; the middle of that month is well
+ * within half a year of it, so the year index is the same for all. */
+static unsigned sank_cache_hash(SolarCalendarType type, int rashi, double jd)
+{
+    double mid = MESHA_EPOCH + (rashi - 0.5) * SIDEREAL_YEAR / 12.0;
+    long y = (long)floor((jd - mid) / SIDEREAL_YEAR + 0.5);
+    return ((unsigned)y * 12 + (unsigned)(rashi - 1)) * 4 +
+           (unsigned)(get_config(type) - SOLAR_CONFIGS);
+}
 
 /* ---- Public API ---- */
 
-SolarDate gregorian_to_solar(int year, int month, int day,
-                             const Location *loc, SolarCalendarType type)
+static SolarDate solar_date_compute(int year, int month, int day,
+                                    const Location *loc, SolarCalendarType type)
 {
     SolarDate sd = {0};
 
+    if (shmcache_get_solar(year, month, day, loc, type, &sd))
+        return sd;
+
     double jd = gregorian_to_jd(year, month, day);
     double jd_crit = critical_time_jd(jd, loc, type);
 
@@ -510,38 +587,36 @@ SolarDate gregorian_to_solar(int year, int month, int day,
     sd.rashi = rashi;
 
     /* Find the sankranti that started this month — check cache first.
-     * Cache is valid if same type, same rashi, and the cached sankranti
+     * Cache is valid if same rashi and location, and the cached sankranti
      * is within ~35 days before the current date (same solar month). */
     int sy, sm, s_day;
     double jd_month_start;
-    int cache_hit = (sank_cache.type == type && sank_cache.rashi == rashi &&
-                     sank_cache.jd_sankranti > 0 &&
-                     jd > sank_cache.jd_civil &&
-                     jd - sank_cache.jd_civil < 35.0);
-
-    if (cache_hit) {
-        sd.jd_sankranti = sank_cache.jd_sankranti;
-        sy = sank_cache.civil_y;
-        sm = sank_cache.civil_m;
-        s_day = sank_cache.civil_d;
-        jd_month_start = sank_cache.jd_civil;
+    SankrantiKey key = { type, rashi, loc, jd };
+    const SankrantiCache *sc = cache_find(CACHE_SANKRANTI, sizeof(SankrantiCache),
+                                          sank_cache_hash(type, rashi, jd),
+                                          sank_cache_match, &key);
+
+    if (sc) {
+        CACHE_HIT(CACHE_SANKRANTI);
+        sd.jd_sankranti = sc->jd_sankranti;
+        sy = sc->civil_y;
+        sm = sc->civil_m;
+        s_day = sc->civil_d;
+        jd_month_start = sc->jd_civil;
     } else {
-        double target = (rashi - 1) * 30.0;
-        double degrees_past = lon - target;
-        if (degrees_past < 0) degrees_past += 360.0;
-        double jd_est = jd_crit - degrees_past;
-        sd.jd_sankranti = sankranti_jd(jd_est, target);
+        CACHE_MISS(CACHE_SANKRANTI);
+        /* The sign was entered at most ~32 days before the critical time
+         * (just after it, after the Bengali rashi correction) */
+        if (!snapshot_get_sankranti(rashi, jd_crit - 35.0, jd_crit + 1.0, &sd.jd_sankranti)) {
+            double target = (rashi - 1) * 30.0;
+            double degrees_past = lon - target;
+            if (degrees_past < 0) degrees_past += 360.0;
+            double jd_est = jd_crit - degrees_past;
+            sd.jd_sankranti = snapshot_put_sankranti(sankranti_jd(jd_est, target), rashi);
+        }
 
-        sankranti_to_civil_day(sd.jd_sankranti, loc, type, rashi, &sy, &sm, &s_day);
+        month_start_civil_day(sd.jd_sankranti, loc, type, rashi, &sy, &sm, &s_day);
         jd_month_start = gregorian_to_jd(sy, sm, s_day);
-
-        sank_cache.type = type;
-        sank_cache.rashi = rashi;
-        sank_cache.jd_sankranti = sd.jd_sankranti;
-        sank_cache.civil_y = sy;
-        sank_cache.civil_m = sm;
-        sank_cache.civil_d = s_day;
-        sank_cache.jd_civil = jd_month_start;
     }
 
     /* Day within solar month = days since month start + 1 */
@@ -558,15 +633,22 @@ SolarDate gregorian_to_solar(int year, int month, int day,
                                &sy, &sm, &s_day);
         jd_month_start = gregorian_to_jd(sy, sm, s_day);
         sd.day = (int)(jd - jd_month_start) + 1;
+    }
 
-        /* Update cache with corrected values */
-        sank_cache.type = type;
-        sank_cache.rashi = rashi;
-        sank_cache.jd_sankranti = sd.jd_sankranti;
-        sank_cache.civil_y = sy;
-        sank_cache.civil_m = sm;
-        sank_cache.civil_d = s_day;
-        sank_cache.jd_civil = jd_month_start;
+    /* Cache the (corrected) month for the following days */
+    if (!sc) {
+        SankrantiCache *e = cache_insert(CACHE_SANKRANTI, sizeof(SankrantiCache),
+                                         sank_cache_hash(type, rashi, jd));
+        if (e) {
+            e->type = type;
+            e->rashi = rashi;
+            e->loc = *loc;
+            e->jd_sankranti = sd.jd_sankranti;
+            e->civil_y = sy;
+            e->civil_m = sm;
+            e->civil_d = s_day;
+            e->jd_civil = jd_month_start;
+        }
     }
 
     /* Regional month number */
@@ -575,6 +657,16 @@ SolarDate gregorian_to_solar(int year, int month, int day,
     /* Year (solar_year has its own internal cache) */
     sd.year = solar_year(jd_crit, loc, jd, type);
 
+    shmcache_put_solar(year, month, day, loc, type, &sd);
+    return sd;
+}
+
+SolarDate gregorian_to_solar(int year, int month, int day,
+                             const Location *loc, SolarCalendarType type)
+{
+    LATENCY_BEGIN(lat);
+    SolarDate sd = solar_date_compute(year, month, day, loc, type);
+    LATENCY_END(lat, LAT_GREGORIAN_TO_SOLAR);
     return sd;
 }
 
@@ -1,10 +1,12 @@
 #include "tithi.h"
 #include "astro.h"
+#include "callstats.h"
 #include "date_utils.h"
 #include <math.h>
 
 double lunar_phase(double jd_ut)
 {
+    CALL_STAT(CS_LUNAR_PHASE);
     double moon = lunar_longitude(jd_ut);
     double sun = solar_longitude(jd_ut);
     double phase = fmod(moon - sun, 360.0);
@@ -31,6 +33,7 @@ double find_tithi_boundary(double jd_start, double jd_end, int target_tithi)
      * We search for the moment when lunar_phase crosses this value.
      * Use bisection on the phase difference. */
     double target_phase = (target_tithi - 1) * 12.0;
+    CALL_STAT(CS_TITHI_BOUNDARY);
 
     /* Bisection: find JD where lunar_phase == target_phase */
     double lo = jd_start;
@@ -18,6 +18,8 @@
 #ifndef TYPES_H
 #define TYPES_H
 
+#include <stdio.h>   /* FILE, size_t (RecordWriter) */
+
 /* ---------------------------------------------------------------------------
  * Location
  * ---------------------------------------------------------------------------
@@ -42,6 +44,21 @@ typedef struct {
 /* Default location: New Delhi (28.6139 N, 77.2090 E, IST = UTC+5:30) */
 #define DEFAULT_LOCATION { 28.6139, 77.2090, 0.0, 5.5 }
 
+/* Field-wise equality, for caches keyed on the location they were built for */
+#define LOCATION_EQUAL(a, b) \
+    ((a)->latitude == (b)->latitude && (a)->longitude == (b)->longitude && \
+     (a)->altitude == (b)->altitude && (a)->utc_offset == (b)->utc_offset)
+
+/* Storage class for the day-to-day caches in masa.c, panchang.c and
+ * solar.c: one copy per thread, so concurrent callers need no locking
+ * (same spelling as TLS in lib/swisseph/sweodef.h; C11 _Thread_local is
+ * not available under -std=c99). */
+#if defined(_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
 /* ---------------------------------------------------------------------------
  * Paksha - Lunar fortnight
  * ---------------------------------------------------------------------------
@@ -196,6 +213,22 @@ typedef enum {
     LUNISOLAR_PURNIMANTA,       /* Full-moon-to-full-moon */
 } LunisolarScheme;
 
+/* ---------------------------------------------------------------------------
+ * HinduDateMatch - Outcome of hindu_to_gregorian()
+ * ---------------------------------------------------------------------------
+ * A lunisolar date names zero, one or two civil days, depending on how
+ * many sunrises fall inside its tithi.
+ */
+typedef enum {
+    HINDU_MATCH_NONE = -1,      /* No such date (month absent, or adhika
+                                   tithi requested where there is none) */
+    HINDU_MATCH_EXACT = 0,      /* Tithi prevails at exactly one sunrise */
+    HINDU_MATCH_ADHIKA_TITHI,   /* Tithi prevails at two sunrises; the day
+                                   returned is chosen by is_adhika_tithi */
+    HINDU_MATCH_KSHAYA_TITHI,   /* Tithi prevails at no sunrise; the day
+                                   returned is the one during which it runs */
+} HinduDateMatch;
+
 /* ---------------------------------------------------------------------------
  * SolarCalendarType - Regional solar calendar variants
  * ---------------------------------------------------------------------------
@@ -231,6 +264,512 @@ typedef struct {
     double jd_sankranti;   /* JD (UT) of the sankranti that started this month */
 } SolarDate;
 
+/* ---------------------------------------------------------------------------
+ * TithiQuery / TithiOccurrence - Festival and vrata search
+ * ---------------------------------------------------------------------------
+ * A TithiQuery selects lunisolar dates by any combination of masa,
+ * adhika flag, paksha and tithi; each field has a wildcard value.
+ * Ekadashi in every month:   { 0, -1, -1, 11 }
+ * Every Amavasya:            { 0, -1, KRISHNA_PAKSHA, 15 }
+ * Nija Kartika Purnima only: { KARTIKA, 0, SHUKLA_PAKSHA, 15 }
+ *
+ * sunrises counts the sunrises at which the tithi prevails:
+ *   1 = normal; 2 = adhika tithi (the next civil day repeats it);
+ *   0 = kshaya tithi (no sunrise; the civil day is the one during which
+ *       the tithi runs, i.e. whose sunrise-to-sunrise span contains it).
+ */
+typedef struct {
+    int masa;              /* MasaName 1-12, or 0 = any month */
+    int is_adhika;         /* 0 = nija only, 1 = adhika only, -1 = either */
+    int paksha;            /* SHUKLA_PAKSHA, KRISHNA_PAKSHA, or -1 = either */
+    int tithi;             /* 1-15 within the paksha, or 0 = any */
+} TithiQuery;
+
+typedef struct {
+    int greg_year, greg_month, greg_day;  /* Civil day observing the tithi */
+    HinduDate hindu_date;                  /* masa/paksha/tithi of the tithi itself */
+    double jd_start;                       /* JD (UT) when the tithi begins */
+    double jd_end;                         /* JD (UT) when the tithi ends */
+    int sunrises;                          /* 0 = kshaya, 1 = normal, 2 = adhika */
+} TithiOccurrence;
+
+/* ---------------------------------------------------------------------------
+ * SankrantiOccurrence - A solar month start found by range search
+ * ---------------------------------------------------------------------------
+ */
+typedef struct {
+    int greg_year, greg_month, greg_day;  /* First civil day of the solar month */
+    SolarDate solar_date;                  /* Regional date on that day (day = 1) */
+} SankrantiOccurrence;
+
+/* ---------------------------------------------------------------------------
+ * EventType / AstroEvent / EventCursor - Next/previous event queries
+ * ---------------------------------------------------------------------------
+ * EventType values are bit flags so a query can ask for several kinds at
+ * once (e.g. EVENT_TITHI | EVENT_SUNRISE).  Events are totally ordered by
+ * (jd, type), so coinciding events (a new moon is also the start of
+ * tithi 1) are each returned once.
+ *
+ * AstroEvent.value is the tithi (1-30), nakshatra (1-27) or rashi (1-12)
+ * that begins at the event; 0 for moons, sunrise and sunset.
+ *
+ * EventCursor keeps, per event kind, the two consecutive events that
+ * bracket the last query, so monotonic queries cost one root find per
+ * event passed.  Initialise with event_cursor_init() (events.h); the
+ * fields are private.
+ */
+typedef enum {
+    EVENT_TITHI     = 1 << 0,  /* Moon-sun elongation crosses a multiple of 12 deg */
+    EVENT_NAKSHATRA = 1 << 1,  /* Sidereal moon crosses a multiple of 13 deg 20' */
+    EVENT_SANKRANTI = 1 << 2,  /* Sidereal sun crosses a multiple of 30 deg */
+    EVENT_NEW_MOON  = 1 << 3,  /* Elongation 0 deg */
+    EVENT_FULL_MOON = 1 << 4,  /* Elongation 180 deg */
+    EVENT_SUNRISE   = 1 << 5,  /* Upper-limb sunrise at the cursor's location */
+    EVENT_SUNSET    = 1 << 6,  /* Upper-limb sunset at the cursor's location */
+} EventType;
+
+#define EVENT_ALL        0x7F
+#define EVENT_KIND_COUNT 7
+
+typedef struct {
+    EventType type;        /* Single EVENT_* flag */
+    double jd;             /* JD (UT) of the event */
+    int value;             /* Tithi/nakshatra/rashi entered, or 0 */
+} AstroEvent;
+
+typedef struct {
+    double lo_jd, hi_jd;   /* Consecutive events, lo_jd <= query < hi_jd */
+    int lo_value, hi_value;
+    int valid;             /* 0 until first use */
+} EventBracket;
+
+typedef struct {
+    Location loc;
+    EventBracket bracket[EVENT_KIND_COUNT];
+    double last_jd;        /* Last event returned, for same-instant ties */
+    EventType last_type;
+} EventCursor;
+
+/* ---------------------------------------------------------------------------
+ * MomentAnnotation / Annotator - Streaming timestamp annotation
+ * ---------------------------------------------------------------------------
+ * annotate_moment() (annotate.h) labels an instant with the tithi and
+ * sidereal solar rashi in force.  The Annotator remembers the span over
+ * which the last labels hold, so sorted input costs a comparison per row
+ * and one root find per tithi/sankranti crossed; rows that jump back or
+ * far ahead are evaluated directly instead.
+ */
+typedef struct {
+    int tithi;             /* 1-30 */
+    Paksha paksha;         /* SHUKLA_PAKSHA or KRISHNA_PAKSHA */
+    int paksha_tithi;      /* 1-15 within the paksha */
+    int rashi;             /* Sidereal solar rashi 1-12 */
+} MomentAnnotation;
+
+typedef struct {
+    EventCursor tithi_events;  /* Tithi boundary source */
+    EventCursor rashi_events;  /* Sankranti source */
+    double tithi_from, tithi_until;   /* tithi holds on [from, until) */
+    int tithi;
+    double rashi_from, rashi_until;   /* rashi holds on [from, until) */
+    int rashi;
+    double last_jd;        /* Previous row, to tell sorted from shuffled */
+    long refreshes;        /* Boundary lookups (one per span entered) */
+    long direct;           /* Labels evaluated directly (out-of-order rows) */
+} Annotator;
+
+/* ---------------------------------------------------------------------------
+ * Choghadiya - Named eighth-part of the day or night
+ * ---------------------------------------------------------------------------
+ * Daytime (sunrise -> sunset) and nighttime (sunset -> next sunrise) are
+ * each split into 8 equal choghadiyas.  The names follow the planetary
+ * hora order (Sun, Venus, Mercury, Moon, Saturn, Jupiter, Mars); the
+ * first slot of the day is ruled by the weekday's lord.
+ */
+typedef enum {
+    CHOGHADIYA_UDVEG = 0,  /* Sun     - inauspicious */
+    CHOGHADIYA_CHAR,       /* Venus   - neutral */
+    CHOGHADIYA_LABH,       /* Mercury - auspicious */
+    CHOGHADIYA_AMRIT,      /* Moon    - auspicious */
+    CHOGHADIYA_KAAL,       /* Saturn  - inauspicious */
+    CHOGHADIYA_SHUBH,      /* Jupiter - auspicious */
+    CHOGHADIYA_ROG,        /* Mars    - inauspicious */
+} Choghadiya;
+
+/* ---------------------------------------------------------------------------
+ * TimeWindow - A span of time between two moments
+ * ---------------------------------------------------------------------------
+ */
+typedef struct {
+    double jd_start;       /* JD (UT) when the window opens */
+    double jd_end;         /* JD (UT) when the window closes */
+} TimeWindow;
+
+typedef struct {
+    Choghadiya name;       /* Which choghadiya */
+    TimeWindow window;     /* When it runs */
+} ChoghadiyaSlot;
+
+/* ---------------------------------------------------------------------------
+ * MuhurtaDay - Sunrise-based time divisions for one civil day
+ * ---------------------------------------------------------------------------
+ * All windows are derived from sunrise, sunset and the next day's
+ * sunrise.  Rahu Kalam, Yamaganda and Gulika Kalam are each one eighth
+ * of daytime, at a weekday-dependent position.  Abhijit is the 8th of
+ * the 15 daytime muhurtas (centred on local apparent noon).
+ *
+ * If the sun does not rise or set (polar day/night), is_valid is 0 and
+ * all windows are zero.
+ */
+typedef struct {
+    int greg_year, greg_month, greg_day;  /* Gregorian date */
+    int weekday;                          /* 0 = Monday .. 6 = Sunday */
+    int is_valid;                         /* 0 if rise/set not found */
+    double jd_sunrise;                    /* JD (UT) of sunrise */
+    double jd_sunset;                     /* JD (UT) of sunset */
+    double jd_next_sunrise;               /* JD (UT) of the following sunrise */
+    TimeWindow rahu_kalam;
+    TimeWindow yamaganda;
+    TimeWindow gulika_kalam;
+    TimeWindow abhijit;
+    ChoghadiyaSlot day_choghadiya[8];     /* sunrise -> sunset */
+    ChoghadiyaSlot night_choghadiya[8];   /* sunset -> next sunrise */
+} MuhurtaDay;
+
+/* ---------------------------------------------------------------------------
+ * CalendarRecord - One calendar date of one civil day, for output writers
+ * ---------------------------------------------------------------------------
+ * The common row of every machine-readable output (writer.h): the
+ * lunisolar date (HinduDate) or a regional solar date (SolarDate) of a
+ * Gregorian day at one location.
+ *
+ * calendar is CALENDAR_LUNISOLAR or CALENDAR_SOLAR(type).  For the
+ * lunisolar calendar year is Saka, month the masa and day the tithi
+ * within the paksha; solar calendars use their regional year, month and
+ * day, with paksha and the adhika flags 0.
+ */
+#define CALENDAR_LUNISOLAR      0
+#define CALENDAR_SOLAR(type)    (1 + (int)(type))
+#define CALENDAR_COUNT          5
+
+typedef struct {
+    int location;          /* caller's location index (binary output) */
+    int greg_year, greg_month, greg_day;
+    int weekday;           /* 0 = Monday .. 6 = Sunday */
+    int calendar;          /* CALENDAR_LUNISOLAR or CALENDAR_SOLAR(type) */
+    int year, month, day;
+    Paksha paksha;         /* lunisolar only */
+    int is_adhika_month;   /* lunisolar only */
+    int is_adhika_day;     /* lunisolar only: adhika tithi */
+} CalendarRecord;
+
+/* ---------------------------------------------------------------------------
+ * OutputFormat / RecordWriter - Buffered record output
+ * ---------------------------------------------------------------------------
+ * A RecordWriter formats CalendarRecords straight into its own buffer
+ * and hands the buffer to fwrite() when nearly full.  With out == NULL
+ * it accumulates in memory instead (growing as needed), for output that
+ * is assembled out of order and copied with writer_append().
+ */
+typedef enum {
+    OUTPUT_CSV = 0,        /* header line, then one line per record */
+    OUTPUT_JSONL,          /* one JSON object per line */
+    OUTPUT_BINARY          /* 16-byte file header, 16-byte records */
+} OutputFormat;
+
+typedef struct {
+    FILE *out;             /* destination, or NULL for in-memory */
+    OutputFormat format;
+    char *buf;
+    size_t len, cap;
+    long records;          /* records formatted so far */
+    int location;          /* set by writer_set_location() */
+    char location_name[128]; /* name, JSON-escaped for OUTPUT_JSONL */
+    int failed;            /* allocation or write error */
+} RecordWriter;
+
+/* ---------------------------------------------------------------------------
+ * BulkRequest - Date range x locations x calendars for bulk_generate()
+ * ---------------------------------------------------------------------------
+ * calendars is a mask of CALSET_* bits (1 << CALENDAR_*).  Rows are
+ * produced per (location, Gregorian month) work unit and written in
+ * location, date, calendar order whatever the thread count.
+ */
+#define CALSET_LUNISOLAR  0x01
+#define CALSET_TAMIL      0x02
+#define CALSET_BENGALI    0x04
+#define CALSET_ODIA       0x08
+#define CALSET_MALAYALAM  0x10
+#define CALSET_ALL        0x1F
+
+typedef struct {
+    char name[64];         /* label written in the location column */
+    Location loc;
+} NamedLocation;
+
+typedef struct {
+    const NamedLocation *locations;
+    int n_locations;
+    int y0, m0, d0;        /* first Gregorian date (inclusive) */
+    int y1, m1, d1;        /* last Gregorian date (inclusive) */
+    unsigned calendars;    /* CALSET_* mask */
+    int threads;           /* worker threads; <= 1 runs in the caller */
+    OutputFormat format;   /* CSV by default */
+} BulkRequest;
+
+/* ---------------------------------------------------------------------------
+ * PanchangArchive - Open packed panchang archive (archive.h)
+ * ---------------------------------------------------------------------------
+ * A read-only memory mapping of an archive file plus a one-year decode
+ * cache for archive_get_day().  The cache makes a handle unsafe to share
+ * between threads; archive_get_year() does not touch it.
+ */
+#define ARCHIVE_MAX_DAYS 366
+
+typedef struct {
+    const unsigned char *data;  /* mapped file */
+    size_t size;
+    int first_year, n_years;
+    int has_times;              /* sunrise and tithi boundaries stored */
+    Location loc;               /* location the archive was computed for */
+    int cached_year;            /* year decoded into cache, 0 = none */
+    int cached_count;
+    PanchangDay cache[ARCHIVE_MAX_DAYS];
+} PanchangArchive;
+
+/* ---------------------------------------------------------------------------
+ * Server types - Calendar daemon (server.h)
+ * ---------------------------------------------------------------------------
+ * One parsed request line.  Dates not used by an operation are 0.
+ */
+typedef enum {
+    SERVER_OP_DAY,         /* full panchang of one day (date) */
+    SERVER_OP_MONTH,       /* full panchang of a Gregorian month (year, month) */
+    SERVER_OP_RANGE,       /* calendar dates for a range (from, to, calendars) */
+    SERVER_OP_SOLAR,       /* solar calendar date (date, calendar) */
+    SERVER_OP_STATS,       /* server counters */
+    SERVER_OP_PING
+} ServerOp;
+
+#define SERVER_MAX_RANGE_DAYS 366
+
+/* Gregorian years the ephemeris precision is stated for
+ * (lib/moshier/moshier.h); requests outside them are rejected */
+#define SERVER_YEAR_MIN 1900
+#define SERVER_YEAR_MAX 2100
+
+typedef struct {
+    char id[64];           /* "id" value as sent (JSON text), "" if absent */
+    ServerOp op;
+    Location loc;          /* lat/lon/alt/utc_offset, default New Delhi */
+    int y0, m0, d0;        /* date, or first date of a range / month */
+    int y1, m1, d1;        /* last date of a range */
+    unsigned calendars;    /* CALSET_* mask for ranges (default lunisolar) */
+    SolarCalendarType solar_type;
+} ServerRequest;
+
+typedef struct {
+    int threads;           /* worker threads (>= 1) */
+    int max_batch;         /* most requests one worker takes at a time */
+} ServerConfig;
+
+typedef struct {
+    long connections;      /* accepted so far */
+    long requests;         /* request lines received */
+    long errors;           /* lines rejected as malformed */
+    long batches;          /* groups taken by workers */
+} ServerStats;
+
+/* ---------------------------------------------------------------------------
+ * ShmCacheStats - Shared-memory result cache counters (shmcache.h)
+ * ---------------------------------------------------------------------------
+ * Counters live in the segment, so they add up every attached process.
+ */
+typedef struct {
+    unsigned long hits;        /* lookups answered from the table */
+    unsigned long misses;      /* cacheable lookups not found */
+    unsigned long inserts;     /* results stored */
+    unsigned long evictions;   /* current-generation entries overwritten */
+    unsigned long contended;   /* inserts skipped: slot being written */
+    unsigned long bypassed;    /* lookups not cacheable (see shmcache.h) */
+    unsigned capacity;         /* slots in the table */
+    unsigned generation;       /* entries from older generations are stale */
+} ShmCacheStats;
+
+/* ---------------------------------------------------------------------------
+ * SnapshotStats - Warm-start store contents and counters (snapshot.h)
+ * ---------------------------------------------------------------------------
+ */
+typedef struct {
+    long lunations;        /* new moon pairs with their rashis */
+    long sankrantis;       /* sidereal sign entries */
+    long month_starts;     /* solar month first civil days, per location */
+    long sunrises;         /* sunrise JDs, per location and day */
+    long hits;             /* lookups answered by the store */
+    long misses;           /* lookups computed (and then stored) */
+} SnapshotStats;
+
+/* ---------------------------------------------------------------------------
+ * CsvFile - Memory-mapped CSV file (csvmap.h)
+ * ---------------------------------------------------------------------------
+ * Fields point into the read-only mapping and are not NUL-terminated.
+ * A handle is read by one thread at a time.
+ */
+#define CSV_MAX_FIELDS 16
+
+typedef struct {
+    const char *data;                  /* mapped file */
+    size_t size;
+    const char *pos;                   /* start of the next line */
+    long line;                         /* 1-based line of the current row */
+    int n_columns;                     /* fields in the header row */
+    const char *header[CSV_MAX_FIELDS];
+    int header_len[CSV_MAX_FIELDS];
+    int n_fields;                      /* fields in the current row */
+    const char *field[CSV_MAX_FIELDS];
+    int field_len[CSV_MAX_FIELDS];
+} CsvFile;
+
+/* ---------------------------------------------------------------------------
+ * ScanRequest / ScanHit / ScanResult - Parallel boundary scans (scan.h)
+ * ---------------------------------------------------------------------------
+ * The metric callback sees every event of the requested kinds in the
+ * range.  It returns 0 to skip the event, or 1 after setting hit->metric
+ * (signed distance to the boundary under study, in the caller's unit)
+ * and optionally hit->row (extra CSV fields, no leading comma).  It runs
+ * on worker threads: ctx must be read-only or protected by the caller.
+ */
+#define SCAN_ROW_MAX 192
+
+typedef struct {
+    AstroEvent ev;             /* event the metric was taken at */
+    double metric;             /* signed; hits are ranked by |metric| */
+    char row[SCAN_ROW_MAX];    /* caller's CSV fields for this hit */
+} ScanHit;
+
+typedef int (*ScanMetricFn)(const AstroEvent *ev, const Location *loc,
+                            void *ctx, ScanHit *hit);
+
+typedef struct {
+    double jd_start, jd_end;   /* events with jd_start < jd <= jd_end */
+    unsigned event_mask;       /* EVENT_* kinds to enumerate */
+    Location loc;              /* cursor and callback location */
+    ScanMetricFn metric;
+    void *ctx;                 /* passed to every metric call */
+    int top_n;                 /* hits to keep, closest first */
+    int threads;               /* worker threads; <= 1 runs in the caller */
+} ScanRequest;
+
+typedef struct {
+    ScanHit *hits;             /* sorted by |metric|, then jd */
+    int n_hits;                /* min(top_n, n_matched) */
+    long n_events;             /* events enumerated */
+    long n_matched;            /* events the callback kept */
+} ScanResult;
+
+/* ---------------------------------------------------------------------------
+ * CallStat / CallStats - Ephemeris call counters (callstats.h)
+ * ---------------------------------------------------------------------------
+ * One counter per ephemeris entry point, per derived search and per
+ * cache lookup (a HIT/MISS pair).  Only counted in builds with
+ * USE_CALL_STATS (make CALL_STATS=1); otherwise every count stays 0.
+ */
+typedef enum {
+    /* Ephemeris entry points (astro.c) */
+    CS_SOLAR_LONGITUDE,        /* tropical sun, incl. via the sidereal call */
+    CS_LUNAR_LONGITUDE,
+    CS_AYANAMSA,               /* incl. via solar_longitude_sidereal() */
+    CS_SUNRISE,
+    CS_SUNSET,
+    /* Searches built on them */
+    CS_LUNAR_PHASE,            /* tithi.c */
+    CS_TITHI_BOUNDARY,         /* find_tithi_boundary() bisections */
+    CS_NEW_MOON,               /* new_moon_before/after, full_moon_near */
+    CS_SANKRANTI,              /* sankranti_jd() bisections */
+    /* Cache lookups */
+    CS_LUNATION_HIT,           /* masa.c new moon pair */
+    CS_LUNATION_MISS,
+    CS_MONTH_HIT,              /* masa.c lunisolar month LRU */
+    CS_MONTH_MISS,
+    CS_PREV_DAY_HIT,           /* panchang.c previous day's sunrise tithi */
+    CS_PREV_DAY_MISS,
+    CS_SOLAR_YEAR_HIT,         /* solar.c year start */
+    CS_SOLAR_YEAR_MISS,
+    CS_SANKRANTI_HIT,          /* solar.c month start sankranti */
+    CS_SANKRANTI_MISS,
+    CS_COUNT
+} CallStat;
+
+typedef struct {
+    unsigned long count[CS_COUNT];
+} CallStats;
+
+/* ---------------------------------------------------------------------------
+ * LatencyApi / LatencyHistogram / LatencyStats - Latency histograms
+ * (latency.h)
+ * ---------------------------------------------------------------------------
+ * Log-linear buckets in nanoseconds: values below LAT_SUB_BUCKETS get one
+ * bucket each; above that every power of two is split into LAT_SUB_BUCKETS
+ * equal buckets, so a bucket is at most 1/16 (6.25%) of its value wide.
+ * The last bucket also takes everything above 2^LAT_MAX_EXP ns (~18 min).
+ */
+typedef enum {
+    LAT_GREGORIAN_TO_HINDU,
+    LAT_GREGORIAN_TO_SOLAR,
+    LAT_LUNISOLAR_MONTH_START,
+    LAT_SUNRISE,               /* no cache: every call counts as a miss */
+    LAT_SUNSET,
+    LAT_COUNT
+} LatencyApi;
+
+#define LAT_HIT  0
+#define LAT_MISS 1
+
+#define LAT_SUB_BITS    4
+#define LAT_SUB_BUCKETS (1 << LAT_SUB_BITS)
+#define LAT_MAX_EXP     40
+#define LAT_BUCKETS     (LAT_SUB_BUCKETS * (LAT_MAX_EXP - LAT_SUB_BITS + 2))
+
+typedef struct {
+    unsigned long count[LAT_BUCKETS];
+    unsigned long total;       /* samples */
+    double sum_ns;             /* for the mean */
+    unsigned long long min_ns, max_ns;
+} LatencyHistogram;
+
+typedef struct {
+    LatencyHistogram h[LAT_COUNT][2];  /* [api][LAT_HIT or LAT_MISS] */
+} LatencyStats;
+
+/* Tracer hook: one call per timed API call, on the calling thread */
+typedef void (*LatencyTraceFn)(LatencyApi api, int miss,
+                               unsigned long long start_ns,
+                               unsigned long long duration_ns, void *ctx);
+
+/* ---------------------------------------------------------------------------
+ * CacheId / CacheStats - Per-thread calendar caches (cache.h)
+ * ---------------------------------------------------------------------------
+ * Same order as the CS_*_HIT/CS_*_MISS pairs of CallStat.
+ */
+typedef enum {
+    CACHE_LUNATION,            /* masa.c: new moon pair around a sunrise */
+    CACHE_MONTH,               /* masa.c: lunisolar month start and length */
+    CACHE_PREV_DAY,            /* panchang.c: sunrise tithi of a civil day */
+    CACHE_SOLAR_YEAR,          /* solar.c: civil day the regional year starts */
+    CACHE_SANKRANTI,           /* solar.c: sankranti and civil day of a month start */
+    CACHE_COUNT
+} CacheId;
+
+typedef struct {
+    unsigned long hits, misses;
+    unsigned long evictions;   /* entries replaced to make room */
+    unsigned occupancy;        /* entries held by the fullest thread table */
+    unsigned capacity;         /* entries per thread */
+} CacheStats;
+
+/* 1 if entry (a cached record) answers key */
+typedef int (*CacheMatchFn)(const void *entry, const void *key);
+
 static const char *MASA_NAMES[] = {
     "",              /* 0 - unused */
     "Chaitra",       /* 1 */
@@ -0,0 +1,348 @@
+#include "writer.h"
+#include "solar.h"
+#include "date_utils.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Stream buffer size, and the most one record can take (JSONL with a
+ * fully escaped 63-character location name) */
+#define WRITER_BUFFER_SIZE (256 * 1024)
+#define WRITER_MAX_RECORD  512
+
+static const char *CALENDAR_NAMES[CALENDAR_COUNT] = {
+    "lunisolar", "tamil", "bengali", "odia", "malayalam"
+};
+
+static const char CSV_HEADER[] =
+    "location,date,weekday,calendar,year,month,month_name,adhika_month,"
+    "paksha,day,adhika_day\n";
+
+static const unsigned char BINARY_MAGIC[8] = {'H', 'C', 'A', 'L', 'R', 'E', 'C', 0x01};
+
+const char *calendar_name(int calendar)
+{
+    if (calendar < 0 || calendar >= CALENDAR_COUNT) return "?";
+    return CALENDAR_NAMES[calendar];
+}
+
+int parse_output_format(const char *str, OutputFormat *format)
+{
+    if (strcmp(str, "csv") == 0)   { *format = OUTPUT_CSV; return 1; }
+    if (strcmp(str, "jsonl") == 0) { *format = OUTPUT_JSONL; return 1; }
+    if (strcmp(str, "bin") == 0)   { *format = OUTPUT_BINARY; return 1; }
+    return 0;
+}
+
+/* ---- Buffer management ---- */
+
+/* Make room for n more bytes: flush a stream writer, grow an in-memory one */
+static int reserve(RecordWriter *w, size_t n)
+{
+    if (w->len + n <= w->cap) return 1;
+    if (w->out) {
+        writer_flush(w);
+        if (w->len + n <= w->cap) return 1;
+    }
+    size_t cap = w->cap ? w->cap : 4096;
+    while (cap < w->len + n) cap *= 2;
+    char *grown = realloc(w->buf, cap);
+    if (!grown) {
+        w->failed = 1;
+        return 0;
+    }
+    w->buf = grown;
+    w->cap = cap;
+    return 1;
+}
+
+static void put_bytes(RecordWriter *w, const void *p, size_t n)
+{
+    if (!reserve(w, n)) return;
+    memcpy(w->buf + w->len, p, n);
+    w->len += n;
+}
+
+int writer_init(RecordWriter *w, FILE *out, OutputFormat format)
+{
+    memset(w, 0, sizeof(*w));
+    w->out = out;
+    w->format = format;
+    w->cap = out ? WRITER_BUFFER_SIZE : 4096;
+    w->buf = malloc(w->cap);
+    if (!w->buf) {
+        w->cap = 0;
+        w->failed = 1;
+        return 0;
+    }
+    if (!out) return 1;
+
+    if (format == OUTPUT_CSV) {
+        put_bytes(w, CSV_HEADER, sizeof(CSV_HEADER) - 1);
+    } else if (format == OUTPUT_BINARY) {
+        unsigned char hdr[WRITER_BINARY_HEADER_SIZE] = {0};
+        memcpy(hdr, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+        hdr[8] = WRITER_BINARY_RECORD_SIZE & 0xFF;
+        hdr[9] = WRITER_BINARY_RECORD_SIZE >> 8;
+        put_bytes(w, hdr, sizeof(hdr));
+    }
+    return 1;
+}
+
+void writer_set_location(RecordWriter *w, int index, const char *name)
+{
+    /* An index the binary field cannot hold would be written truncated */
+    if (w->format == OUTPUT_BINARY && (index < 0 || index >= WRITER_BINARY_MAX_LOCATIONS))
+        w->failed = 1;
+    w->location = index;
+    size_t n = 0;
+    for (const char *p = name; *p && p - name < 63; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (w->format == OUTPUT_JSONL) {
+            if (c < 0x20) continue;
+            if (c == '"' || c == '\\') w->location_name[n++] = '\\';
+        }
+        w->location_name[n++] = (char)c;
+    }
+    w->location_name[n] = '\0';
+}
+
+int writer_flush(RecordWriter *w)
+{
+    if (w->out && w->len > 0) {
+        if (fwrite(w->buf, 1, w->len, w->out) != w->len)
+            w->failed = 1;
+        w->len = 0;
+    }
+    return w->failed ? -1 : 0;
+}
+
+int writer_close(RecordWriter *w)
+{
+    int rc = writer_flush(w);
+    free(w->buf);
+    w->buf = NULL;
+    w->len = w->cap = 0;
+    return rc;
+}
+
+void writer_append(RecordWriter *w, RecordWriter *src)
+{
+    if (src->failed) w->failed = 1;
+    if (src->len > WRITER_BUFFER_SIZE && w->out) {
+        /* Large block: bypass our buffer */
+        writer_flush(w);
+        if (fwrite(src->buf, 1, src->len, w->out) != src->len)
+            w->failed = 1;
+    } else {
+        put_bytes(w, src->buf, src->len);
+    }
+    w->records += src->records;
+    src->records = 0;
+    src->len = 0;
+}
+
+/* ---- Field formatting ---- */
+
+/* String literal: length known at compile time */
+#define PUT_LIT(p, lit) (memcpy((p), (lit), sizeof(lit) - 1), (p) + sizeof(lit) - 1)
+
+static char *put_str(char *p, const char *s)
+{
+    while (*s) *p++ = *s++;
+    return p;
+}
+
+static char *put_uint(char *p, unsigned v)
+{
+    char tmp[10];
+    int n = 0;
+    do {
+        tmp[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    while (n) *p++ = tmp[--n];
+    return p;
+}
+
+static char *put_int(char *p, int v)
+{
+    if (v < 0) {
+        *p++ = '-';
+        return put_uint(p, 0u - (unsigned)v);
+    }
+    return put_uint(p, (unsigned)v);
+}
+
+/* Zero-padded to at least width digits (width <= 4, v >= 0) */
+static char *put_padded(char *p, int v, int width)
+{
+    if (v < 0) return put_int(p, v);
+    int digits = (v >= 1000) ? 4 : (v >= 100) ? 3 : (v >= 10) ? 2 : 1;
+    for (int i = digits; i < width; i++) *p++ = '0';
+    return put_uint(p, (unsigned)v);
+}
+
+static char *put_date(char *p, const CalendarRecord *r)
+{
+    p = put_padded(p, r->greg_year, 4);
+    *p++ = '-';
+    p = put_padded(p, r->greg_month, 2);
+    *p++ = '-';
+    return put_padded(p, r->greg_day, 2);
+}
+
+static const char *record_month_name(const CalendarRecord *r)
+{
+    if (r->calendar == CALENDAR_LUNISOLAR)
+        return (r->month >= 1 && r->month <= 12) ? MASA_NAMES[r->month] : "???";
+    return solar_month_name(r->month, (SolarCalendarType)(r->calendar - 1));
+}
+
+static char *format_csv(char *p, const RecordWriter *w, const CalendarRecord *r)
+{
+    int luni = (r->calendar == CALENDAR_LUNISOLAR);
+    p = put_str(p, w->location_name);
+    *p++ = ',';
+    p = put_date(p, r);
+    *p++ = ',';
+    p = put_str(p, day_of_week_short(r->weekday));
+    *p++ = ',';
+    p = put_str(p, calendar_name(r->calendar));
+    *p++ = ',';
+    p = put_int(p, r->year);
+    *p++ = ',';
+    p = put_int(p, r->month);
+    *p++ = ',';
+    p = put_str(p, record_month_name(r));
+    *p++ = ',';
+    *p++ = (char)('0' + (r->is_adhika_month != 0));
+    *p++ = ',';
+    if (luni) p = put_str(p, r->paksha == SHUKLA_PAKSHA ? "Shukla" : "Krishna");
+    *p++ = ',';
+    p = put_int(p, r->day);
+    *p++ = ',';
+    *p++ = (char)('0' + (r->is_adhika_day != 0));
+    *p++ = '\n';
+    return p;
+}
+
+static char *format_jsonl(char *p, const RecordWriter *w, const CalendarRecord *r)
+{
+    p = PUT_LIT(p, "{\"location\":\"");
+    p = put_str(p, w->location_name);
+    p = PUT_LIT(p, "\",\"date\":\"");
+    p = put_date(p, r);
+    p = PUT_LIT(p, "\",\"weekday\":\"");
+    p = put_str(p, day_of_week_short(r->weekday));
+    p = PUT_LIT(p, "\",\"calendar\":\"");
+    p = put_str(p, calendar_name(r->calendar));
+    p = PUT_LIT(p, "\",\"year\":");
+    p = put_int(p, r->year);
+    p = PUT_LIT(p, ",\"month\":");
+    p = put_int(p, r->month);
+    p = PUT_LIT(p, ",\"month_name\":\"");
+    p = put_str(p, record_month_name(r));
+    p = PUT_LIT(p, "\",\"adhika_month\":");
+    *p++ = (char)('0' + (r->is_adhika_month != 0));
+    if (r->calendar == CALENDAR_LUNISOLAR)
+        p = (r->paksha == SHUKLA_PAKSHA) ? PUT_LIT(p, ",\"paksha\":\"Shukla\"")
+                                         : PUT_LIT(p, ",\"paksha\":\"Krishna\"");
+    else
+        p = PUT_LIT(p, ",\"paksha\":null");
+    p = PUT_LIT(p, ",\"day\":");
+    p = put_int(p, r->day);
+    p = PUT_LIT(p, ",\"adhika_day\":");
+    *p++ = (char)('0' + (r->is_adhika_day != 0));
+    p = PUT_LIT(p, "}\n");
+    return p;
+}
+
+static char *format_binary(char *p, const RecordWriter *w, const CalendarRecord *r)
+{
+    unsigned char *b = (unsigned char *)p;
+    unsigned loc = (unsigned)w->location;
+    unsigned gy = (unsigned)r->greg_year & 0xFFFF, cy = (unsigned)r->year & 0xFFFF;
+    b[0] = loc & 0xFF;
+    b[1] = (loc >> 8) & 0xFF;
+    b[2] = (unsigned char)r->calendar;
+    b[3] = (unsigned char)((r->is_adhika_month ? 1 : 0) | (r->is_adhika_day ? 2 : 0) |
+                           (r->calendar == CALENDAR_LUNISOLAR &&
+                            r->paksha == KRISHNA_PAKSHA ? 4 : 0));
+    b[4] = gy & 0xFF;
+    b[5] = gy >> 8;
+    b[6] = (unsigned char)r->greg_month;
+    b[7] = (unsigned char)r->greg_day;
+    b[8] = cy & 0xFF;
+    b[9] = cy >> 8;
+    b[10] = (unsigned char)r->month;
+    b[11] = (unsigned char)r->day;
+    b[12] = (unsigned char)r->weekday;
+    b[13] = b[14] = b[15] = 0;
+    return p + WRITER_BINARY_RECORD_SIZE;
+}
+
+void writer_record(RecordWriter *w, const CalendarRecord *rec)
+{
+    if (!reserve(w, WRITER_MAX_RECORD)) return;
+    char *start = w->buf + w->len, *end;
+    switch (w->format) {
+    case OUTPUT_JSONL:  end = format_jsonl(start, w, rec); break;
+    case OUTPUT_BINARY: end = format_binary(start, w, rec); break;
+    default:            end = format_csv(start, w, rec); break;
+    }
+    w->len += (size_t)(end - start);
+    w->records++;
+}
+
+/* ---- Records ---- */
+
+void calendar_record_lunisolar(CalendarRecord *rec, int y, int m, int d,
+                               const HinduDate *hd)
+{
+    memset(rec, 0, sizeof(*rec));
+    rec->greg_year = y;
+    rec->greg_month = m;
+    rec->greg_day = d;
+    rec->weekday = day_of_week(gregorian_to_jd(y, m, d));
+    rec->calendar = CALENDAR_LUNISOLAR;
+    rec->year = hd->year_saka;
+    rec->month = (int)hd->masa;
+    rec->day = hd->tithi;
+    rec->paksha = hd->paksha;
+    rec->is_adhika_month = hd->is_adhika_masa;
+    rec->is_adhika_day = hd->is_adhika_tithi;
+}
+
+void calendar_record_solar(CalendarRecord *rec, int y, int m, int d,
+                           SolarCalendarType type, const SolarDate *sd)
+{
+    memset(rec, 0, sizeof(*rec));
+    rec->greg_year = y;
+    rec->greg_month = m;
+    rec->greg_day = d;
+    rec->weekday = day_of_week(gregorian_to_jd(y, m, d));
+    rec->calendar = CALENDAR_SOLAR(type);
+    rec->year = sd->year;
+    rec->month = sd->month;
+    rec->day = sd->day;
+}
+
+int calendar_record_decode(const unsigned char *p, CalendarRecord *rec)
+{
+    memset(rec, 0, sizeof(*rec));
+    rec->location = p[0] | (p[1] << 8);
+    rec->calendar = p[2];
+    rec->is_adhika_month = (p[3] & 1) != 0;
+    rec->is_adhika_day = (p[3] & 2) != 0;
+    rec->paksha = (p[3] & 4) ? KRISHNA_PAKSHA : SHUKLA_PAKSHA;
+    rec->greg_year = (short)(p[4] | (p[5] << 8));
+    rec->greg_month = p[6];
+    rec->greg_day = p[7];
+    rec->year = (short)(p[8] | (p[9] << 8));
+    rec->month = p[10];
+    rec->day = p[11];
+    rec->weekday = p[12];
+    return rec->calendar < CALENDAR_COUNT &&
+           rec->greg_month >= 1 && rec->greg_month <= 12 &&
+           rec->greg_day >= 1 && rec->greg_day <= 31 && rec->weekday <= 6;
+}
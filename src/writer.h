@@ -0,0 +1,116 @@
+/*
+ * writer.h - Buffered CSV / JSON Lines / binary output of calendar dates
+ *
+ * Streams CalendarRecords (one lunisolar or solar date of one civil day)
+ * in a machine-readable format.  Fields are formatted by hand straight
+ * into a large buffer and written with one fwrite() per buffer, instead
+ * of a printf() per row.
+ *
+ * CSV columns (header written by writer_init()):
+ *
+ *   location,date,weekday,calendar,year,month,month_name,adhika_month,
+ *   paksha,day,adhika_day
+ *
+ * paksha is empty for solar calendars.  JSON Lines uses the same keys,
+ * one object per line, with "paksha": null for solar calendars.
+ *
+ * Binary: a 16-byte file header ("HCALREC" 0x01, then the record size
+ * as uint16 and six zero bytes), then fixed 16-byte little-endian
+ * records:
+ *
+ *   offset  size  field
+ *        0     2  location index (uint16)
+ *        2     1  calendar (CALENDAR_*)
+ *        3     1  flags: 1 = adhika month, 2 = adhika day, 4 = Krishna
+ *        4     2  Gregorian year (int16)
+ *        6     1  Gregorian month
+ *        7     1  Gregorian day
+ *        8     2  calendar year (int16)
+ *       10     1  calendar month
+ *       11     1  calendar day
+ *       12     1  weekday (0 = Monday)
+ *       13     3  zero
+ *
+ * Binary output carries location indices, not names; the caller keeps
+ * the index -> location mapping (e.g. the -L file order).  Indices must
+ * fit the uint16 field: at most WRITER_BINARY_MAX_LOCATIONS locations.
+ */
+#ifndef WRITER_H
+#define WRITER_H
+
+#include "types.h"
+
+#define WRITER_BINARY_HEADER_SIZE 16
+#define WRITER_BINARY_RECORD_SIZE 16
+#define WRITER_BINARY_MAX_LOCATIONS 65536   /* indices 0-65535 */
+
+/*
+ * writer_init - Start a writer.
+ *
+ *   w:      Writer to initialise.
+ *   out:    Destination stream, or NULL to accumulate in memory (no
+ *           header is written then; see writer_append()).
+ *   format: OUTPUT_CSV, OUTPUT_JSONL or OUTPUT_BINARY.
+ *   Returns: 1 on success, 0 if the buffer could not be allocated.
+ */
+int writer_init(RecordWriter *w, FILE *out, OutputFormat format);
+
+/*
+ * writer_set_location - Location for the following records: the index
+ * goes into binary records, the name into CSV/JSONL (truncated to 63
+ * characters).
+ */
+void writer_set_location(RecordWriter *w, int index, const char *name);
+
+/*
+ * writer_record - Append one record.  rec->location is ignored; the
+ * writer's current location is used.
+ */
+void writer_record(RecordWriter *w, const CalendarRecord *rec);
+
+/*
+ * writer_append - Append everything an in-memory writer has formatted
+ * (same format) to w, and empty src.
+ */
+void writer_append(RecordWriter *w, RecordWriter *src);
+
+/*
+ * writer_flush - Write buffered output to the stream (no-op in memory).
+ *   Returns: 0 on success, -1 after any allocation or write error.
+ */
+int writer_flush(RecordWriter *w);
+
+/*
+ * writer_close - Flush and free the buffer (the stream stays open).
+ *   Returns: 0 on success, -1 after any allocation or write error.
+ */
+int writer_close(RecordWriter *w);
+
+/*
+ * calendar_record_lunisolar / calendar_record_solar - Fill a record from
+ * a conversion result for Gregorian date y-m-d.
+ */
+void calendar_record_lunisolar(CalendarRecord *rec, int y, int m, int d,
+                               const HinduDate *hd);
+void calendar_record_solar(CalendarRecord *rec, int y, int m, int d,
+                           SolarCalendarType type, const SolarDate *sd);
+
+/*
+ * calendar_record_decode - Read one binary record (16 bytes).
+ *   Returns: 1 on success, 0 if the calendar or date fields are invalid.
+ */
+int calendar_record_decode(const unsigned char *p, CalendarRecord *rec);
+
+/*
+ * calendar_name - "lunisolar", "tamil", "bengali", "odia", "malayalam",
+ * or "?" for an invalid index.
+ */
+const char *calendar_name(int calendar);
+
+/*
+ * parse_output_format - "csv", "jsonl" or "bin".
+ *   Returns: 1 on success, 0 on an unknown name.
+ */
+int parse_output_format(const char *str, OutputFormat *format);
+
+#endif /* WRITER_H */
@@ -14,6 +14,11 @@ let package = Package(
             dependencies: ["HinduCalendar"],
             path: "Sources/HinduCalendarCLI"
         ),
+        .executableTarget(
+            name: "port-bench",
+            dependencies: ["HinduCalendar"],
+            path: "Sources/PortBench"
+        ),
         .testTarget(
             name: "HinduCalendarTests",
             dependencies: ["HinduCalendar"],
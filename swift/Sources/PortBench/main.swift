@@ -0,0 +1,140 @@
+// Swift driver for the cross-port benchmark (`make bench-ports`).
+//
+// Reads a workload file (format in tools/bench_ports.workload), converts
+// every (location, date) pair in every listed calendar and writes the
+// canonical rows compared by tools/bench_ports.py.  Only the conversions
+// are timed.
+
+import Foundation
+import HinduCalendar
+
+let calendarNames = ["lunisolar", "tamil", "bengali", "odia", "malayalam"]
+let solarTypes: [SolarCalendarType] = [.tamil, .bengali, .odia, .malayalam]
+
+struct Workload {
+    var jd0 = -1.0, jd1 = -1.0
+    var locs: [Location] = []
+    var calendars: [Int] = []
+    var seed: UInt32? = nil
+}
+
+func fail(_ msg: String) -> Never {
+    FileHandle.standardError.write(Data("Error: \(msg)\n".utf8))
+    exit(1)
+}
+
+/// Peak resident set of this process in KiB (Linux VmHWM), or 0
+func peakRssKb() -> Int {
+    guard let status = try? String(contentsOfFile: "/proc/self/status", encoding: .utf8) else {
+        return 0
+    }
+    for line in status.split(separator: "\n") where line.hasPrefix("VmHWM:") {
+        return Int(line.split(separator: " ", omittingEmptySubsequences: true)[1]) ?? 0
+    }
+    return 0
+}
+
+func parseDay(_ eph: Ephemeris, _ s: Substring) -> Double? {
+    let p = s.split(separator: "-").compactMap { Int($0) }
+    guard p.count == 3, (1...12).contains(p[1]), (1...31).contains(p[2]) else { return nil }
+    return eph.gregorianToJd(year: p[0], month: p[1], day: p[2])
+}
+
+/// The workload, or nil and the line number of the first bad line
+func loadWorkload(_ eph: Ephemeris, _ text: String) -> (Workload?, Int) {
+    var w = Workload()
+    var lineno = 0
+    for line in text.split(separator: "\n", omittingEmptySubsequences: false) {
+        lineno += 1
+        let tok = line.split(whereSeparator: { $0 == " " || $0 == "\t" || $0 == "\r" })
+        if tok.isEmpty || tok[0].hasPrefix("#") { continue }
+        var ok = false
+        switch (tok[0], tok.count) {
+        case ("from", 2):
+            if let jd = parseDay(eph, tok[1]) { w.jd0 = jd; ok = true }
+        case ("to", 2):
+            if let jd = parseDay(eph, tok[1]) { w.jd1 = jd; ok = true }
+        case ("location", 4):
+            if let lat = Double(tok[1]), let lon = Double(tok[2]), let off = Double(tok[3]) {
+                w.locs.append(Location(latitude: lat, longitude: lon, altitude: 0.0, utcOffset: off))
+                ok = true
+            }
+        case ("calendars", _):
+            let idx = tok.dropFirst().compactMap { calendarNames.firstIndex(of: String($0)) }
+            ok = idx.count == tok.count - 1
+            w.calendars += idx
+        case ("order", 2):
+            ok = tok[1] == "sequential"
+            w.seed = nil
+        case ("order", 3):
+            if tok[1] == "random", let seed = UInt32(tok[2]) { w.seed = seed; ok = true }
+        default:
+            break
+        }
+        if !ok { return (nil, lineno) }
+    }
+    if w.jd0 < 0 || w.jd1 < w.jd0 || w.locs.isEmpty || w.calendars.isEmpty {
+        return (nil, lineno + 1)
+    }
+    return (w, 0)
+}
+
+let args = CommandLine.arguments
+if args.count != 2 {
+    FileHandle.standardError.write(Data("Usage: port-bench WORKLOAD\n".utf8))
+    exit(1)
+}
+guard let text = try? String(contentsOfFile: args[1], encoding: .utf8) else {
+    fail("cannot open '\(args[1])'")
+}
+let ephemeris = Ephemeris()
+let (loaded, badLine) = loadWorkload(ephemeris, text)
+guard let w = loaded else {
+    fail("\(args[1]) line \(badLine): bad or missing workload entry")
+}
+let panchang = Panchang(ephemeris: ephemeris)
+let solar = Solar(ephemeris: ephemeris)
+
+// (location, day) pairs, location-major, optionally shuffled
+let nDays = Int(w.jd1 - w.jd0) + 1
+let n = nDays * w.locs.count
+var order = Array(0..<n)
+if var x = w.seed {
+    for i in stride(from: n - 1, to: 0, by: -1) {
+        x = x &* 1103515245 &+ 12345
+        let j = Int((x >> 8) % UInt32(i + 1))
+        order.swapAt(i, j)
+    }
+}
+
+// loc, y, m, d, calendar, year, month, adhika, day per row
+var rows: [Int] = []
+rows.reserveCapacity(n * w.calendars.count * 9)
+let start = DispatchTime.now().uptimeNanoseconds
+for k in order {
+    let loc = k / nDays
+    let (y, m, d) = ephemeris.jdToGregorian(w.jd0 + Double(k % nDays))
+    for c in w.calendars {
+        rows += [loc, y, m, d, c]
+        if c == 0 {
+            let hd = panchang.gregorianToHindu(year: y, month: m, day: d, loc: w.locs[loc])
+            rows += [hd.yearSaka, hd.masa.rawValue, hd.isAdhikaMasa ? 1 : 0,
+                     hd.tithi + (hd.paksha == .krishna ? 15 : 0)]
+        } else {
+            let sd = solar.gregorianToSolar(year: y, month: m, day: d, loc: w.locs[loc],
+                                            type: solarTypes[c - 1])
+            rows += [sd.year, sd.month, 0, sd.day]
+        }
+    }
+}
+let elapsed = DispatchTime.now().uptimeNanoseconds - start
+
+var out = ""
+out.reserveCapacity(rows.count * 4)
+for i in stride(from: 0, to: rows.count, by: 9) {
+    out += String(format: "%d,%04d-%02d-%02d,", rows[i], rows[i + 1], rows[i + 2], rows[i + 3])
+    out += "\(calendarNames[rows[i + 4]]),\(rows[i + 5]),\(rows[i + 6]),\(rows[i + 7]),\(rows[i + 8])\n"
+}
+FileHandle.standardOutput.write(Data(out.utf8))
+FileHandle.standardError.write(Data(
+    "rows=\(rows.count / 9) compute_ns=\(elapsed) peak_rss_kb=\(peakRssKb())\n".utf8))
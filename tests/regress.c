@@ -0,0 +1,380 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "tithi.h"
+#include "masa.h"
+#include "solar.h"
+#include "astro.h"
+#include "date_utils.h"
+#include "csvmap.h"
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+ * Parallel regression runner (make regress): every row of the reference
+ * CSVs, not a sample.
+ *
+ * Each CSV is mapped and parsed in place (csvmap.h), then cut into
+ * shards of SHARD_LUNATIONS lunations (daily rows are cut where the
+ * tithi wraps back to the new month, month rows count one each), so a
+ * thread walks consecutive days of whole months and the thread-local
+ * caches in masa.c, panchang.c and solar.c stay warm.  Worker threads
+ * take shards in any order; each shard keeps its own counters and
+ * failure messages, which are printed in shard order once the suite is
+ * done, so the output is the same for any thread count apart from the
+ * timings.
+ *
+ * Usage: regress [-j THREADS] [-d DIR] [SUITE...]
+ *   DIR defaults to validation/moshier (validation/se with USE_SWISSEPH);
+ *   SUITE is one of lunisolar, adhika_kshaya, lunisolar_months, tamil,
+ *   bengali, odia, malayalam (default: all).
+ */
+
+#define SHARD_LUNATIONS 12
+#define MAX_FIELDS 8
+
+#ifdef USE_SWISSEPH
+#define DEFAULT_DIR "validation/se"
+#else
+#define DEFAULT_DIR "validation/moshier"
+#endif
+
+/* One parsed CSV row: integer fields, plus the text of the last column */
+typedef struct {
+    int v[MAX_FIELDS];
+    const char *text;   /* points into the mapping, not terminated */
+    int text_len;
+} Row;
+
+typedef struct Suite Suite;
+typedef struct Shard Shard;
+
+struct Suite {
+    const char *name;
+    const char *file;          /* relative to the data directory */
+    int n_ints;                /* leading integer columns */
+    int has_text;              /* a text column follows them */
+    SolarCalendarType cal;     /* solar suites */
+    /* 1 if row i starts a new lunation (or month) */
+    int (*starts_unit)(const Row *rows, int i);
+    void (*check_row)(const Suite *s, const Row *r, Shard *sh);
+
+    CsvFile csv;
+    Row *rows;
+    int n_rows;
+    int bad_rows;              /* rows that did not parse: each a failure */
+};
+
+struct Shard {
+    const Suite *suite;
+    int first, end;            /* rows [first, end) */
+    long run, failed;
+    char *log;                 /* failure messages */
+    size_t log_len, log_cap;
+};
+
+static const Location DELHI = DEFAULT_LOCATION;
+
+/* ===== Checks ===== */
+
+static void check(Shard *sh, int condition, const char *fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+static void check(Shard *sh, int condition, const char *fmt, ...)
+{
+    sh->run++;
+    if (condition) return;
+    sh->failed++;
+
+    char msg[256];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(msg, sizeof(msg), fmt, ap);
+    va_end(ap);
+    if (n < 0) return;
+    if ((size_t)n >= sizeof(msg)) n = sizeof(msg) - 1;
+
+    size_t need = sh->log_len + n + 10;
+    if (need > sh->log_cap) {
+        size_t cap = sh->log_cap ? 2 * sh->log_cap : 1024;
+        while (cap < need) cap *= 2;
+        char *grown = realloc(sh->log, cap);
+        if (!grown) return;
+        sh->log = grown;
+        sh->log_cap = cap;
+    }
+    sh->log_len += sprintf(sh->log + sh->log_len, "  FAIL: %s\n", msg);
+}
+
+/* year,month,day,tithi,masa,adhika,saka[,type] */
+static void check_day(const Suite *s, const Row *r, Shard *sh)
+{
+    const int *v = r->v;
+    TithiInfo ti = tithi_at_sunrise(v[0], v[1], v[2], &DELHI);
+    MasaInfo mi = masa_for_date(v[0], v[1], v[2], &DELHI);
+
+    char day[48];
+    int n = snprintf(day, sizeof(day), "%04d-%02d-%02d", v[0], v[1], v[2]);
+    if (s->has_text)
+        snprintf(day + n, sizeof(day) - n, " [%.*s]", r->text_len, r->text);
+
+    check(sh, ti.tithi_num == v[3], "%s tithi (got %d, expected %d)", day, ti.tithi_num, v[3]);
+    check(sh, (int)mi.name == v[4], "%s masa (got %d, expected %d)", day, (int)mi.name, v[4]);
+    check(sh, mi.is_adhika == v[5], "%s adhika (got %d, expected %d)", day, mi.is_adhika, v[5]);
+    check(sh, mi.year_saka == v[6], "%s saka (got %d, expected %d)", day, mi.year_saka, v[6]);
+}
+
+/* masa,is_adhika,saka_year,length,greg_year,greg_month,greg_day,masa_name */
+static void check_lunisolar_month(const Suite *s, const Row *r, Shard *sh)
+{
+    (void)s;
+    const int *v = r->v;
+    double jd = lunisolar_month_start((MasaName)v[0], v[2], v[1], LUNISOLAR_AMANTA, &DELHI);
+    int ry = 0, rm = 0, rd = 0;
+    if (jd > 0) jd_to_gregorian(jd, &ry, &rm, &rd);
+    check(sh, ry == v[4] && rm == v[5] && rd == v[6],
+          "%s%.*s %d: start (got %04d-%02d-%02d, expected %04d-%02d-%02d)",
+          v[1] ? "Adhika " : "", r->text_len, r->text, v[2], ry, rm, rd, v[4], v[5], v[6]);
+    if (v[3] > 0) {
+        int len = lunisolar_month_length((MasaName)v[0], v[2], v[1], LUNISOLAR_AMANTA, &DELHI);
+        check(sh, len == v[3], "%s%.*s %d: length (got %d, expected %d)",
+              v[1] ? "Adhika " : "", r->text_len, r->text, v[2], len, v[3]);
+    }
+}
+
+/* month,year,length,greg_year,greg_month,greg_day,month_name */
+static void check_solar_month(const Suite *s, const Row *r, Shard *sh)
+{
+    const int *v = r->v;
+    SolarDate sd = gregorian_to_solar(v[3], v[4], v[5], &DELHI, s->cal);
+    check(sh, sd.month == v[0], "%s %04d-%02d-%02d: month (got %d, expected %d)",
+          s->name, v[3], v[4], v[5], sd.month, v[0]);
+    check(sh, sd.year == v[1], "%s %04d-%02d-%02d: year (got %d, expected %d)",
+          s->name, v[3], v[4], v[5], sd.year, v[1]);
+    check(sh, sd.day == 1, "%s %04d-%02d-%02d: day==1 (got %d)",
+          s->name, v[3], v[4], v[5], sd.day);
+
+    int ly, lm, ld;
+    jd_to_gregorian(gregorian_to_jd(v[3], v[4], v[5]) + v[2] - 1, &ly, &lm, &ld);
+    SolarDate last = gregorian_to_solar(ly, lm, ld, &DELHI, s->cal);
+    check(sh, last.day == v[2], "%s %04d-%02d-%02d: last day (got %d, expected %d)",
+          s->name, ly, lm, ld, last.day, v[2]);
+}
+
+/* ===== Shard boundaries ===== */
+
+/* Daily rows: a new lunation begins where the tithi number drops */
+static int tithi_wraps(const Row *rows, int i)
+{
+    return i == 0 || rows[i].v[3] < rows[i - 1].v[3];
+}
+
+/* Edge-case rows: a new lunation begins with a new (masa, adhika, saka) */
+static int masa_changes(const Row *rows, int i)
+{
+    return i == 0 || rows[i].v[4] != rows[i - 1].v[4] ||
+           rows[i].v[5] != rows[i - 1].v[5] || rows[i].v[6] != rows[i - 1].v[6];
+}
+
+/* Month rows */
+static int every_row(const Row *rows, int i)
+{
+    (void)rows;
+    (void)i;
+    return 1;
+}
+
+static Suite suites[] = {
+    {"lunisolar", "ref_1900_2050.csv", 7, 0, 0, tithi_wraps, check_day, {0}, NULL, 0, 0},
+    {"adhika_kshaya", "adhika_kshaya_tithis.csv", 7, 1, 0, masa_changes, check_day, {0}, NULL, 0, 0},
+    {"lunisolar_months", "lunisolar_months.csv", 7, 1, 0, every_row, check_lunisolar_month, {0}, NULL, 0, 0},
+    {"tamil", "solar/tamil_months_1900_2050.csv", 6, 1, SOLAR_CAL_TAMIL,
+     every_row, check_solar_month, {0}, NULL, 0, 0},
+    {"bengali", "solar/bengali_months_1900_2050.csv", 6, 1, SOLAR_CAL_BENGALI,
+     every_row, check_solar_month, {0}, NULL, 0, 0},
+    {"odia", "solar/odia_months_1900_2050.csv", 6, 1, SOLAR_CAL_ODIA,
+     every_row, check_solar_month, {0}, NULL, 0, 0},
+    {"malayalam", "solar/malayalam_months_1900_2050.csv", 6, 1, SOLAR_CAL_MALAYALAM,
+     every_row, check_solar_month, {0}, NULL, 0, 0},
+};
+#define N_SUITES ((int)(sizeof(suites) / sizeof(suites[0])))
+
+/* ===== Loading ===== */
+
+/* Map the suite's CSV and parse its rows into s->rows; returns 0, or -1
+ * (message printed).  The rows point into the mapping, which is kept.
+ * A row that does not parse is printed and counted in s->bad_rows, so a
+ * damaged file fails instead of passing with fewer checks. */
+static int load_suite(Suite *s, const char *dir)
+{
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", dir, s->file);
+    if (!csv_open(&s->csv, path)) {
+        printf("SKIP: %s not found\n", path);
+        return -1;
+    }
+    s->rows = malloc((csv_count_rows(&s->csv) + 1) * sizeof(Row));
+    if (!s->rows) return -1;
+
+    s->n_rows = 0;
+    s->bad_rows = 0;
+    for (long line = 1; csv_next(&s->csv); line++) {
+        Row *r = &s->rows[s->n_rows];
+        int ok = 1;
+        for (int f = 0; f < s->n_ints && ok; f++)
+            ok = csv_int(&s->csv, f, &r->v[f]);
+        r->text = "";
+        r->text_len = 0;
+        if (ok && s->has_text)
+            ok = (r->text = csv_str(&s->csv, s->n_ints, &r->text_len)) != NULL;
+        if (ok) {
+            s->n_rows++;
+        } else {
+            int len = 0;
+            const char *first = csv_str(&s->csv, 0, &len);
+            printf("  FAIL: %s data row %ld: cannot parse (starts '%.*s')\n",
+                   s->file, line, first ? len : 0, first ? first : "");
+            s->bad_rows++;
+        }
+    }
+    return 0;
+}
+
+/* ===== Running ===== */
+
+static Shard *shards;
+static int n_shards;
+static int next_shard;
+
+static void *worker(void *arg)
+{
+    (void)arg;
+    astro_init(NULL);
+    for (;;) {
+        int i = __atomic_fetch_add(&next_shard, 1, __ATOMIC_RELAXED);
+        if (i >= n_shards) break;
+        Shard *sh = &shards[i];
+        for (int r = sh->first; r < sh->end; r++)
+            sh->suite->check_row(sh->suite, &sh->suite->rows[r], sh);
+    }
+    astro_close();
+    return NULL;
+}
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Cut a suite into shards of SHARD_LUNATIONS units */
+static int make_shards(const Suite *s)
+{
+    int units = 0;
+    for (int i = 0; i < s->n_rows; i++)
+        if (s->starts_unit(s->rows, i)) units++;
+    shards = calloc(units / SHARD_LUNATIONS + 2, sizeof(Shard));
+    if (!shards) return -1;
+
+    n_shards = 0;
+    units = 0;
+    for (int i = 0; i < s->n_rows; i++) {
+        if (s->starts_unit(s->rows, i) && units++ % SHARD_LUNATIONS == 0) {
+            if (n_shards > 0) shards[n_shards - 1].end = i;
+            shards[n_shards].suite = s;
+            shards[n_shards].first = i;
+            n_shards++;
+        }
+    }
+    if (n_shards > 0) shards[n_shards - 1].end = s->n_rows;
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *dir = DEFAULT_DIR;
+    long n_threads = sysconf(_SC_NPROCESSORS_ONLN);
+    int selected[N_SUITES] = {0}, any_selected = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            n_threads = atoi(argv[++i]);
+            if (n_threads < 1) {
+                fprintf(stderr, "ERROR: -j needs a positive thread count\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            dir = argv[++i];
+        } else {
+            int k = 0;
+            while (k < N_SUITES && strcmp(argv[i], suites[k].name) != 0) k++;
+            if (k == N_SUITES) {
+                fprintf(stderr, "Usage: %s [-j THREADS] [-d DIR] [SUITE...]\n", argv[0]);
+                return 1;
+            }
+            selected[k] = any_selected = 1;
+        }
+    }
+    if (n_threads < 1) n_threads = 1;
+
+    printf("=== Parallel Regression (%s, %ld threads) ===\n", dir, n_threads);
+    pthread_t *tids = malloc(n_threads * sizeof(pthread_t));
+    if (!tids) return 1;
+
+    long total_run = 0, total_failed = 0;
+    double total_sec = 0;
+    int status = 0;
+    for (int k = 0; k < N_SUITES; k++) {
+        Suite *s = &suites[k];
+        if (any_selected && !selected[k]) continue;
+        printf("\n--- %s ---\n", s->name);
+        if (load_suite(s, dir) != 0) {
+            if (any_selected) status = 1;
+            continue;
+        }
+        if (make_shards(s) != 0) return 1;
+
+        double t0 = now_sec();
+        next_shard = 0;
+        long workers = n_threads < n_shards ? n_threads : n_shards;
+        long started = 0;
+        for (; started < workers; started++)
+            if (pthread_create(&tids[started], NULL, worker, NULL) != 0)
+                break;
+        /* Shards are claimed from a shared counter, so the threads that
+         * did start still run all of them */
+        for (long t = 0; t < started; t++)
+            pthread_join(tids[t], NULL);
+        double sec = now_sec() - t0;
+        if (started == 0 && n_shards > 0) {
+            printf("ERROR: cannot start a worker thread\n");
+            free(shards);
+            free(tids);
+            return 1;
+        }
+
+        long run = s->bad_rows, failed = s->bad_rows;
+        for (int i = 0; i < n_shards; i++) {
+            if (shards[i].log) fwrite(shards[i].log, 1, shards[i].log_len, stdout);
+            run += shards[i].run;
+            failed += shards[i].failed;
+            free(shards[i].log);
+        }
+        printf("  %-18s: %ld/%ld passed, %d rows, %d shards, %.2f s\n",
+               s->name, run - failed, run, s->n_rows, n_shards, sec);
+        free(shards);
+        total_run += run;
+        total_failed += failed;
+        total_sec += sec;
+    }
+    free(tids);
+
+    printf("\n=== Regression: %ld/%ld passed, %ld failed (%.2f s) ===\n",
+           total_run - total_failed, total_run, total_failed, total_sec);
+    return (total_failed == 0 && status == 0) ? 0 : 1;
+}
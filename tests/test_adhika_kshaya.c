@@ -1,6 +1,7 @@
 #include "tithi.h"
 #include "masa.h"
 #include "astro.h"
+#include "csvmap.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -52,8 +53,8 @@ int main(void)
         return 0;
     }
 
-    FILE *f = fopen(csv_path, "r");
-    if (!f) {
+    CsvFile csv;
+    if (!csv_open(&csv, csv_path)) {
         printf("ERROR: cannot open %s\n", csv_path);
         return 1;
     }
@@ -61,21 +62,14 @@ int main(void)
     astro_init(NULL);
     Location delhi = DEFAULT_LOCATION;
 
-    char line[256];
     int count = 0;
 
-    /* Skip header */
-    if (!fgets(line, sizeof(line), f)) {
-        fclose(f);
-        astro_close();
-        return 1;
-    }
-
-    while (fgets(line, sizeof(line), f)) {
-        int y, m, d, tithi, masa, adhika, saka;
-        char type[16];
-        if (sscanf(line, "%d,%d,%d,%d,%d,%d,%d,%15s",
-                   &y, &m, &d, &tithi, &masa, &adhika, &saka, type) != 8)
+    while (csv_next(&csv)) {
+        int y, m, d, tithi, masa, adhika, saka, type_len;
+        const char *type = csv_str(&csv, 7, &type_len);
+        if (!csv_int(&csv, 0, &y) || !csv_int(&csv, 1, &m) || !csv_int(&csv, 2, &d) ||
+            !csv_int(&csv, 3, &tithi) || !csv_int(&csv, 4, &masa) ||
+            !csv_int(&csv, 5, &adhika) || !csv_int(&csv, 6, &saka) || !type)
             continue;
 
         TithiInfo ti = tithi_at_sunrise(y, m, d, &delhi);
@@ -83,26 +77,26 @@ int main(void)
 
         char buf[256];
 
-        snprintf(buf, sizeof(buf), "%04d-%02d-%02d [%s] tithi (got %d, exp %d)",
-                 y, m, d, type, ti.tithi_num, tithi);
+        snprintf(buf, sizeof(buf), "%04d-%02d-%02d [%.*s] tithi (got %d, exp %d)",
+                 y, m, d, type_len, type, ti.tithi_num, tithi);
         check(ti.tithi_num == tithi, buf);
 
-        snprintf(buf, sizeof(buf), "%04d-%02d-%02d [%s] masa (got %d, exp %d)",
-                 y, m, d, type, (int)mi.name, masa);
+        snprintf(buf, sizeof(buf), "%04d-%02d-%02d [%.*s] masa (got %d, exp %d)",
+                 y, m, d, type_len, type, (int)mi.name, masa);
         check((int)mi.name == masa, buf);
 
-        snprintf(buf, sizeof(buf), "%04d-%02d-%02d [%s] adhika (got %d, exp %d)",
-                 y, m, d, type, mi.is_adhika, adhika);
+        snprintf(buf, sizeof(buf), "%04d-%02d-%02d [%.*s] adhika (got %d, exp %d)",
+                 y, m, d, type_len, type, mi.is_adhika, adhika);
         check(mi.is_adhika == adhika, buf);
 
-        snprintf(buf, sizeof(buf), "%04d-%02d-%02d [%s] saka (got %d, exp %d)",
-                 y, m, d, type, mi.year_saka, saka);
+        snprintf(buf, sizeof(buf), "%04d-%02d-%02d [%.*s] saka (got %d, exp %d)",
+                 y, m, d, type_len, type, mi.year_saka, saka);
         check(mi.year_saka == saka, buf);
 
         count++;
     }
 
-    fclose(f);
+    csv_close(&csv);
     astro_close();
 
     printf("\n=== Adhika/Kshaya Tithi: %d/%d passed, %d failed (%d days) ===\n",
@@ -0,0 +1,207 @@
+#include "annotate.h"
+#include "events.h"
+#include "tithi.h"
+#include "masa.h"
+#include "astro.h"
+#include "date_utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define ASSERT_EQ(actual, expected, msg) do { \
+    tests_run++; \
+    int _a = (actual), _e = (expected); \
+    if (_a == _e) { \
+        tests_passed++; \
+    } else { \
+        printf("  FAIL: %s (got %d, expected %d)\n", msg, _a, _e); \
+    } \
+} while (0)
+
+#define ASSERT_NEAR(actual, expected, tolerance, msg) do { \
+    tests_run++; \
+    double _a = (actual), _e = (expected), _t = (tolerance); \
+    if (fabs(_a - _e) <= _t) { \
+        tests_passed++; \
+    } else { \
+        printf("  FAIL: %s (got %.8f, expected %.8f)\n", msg, _a, _e); \
+    } \
+} while (0)
+
+#define N_MOMENTS 20000
+
+/* Half a second: the root finders agree far closer than this */
+#define GUARD (0.5 / 86400.0)
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Compare against direct evaluation, skipping instants within GUARD of a
+ * boundary; returns the number of rows compared */
+static int check_against_direct(Annotator *an, const double *jds, int n,
+                                const char *label)
+{
+    int compared = 0, tithi_bad = 0, rashi_bad = 0;
+    for (int i = 0; i < n; i++) {
+        MomentAnnotation ma;
+        annotate_moment(an, jds[i], &ma);
+
+        int t = tithi_at_moment(jds[i]);
+        int r = solar_rashi(jds[i]);
+        if (tithi_at_moment(jds[i] - GUARD) != t || tithi_at_moment(jds[i] + GUARD) != t ||
+            solar_rashi(jds[i] - GUARD) != r || solar_rashi(jds[i] + GUARD) != r)
+            continue;
+
+        compared++;
+        if (ma.tithi != t) tithi_bad++;
+        if (ma.rashi != r) rashi_bad++;
+        if (ma.paksha_tithi != ((t <= 15) ? t : t - 15) ||
+            ma.paksha != ((t <= 15) ? SHUKLA_PAKSHA : KRISHNA_PAKSHA))
+            tithi_bad++;
+    }
+
+    char buf[96];
+    snprintf(buf, sizeof(buf), "%s: tithi mismatches", label);
+    ASSERT_EQ(tithi_bad, 0, buf);
+    snprintf(buf, sizeof(buf), "%s: rashi mismatches", label);
+    ASSERT_EQ(rashi_bad, 0, buf);
+    return compared;
+}
+
+/*
+ * Sorted and shuffled random instants over 2024-2025 agree with
+ * tithi_at_moment() / solar_rashi(); sorted input needs one refresh per
+ * boundary crossed.
+ */
+static void test_random_moments(void)
+{
+    printf("\n--- %d random instants, 2024-2025 ---\n", N_MOMENTS);
+    static double jds[N_MOMENTS];
+    double jd0 = gregorian_to_jd(2024, 1, 1);
+    srand(7);
+    for (int i = 0; i < N_MOMENTS; i++)
+        jds[i] = jd0 + 731.0 * rand() / ((double)RAND_MAX + 1.0);
+    qsort(jds, N_MOMENTS, sizeof(double), cmp_double);
+
+    Annotator an;
+    annotator_init(&an);
+    int compared = check_against_direct(&an, jds, N_MOMENTS, "sorted");
+    printf("  sorted: %d rows compared, %ld refreshes\n", compared, an.refreshes);
+
+    /* ~742 tithis and 24 sankrantis in two years, plus the first row */
+    tests_run++;
+    if (an.refreshes <= 2 * 2 + 742 + 25)
+        tests_passed++;
+    else
+        printf("  FAIL: %ld refreshes for sorted input\n", an.refreshes);
+
+    for (int i = N_MOMENTS - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        double tmp = jds[i];
+        jds[i] = jds[j];
+        jds[j] = tmp;
+    }
+    annotator_init(&an);
+    compared = check_against_direct(&an, jds, N_MOMENTS, "shuffled");
+    printf("  shuffled: %d rows compared, %ld refreshes\n", compared, an.refreshes);
+}
+
+/*
+ * Instants exactly on a boundary take the tithi/rashi that begins there.
+ */
+static void test_on_boundary(void)
+{
+    printf("\n--- Instants on boundaries ---\n");
+    Location delhi = DEFAULT_LOCATION;
+    EventCursor cur;
+    event_cursor_init(&cur, &delhi);
+    Annotator an;
+    annotator_init(&an);
+
+    double jd = gregorian_to_jd(2025, 1, 1);
+    AstroEvent ev;
+    for (int i = 0; i < 40; i++) {
+        next_event(&cur, jd, EVENT_TITHI | EVENT_SANKRANTI, &ev);
+        MomentAnnotation ma, before;
+        annotate_moment(&an, ev.jd - GUARD, &before);
+        annotate_moment(&an, ev.jd, &ma);
+
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%s %d at boundary", event_type_name(ev.type), ev.value);
+        if (ev.type == EVENT_TITHI) {
+            ASSERT_EQ(ma.tithi, ev.value, buf);
+            ASSERT_EQ(before.tithi, (ev.value + 28) % 30 + 1, buf);
+        } else {
+            ASSERT_EQ(ma.rashi, ev.value, buf);
+            ASSERT_EQ(before.rashi, (ev.value + 10) % 12 + 1, buf);
+        }
+        jd = ev.jd;
+    }
+}
+
+static void test_parse_timestamp(void)
+{
+    printf("\n--- parse_timestamp ---\n");
+    double jd0 = gregorian_to_jd(2025, 1, 1);
+    double jd;
+
+    ASSERT_EQ(parse_timestamp("2460676.5", &jd), 1, "JD parses");
+    ASSERT_NEAR(jd, 2460676.5, 0.0, "JD value");
+    ASSERT_EQ(parse_timestamp("  2025-01-01 \n", &jd), 1, "date only");
+    ASSERT_NEAR(jd, jd0, 0.0, "date only = 0h UT");
+    ASSERT_EQ(parse_timestamp("2025-01-01T06:00:00Z", &jd), 1, "UTC time");
+    ASSERT_NEAR(jd, jd0 + 0.25, 1e-9, "06:00Z");
+    ASSERT_EQ(parse_timestamp("2025-01-01 11:30:00+05:30", &jd), 1, "zoned time");
+    ASSERT_NEAR(jd, jd0 + 0.25, 1e-9, "11:30+05:30 = 06:00Z");
+    ASSERT_EQ(parse_timestamp("2025-01-01T01:00-0500", &jd), 1, "compact offset");
+    ASSERT_NEAR(jd, jd0 + 0.25, 1e-9, "01:00-0500 = 06:00Z");
+    ASSERT_EQ(parse_timestamp("2025-01-01T06:00:30.5", &jd), 1, "fractional seconds");
+    ASSERT_NEAR(jd, jd0 + 0.25 + 30.5 / 86400.0, 1e-9, "06:00:30.5");
+
+    ASSERT_EQ(parse_timestamp("", &jd), 0, "empty rejected");
+    ASSERT_EQ(parse_timestamp("2025-13-01", &jd), 0, "month 13 rejected");
+    ASSERT_EQ(parse_timestamp("2025-01-01T6:00", &jd), 0, "one-digit hour rejected");
+    ASSERT_EQ(parse_timestamp("2460676.5x", &jd), 0, "trailing junk rejected");
+    ASSERT_EQ(parse_timestamp("yesterday", &jd), 0, "text rejected");
+    ASSERT_EQ(parse_timestamp("2025-02-31", &jd), 0, "February 31 rejected");
+    ASSERT_EQ(parse_timestamp("2023-02-29", &jd), 0, "February 29 in a common year rejected");
+    ASSERT_EQ(parse_timestamp("2024-02-29", &jd), 1, "February 29 in a leap year");
+    ASSERT_EQ(parse_timestamp("2025-01-01T24:30", &jd), 0, "24:30 rejected");
+    ASSERT_EQ(parse_timestamp("2025-01-01T24:00:01", &jd), 0, "24:00:01 rejected");
+    ASSERT_EQ(parse_timestamp("2025-01-01T24:00:00Z", &jd), 1, "24:00 accepted");
+    ASSERT_NEAR(jd, gregorian_to_jd(2025, 1, 2), 1e-9, "24:00 is next midnight");
+    ASSERT_EQ(parse_timestamp("nan", &jd), 0, "NaN rejected");
+    ASSERT_EQ(parse_timestamp("inf", &jd), 0, "infinity rejected");
+    ASSERT_EQ(parse_timestamp("1e300", &jd), 0, "huge JD rejected");
+    ASSERT_EQ(parse_timestamp("-2460676.5", &jd), 0, "negative JD rejected");
+    ASSERT_EQ(parse_timestamp("2025-01-01T06:00:nan", &jd), 0, "NaN seconds rejected");
+    ASSERT_EQ(parse_timestamp("2025-01-01T06:00:0x1F", &jd), 0, "hex seconds rejected");
+    ASSERT_EQ(parse_timestamp("2025-01-01T06:00:infZ", &jd), 0, "infinite seconds rejected");
+    ASSERT_EQ(parse_timestamp("2025-01-01T06:00: 5Z", &jd), 0, "space before seconds rejected");
+    ASSERT_EQ(parse_timestamp("2025-01-01T06:00:5Z", &jd), 0, "one-digit seconds rejected");
+    ASSERT_EQ(parse_timestamp("2025-01-01T06:00:61", &jd), 0, "second 61 rejected");
+    ASSERT_EQ(parse_timestamp("2025-01-01T06:00+99:99", &jd), 0, "offset +99:99 rejected");
+    ASSERT_EQ(parse_timestamp("2025-01-01T06:00+05:60", &jd), 0, "offset minute 60 rejected");
+    ASSERT_EQ(parse_timestamp("2025-01-01T06:00+15:00", &jd), 0, "offset +15:00 rejected");
+    ASSERT_EQ(parse_timestamp("2025-01-01T06:00+14:00", &jd), 1, "offset +14:00 accepted");
+}
+
+int main(void)
+{
+    astro_init(NULL);
+
+    test_random_moments();
+    test_on_boundary();
+    test_parse_timestamp();
+
+    astro_close();
+
+    printf("\n=== Annotate tests: %d/%d passed ===\n", tests_passed, tests_run);
+    return (tests_passed == tests_run) ? 0 : 1;
+}
@@ -0,0 +1,245 @@
+#include "archive.h"
+#include "panchang.h"
+#include "astro.h"
+#include "masa.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define ASSERT_EQ(actual, expected, msg) do { \
+    tests_run++; \
+    long _a = (actual), _e = (expected); \
+    if (_a == _e) { \
+        tests_passed++; \
+    } else { \
+        printf("  FAIL: %s (got %ld, expected %ld)\n", msg, _a, _e); \
+    } \
+} while (0)
+
+#define ARCHIVE_PATH "build/test_archive.hcpa"
+/* Stored times are rounded to 0.1 s */
+#define MAX_TIME_ERR (0.0501 / 86400.0)
+
+static PanchangDay computed[3 * 366];
+static PanchangArchive archive;
+
+static int compute_years(int y0, int y1, const Location *loc)
+{
+    int n = 0;
+    for (int y = y0; y <= y1; y++) {
+        for (int m = 1; m <= 12; m++) {
+            int count;
+            generate_month_panchang(y, m, loc, computed + n, &count);
+            n += count;
+        }
+    }
+    return n;
+}
+
+/* Days that differ from the computed ones beyond the time rounding */
+static int count_mismatches(const PanchangDay *got, const PanchangDay *e, int n)
+{
+    int bad = 0;
+    for (int i = 0; i < n; i++, got++, e++) {
+        if (got->greg_year != e->greg_year || got->greg_month != e->greg_month ||
+            got->greg_day != e->greg_day ||
+            memcmp(&got->hindu_date, &e->hindu_date, sizeof(HinduDate)) != 0 ||
+            got->tithi.tithi_num != e->tithi.tithi_num ||
+            got->tithi.paksha != e->tithi.paksha ||
+            got->tithi.paksha_tithi != e->tithi.paksha_tithi ||
+            got->tithi.is_kshaya != e->tithi.is_kshaya ||
+            fabs(got->jd_sunrise - e->jd_sunrise) > MAX_TIME_ERR ||
+            fabs(got->tithi.jd_start - e->tithi.jd_start) > MAX_TIME_ERR ||
+            fabs(got->tithi.jd_end - e->tithi.jd_end) > MAX_TIME_ERR) {
+            if (bad == 0)
+                printf("  first mismatch: %04d-%02d-%02d\n",
+                       e->greg_year, e->greg_month, e->greg_day);
+            bad++;
+        }
+    }
+    return bad;
+}
+
+/* Full panchangs with times: every field read back, 10x smaller */
+static void test_round_trip(const char *name, const Location *loc)
+{
+    printf("\n--- Round trip with times: %s ---\n", name);
+    int n = compute_years(2023, 2025, loc);
+    long size = archive_write(ARCHIVE_PATH, loc, computed, n, 1);
+    ASSERT_EQ(size > 0, 1, "archive written");
+    ASSERT_EQ(size * 10 < (long)(n * sizeof(PanchangDay)), 1,
+              "at least 10x smaller than PanchangDay array");
+
+    ASSERT_EQ(archive_open(&archive, ARCHIVE_PATH), 1, "archive opens");
+    ASSERT_EQ(archive.first_year, 2023, "first year");
+    ASSERT_EQ(archive.n_years, 3, "year count");
+    ASSERT_EQ(archive.has_times, 1, "times flag");
+    ASSERT_EQ(memcmp(&archive.loc, loc, sizeof(Location)), 0, "location stored");
+
+    static PanchangDay year[ARCHIVE_MAX_DAYS];
+    int bad = 0, i = 0;
+    for (int y = 2023; y <= 2025; y++) {
+        int count = archive_get_year(&archive, y, year);
+        ASSERT_EQ(count, (y == 2024) ? 366 : 365, "days in year");
+        bad += count_mismatches(year, computed + i, count);
+        i += count;
+    }
+    ASSERT_EQ(i, n, "all days decoded");
+    ASSERT_EQ(bad, 0, "days differing from computed");
+
+    /* Random-order single-day lookups */
+    bad = 0;
+    for (int k = 0; k < 500; k++) {
+        int j = (int)((k * 7919L) % n);
+        PanchangDay pd;
+        if (!archive_get_day(&archive, computed[j].greg_year, computed[j].greg_month,
+                             computed[j].greg_day, &pd) ||
+            count_mismatches(&pd, &computed[j], 1) != 0)
+            bad++;
+    }
+    ASSERT_EQ(bad, 0, "random lookups differing");
+    archive_close(&archive);
+    ASSERT_EQ(archive.data == NULL, 1, "closed");
+}
+
+/* Calendar-only conversion of the reference CSV */
+static void test_ref_csv(void)
+{
+    printf("\n--- Reference CSV (calendar only) ---\n");
+#ifdef USE_SWISSEPH
+    const char *csv_path = "validation/se/ref_1900_2050.csv";
+#else
+    const char *csv_path = "validation/moshier/ref_1900_2050.csv";
+#endif
+    FILE *f = fopen(csv_path, "r");
+    if (!f) {
+        printf("  SKIP: %s not found\n", csv_path);
+        return;
+    }
+
+    int cap = 151 * 366, n = 0;
+    PanchangDay *days = calloc(cap, sizeof(PanchangDay));
+    char line[256];
+    while (fgets(line, sizeof(line), f) && n < cap) {
+        int y, m, d, t, masa, adhika, saka;
+        if (sscanf(line, "%d,%d,%d,%d,%d,%d,%d", &y, &m, &d, &t, &masa, &adhika, &saka) != 7)
+            continue;
+        PanchangDay *pd = &days[n++];
+        pd->greg_year = y;
+        pd->greg_month = m;
+        pd->greg_day = d;
+        pd->tithi.tithi_num = t;
+        pd->tithi.paksha = pd->hindu_date.paksha = (t <= 15) ? SHUKLA_PAKSHA : KRISHNA_PAKSHA;
+        pd->tithi.paksha_tithi = pd->hindu_date.tithi = (t <= 15) ? t : t - 15;
+        pd->hindu_date.masa = (MasaName)masa;
+        pd->hindu_date.is_adhika_masa = adhika;
+        pd->hindu_date.year_saka = saka;
+        pd->hindu_date.year_vikram = hindu_year_vikram(saka);
+        if (n > 1) pd->hindu_date.is_adhika_tithi = (t == pd[-1].tithi.tithi_num);
+        if (n > 1) pd[-1].tithi.is_kshaya = ((t - pd[-1].tithi.tithi_num + 30) % 30 > 1);
+    }
+    long csv_size = ftell(f);
+    fclose(f);
+    ASSERT_EQ(n, 55152, "rows read");
+
+    Location delhi = DEFAULT_LOCATION;
+    long size = archive_write(ARCHIVE_PATH, &delhi, days, n, 0);
+    ASSERT_EQ(size > 0, 1, "archive written");
+    ASSERT_EQ(size * 10 < csv_size, 1, "at least 10x smaller than the CSV");
+    ASSERT_EQ(archive_open(&archive, ARCHIVE_PATH), 1, "archive opens");
+    ASSERT_EQ(archive.first_year, 1900, "first year");
+    ASSERT_EQ(archive.n_years, 151, "year count");
+    ASSERT_EQ(archive.has_times, 0, "no times");
+
+    /* Every day, visited year by year in reverse to defeat the cache */
+    int bad = 0;
+    for (int i = n - 1; i >= 0; i--) {
+        PanchangDay pd;
+        if (!archive_get_day(&archive, days[i].greg_year, days[i].greg_month,
+                             days[i].greg_day, &pd) ||
+            count_mismatches(&pd, &days[i], 1) != 0)
+            bad++;
+    }
+    ASSERT_EQ(bad, 0, "days differing from CSV");
+
+    /* 2012 had an adhika Bhadrapada (Aug 18 - Sep 16) */
+    PanchangDay pd;
+    ASSERT_EQ(archive_get_day(&archive, 2012, 9, 1, &pd), 1, "2012-09-01 present");
+    ASSERT_EQ(pd.hindu_date.masa, BHADRAPADA, "2012-09-01 masa");
+    ASSERT_EQ(pd.hindu_date.is_adhika_masa, 1, "2012-09-01 adhika");
+    ASSERT_EQ(pd.jd_sunrise == 0 && pd.tithi.jd_end == 0, 1, "no times");
+
+    archive_close(&archive);
+    free(days);
+}
+
+static void test_errors(void)
+{
+    printf("\n--- Errors ---\n");
+    Location loc = DEFAULT_LOCATION;
+    int n = compute_years(2024, 2024, &loc);
+
+    ASSERT_EQ(archive_write(ARCHIVE_PATH, &loc, computed + 1, n - 1, 1), -1,
+              "must start on January 1");
+    ASSERT_EQ(archive_write(ARCHIVE_PATH, &loc, computed, n - 1, 1), -1,
+              "must end on December 31");
+    PanchangDay saved = computed[100];
+    computed[100] = computed[99];
+    ASSERT_EQ(archive_write(ARCHIVE_PATH, &loc, computed, n, 1), -1,
+              "days must be consecutive");
+    computed[100] = saved;
+
+    ASSERT_EQ(archive_write(ARCHIVE_PATH, &loc, computed, n, 1) > 0, 1, "valid year written");
+    ASSERT_EQ(archive_open(&archive, ARCHIVE_PATH), 1, "opens");
+    PanchangDay pd;
+    ASSERT_EQ(archive_get_day(&archive, 2023, 12, 31, &pd), 0, "before first year");
+    ASSERT_EQ(archive_get_day(&archive, 2025, 1, 1, &pd), 0, "after last year");
+    ASSERT_EQ(archive_get_day(&archive, 2024, 2, 30, &pd), 0, "invalid date");
+    ASSERT_EQ(archive_get_day(&archive, 2024, 2, 29, &pd), 1, "leap day");
+    archive_close(&archive);
+
+    ASSERT_EQ(archive_open(&archive, "build/no_such_archive.hcpa"), 0, "missing file");
+
+    /* Truncated index, then a chunk pointing past the end */
+    FILE *f = fopen(ARCHIVE_PATH, "r+b");
+    unsigned char header[ARCHIVE_HEADER_SIZE + 16];
+    if (fread(header, 1, sizeof(header), f) != sizeof(header)) header[0] = 0;
+    header[16] = 200;  /* 200 years */
+    rewind(f);
+    fwrite(header, 1, sizeof(header), f);
+    fflush(f);
+    ASSERT_EQ(archive_open(&archive, ARCHIVE_PATH), 0, "index beyond file");
+    header[16] = 1;
+    header[ARCHIVE_HEADER_SIZE + 9] = 0xFF;  /* chunk length */
+    rewind(f);
+    fwrite(header, 1, sizeof(header), f);
+    fflush(f);
+    ASSERT_EQ(archive_open(&archive, ARCHIVE_PATH), 0, "chunk beyond file");
+    header[0] = 'X';
+    rewind(f);
+    fwrite(header, 1, sizeof(header), f);
+    fclose(f);
+    ASSERT_EQ(archive_open(&archive, ARCHIVE_PATH), 0, "bad magic");
+}
+
+int main(void)
+{
+    astro_init(NULL);
+
+    Location delhi = DEFAULT_LOCATION;
+    Location nyc = { 40.7128, -74.0060, 0.0, -5.0 };
+    test_round_trip("New Delhi", &delhi);
+    test_round_trip("New York", &nyc);
+    test_ref_csv();
+    test_errors();
+
+    remove(ARCHIVE_PATH);
+    astro_close();
+
+    printf("\n=== Archive tests: %d/%d passed ===\n", tests_passed, tests_run);
+    return (tests_passed == tests_run) ? 0 : 1;
+}
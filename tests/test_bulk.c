@@ -0,0 +1,270 @@
+#include "bulk.h"
+#include "writer.h"
+#include "panchang.h"
+#include "solar.h"
+#include "astro.h"
+#include "date_utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define ASSERT_EQ(actual, expected, msg) do { \
+    tests_run++; \
+    long _a = (actual), _e = (expected); \
+    if (_a == _e) { \
+        tests_passed++; \
+    } else { \
+        printf("  FAIL: %s (got %ld, expected %ld)\n", msg, _a, _e); \
+    } \
+} while (0)
+
+static const NamedLocation LOCS[] = {
+    {"Delhi",    { 28.6139,  77.2090, 0.0,  5.5 }},
+    {"Chennai",  { 13.0827,  80.2707, 0.0,  5.5 }},
+    {"New York", { 40.7128, -74.0060, 0.0, -5.0 }},
+};
+#define N_LOCS 3
+
+/* Read a whole stream back into a malloc'd string */
+static char *slurp(FILE *f, long *len)
+{
+    fseek(f, 0, SEEK_END);
+    *len = ftell(f);
+    rewind(f);
+    char *s = malloc(*len + 1);
+    if (fread(s, 1, *len, f) != (size_t)*len) *len = -1;
+    s[*len > 0 ? *len : 0] = '\0';
+    return s;
+}
+
+/*
+ * The day-to-day caches are keyed on location: alternating locations
+ * day by day must give the same dates as a run per location.
+ */
+static void test_interleaved_locations(void)
+{
+    printf("\n--- Interleaved locations, 2023-2024 ---\n");
+    double jd0 = gregorian_to_jd(2023, 1, 1);
+    int ndays = 731;
+    HinduDate *ref = malloc(N_LOCS * ndays * sizeof(HinduDate));
+    SolarDate *sref = malloc(N_LOCS * ndays * sizeof(SolarDate));
+
+    for (int l = 0; l < N_LOCS; l++) {
+        for (int i = 0; i < ndays; i++) {
+            int y, m, d;
+            jd_to_gregorian(jd0 + i, &y, &m, &d);
+            ref[l * ndays + i] = gregorian_to_hindu(y, m, d, &LOCS[l].loc);
+            sref[l * ndays + i] = gregorian_to_solar(y, m, d, &LOCS[l].loc, SOLAR_CAL_BENGALI);
+        }
+    }
+
+    int bad = 0, sbad = 0;
+    for (int i = 0; i < ndays; i++) {
+        int y, m, d;
+        jd_to_gregorian(jd0 + i, &y, &m, &d);
+        for (int l = 0; l < N_LOCS; l++) {
+            HinduDate hd = gregorian_to_hindu(y, m, d, &LOCS[l].loc);
+            SolarDate sd = gregorian_to_solar(y, m, d, &LOCS[l].loc, SOLAR_CAL_BENGALI);
+            const HinduDate *r = &ref[l * ndays + i];
+            const SolarDate *s = &sref[l * ndays + i];
+            if (hd.tithi != r->tithi || hd.paksha != r->paksha || hd.masa != r->masa ||
+                hd.is_adhika_masa != r->is_adhika_masa ||
+                hd.is_adhika_tithi != r->is_adhika_tithi)
+                bad++;
+            if (sd.year != s->year || sd.month != s->month || sd.day != s->day)
+                sbad++;
+        }
+    }
+    ASSERT_EQ(bad, 0, "lunisolar mismatches when interleaved");
+    ASSERT_EQ(sbad, 0, "solar mismatches when interleaved");
+    free(ref);
+    free(sref);
+}
+
+/* Every row of the bulk output equals a direct conversion */
+static void test_rows_match_direct(void)
+{
+    printf("\n--- Rows vs direct conversion ---\n");
+    BulkRequest req = {0};
+    req.locations = LOCS;
+    req.n_locations = N_LOCS;
+    req.y0 = 2024; req.m0 = 2; req.d0 = 20;
+    req.y1 = 2024; req.m1 = 4; req.d1 = 10;
+    req.calendars = CALSET_ALL;
+    req.threads = 1;
+
+    FILE *f = tmpfile();
+    long rows = bulk_generate(&req, f);
+    ASSERT_EQ(rows, N_LOCS * 51 * 5, "row count");
+    rewind(f);
+
+    char line[256];
+    int bad = 0, seen = 0, prev_loc = 0;
+    double prev_jd = 0;
+    if (!fgets(line, sizeof(line), f)) line[0] = '\0';
+    ASSERT_EQ(strncmp(line, "location,date,", 14), 0, "header");
+
+    while (fgets(line, sizeof(line), f)) {
+        char name[64], cal[16], mname[32], paksha[16];
+        int y, m, d, year, month, adhika_m, day, adhika_d;
+        char *p = line;
+        /* The paksha field may be empty: split it off by hand */
+        if (sscanf(p, "%63[^,],%d-%d-%d,%*[^,],%15[^,],%d,%d,%31[^,],%d,",
+                   name, &y, &m, &d, cal, &year, &month, mname, &adhika_m) != 9) {
+            bad++;
+            continue;
+        }
+        for (int commas = 0; commas < 8 && p; commas++) p = strchr(p, ',') + 1;
+        size_t plen = strcspn(p, ",");
+        memcpy(paksha, p, plen);
+        paksha[plen] = '\0';
+        if (sscanf(p + plen, ",%d,%d", &day, &adhika_d) != 2) {
+            bad++;
+            continue;
+        }
+        seen++;
+
+        int l = 0;
+        while (l < N_LOCS && strcmp(LOCS[l].name, name) != 0) l++;
+        double jd = gregorian_to_jd(y, m, d);
+        if (l == N_LOCS || l < prev_loc || (l == prev_loc && jd < prev_jd)) {
+            bad++;
+            continue;
+        }
+        prev_loc = l;
+        prev_jd = jd;
+
+        if (strcmp(cal, "lunisolar") == 0) {
+            HinduDate hd = gregorian_to_hindu(y, m, d, &LOCS[l].loc);
+            if (year != hd.year_saka || month != (int)hd.masa ||
+                adhika_m != hd.is_adhika_masa || day != hd.tithi ||
+                adhika_d != hd.is_adhika_tithi ||
+                strcmp(paksha, hd.paksha == SHUKLA_PAKSHA ? "Shukla" : "Krishna") != 0)
+                bad++;
+        } else {
+            unsigned mask;
+            parse_calendar_set(cal, &mask);
+            SolarCalendarType type = mask == CALSET_TAMIL ? SOLAR_CAL_TAMIL :
+                                     mask == CALSET_BENGALI ? SOLAR_CAL_BENGALI :
+                                     mask == CALSET_ODIA ? SOLAR_CAL_ODIA : SOLAR_CAL_MALAYALAM;
+            SolarDate sd = gregorian_to_solar(y, m, d, &LOCS[l].loc, type);
+            if (year != sd.year || month != sd.month || day != sd.day ||
+                strcmp(mname, solar_month_name(sd.month, type)) != 0 || paksha[0] != '\0')
+                bad++;
+        }
+    }
+    fclose(f);
+    ASSERT_EQ(seen, rows, "rows parsed");
+    ASSERT_EQ(bad, 0, "rows differing from direct conversion or out of order");
+}
+
+/* Output is byte-identical for any thread count */
+static void test_thread_counts(void)
+{
+    printf("\n--- Thread counts ---\n");
+    BulkRequest req = {0};
+    req.locations = LOCS;
+    req.n_locations = N_LOCS;
+    req.y0 = 2019; req.m0 = 11; req.d0 = 15;
+    req.y1 = 2021; req.m1 = 2; req.d1 = 3;
+    req.calendars = CALSET_LUNISOLAR | CALSET_TAMIL | CALSET_MALAYALAM;
+
+    char *ref = NULL;
+    long ref_len = 0, ref_rows = 0;
+    int counts[] = {1, 2, 3, 8};
+    for (int i = 0; i < 4; i++) {
+        req.threads = counts[i];
+        FILE *f = tmpfile();
+        long rows = bulk_generate(&req, f);
+        long len;
+        char *s = slurp(f, &len);
+        fclose(f);
+
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%d threads: rows", counts[i]);
+        if (i == 0) {
+            ASSERT_EQ(rows, N_LOCS * 447 * 3, buf);
+            ref = s;
+            ref_len = len;
+            ref_rows = rows;
+            continue;
+        }
+        ASSERT_EQ(rows, ref_rows, buf);
+        snprintf(buf, sizeof(buf), "%d threads: identical output", counts[i]);
+        ASSERT_EQ(len == ref_len && memcmp(s, ref, len) == 0, 1, buf);
+        free(s);
+    }
+    free(ref);
+}
+
+static void test_parsing(void)
+{
+    printf("\n--- Calendar sets, locations files, bad requests ---\n");
+    unsigned mask = 0;
+    ASSERT_EQ(parse_calendar_set("lunisolar,odia", &mask), 1, "list parses");
+    ASSERT_EQ(mask, CALSET_LUNISOLAR | CALSET_ODIA, "list mask");
+    ASSERT_EQ(parse_calendar_set("solar", &mask), 1, "solar parses");
+    ASSERT_EQ(mask, CALSET_ALL & ~CALSET_LUNISOLAR, "solar mask");
+    ASSERT_EQ(parse_calendar_set("all", &mask), 1, "all parses");
+    ASSERT_EQ(mask, CALSET_ALL, "all mask");
+    ASSERT_EQ(parse_calendar_set("tamil,gujarati", &mask), 0, "unknown rejected");
+    ASSERT_EQ(parse_calendar_set("", &mask), 0, "empty rejected");
+
+    NamedLocation *locs;
+    int n;
+    FILE *f = tmpfile();
+    fputs("# name,lat,lon,utc_offset\n\nUjjain,23.1765,75.7885,5.5\n"
+          "Los Angeles,34.0522,-118.2437,-8,71\n", f);
+    rewind(f);
+    ASSERT_EQ(load_locations(f, &locs, &n), 0, "locations file loads");
+    ASSERT_EQ(n, 2, "two locations");
+    if (n == 2) {
+        ASSERT_EQ(strcmp(locs[1].name, "Los Angeles"), 0, "name with space");
+        ASSERT_EQ((long)locs[1].loc.utc_offset, -8, "utc offset");
+        ASSERT_EQ((long)locs[1].loc.altitude, 71, "altitude");
+        ASSERT_EQ((long)locs[0].loc.altitude, 0, "default altitude");
+    }
+    free(locs);
+    fclose(f);
+
+    f = tmpfile();
+    fputs("Ujjain,23.1765,75.7885,5.5\nNowhere,23.1\n", f);
+    rewind(f);
+    ASSERT_EQ(load_locations(f, &locs, &n), 2, "bad line number reported");
+    ASSERT_EQ(locs == NULL, 1, "no array on failure");
+    fclose(f);
+
+    BulkRequest req = {0};
+    req.locations = LOCS;
+    req.n_locations = 1;
+    req.calendars = CALSET_LUNISOLAR;
+    req.y0 = 2025; req.m0 = 2; req.d0 = 29;
+    req.y1 = 2025; req.m1 = 3; req.d1 = 1;
+    ASSERT_EQ(bulk_generate(&req, stdout), -1, "invalid date rejected");
+    req.d0 = 2; req.m1 = 1;
+    ASSERT_EQ(bulk_generate(&req, stdout), -1, "reversed range rejected");
+
+    /* Binary location indices are uint16 */
+    req.m1 = 3;
+    req.n_locations = WRITER_BINARY_MAX_LOCATIONS + 1;
+    req.format = OUTPUT_BINARY;
+    ASSERT_EQ(bulk_generate(&req, stdout), -1, "65537 binary locations rejected");
+}
+
+int main(void)
+{
+    astro_init(NULL);
+
+    test_interleaved_locations();
+    test_rows_match_direct();
+    test_thread_counts();
+    test_parsing();
+
+    astro_close();
+
+    printf("\n=== Bulk tests: %d/%d passed ===\n", tests_passed, tests_run);
+    return (tests_passed == tests_run) ? 0 : 1;
+}
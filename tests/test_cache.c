@@ -0,0 +1,341 @@
+#include "cache.h"
+#include "astro.h"
+#include "masa.h"
+#include "panchang.h"
+#include "solar.h"
+#include "date_utils.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define ASSERT_EQ(actual, expected, msg) do { \
+    tests_run++; \
+    long _a = (actual), _e = (expected); \
+    if (_a == _e) { \
+        tests_passed++; \
+    } else { \
+        printf("  FAIL: %s (got %ld, expected %ld)\n", msg, _a, _e); \
+    } \
+} while (0)
+
+static unsigned default_capacity[CACHE_COUNT];
+
+static void restore_capacities(void)
+{
+    for (int c = 0; c < CACHE_COUNT; c++)
+        cache_set_capacity((CacheId)c, default_capacity[c]);
+}
+
+static CacheStats stats_now(CacheId id)
+{
+    CacheStats s[CACHE_COUNT];
+    cache_stats(s);
+    return s[id];
+}
+
+/* A small record for exercising the tables directly */
+typedef struct {
+    int key;
+    int value;
+} TestEntry;
+
+static int test_match(const void *entry, const void *key)
+{
+    return ((const TestEntry *)entry)->key == *(const int *)key;
+}
+
+static TestEntry *find(int key, unsigned hash)
+{
+    return cache_find(CACHE_MONTH, sizeof(TestEntry), hash, test_match, &key);
+}
+
+static void put(int key, unsigned hash)
+{
+    TestEntry *e = cache_insert(CACHE_MONTH, sizeof(TestEntry), hash);
+    if (e) {
+        e->key = key;
+        e->value = key * 10;
+    }
+}
+
+static void test_names_and_capacities(void)
+{
+    printf("\n--- Names and capacities ---\n");
+    ASSERT_EQ(strcmp(cache_name(CACHE_LUNATION), "lunation"), 0, "first name");
+    ASSERT_EQ(strcmp(cache_name(CACHE_SANKRANTI), "sankranti"), 0, "last name");
+    ASSERT_EQ(strcmp(cache_name(CACHE_COUNT), "unknown"), 0, "out of range");
+    ASSERT_EQ(cache_capacity(CACHE_LUNATION), 1, "lunation default");
+    ASSERT_EQ(cache_capacity(CACHE_MONTH), 32, "month default");
+
+    ASSERT_EQ(cache_set_capacity(CACHE_LUNATION, 0), -1, "zero rejected");
+    ASSERT_EQ(cache_set_capacity(CACHE_LUNATION, CACHE_MAX_ENTRIES + 1), -1, "too large rejected");
+    ASSERT_EQ(cache_set_capacity(CACHE_COUNT, 8), -1, "bad id rejected");
+    ASSERT_EQ(cache_set_capacity(CACHE_LUNATION, 20), 0, "small size");
+    ASSERT_EQ(cache_capacity(CACHE_LUNATION), 20, "small size kept");
+    cache_set_capacity(CACHE_LUNATION, 33);
+    ASSERT_EQ(cache_capacity(CACHE_LUNATION), 64, "rounded up to whole sets");
+
+    ASSERT_EQ(cache_parse_capacities("lunation=2048,sankranti=8192"), 0, "parse two");
+    ASSERT_EQ(cache_capacity(CACHE_LUNATION), 2048, "parsed lunation");
+    ASSERT_EQ(cache_capacity(CACHE_SANKRANTI), 8192, "parsed sankranti");
+    ASSERT_EQ(cache_parse_capacities("month=7,bogus=1"), -1, "unknown name");
+    ASSERT_EQ(cache_capacity(CACHE_MONTH), 32, "nothing applied on error");
+    ASSERT_EQ(cache_parse_capacities("month="), -1, "missing size");
+    ASSERT_EQ(cache_parse_capacities("month=5x"), -1, "trailing junk");
+    ASSERT_EQ(cache_parse_capacities("month=0"), -1, "zero size");
+    ASSERT_EQ(cache_parse_capacities("month"), -1, "missing '='");
+    ASSERT_EQ(cache_parse_capacities("prev_day=3,"), 0, "trailing comma");
+    ASSERT_EQ(cache_capacity(CACHE_PREV_DAY), 3, "parsed prev_day");
+    restore_capacities();
+}
+
+static void test_lru(void)
+{
+    printf("\n--- LRU replacement ---\n");
+    cache_set_capacity(CACHE_MONTH, 4);
+    cache_stats_reset();
+
+    for (int k = 1; k <= 4; k++)
+        put(k, (unsigned)k);
+    ASSERT_EQ(stats_now(CACHE_MONTH).occupancy, 4, "four entries held");
+    TestEntry *e = find(1, 1);
+    ASSERT_EQ(e ? e->value : -1, 10, "entry found with its value");
+
+    put(5, 5);   /* evicts 2, the least recently used */
+    ASSERT_EQ(find(2, 2) == NULL, 1, "least recently used evicted");
+    ASSERT_EQ(find(1, 1) != NULL, 1, "recently used kept");
+    ASSERT_EQ(find(5, 5) != NULL, 1, "new entry found");
+    ASSERT_EQ(stats_now(CACHE_MONTH).evictions, 1, "one eviction");
+    ASSERT_EQ(stats_now(CACHE_MONTH).occupancy, 4, "still four entries");
+
+    /* A resize empties the table */
+    cache_set_capacity(CACHE_MONTH, 8);
+    ASSERT_EQ(find(1, 1) == NULL, 1, "emptied by resize");
+    ASSERT_EQ(stats_now(CACHE_MONTH).occupancy, 0, "no entries after resize");
+}
+
+static void test_sets(void)
+{
+    printf("\n--- Set-associative tables ---\n");
+    cache_set_capacity(CACHE_MONTH, 2 * CACHE_WAYS);
+    cache_stats_reset();
+
+    /* Spread over both sets: everything fits */
+    for (int k = 0; k < 2 * CACHE_WAYS; k++)
+        put(k, (unsigned)k);
+    int found = 0;
+    for (int k = 0; k < 2 * CACHE_WAYS; k++)
+        if (find(k, (unsigned)k)) found++;
+    ASSERT_EQ(found, 2 * CACHE_WAYS, "hashed keys all kept");
+    ASSERT_EQ(stats_now(CACHE_MONTH).evictions, 0, "no evictions");
+
+    /* One set only: its last CACHE_WAYS entries survive */
+    cache_set_capacity(CACHE_MONTH, 2 * CACHE_WAYS);
+    for (int k = 0; k < 2 * CACHE_WAYS; k++)
+        put(k, 0);
+    found = 0;
+    for (int k = 0; k < 2 * CACHE_WAYS; k++)
+        if (find(k, 0)) found++;
+    ASSERT_EQ(found, CACHE_WAYS, "one set holds CACHE_WAYS");
+    ASSERT_EQ(find(2 * CACHE_WAYS - 1, 0) != NULL, 1, "newest kept");
+    ASSERT_EQ(find(0, 0) == NULL, 1, "oldest evicted");
+    ASSERT_EQ(stats_now(CACHE_MONTH).evictions, CACHE_WAYS, "evictions counted");
+
+    /* Leave the month table to masa.c again */
+    restore_capacities();
+}
+
+static void test_counts(void)
+{
+    printf("\n--- Hits and misses ---\n");
+    Location loc = DEFAULT_LOCATION;
+
+    /* A day far from any earlier test, then the next day */
+    cache_stats_reset();
+    gregorian_to_hindu(1931, 6, 10, &loc);
+    ASSERT_EQ(stats_now(CACHE_PREV_DAY).misses, 1, "first day misses");
+    ASSERT_EQ(stats_now(CACHE_LUNATION).misses, 1, "new lunation misses");
+    gregorian_to_hindu(1931, 6, 11, &loc);
+    ASSERT_EQ(stats_now(CACHE_PREV_DAY).hits, 1, "next day hits");
+    ASSERT_EQ(stats_now(CACHE_LUNATION).hits, 1, "same lunation hits");
+
+    cache_stats_reset();
+    gregorian_to_solar(1931, 6, 10, &loc, SOLAR_CAL_TAMIL);
+    gregorian_to_solar(1931, 6, 11, &loc, SOLAR_CAL_TAMIL);
+    ASSERT_EQ(stats_now(CACHE_SANKRANTI).misses, 1, "sankranti miss");
+    ASSERT_EQ(stats_now(CACHE_SANKRANTI).hits, 1, "sankranti hit");
+    ASSERT_EQ(stats_now(CACHE_SOLAR_YEAR).misses, 1, "solar year miss");
+    ASSERT_EQ(stats_now(CACHE_SOLAR_YEAR).hits, 1, "solar year hit");
+
+    cache_stats_reset();
+    lunisolar_month_start(CHAITRA, 1853, 0, LUNISOLAR_AMANTA, &loc);
+    lunisolar_month_start(CHAITRA, 1853, 0, LUNISOLAR_AMANTA, &loc);
+    ASSERT_EQ(stats_now(CACHE_MONTH).misses, 1, "month start miss");
+    ASSERT_EQ(stats_now(CACHE_MONTH).hits, 1, "month start hit");
+
+    /* Start cached, length not: one miss, not a miss and a hit */
+    cache_stats_reset();
+    lunisolar_month_length(CHAITRA, 1853, 0, LUNISOLAR_AMANTA, &loc);
+    ASSERT_EQ(stats_now(CACHE_MONTH).misses, 1, "month length miss");
+    ASSERT_EQ(stats_now(CACHE_MONTH).hits, 0, "month length: start not counted again");
+    lunisolar_month_length(CHAITRA, 1853, 0, LUNISOLAR_AMANTA, &loc);
+    ASSERT_EQ(stats_now(CACHE_MONTH).hits, 1, "month length hit");
+    cache_stats_reset();
+    lunisolar_month_length(VAISHAKHA, 1853, 0, LUNISOLAR_AMANTA, &loc);
+    ASSERT_EQ(stats_now(CACHE_MONTH).misses, 1, "uncached month length: one miss");
+
+    /* One slot: alternating years evicts every time */
+    cache_set_capacity(CACHE_LUNATION, 1);
+    cache_stats_reset();
+    gregorian_to_hindu(1931, 6, 10, &loc);
+    gregorian_to_hindu(1941, 6, 10, &loc);
+    gregorian_to_hindu(1931, 6, 10, &loc);
+    ASSERT_EQ(stats_now(CACHE_LUNATION).misses, 3, "one slot: all miss");
+    ASSERT_EQ(stats_now(CACHE_LUNATION).evictions, 2, "one slot: evictions");
+
+    cache_set_capacity(CACHE_LUNATION, 64);
+    cache_stats_reset();
+    gregorian_to_hindu(1931, 6, 10, &loc);
+    gregorian_to_hindu(1941, 6, 10, &loc);
+    gregorian_to_hindu(1931, 6, 10, &loc);
+    ASSERT_EQ(stats_now(CACHE_LUNATION).hits, 1, "larger: earlier lunation kept");
+    ASSERT_EQ(stats_now(CACHE_LUNATION).evictions, 0, "larger: no evictions");
+    restore_capacities();
+}
+
+#define SPAN 731   /* 1990-01-01 .. 1992-01-01 */
+#define N_CAL 5
+
+static void convert(double jd, const Location *loc, int out[N_CAL][4])
+{
+    int y, m, d;
+    jd_to_gregorian(jd, &y, &m, &d);
+    HinduDate hd = gregorian_to_hindu(y, m, d, loc);
+    out[0][0] = hd.masa;
+    out[0][1] = hd.tithi + 15 * (hd.paksha == KRISHNA_PAKSHA);
+    out[0][2] = hd.year_saka;
+    out[0][3] = hd.is_adhika_masa * 2 + hd.is_adhika_tithi;
+    for (int t = SOLAR_CAL_TAMIL; t <= SOLAR_CAL_MALAYALAM; t++) {
+        SolarDate sd = gregorian_to_solar(y, m, d, loc, (SolarCalendarType)t);
+        out[1 + t][0] = sd.month;
+        out[1 + t][1] = sd.day;
+        out[1 + t][2] = sd.year;
+        out[1 + t][3] = sd.rashi;
+    }
+}
+
+static void test_random_order(void)
+{
+    printf("\n--- Large caches in random order ---\n");
+    Location loc = DEFAULT_LOCATION;
+    double jd0 = gregorian_to_jd(1990, 1, 1);
+    static int seq[SPAN][N_CAL][4], rnd[SPAN][N_CAL][4];
+
+    /* Reference: consecutive days with the default capacities */
+    for (int i = 0; i < SPAN; i++)
+        convert(jd0 + i, &loc, seq[i]);
+
+    cache_parse_capacities("lunation=64,prev_day=1024,solar_year=16,sankranti=128");
+    cache_stats_reset();
+    unsigned lcg = 7;
+    for (int pass = 0; pass < 2; pass++) {
+        for (int n = 0; n < SPAN; n++) {
+            lcg = lcg * 1103515245u + 12345u;
+            int i = (int)((lcg >> 8) % SPAN);
+            convert(jd0 + i, &loc, rnd[i]);
+            if (memcmp(rnd[i], seq[i], sizeof(seq[i])) != 0) {
+                ASSERT_EQ(i, -1, "random order matches consecutive days");
+                restore_capacities();
+                return;
+            }
+        }
+    }
+    ASSERT_EQ(1, 1, "random order matches consecutive days");
+    CacheStats s[CACHE_COUNT];
+    cache_stats(s);
+    ASSERT_EQ(s[CACHE_LUNATION].evictions, 0, "every lunation kept");
+    ASSERT_EQ(s[CACHE_SANKRANTI].evictions, 0, "every solar month kept");
+    ASSERT_EQ(s[CACHE_LUNATION].misses <= 26, 1, "each lunation computed once");
+    ASSERT_EQ(s[CACHE_SOLAR_YEAR].misses <= 4 * 3, 1, "each solar year computed once");
+    restore_capacities();
+}
+
+static void *worker(void *arg)
+{
+    (void)arg;
+    Location loc = DEFAULT_LOCATION;
+    astro_init(NULL);
+    gregorian_to_hindu(1931, 6, 10, &loc);
+    gregorian_to_hindu(1931, 6, 11, &loc);
+    astro_close();
+    return NULL;
+}
+
+static void test_threads(void)
+{
+    printf("\n--- Threads retire their counts ---\n");
+    cache_stats_reset();
+
+    pthread_t tids[2];
+    for (int t = 0; t < 2; t++)
+        pthread_create(&tids[t], NULL, worker, NULL);
+    for (int t = 0; t < 2; t++)
+        pthread_join(tids[t], NULL);
+    CacheStats s = stats_now(CACHE_PREV_DAY);
+    ASSERT_EQ(s.hits, 2, "retired hits");
+    ASSERT_EQ(s.misses, 2, "retired misses");
+    ASSERT_EQ(s.occupancy, 1, "occupancy of a finished thread");
+
+    cache_stats_reset();
+    ASSERT_EQ(stats_now(CACHE_PREV_DAY).hits, 0, "reset clears retired counts");
+}
+
+static void test_print(void)
+{
+    printf("\n--- Report ---\n");
+    CacheStats s[CACHE_COUNT];
+    memset(s, 0, sizeof(s));
+    s[CACHE_LUNATION].hits = 3;
+    s[CACHE_LUNATION].misses = 1;
+    s[CACHE_LUNATION].capacity = 2048;
+    FILE *f = tmpfile();
+    ASSERT_EQ(f != NULL, 1, "tmpfile");
+    if (!f) return;
+    cache_print_stats(f, s);
+    rewind(f);
+    char line[160];
+    int lines = 0, hit_rate = 0;
+    while (fgets(line, sizeof(line), f)) {
+        lines++;
+        if (strncmp(line, "lunation ", 9) == 0 && strstr(line, "2048") &&
+            strstr(line, "75.0%"))
+            hit_rate = 1;
+    }
+    fclose(f);
+    ASSERT_EQ(lines, 1 + CACHE_COUNT, "header plus one line per cache");
+    ASSERT_EQ(hit_rate, 1, "capacity and hit rate");
+}
+
+int main(void)
+{
+    astro_init(NULL);
+    for (int c = 0; c < CACHE_COUNT; c++)
+        default_capacity[c] = cache_capacity((CacheId)c);
+
+    test_names_and_capacities();
+    test_lru();
+    test_sets();
+    test_counts();
+    test_random_order();
+    test_threads();
+    test_print();
+
+    astro_close();
+
+    printf("\n=== Cache tests: %d/%d passed ===\n", tests_passed, tests_run);
+    return (tests_passed == tests_run) ? 0 : 1;
+}
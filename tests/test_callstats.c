@@ -0,0 +1,168 @@
+#include "callstats.h"
+#include "astro.h"
+#include "panchang.h"
+#include "solar.h"
+#include "date_utils.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define ASSERT_EQ(actual, expected, msg) do { \
+    tests_run++; \
+    long _a = (actual), _e = (expected); \
+    if (_a == _e) { \
+        tests_passed++; \
+    } else { \
+        printf("  FAIL: %s (got %ld, expected %ld)\n", msg, _a, _e); \
+    } \
+} while (0)
+
+/* Expected count: n when the counters are compiled in, else 0 */
+static long expect(long n)
+{
+    return call_stats_enabled() ? n : 0;
+}
+
+static unsigned long stat_now(CallStat id)
+{
+    CallStats s;
+    call_stats_snapshot(&s);
+    return s.count[id];
+}
+
+static void test_entry_points(void)
+{
+    printf("\n--- Ephemeris entry points ---\n");
+    Location loc = DEFAULT_LOCATION;
+    double jd = gregorian_to_jd(2025, 3, 14);
+
+    call_stats_reset();
+    CallStats s;
+    call_stats_snapshot(&s);
+    int zero = 1;
+    for (int i = 0; i < CS_COUNT; i++)
+        if (s.count[i]) zero = 0;
+    ASSERT_EQ(zero, 1, "reset zeroes every counter");
+
+    for (int i = 0; i < 3; i++)
+        solar_longitude(jd + i);
+    lunar_longitude(jd);
+    get_ayanamsa(jd);
+    sunrise_jd(jd, &loc);
+    sunset_jd(jd, &loc);
+    ASSERT_EQ(stat_now(CS_SOLAR_LONGITUDE), expect(3), "solar_longitude");
+    ASSERT_EQ(stat_now(CS_LUNAR_LONGITUDE), expect(1), "lunar_longitude");
+    ASSERT_EQ(stat_now(CS_AYANAMSA), expect(1), "get_ayanamsa");
+    ASSERT_EQ(stat_now(CS_SUNRISE), expect(1), "sunrise_jd");
+    ASSERT_EQ(stat_now(CS_SUNSET), expect(1), "sunset_jd");
+
+    /* The sidereal longitude is one solar longitude plus one ayanamsa */
+    call_stats_reset();
+    solar_longitude_sidereal(jd);
+    ASSERT_EQ(stat_now(CS_SOLAR_LONGITUDE), expect(1), "sidereal: sun");
+    ASSERT_EQ(stat_now(CS_AYANAMSA), expect(1), "sidereal: ayanamsa");
+}
+
+static void test_caches(void)
+{
+    printf("\n--- Cache lookups ---\n");
+    Location loc = DEFAULT_LOCATION;
+
+    /* A day far from any earlier test, then the next day */
+    call_stats_reset();
+    gregorian_to_hindu(1931, 6, 10, &loc);
+    ASSERT_EQ(stat_now(CS_PREV_DAY_MISS), expect(1), "first day misses");
+    ASSERT_EQ(stat_now(CS_LUNATION_MISS), expect(1), "new lunation misses");
+    gregorian_to_hindu(1931, 6, 11, &loc);
+    ASSERT_EQ(stat_now(CS_PREV_DAY_HIT), expect(1), "next day hits");
+    ASSERT_EQ(stat_now(CS_LUNATION_HIT), expect(1), "same lunation hits");
+    ASSERT_EQ(stat_now(CS_NEW_MOON), expect(2), "one new moon pair searched");
+
+    call_stats_reset();
+    gregorian_to_solar(1931, 6, 10, &loc, SOLAR_CAL_TAMIL);
+    gregorian_to_solar(1931, 6, 11, &loc, SOLAR_CAL_TAMIL);
+    ASSERT_EQ(stat_now(CS_SANKRANTI_MISS), expect(1), "sankranti miss");
+    ASSERT_EQ(stat_now(CS_SANKRANTI_HIT), expect(1), "sankranti hit");
+    ASSERT_EQ(stat_now(CS_SOLAR_YEAR_MISS), expect(1), "solar year miss");
+    ASSERT_EQ(stat_now(CS_SOLAR_YEAR_HIT), expect(1), "solar year hit");
+}
+
+static void *worker(void *arg)
+{
+    (void)arg;
+    astro_init(NULL);
+    for (int i = 0; i < 5; i++)
+        lunar_longitude(2460000.5 + i);
+    astro_close();
+    return NULL;
+}
+
+static void test_threads(void)
+{
+    printf("\n--- Threads retire their counts ---\n");
+    call_stats_reset();
+    lunar_longitude(2460000.5);
+
+    pthread_t tids[2];
+    for (int t = 0; t < 2; t++)
+        pthread_create(&tids[t], NULL, worker, NULL);
+    for (int t = 0; t < 2; t++)
+        pthread_join(tids[t], NULL);
+    ASSERT_EQ(stat_now(CS_LUNAR_LONGITUDE), expect(11), "own plus retired counts");
+
+    call_stats_reset();
+    ASSERT_EQ(stat_now(CS_LUNAR_LONGITUDE), 0, "reset clears retired counts");
+}
+
+static void test_names_and_print(void)
+{
+    printf("\n--- Names and report ---\n");
+    ASSERT_EQ(strcmp(call_stat_name(CS_SUNRISE), "sunrise"), 0, "sunrise name");
+    ASSERT_EQ(strcmp(call_stat_name(CS_SANKRANTI_MISS), "sankranti_miss"), 0, "last name");
+    ASSERT_EQ(strcmp(call_stat_name(CS_COUNT), "unknown"), 0, "out of range");
+
+    CallStats s;
+    memset(&s, 0, sizeof(s));
+    s.count[CS_SOLAR_LONGITUDE] = 50;
+    s.count[CS_LUNATION_HIT] = 3;
+    s.count[CS_LUNATION_MISS] = 1;
+    FILE *f = tmpfile();
+    ASSERT_EQ(f != NULL, 1, "tmpfile");
+    if (!f) return;
+    call_stats_print(f, &s, 10);
+    rewind(f);
+    char line[128];
+    int per_day = 0, hit_rate = 0, lines = 0;
+    while (fgets(line, sizeof(line), f)) {
+        lines++;
+        if (strstr(line, "solar_longitude") && strstr(line, "5.00")) per_day = 1;
+        if (strncmp(line, "lunation ", 9) == 0 && strstr(line, "75.0%")) hit_rate = 1;
+    }
+    fclose(f);
+    if (call_stats_enabled()) {
+        ASSERT_EQ(lines, 2 + CS_COUNT - (CS_COUNT - CS_LUNATION_HIT) / 2, "one line per counter");
+        ASSERT_EQ(per_day, 1, "count per day");
+        ASSERT_EQ(hit_rate, 1, "cache hit rate");
+    } else {
+        ASSERT_EQ(lines, 1, "notice when not compiled in");
+    }
+}
+
+int main(void)
+{
+    astro_init(NULL);
+
+    printf("Call counters %s\n", call_stats_enabled() ? "enabled" : "disabled");
+    test_entry_points();
+    test_caches();
+    test_threads();
+    test_names_and_print();
+
+    astro_close();
+
+    printf("\n=== Call stats tests: %d/%d passed ===\n", tests_passed, tests_run);
+    return (tests_passed == tests_run) ? 0 : 1;
+}
@@ -1,6 +1,7 @@
 #include "tithi.h"
 #include "masa.h"
 #include "astro.h"
+#include "csvmap.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -55,8 +56,8 @@ int main(void)
         return 0;
     }
 
-    FILE *f = fopen(csv_path, "r");
-    if (!f) {
+    CsvFile csv;
+    if (!csv_open(&csv, csv_path)) {
         printf("ERROR: cannot open %s\n", csv_path);
         return 1;
     }
@@ -64,24 +65,18 @@ int main(void)
     astro_init(NULL);
     Location delhi = DEFAULT_LOCATION;
 
-    char line[256];
-    int line_num = 0;
+    int row_num = 0;
     int sampled = 0;
 
-    /* Skip header */
-    if (!fgets(line, sizeof(line), f)) {
-        fclose(f);
-        astro_close();
-        return 1;
-    }
-
-    while (fgets(line, sizeof(line), f)) {
-        line_num++;
-        if ((line_num - 1) % SAMPLE_STEP != 0)
+    while (csv_next(&csv)) {
+        row_num++;
+        if ((row_num - 1) % SAMPLE_STEP != 0)
             continue;
 
         int y, m, d, tithi, masa, adhika, saka;
-        if (sscanf(line, "%d,%d,%d,%d,%d,%d,%d", &y, &m, &d, &tithi, &masa, &adhika, &saka) != 7)
+        if (!csv_int(&csv, 0, &y) || !csv_int(&csv, 1, &m) || !csv_int(&csv, 2, &d) ||
+            !csv_int(&csv, 3, &tithi) || !csv_int(&csv, 4, &masa) ||
+            !csv_int(&csv, 5, &adhika) || !csv_int(&csv, 6, &saka))
             continue;
 
         TithiInfo ti = tithi_at_sunrise(y, m, d, &delhi);
@@ -108,7 +103,7 @@ int main(void)
         sampled++;
     }
 
-    fclose(f);
+    csv_close(&csv);
     astro_close();
 
     printf("\n=== CSV Regression: %d/%d passed, %d failed (%d days sampled from CSV) ===\n",
@@ -0,0 +1,176 @@
+#include "csvmap.h"
+#include "date_utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define ASSERT_EQ(actual, expected, msg) do { \
+    tests_run++; \
+    long _a = (actual), _e = (expected); \
+    if (_a == _e) { \
+        tests_passed++; \
+    } else { \
+        printf("  FAIL: %s (got %ld, expected %ld)\n", msg, _a, _e); \
+    } \
+} while (0)
+
+#define TMP_PATH "build/test_csvmap.csv"
+
+static void write_file(const char *text)
+{
+    FILE *f = fopen(TMP_PATH, "wb");
+    if (!f) return;
+    fputs(text, f);
+    fclose(f);
+}
+
+static void test_fields(void)
+{
+    printf("\n--- Fields and typed accessors ---\n");
+    write_file("year,month,day,jd,name\n"
+               "2025,3,14,2460748.5,Phalguna\n"
+               "-44,+3,15,1705426.0,Ides\n");
+    CsvFile c;
+    ASSERT_EQ(csv_open(&c, TMP_PATH), 1, "open");
+    ASSERT_EQ(c.n_columns, 5, "header columns");
+    ASSERT_EQ(csv_column(&c, "day"), 2, "column by name");
+    ASSERT_EQ(csv_column(&c, "name"), 4, "last column by name");
+    ASSERT_EQ(csv_column(&c, "da"), -1, "prefix of a name is not a match");
+    ASSERT_EQ(csv_count_rows(&c), 2, "row count");
+
+    int v = 0, len = 0;
+    double x = 0;
+    ASSERT_EQ(csv_next(&c), 1, "first row");
+    ASSERT_EQ(c.line, 2, "line number");
+    ASSERT_EQ(c.n_fields, 5, "fields");
+    ASSERT_EQ(csv_int(&c, 0, &v) && v == 2025, 1, "int");
+    ASSERT_EQ(csv_double(&c, 3, &x) && x == 2460748.5, 1, "double");
+    ASSERT_EQ(csv_date_jd(&c, 0, 1, 2, &x) && x == gregorian_to_jd(2025, 3, 14), 1,
+              "date columns to JD");
+    const char *name = csv_str(&c, 4, &len);
+    ASSERT_EQ(name && len == 8 && memcmp(name, "Phalguna", 8) == 0, 1, "string");
+    ASSERT_EQ(csv_str_eq(&c, 4, "Phalguna"), 1, "string compare");
+    ASSERT_EQ(csv_str_eq(&c, 4, "Phalgun"), 0, "string compare, shorter");
+
+    v = 7;
+    ASSERT_EQ(csv_int(&c, 4, &v), 0, "text is not an int");
+    ASSERT_EQ(csv_int(&c, 3, &v), 0, "decimal is not an int");
+    ASSERT_EQ(csv_int(&c, 5, &v), 0, "column past the row");
+    ASSERT_EQ(csv_int(&c, -1, &v), 0, "negative column");
+    ASSERT_EQ(v, 7, "output untouched on failure");
+    ASSERT_EQ(csv_str(&c, 9, &len) == NULL, 1, "no string past the row");
+
+    ASSERT_EQ(csv_next(&c), 1, "second row");
+    ASSERT_EQ(csv_int(&c, 0, &v) && v == -44, 1, "negative int");
+    ASSERT_EQ(csv_int(&c, 1, &v) && v == 3, 1, "int with plus sign");
+    ASSERT_EQ(csv_next(&c), 0, "end of file");
+    ASSERT_EQ(csv_next(&c), 0, "still at end");
+
+    csv_rewind(&c);
+    ASSERT_EQ(csv_next(&c) && csv_int(&c, 0, &v) && v == 2025, 1, "rewind");
+    csv_close(&c);
+    ASSERT_EQ(c.data == NULL, 1, "close clears the handle");
+}
+
+static void test_layout(void)
+{
+    printf("\n--- Line endings, blank lines, empty fields ---\n");
+    write_file("a,b,c\r\n"
+               "1,,3\r\n"
+               "\r\n"
+               "\n"
+               "4,5,6");   /* no final newline */
+    CsvFile c;
+    int v = 0, len = -1;
+    ASSERT_EQ(csv_open(&c, TMP_PATH), 1, "open");
+    ASSERT_EQ(csv_column(&c, "c"), 2, "CR not part of the last header name");
+    ASSERT_EQ(csv_count_rows(&c), 2, "blank lines not counted");
+
+    ASSERT_EQ(csv_next(&c), 1, "row 1");
+    ASSERT_EQ(c.n_fields, 3, "empty field counted");
+    ASSERT_EQ(csv_int(&c, 1, &v), 0, "empty field is not an int");
+    ASSERT_EQ(csv_str(&c, 1, &len) != NULL && len == 0, 1, "empty string");
+    ASSERT_EQ(csv_int(&c, 2, &v) && v == 3, 1, "CR not part of the last field");
+
+    ASSERT_EQ(csv_next(&c), 1, "row after blank lines");
+    ASSERT_EQ(c.line, 5, "line number counts blank lines");
+    ASSERT_EQ(csv_int(&c, 2, &v) && v == 6, 1, "last field without newline");
+    ASSERT_EQ(csv_next(&c), 0, "end");
+    csv_close(&c);
+
+    /* Overlong and overflowing values */
+    write_file("x,y\n99999999999,2147483647\n1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18\n");
+    ASSERT_EQ(csv_open(&c, TMP_PATH), 1, "open");
+    csv_next(&c);
+    ASSERT_EQ(csv_int(&c, 0, &v), 0, "overflow refused");
+    ASSERT_EQ(csv_int(&c, 1, &v) && v == 2147483647, 1, "INT_MAX");
+    csv_next(&c);
+    ASSERT_EQ(c.n_fields, CSV_MAX_FIELDS, "fields past the limit ignored");
+    ASSERT_EQ(csv_int(&c, CSV_MAX_FIELDS - 1, &v) && v == CSV_MAX_FIELDS, 1, "last kept field");
+    csv_close(&c);
+}
+
+static void test_open_errors(void)
+{
+    printf("\n--- Open errors ---\n");
+    CsvFile c;
+    ASSERT_EQ(csv_open(&c, "build/no_such_file.csv"), 0, "missing file");
+    write_file("");
+    ASSERT_EQ(csv_open(&c, TMP_PATH), 0, "empty file");
+    write_file("\n\n");
+    ASSERT_EQ(csv_open(&c, TMP_PATH), 0, "only blank lines");
+    write_file("a,b\n");
+    ASSERT_EQ(csv_open(&c, TMP_PATH), 1, "header only");
+    ASSERT_EQ(csv_count_rows(&c), 0, "no rows");
+    ASSERT_EQ(csv_next(&c), 0, "no first row");
+    csv_close(&c);
+}
+
+/* The reference CSV read through csvmap matches sscanf on each line */
+static void test_reference(void)
+{
+    const char *path = "validation/moshier/ref_1900_2050.csv";
+    FILE *f = fopen(path, "r");
+    CsvFile c;
+    if (!f || !csv_open(&c, path)) {
+        printf("\n--- %s not found, skipping ---\n", path);
+        if (f) fclose(f);
+        return;
+    }
+    printf("\n--- ref_1900_2050.csv against sscanf ---\n");
+
+    char line[256];
+    long rows = 0, mismatches = 0;
+    if (!fgets(line, sizeof(line), f)) line[0] = '\0';
+    while (fgets(line, sizeof(line), f)) {
+        int a[7], b[7];
+        if (sscanf(line, "%d,%d,%d,%d,%d,%d,%d", &a[0], &a[1], &a[2], &a[3], &a[4],
+                   &a[5], &a[6]) != 7)
+            continue;
+        int ok = csv_next(&c);
+        for (int i = 0; ok && i < 7; i++)
+            ok = csv_int(&c, i, &b[i]) && b[i] == a[i];
+        if (!ok) mismatches++;
+        rows++;
+    }
+    fclose(f);
+    ASSERT_EQ(rows, 55152, "rows read");
+    ASSERT_EQ(mismatches, 0, "every field matches");
+    ASSERT_EQ(csv_next(&c), 0, "same number of rows");
+    csv_close(&c);
+}
+
+int main(void)
+{
+    test_fields();
+    test_layout();
+    test_open_errors();
+    test_reference();
+    remove(TMP_PATH);
+
+    printf("\n=== CSV reader tests: %d/%d passed ===\n", tests_passed, tests_run);
+    return (tests_passed == tests_run) ? 0 : 1;
+}
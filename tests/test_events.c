@@ -0,0 +1,269 @@
+#include "events.h"
+#include "tithi.h"
+#include "masa.h"
+#include "solar.h"
+#include "astro.h"
+#include "date_utils.h"
+#include <stdio.h>
+#include <math.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define ASSERT_EQ(actual, expected, msg) do { \
+    tests_run++; \
+    int _a = (actual), _e = (expected); \
+    if (_a == _e) { \
+        tests_passed++; \
+    } else { \
+        printf("  FAIL: %s (got %d, expected %d)\n", msg, _a, _e); \
+    } \
+} while (0)
+
+#define ASSERT_NEAR(actual, expected, tolerance, msg) do { \
+    tests_run++; \
+    double _a = (actual), _e = (expected), _t = (tolerance); \
+    if (fabs(_a - _e) <= _t) { \
+        tests_passed++; \
+    } else { \
+        printf("  FAIL: %s (got %.8f, expected %.8f)\n", msg, _a, _e); \
+    } \
+} while (0)
+
+/* Seconds in days */
+#define SEC(s) ((s) / 86400.0)
+
+/* 1 second either side of an event */
+#define EPS SEC(1.0)
+
+static int nakshatra_at(double jd)
+{
+    double lon = fmod(lunar_longitude(jd) - get_ayanamsa(jd) + 720.0, 360.0);
+    return (int)(lon / (360.0 / 27.0)) + 1;
+}
+
+/*
+ * Forward iteration over a year: every angular event really is a
+ * crossing, and agrees with the library's own boundary finders.
+ */
+static void test_forward_year(void)
+{
+    printf("\n--- Forward iteration, 2025 (all event kinds) ---\n");
+    Location delhi = DEFAULT_LOCATION;
+    EventCursor cur;
+    event_cursor_init(&cur, &delhi);
+
+    double jd = gregorian_to_jd(2025, 1, 1);
+    double jd_end = gregorian_to_jd(2026, 1, 1);
+    int counts[EVENT_KIND_COUNT] = {0};
+    int saved_run = tests_run, saved_pass = tests_passed;
+    double prev_jd = jd;
+    EventType prev_type = 0;
+    AstroEvent ev;
+
+    while (next_event(&cur, jd, EVENT_ALL, &ev) && ev.jd < jd_end) {
+        char buf[128];
+        snprintf(buf, sizeof(buf), "%s at JD %.5f", event_type_name(ev.type), ev.jd);
+
+        /* Strictly increasing in (jd, type) */
+        tests_run++;
+        if (ev.jd > prev_jd || (ev.jd == prev_jd && ev.type > prev_type))
+            tests_passed++;
+        else
+            printf("  FAIL: %s out of order\n", buf);
+
+        switch (ev.type) {
+        case EVENT_TITHI:
+            ASSERT_EQ(tithi_at_moment(ev.jd + EPS), ev.value, buf);
+            ASSERT_EQ(tithi_at_moment(ev.jd - EPS), (ev.value + 28) % 30 + 1, buf);
+            break;
+        case EVENT_NAKSHATRA:
+            ASSERT_EQ(nakshatra_at(ev.jd + EPS), ev.value, buf);
+            ASSERT_EQ(nakshatra_at(ev.jd - EPS), (ev.value + 25) % 27 + 1, buf);
+            break;
+        case EVENT_SANKRANTI:
+            ASSERT_EQ(solar_rashi(ev.jd + EPS), ev.value, buf);
+            ASSERT_NEAR(ev.jd, sankranti_jd(ev.jd, (ev.value - 1) * 30.0), EPS, buf);
+            break;
+        case EVENT_NEW_MOON:
+            ASSERT_NEAR(ev.jd, new_moon_after(ev.jd - 1.0, 29), EPS, buf);
+            break;
+        case EVENT_FULL_MOON:
+            ASSERT_NEAR(ev.jd, full_moon_near(ev.jd), EPS, buf);
+            break;
+        case EVENT_SUNRISE:
+        case EVENT_SUNSET: {
+            double day = floor(ev.jd + 0.5 + delhi.utc_offset / 24.0) - 0.5;
+            double expect = (ev.type == EVENT_SUNRISE) ? sunrise_jd(day, &delhi)
+                                                       : sunset_jd(day, &delhi);
+            ASSERT_NEAR(ev.jd, expect, SEC(0.001), buf);
+            break;
+        }
+        }
+
+        for (int k = 0; k < EVENT_KIND_COUNT; k++)
+            if (ev.type == (EventType)(1 << k)) counts[k]++;
+        prev_jd = ev.jd;
+        prev_type = ev.type;
+        jd = ev.jd;
+    }
+    printf("  %d/%d event checks passed\n",
+           tests_passed - saved_pass, tests_run - saved_run);
+
+    ASSERT_EQ(counts[3], 12, "2025 new moons");
+    ASSERT_EQ(counts[4], 12, "2025 full moons");
+    ASSERT_EQ(counts[2], 12, "2025 sankrantis");
+    ASSERT_EQ(counts[5], 365, "2025 sunrises");
+    ASSERT_EQ(counts[6], 365, "2025 sunsets");
+    tests_run++;
+    if (counts[0] >= 368 && counts[0] <= 373 && counts[1] >= 360 && counts[1] <= 368)
+        tests_passed++;
+    else
+        printf("  FAIL: tithi/nakshatra counts %d/%d\n", counts[0], counts[1]);
+}
+
+/*
+ * Coinciding events: every new moon also starts tithi 1, and both are
+ * returned when iterating with both kinds in the mask.
+ */
+static void test_coinciding(void)
+{
+    printf("\n--- New moon / tithi 1 coincidence ---\n");
+    Location delhi = DEFAULT_LOCATION;
+    EventCursor cur;
+    event_cursor_init(&cur, &delhi);
+
+    double jd = gregorian_to_jd(2024, 1, 1);
+    double jd_end = gregorian_to_jd(2026, 1, 1);
+    double last_tithi1 = 0;
+    AstroEvent ev;
+    int moons = 0;
+
+    while (next_event(&cur, jd, EVENT_TITHI | EVENT_NEW_MOON, &ev) && ev.jd < jd_end) {
+        if (ev.type == EVENT_TITHI && ev.value == 1)
+            last_tithi1 = ev.jd;
+        if (ev.type == EVENT_NEW_MOON) {
+            moons++;
+            char buf[64];
+            snprintf(buf, sizeof(buf), "new moon %d has tithi 1 alongside", moons);
+            ASSERT_NEAR(ev.jd, last_tithi1, SEC(0.01), buf);
+        }
+        jd = ev.jd;
+    }
+    ASSERT_EQ(moons, 25, "2024-2025 new moons");
+}
+
+/*
+ * Backward iteration returns the forward sequence reversed.
+ */
+static void test_backward_matches_forward(void)
+{
+    printf("\n--- prev_event reverses next_event ---\n");
+    Location delhi = DEFAULT_LOCATION;
+    EventCursor fwd, bwd;
+    event_cursor_init(&fwd, &delhi);
+    event_cursor_init(&bwd, &delhi);
+
+    enum { N = 400 };
+    static AstroEvent seq[N];
+    double jd = gregorian_to_jd(2030, 6, 1);
+    for (int i = 0; i < N; i++) {
+        next_event(&fwd, jd, EVENT_ALL, &seq[i]);
+        jd = seq[i].jd;
+    }
+
+    int mismatches = 0;
+    AstroEvent ev;
+    jd = seq[N - 1].jd;
+    bwd.last_jd = 0;
+    prev_event(&bwd, jd + SEC(1e-3), EVENT_ALL, &ev);
+    for (int i = N - 1; i >= 0; i--) {
+        /* Brackets rebuilt from a different seed agree to well under 1 ms */
+        if (ev.type != seq[i].type || ev.value != seq[i].value ||
+            fabs(ev.jd - seq[i].jd) > SEC(1e-3))
+            mismatches++;
+        if (i > 0) prev_event(&bwd, ev.jd, EVENT_ALL, &ev);
+    }
+    ASSERT_EQ(mismatches, 0, "400 events reversed");
+}
+
+/*
+ * "When does the current tithi end": next tithi event from an arbitrary
+ * instant equals tithi_at_sunrise()'s jd_end; previous equals jd_start.
+ * Queries jump around to exercise bracket rebuilds.
+ */
+static void test_random_access(void)
+{
+    printf("\n--- Random access vs tithi_at_sunrise() ---\n");
+    Location delhi = DEFAULT_LOCATION;
+    EventCursor cur;
+    event_cursor_init(&cur, &delhi);
+
+    static const int dates[][3] = {
+        {2025, 3, 30}, {1950, 7, 4}, {2025, 3, 31}, {2025, 3, 29},
+        {1901, 1, 1}, {2049, 12, 31}, {2012, 8, 17}, {2012, 8, 16},
+    };
+    for (int i = 0; i < (int)(sizeof(dates) / sizeof(dates[0])); i++) {
+        int y = dates[i][0], m = dates[i][1], d = dates[i][2];
+        TithiInfo ti = tithi_at_sunrise(y, m, d, &delhi);
+        double rise = sunrise_jd(gregorian_to_jd(y, m, d), &delhi);
+        AstroEvent ev;
+        char buf[64];
+
+        snprintf(buf, sizeof(buf), "%04d-%02d-%02d tithi end", y, m, d);
+        next_event(&cur, rise, EVENT_TITHI, &ev);
+        ASSERT_NEAR(ev.jd, ti.jd_end, EPS, buf);
+        ASSERT_EQ(ev.value, ti.tithi_num % 30 + 1, buf);
+
+        snprintf(buf, sizeof(buf), "%04d-%02d-%02d tithi start", y, m, d);
+        prev_event(&cur, rise, EVENT_TITHI, &ev);
+        ASSERT_NEAR(ev.jd, ti.jd_start, EPS, buf);
+        ASSERT_EQ(ev.value, ti.tithi_num, buf);
+
+        snprintf(buf, sizeof(buf), "%04d-%02d-%02d next sunrise", y, m, d);
+        next_event(&cur, rise, EVENT_SUNRISE, &ev);
+        ASSERT_NEAR(ev.jd, sunrise_jd(gregorian_to_jd(y, m, d) + 1.0, &delhi),
+                    SEC(0.001), buf);
+    }
+}
+
+/*
+ * Polar night: no sunrise between late November and mid January at
+ * Tromso; the next sunrise is found past the gap.
+ */
+static void test_polar(void)
+{
+    printf("\n--- Polar night (Tromso) ---\n");
+    Location tromso = { 69.6492, 18.9553, 0.0, 1.0 };
+    EventCursor cur;
+    event_cursor_init(&cur, &tromso);
+
+    AstroEvent ev;
+    double jd = gregorian_to_jd(2025, 12, 10);
+    ASSERT_EQ(next_event(&cur, jd, EVENT_SUNRISE, &ev), 1, "sunrise found");
+    int y, m, d;
+    jd_to_gregorian(ev.jd, &y, &m, &d);
+    ASSERT_EQ(y * 100 + m, 202601, "first sunrise after polar night in Jan 2026");
+
+    ASSERT_EQ(prev_event(&cur, jd, EVENT_SUNSET, &ev), 1, "sunset found");
+    jd_to_gregorian(ev.jd, &y, &m, &d);
+    ASSERT_EQ(y * 100 + m, 202511, "last sunset before polar night in Nov 2025");
+
+    ASSERT_EQ(next_event(&cur, jd, 0, &ev), 0, "empty mask finds nothing");
+}
+
+int main(void)
+{
+    astro_init(NULL);
+
+    test_forward_year();
+    test_coinciding();
+    test_backward_matches_forward();
+    test_random_access();
+    test_polar();
+
+    astro_close();
+
+    printf("\n=== Event tests: %d/%d passed ===\n", tests_passed, tests_run);
+    return (tests_passed == tests_run) ? 0 : 1;
+}
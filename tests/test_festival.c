@@ -0,0 +1,291 @@
+#include "festival.h"
+#include "panchang.h"
+#include "astro.h"
+#include "date_utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Festival search tests: find_tithi_dates() and find_sankranti_dates()
+ * must return exactly the days a day-by-day scan would, including
+ * adhika and kshaya tithis.
+ */
+
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+static void check(int condition, const char *msg)
+{
+    tests_run++;
+    if (condition) {
+        tests_passed++;
+    } else {
+        tests_failed++;
+        printf("  FAIL: %s\n", msg);
+    }
+}
+
+static const char *find_csv(const char *base)
+{
+    static char path[512];
+    const char *prefixes[] = {
+#ifdef USE_SWISSEPH
+        "validation/se/", "../validation/se/",
+#else
+        "validation/moshier/", "../validation/moshier/",
+#endif
+        NULL
+    };
+    for (int i = 0; prefixes[i]; i++) {
+        snprintf(path, sizeof(path), "%s%s", prefixes[i], base);
+        FILE *f = fopen(path, "r");
+        if (f) { fclose(f); return path; }
+    }
+    return NULL;
+}
+
+/*
+ * Compare a query against gregorian_to_hindu() for every day of a range.
+ */
+static void test_against_scan(const TithiQuery *q, int y1, int y2,
+                              const char *label)
+{
+    printf("\n--- %s, %d-%d vs day-by-day scan ---\n", label, y1, y2);
+    Location delhi = DEFAULT_LOCATION;
+    double jd_from = gregorian_to_jd(y1, 1, 1);
+    double jd_to = gregorian_to_jd(y2, 12, 31);
+
+    int n = find_tithi_dates(q, jd_from, jd_to, &delhi, NULL, 0);
+    TithiOccurrence *occ = malloc((n > 0 ? n : 1) * sizeof(TithiOccurrence));
+    int n2 = find_tithi_dates(q, jd_from, jd_to, &delhi, occ, n);
+    check(n2 == n, "sizing call and filling call agree");
+
+    int k = 0, scanned = 0, kshaya = 0, adhika = 0;
+    char buf[256];
+    for (double jd = jd_from; jd <= jd_to; jd += 1.0) {
+        int y, m, d;
+        jd_to_gregorian(jd, &y, &m, &d);
+        HinduDate hd = gregorian_to_hindu(y, m, d, &delhi);
+
+        int want = (q->masa <= 0 || q->masa == (int)hd.masa) &&
+                   (q->is_adhika < 0 || q->is_adhika == hd.is_adhika_masa) &&
+                   (q->paksha < 0 || q->paksha == (int)hd.paksha) &&
+                   (q->tithi <= 0 || q->tithi == hd.tithi);
+        if (want && !hd.is_adhika_tithi) {
+            scanned++;
+            if (k >= n) {
+                snprintf(buf, sizeof(buf), "%04d-%02d-%02d missing from search",
+                         y, m, d);
+                check(0, buf);
+                continue;
+            }
+            const TithiOccurrence *o = &occ[k++];
+            snprintf(buf, sizeof(buf),
+                     "%04d-%02d-%02d: search gave %04d-%02d-%02d %s%s %c-%d saka %d",
+                     y, m, d, o->greg_year, o->greg_month, o->greg_day,
+                     o->hindu_date.is_adhika_masa ? "Adhika " : "",
+                     MASA_NAMES[o->hindu_date.masa],
+                     o->hindu_date.paksha == SHUKLA_PAKSHA ? 'S' : 'K',
+                     o->hindu_date.tithi, o->hindu_date.year_saka);
+            check(o->greg_year == y && o->greg_month == m && o->greg_day == d &&
+                  o->sunrises >= 1 &&
+                  o->hindu_date.masa == hd.masa &&
+                  o->hindu_date.is_adhika_masa == hd.is_adhika_masa &&
+                  o->hindu_date.paksha == hd.paksha &&
+                  o->hindu_date.tithi == hd.tithi &&
+                  o->hindu_date.year_saka == hd.year_saka, buf);
+            if (o->sunrises == 2) adhika++;
+        }
+
+        /* A kshaya tithi follows the tithi prevailing at this day's
+         * sunrise and is reported on the same day. */
+        while (k < n && occ[k].sunrises == 0 &&
+               gregorian_to_jd(occ[k].greg_year, occ[k].greg_month,
+                               occ[k].greg_day) == jd) {
+            int t = occ[k].hindu_date.tithi +
+                    (occ[k].hindu_date.paksha == KRISHNA_PAKSHA ? 15 : 0);
+            int t_here = hd.tithi + (hd.paksha == KRISHNA_PAKSHA ? 15 : 0);
+            int t_next;
+            {
+                int ny, nm, nd;
+                jd_to_gregorian(jd + 1.0, &ny, &nm, &nd);
+                HinduDate hn = gregorian_to_hindu(ny, nm, nd, &delhi);
+                t_next = hn.tithi + (hn.paksha == KRISHNA_PAKSHA ? 15 : 0);
+                /* re-prime the adhika cache for the next loop iteration */
+                gregorian_to_hindu(y, m, d, &delhi);
+            }
+            snprintf(buf, sizeof(buf),
+                     "%04d-%02d-%02d kshaya tithi %d between %d and %d",
+                     y, m, d, t, t_here, t_next);
+            check((t_here % 30) + 1 == t && (t % 30) + 1 == t_next, buf);
+            kshaya++;
+            k++;
+        }
+    }
+    snprintf(buf, sizeof(buf), "all %d search results consumed (%d used)", n, k);
+    check(k == n, buf);
+
+    printf("  %d matching days, %d adhika, %d kshaya\n", scanned, adhika, kshaya);
+    free(occ);
+}
+
+/*
+ * 150 years of Purnimas and Amavasyas against ref_1900_2050.csv.
+ */
+static void test_csv_full_moons(void)
+{
+    printf("\n--- Purnima/Amavasya 1900-2050 vs ref_1900_2050.csv ---\n");
+    const char *path = find_csv("ref_1900_2050.csv");
+    if (!path) {
+        printf("  SKIP: ref_1900_2050.csv not found\n");
+        return;
+    }
+    FILE *f = fopen(path, "r");
+    if (!f) return;
+
+    Location delhi = DEFAULT_LOCATION;
+    TithiQuery q = { 0, -1, -1, 15 };
+    double jd_from = gregorian_to_jd(1900, 1, 1);
+    double jd_to = gregorian_to_jd(2050, 12, 31);
+    int n = find_tithi_dates(&q, jd_from, jd_to, &delhi, NULL, 0);
+    TithiOccurrence *occ = malloc(n * sizeof(TithiOccurrence));
+    find_tithi_dates(&q, jd_from, jd_to, &delhi, occ, n);
+
+    char line[256];
+    int k = 0, prev_tithi = 0, rows = 0, mismatches = 0;
+    if (!fgets(line, sizeof(line), f)) { fclose(f); free(occ); return; }
+    while (fgets(line, sizeof(line), f)) {
+        int y, m, d, tithi, masa, adhika, saka;
+        if (sscanf(line, "%d,%d,%d,%d,%d,%d,%d",
+                   &y, &m, &d, &tithi, &masa, &adhika, &saka) != 7)
+            continue;
+        int repeat = (tithi == prev_tithi);
+        prev_tithi = tithi;
+        if ((tithi != 15 && tithi != 30) || repeat) continue;
+        rows++;
+
+        /* Skip kshaya Purnima/Amavasya, which have no CSV row */
+        while (k < n && occ[k].sunrises == 0) k++;
+        if (k >= n) { mismatches++; continue; }
+        const TithiOccurrence *o = &occ[k++];
+        int t = o->hindu_date.tithi +
+                (o->hindu_date.paksha == KRISHNA_PAKSHA ? 15 : 0);
+        if (o->greg_year != y || o->greg_month != m || o->greg_day != d ||
+            t != tithi || (int)o->hindu_date.masa != masa ||
+            o->hindu_date.is_adhika_masa != adhika ||
+            o->hindu_date.year_saka != saka) {
+            if (mismatches < 10)
+                printf("  FAIL: %04d-%02d-%02d tithi %d: got %04d-%02d-%02d tithi %d\n",
+                       y, m, d, tithi, o->greg_year, o->greg_month, o->greg_day, t);
+            mismatches++;
+        }
+    }
+    fclose(f);
+    free(occ);
+
+    char buf[128];
+    snprintf(buf, sizeof(buf), "%d Purnima/Amavasya rows matched (%d mismatches)",
+             rows, mismatches);
+    check(mismatches == 0 && rows > 3500, buf);
+    printf("  %d rows checked\n", rows);
+}
+
+/*
+ * Solar month starts against the solar month CSVs.
+ */
+static void test_sankrantis(SolarCalendarType type, const char *base,
+                            const char *cal_name)
+{
+    printf("\n--- %s sankrantis 1900-2050 vs %s ---\n", cal_name, base);
+    char rel[128];
+    snprintf(rel, sizeof(rel), "solar/%s", base);
+    const char *path = find_csv(rel);
+    if (!path) {
+        printf("  SKIP: %s not found\n", base);
+        return;
+    }
+    FILE *f = fopen(path, "r");
+    if (!f) return;
+
+    Location delhi = DEFAULT_LOCATION;
+    double jd_from = gregorian_to_jd(1900, 1, 1);
+    double jd_to = gregorian_to_jd(2050, 11, 30);  /* last CSV row: Nov 2050 */
+    int n = find_sankranti_dates(type, 0, jd_from, jd_to, &delhi, NULL, 0);
+    SankrantiOccurrence *occ = malloc(n * sizeof(SankrantiOccurrence));
+    find_sankranti_dates(type, 0, jd_from, jd_to, &delhi, occ, n);
+
+    char line[256];
+    int k = 0, rows = 0, mismatches = 0;
+    if (!fgets(line, sizeof(line), f)) { fclose(f); free(occ); return; }
+    while (fgets(line, sizeof(line), f)) {
+        int month, year, length, gy, gm, gd;
+        if (sscanf(line, "%d,%d,%d,%d,%d,%d",
+                   &month, &year, &length, &gy, &gm, &gd) != 6)
+            continue;
+        rows++;
+        if (k >= n) { mismatches++; continue; }
+        const SankrantiOccurrence *o = &occ[k++];
+        if (o->greg_year != gy || o->greg_month != gm || o->greg_day != gd ||
+            o->solar_date.month != month || o->solar_date.year != year) {
+            if (mismatches < 10)
+                printf("  FAIL: %04d-%02d-%02d month %d/%d: got %04d-%02d-%02d month %d/%d\n",
+                       gy, gm, gd, month, year, o->greg_year, o->greg_month,
+                       o->greg_day, o->solar_date.month, o->solar_date.year);
+            mismatches++;
+        }
+    }
+    fclose(f);
+
+    char buf[128];
+    snprintf(buf, sizeof(buf), "%s: %d/%d month starts match, %d found",
+             cal_name, rows - mismatches, rows, n);
+    check(mismatches == 0 && n == rows, buf);
+
+    /* Rashi filter: Makara (10) only = every 12th entry of the full list */
+    int nm = find_sankranti_dates(type, 10, jd_from, jd_to, &delhi, NULL, 0);
+    SankrantiOccurrence *mk = malloc(nm * sizeof(SankrantiOccurrence));
+    find_sankranti_dates(type, 10, jd_from, jd_to, &delhi, mk, nm);
+    int j = 0, filter_ok = 1;
+    for (int i = 0; i < n; i++) {
+        if (occ[i].solar_date.rashi != 10) continue;
+        if (j >= nm || mk[j].greg_year != occ[i].greg_year ||
+            mk[j].greg_month != occ[i].greg_month ||
+            mk[j].greg_day != occ[i].greg_day)
+            filter_ok = 0;
+        j++;
+    }
+    snprintf(buf, sizeof(buf), "%s: Makara filter gives %d of %d", cal_name, nm, j);
+    check(filter_ok && j == nm, buf);
+
+    free(mk);
+    free(occ);
+}
+
+int main(void)
+{
+    astro_init(NULL);
+
+    TithiQuery ekadashi = { 0, -1, -1, 11 };
+    TithiQuery any = { 0, -1, -1, 0 };
+    TithiQuery adhika_only = { 0, 1, -1, 0 };
+    TithiQuery kartika_purnima = { KARTIKA, 0, SHUKLA_PAKSHA, 15 };
+
+    test_against_scan(&ekadashi, 2020, 2026, "Ekadashi");
+    test_against_scan(&any, 2012, 2013, "Every tithi");
+    test_against_scan(&adhika_only, 2012, 2015, "Adhika masa days");
+    test_against_scan(&kartika_purnima, 2000, 2030, "Kartika Purnima");
+    test_csv_full_moons();
+
+    test_sankrantis(SOLAR_CAL_TAMIL, "tamil_months_1900_2050.csv", "Tamil");
+    test_sankrantis(SOLAR_CAL_BENGALI, "bengali_months_1900_2050.csv", "Bengali");
+    test_sankrantis(SOLAR_CAL_ODIA, "odia_months_1900_2050.csv", "Odia");
+    test_sankrantis(SOLAR_CAL_MALAYALAM, "malayalam_months_1900_2050.csv", "Malayalam");
+
+    astro_close();
+
+    printf("\n=== Festival search: %d/%d passed, %d failed ===\n",
+           tests_passed, tests_run, tests_failed);
+    return (tests_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,232 @@
+#include "panchang.h"
+#include "masa.h"
+#include "astro.h"
+#include "date_utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * hindu_to_gregorian() tests: round trip over every day of
+ * ref_1900_2050.csv (including the kshaya tithis the CSV skips),
+ * Purnimanta month starts, and rejection of dates that do not exist.
+ */
+
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+static void check(int condition, const char *msg)
+{
+    tests_run++;
+    if (condition) {
+        tests_passed++;
+    } else {
+        tests_failed++;
+        printf("  FAIL: %s\n", msg);
+    }
+}
+
+static const char *find_csv(void)
+{
+    static const char *paths[] = {
+#ifdef USE_SWISSEPH
+        "validation/se/ref_1900_2050.csv",
+        "../validation/se/ref_1900_2050.csv",
+#else
+        "validation/moshier/ref_1900_2050.csv",
+        "../validation/moshier/ref_1900_2050.csv",
+#endif
+        NULL
+    };
+    for (int i = 0; paths[i]; i++) {
+        FILE *f = fopen(paths[i], "r");
+        if (f) { fclose(f); return paths[i]; }
+    }
+    return NULL;
+}
+
+typedef struct {
+    int y, m, d, tithi, masa, adhika, saka;
+} RefRow;
+
+static RefRow *load_rows(const char *path, int *count)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) return NULL;
+
+    int cap = 56000, n = 0;
+    RefRow *rows = malloc(cap * sizeof(RefRow));
+    char line[256];
+
+    if (!fgets(line, sizeof(line), f)) {  /* header */
+        fclose(f);
+        free(rows);
+        return NULL;
+    }
+    while (fgets(line, sizeof(line), f)) {
+        RefRow r;
+        if (sscanf(line, "%d,%d,%d,%d,%d,%d,%d", &r.y, &r.m, &r.d, &r.tithi,
+                   &r.masa, &r.adhika, &r.saka) != 7)
+            continue;
+        if (n >= cap) {
+            cap *= 2;
+            rows = realloc(rows, cap * sizeof(RefRow));
+        }
+        rows[n++] = r;
+    }
+    fclose(f);
+    *count = n;
+    return rows;
+}
+
+static HinduDate row_date(const RefRow *r, int tithi, int is_adhika_tithi)
+{
+    HinduDate hd = {0};
+    hd.year_saka = r->saka;
+    hd.masa = (MasaName)r->masa;
+    hd.is_adhika_masa = r->adhika;
+    hd.paksha = (tithi <= 15) ? SHUKLA_PAKSHA : KRISHNA_PAKSHA;
+    hd.tithi = (tithi <= 15) ? tithi : tithi - 15;
+    hd.is_adhika_tithi = is_adhika_tithi;
+    return hd;
+}
+
+/*
+ * Every CSV day maps back to itself.  Each skipped tithi maps to the
+ * day before the jump and is flagged kshaya.
+ */
+static void test_csv_round_trip(const RefRow *rows, int n, const Location *loc)
+{
+    printf("\n--- Round trip over ref_1900_2050.csv (%d days) ---\n", n);
+    int n_adhika = 0, n_kshaya = 0;
+
+    for (int i = 1; i + 1 < n; i++) {
+        const RefRow *r = &rows[i];
+        const RefRow *p = &rows[i - 1];
+        int is_adhika_tithi = (r->tithi == p->tithi);
+        int spans_two = is_adhika_tithi || (r->tithi == rows[i + 1].tithi);
+        char buf[256];
+
+        HinduDate hd = row_date(r, r->tithi, is_adhika_tithi);
+        int y, m, d;
+        HinduDateMatch st = hindu_to_gregorian(&hd, LUNISOLAR_AMANTA, loc, &y, &m, &d);
+        snprintf(buf, sizeof(buf), "%04d-%02d-%02d round trip (got %04d-%02d-%02d, status %d)",
+                 r->y, r->m, r->d, y, m, d, (int)st);
+        check(y == r->y && m == r->m && d == r->d &&
+              st == (spans_two ? HINDU_MATCH_ADHIKA_TITHI : HINDU_MATCH_EXACT), buf);
+        if (is_adhika_tithi) n_adhika++;
+
+        /* Kshaya: tithi advanced by two between consecutive sunrises.
+         * The skipped tithi belongs to the lunation of the row it shares
+         * a paksha run with (tithi 1 opens the new lunation). */
+        if ((r->tithi - p->tithi + 30) % 30 == 2) {
+            int skipped = p->tithi % 30 + 1;
+            HinduDate kd = row_date(skipped == 1 ? r : p, skipped, 0);
+            st = hindu_to_gregorian(&kd, LUNISOLAR_AMANTA, loc, &y, &m, &d);
+            snprintf(buf, sizeof(buf), "%04d-%02d-%02d kshaya tithi %d (got %04d-%02d-%02d, status %d)",
+                     p->y, p->m, p->d, skipped, y, m, d, (int)st);
+            check(y == p->y && m == p->m && d == p->d &&
+                  st == HINDU_MATCH_KSHAYA_TITHI, buf);
+            n_kshaya++;
+        }
+    }
+    printf("  %d adhika and %d kshaya tithis checked\n", n_adhika, n_kshaya);
+}
+
+/*
+ * Purnimanta: Krishna Pratipada of month M is the month's first civil day
+ * as given by lunisolar_month_start(), unless that tithi is kshaya.
+ * Months (including adhika ones) are taken from the CSV.
+ */
+static void test_purnimanta_month_starts(const RefRow *rows, int n,
+                                         const Location *loc)
+{
+    printf("\n--- Purnimanta Krishna Pratipada = lunisolar_month_start (1900-2050) ---\n");
+    int checked = 0;
+
+    for (int i = 1; i < n; i++) {
+        const RefRow *r = &rows[i];
+        const RefRow *p = &rows[i - 1];
+        if (r->masa == p->masa && r->adhika == p->adhika)
+            continue;
+
+        double jd = lunisolar_month_start((MasaName)r->masa, r->saka, r->adhika,
+                                          LUNISOLAR_PURNIMANTA, loc);
+        HinduDate hd = row_date(r, 16, 0);
+        int y, m, d;
+        HinduDateMatch st = hindu_to_gregorian(&hd, LUNISOLAR_PURNIMANTA,
+                                               loc, &y, &m, &d);
+        if (st == HINDU_MATCH_KSHAYA_TITHI) continue;
+
+        char buf[128];
+        snprintf(buf, sizeof(buf), "%s%s %d Krishna 1 (got %04d-%02d-%02d)",
+                 r->adhika ? "Adhika " : "", MASA_NAMES[r->masa], r->saka, y, m, d);
+        check(jd > 0 && gregorian_to_jd(y, m, d) == jd, buf);
+        checked++;
+    }
+    printf("  %d months checked\n", checked);
+}
+
+/*
+ * Dates that name no civil day.
+ */
+static void test_no_match(const Location *loc)
+{
+    printf("\n--- Nonexistent dates ---\n");
+    int y, m, d;
+    char buf[128];
+
+    /* Saka 1947: no adhika month */
+    for (int masa = CHAITRA; masa <= PHALGUNA; masa++) {
+        HinduDate hd = { 1947, 2082, (MasaName)masa, 1, SHUKLA_PAKSHA, 5, 0 };
+        snprintf(buf, sizeof(buf), "Adhika %s 1947 does not exist", MASA_NAMES[masa]);
+        check(hindu_to_gregorian(&hd, LUNISOLAR_AMANTA, loc, &y, &m, &d) ==
+              HINDU_MATCH_NONE && y == 0, buf);
+    }
+
+    /* Out-of-range tithi */
+    HinduDate bad = { 1947, 2082, CHAITRA, 0, SHUKLA_PAKSHA, 16, 0 };
+    check(hindu_to_gregorian(&bad, LUNISOLAR_AMANTA, loc, &y, &m, &d) ==
+          HINDU_MATCH_NONE, "tithi 16 rejected");
+    bad.tithi = 0;
+    check(hindu_to_gregorian(&bad, LUNISOLAR_AMANTA, loc, &y, &m, &d) ==
+          HINDU_MATCH_NONE, "tithi 0 rejected");
+
+    /* Adhika tithi flag on a tithi seen at only one sunrise:
+     * Chaitra Shukla 1, Saka 1947 = 2025-03-30 */
+    HinduDate hd = { 1947, 2082, CHAITRA, 0, SHUKLA_PAKSHA, 1, 0 };
+    HinduDateMatch st = hindu_to_gregorian(&hd, LUNISOLAR_AMANTA, loc, &y, &m, &d);
+    snprintf(buf, sizeof(buf), "Chaitra Shukla 1, 1947 = 2025-03-30 (got %04d-%02d-%02d)",
+             y, m, d);
+    check(st == HINDU_MATCH_EXACT && y == 2025 && m == 3 && d == 30, buf);
+    hd.is_adhika_tithi = 1;
+    check(hindu_to_gregorian(&hd, LUNISOLAR_AMANTA, loc, &y, &m, &d) ==
+          HINDU_MATCH_NONE, "adhika flag on single-sunrise tithi rejected");
+}
+
+int main(void)
+{
+    astro_init(NULL);
+    Location delhi = DEFAULT_LOCATION;
+
+    const char *csv_path = find_csv();
+    if (csv_path) {
+        int n = 0;
+        RefRow *rows = load_rows(csv_path, &n);
+        if (rows) {
+            test_csv_round_trip(rows, n, &delhi);
+            test_purnimanta_month_starts(rows, n, &delhi);
+            free(rows);
+        }
+    } else {
+        printf("SKIP: ref_1900_2050.csv not found\n");
+    }
+
+    test_no_match(&delhi);
+
+    astro_close();
+
+    printf("\n=== Hindu to Gregorian: %d/%d passed, %d failed ===\n",
+           tests_passed, tests_run, tests_failed);
+    return (tests_failed == 0) ? 0 : 1;
+}
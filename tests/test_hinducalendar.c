@@ -0,0 +1,262 @@
+/*
+ * Tests for libhinducalendar.so through its public header only: the
+ * binary links against the shared library, as a foreign caller would.
+ */
+#include "hinducalendar.h"
+#include <dlfcn.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define ASSERT_EQ(actual, expected, msg) do { \
+    tests_run++; \
+    int _a = (actual), _e = (expected); \
+    if (_a == _e) { \
+        tests_passed++; \
+    } else { \
+        printf("  FAIL: %s (got %d, expected %d)\n", msg, _a, _e); \
+    } \
+} while (0)
+
+#define ASSERT_TRUE(cond, msg) do { \
+    tests_run++; \
+    if (cond) { \
+        tests_passed++; \
+    } else { \
+        printf("  FAIL: %s\n", msg); \
+    } \
+} while (0)
+
+#define DAYS_2012 366
+
+/* Shuffled indices 0..n-1 (Fisher-Yates, LCG as in tools/bench_ports.workload) */
+static void shuffle(int *order, int n, unsigned seed)
+{
+    for (int i = 0; i < n; i++) order[i] = i;
+    for (int i = n - 1; i > 0; i--) {
+        seed = seed * 1103515245u + 12345u;
+        int j = (int)((seed >> 8) % (unsigned)(i + 1));
+        int t = order[i];
+        order[i] = order[j];
+        order[j] = t;
+    }
+}
+
+static void day_of_2012(int i, int *y, int *m, int *d)
+{
+    hcal_jd_to_gregorian(hcal_gregorian_to_jd(2012, 1, 1) + i, y, m, d);
+}
+
+static void test_known_dates(void)
+{
+    printf("\n--- Known dates ---\n");
+    ASSERT_TRUE(strcmp(hcal_version(), "1.0.0") == 0, "hcal_version");
+
+    hcal_context *ctx = hcal_create(28.6139, 77.2090, 0.0, 5.5);
+    ASSERT_TRUE(ctx != NULL, "create New Delhi");
+
+    /* Pausha Krishna 5, Saka 1946 (Vikram 2081) */
+    hcal_lunisolar_date ld;
+    ASSERT_EQ(hcal_lunisolar_days(ctx, 2025, 1, 18, 1, &ld), 1, "lunisolar count");
+    ASSERT_EQ(ld.masa, 10, "2025-01-18 masa");
+    ASSERT_EQ(ld.paksha, 1, "2025-01-18 paksha");
+    ASSERT_EQ(ld.tithi, 5, "2025-01-18 tithi");
+    ASSERT_EQ(ld.year_saka, 1946, "2025-01-18 saka");
+    ASSERT_EQ(ld.year_vikram, 2081, "2025-01-18 vikram");
+    ASSERT_TRUE(strcmp(hcal_masa_name(ld.masa), "Pausha") == 0, "masa name");
+
+    /* Chithirai 1, 1947 */
+    hcal_solar_date sd;
+    ASSERT_EQ(hcal_solar_days(ctx, HCAL_TAMIL, 2025, 4, 14, 1, &sd), 1, "solar count");
+    ASSERT_EQ(sd.year, 1947, "Tamil year");
+    ASSERT_EQ(sd.month, 1, "Tamil month");
+    ASSERT_EQ(sd.day, 1, "Tamil day");
+    ASSERT_TRUE(strcmp(hcal_solar_month_name(HCAL_TAMIL, sd.month), "Chithirai") == 0,
+                "Tamil month name");
+
+    hcal_destroy(ctx);
+}
+
+/* A batch equals one call per day in any order (2012 has an adhika month) */
+static void test_batch_matches_single_days(void)
+{
+    printf("\n--- Batches vs single days, 2012 ---\n");
+    hcal_context *ctx = hcal_create(13.0827, 80.2707, 0.0, 5.5);
+    static hcal_lunisolar_date batch[DAYS_2012], single[DAYS_2012];
+    static hcal_solar_date sbatch[DAYS_2012], ssingle[DAYS_2012];
+    int order[DAYS_2012];
+    shuffle(order, DAYS_2012, 42);
+
+    ASSERT_EQ(hcal_lunisolar_days(ctx, 2012, 1, 1, DAYS_2012, batch), DAYS_2012, "batch count");
+    for (int k = 0; k < DAYS_2012; k++) {
+        int i = order[k], y, m, d;
+        day_of_2012(i, &y, &m, &d);
+        hcal_lunisolar_days(ctx, y, m, d, 1, &single[i]);
+    }
+    int bad = 0, adhika_masa = 0;
+    for (int i = 0; i < DAYS_2012; i++) {
+        bad += memcmp(&batch[i], &single[i], sizeof(batch[i])) != 0;
+        adhika_masa += batch[i].is_adhika_masa;
+    }
+    ASSERT_EQ(bad, 0, "lunisolar days differing");
+    ASSERT_TRUE(adhika_masa >= 29, "adhika month present");
+
+    for (int cal = HCAL_TAMIL; cal <= HCAL_MALAYALAM; cal++) {
+        char msg[64];
+        hcal_solar_days(ctx, cal, 2012, 1, 1, DAYS_2012, sbatch);
+        for (int k = 0; k < DAYS_2012; k++) {
+            int i = order[k], y, m, d;
+            day_of_2012(i, &y, &m, &d);
+            hcal_solar_days(ctx, cal, y, m, d, 1, &ssingle[i]);
+        }
+        /* jd_sankranti is left out: it depends on the bisection's start */
+        bad = 0;
+        for (int i = 0; i < DAYS_2012; i++) {
+            bad += sbatch[i].year != ssingle[i].year || sbatch[i].month != ssingle[i].month ||
+                   sbatch[i].day != ssingle[i].day || sbatch[i].rashi != ssingle[i].rashi;
+        }
+        snprintf(msg, sizeof(msg), "calendar %d days differing", cal);
+        ASSERT_EQ(bad, 0, msg);
+    }
+    hcal_destroy(ctx);
+}
+
+static void test_errors(void)
+{
+    printf("\n--- Errors ---\n");
+    hcal_context *ctx = hcal_create(28.6139, 77.2090, 0.0, 5.5);
+    hcal_lunisolar_date ld;
+    hcal_solar_date sd;
+    hcal_event ev;
+
+    ASSERT_TRUE(hcal_create(91.0, 0.0, 0.0, 0.0) == NULL, "latitude 91");
+    ASSERT_TRUE(hcal_create(0.0, 0.0, 0.0, NAN) == NULL, "NaN offset");
+    ASSERT_EQ(hcal_lunisolar_days(NULL, 2025, 1, 1, 1, &ld), HCAL_EINVAL, "NULL context");
+    ASSERT_EQ(hcal_lunisolar_days(ctx, 2025, 2, 29, 1, &ld), HCAL_EINVAL, "2025-02-29");
+    ASSERT_EQ(hcal_lunisolar_days(ctx, 2025, 1, 1, -1, &ld), HCAL_EINVAL, "negative count");
+    ASSERT_EQ(hcal_lunisolar_days(ctx, 1000000, 1, 1, 1, &ld), HCAL_EINVAL, "year 1000000");
+    ASSERT_EQ(hcal_lunisolar_days(ctx, 1899, 12, 31, 1, &ld), HCAL_EINVAL, "1899-12-31");
+    ASSERT_EQ(hcal_solar_days(ctx, HCAL_TAMIL, 2100, 12, 31, 2, &sd), HCAL_EINVAL,
+              "batch past 2100");
+    ASSERT_EQ(hcal_solar_days(ctx, HCAL_TAMIL, 2100, 12, 31, 1, &sd), 1, "2100-12-31");
+    ASSERT_EQ(hcal_lunisolar_days(ctx, 2025, 1, 1, 1, NULL), HCAL_EINVAL, "NULL array");
+    ASSERT_EQ(hcal_lunisolar_days(ctx, 2025, 1, 1, 0, NULL), 0, "empty batch");
+    ASSERT_EQ(hcal_solar_days(ctx, 4, 2025, 1, 1, 1, &sd), HCAL_EINVAL, "bad calendar");
+    ASSERT_EQ(hcal_events(ctx, 10.0, 5.0, HCAL_EVENT_TITHI, &ev, 1), HCAL_EINVAL, "reversed span");
+    ASSERT_EQ(hcal_events(ctx, 0.0, 1.0, 1u << 7, &ev, 1), HCAL_EINVAL, "bad mask");
+    ASSERT_EQ(hcal_set_cache_capacities("bogus=3"), HCAL_EINVAL, "bad capacity spec");
+    ASSERT_EQ(hcal_set_cache_capacities("lunation=64"), 0, "capacity spec");
+    ASSERT_TRUE(strcmp(hcal_strerror(HCAL_EINVAL), "Invalid argument") == 0, "strerror");
+    hcal_destroy(ctx);
+    hcal_destroy(NULL);
+}
+
+/* Events in small batches, resumed from the last one, equal one big batch */
+static void test_events(void)
+{
+    printf("\n--- Events, 2025 ---\n");
+    hcal_context *ctx = hcal_create(28.6139, 77.2090, 0.0, 5.5);
+    hcal_context *ctx2 = hcal_create(28.6139, 77.2090, 0.0, 5.5);
+    double jd0 = hcal_gregorian_to_jd(2025, 1, 1), jd1 = hcal_gregorian_to_jd(2026, 1, 1);
+    unsigned mask = HCAL_EVENT_NEW_MOON | HCAL_EVENT_FULL_MOON | HCAL_EVENT_SANKRANTI;
+    static hcal_event all[64], part[64];
+
+    int n = hcal_events(ctx, jd0, jd1, mask, all, 64);
+    ASSERT_EQ(n, 12 + 12 + 12, "new moons + full moons + sankrantis");
+
+    int got = 0, k;
+    double jd = jd0;
+    while ((k = hcal_events(ctx2, jd, jd1, mask, part + got, 5)) > 0) {
+        got += k;
+        jd = part[got - 1].jd;
+        if (k < 5) break;
+    }
+    ASSERT_EQ(got, n, "resumed batches");
+    int bad = 0;
+    for (int i = 0; i < n && i < got; i++)
+        bad += all[i].jd != part[i].jd || all[i].type != part[i].type;
+    ASSERT_EQ(bad, 0, "resumed events differing");
+    ASSERT_TRUE(strcmp(hcal_event_name(all[0].type), "Sankranti") == 0 ||
+                strcmp(hcal_event_name(all[0].type), "New moon") == 0 ||
+                strcmp(hcal_event_name(all[0].type), "Full moon") == 0, "event name");
+
+    hcal_destroy(ctx);
+    hcal_destroy(ctx2);
+}
+
+/* Only hcal_* symbols are exported */
+static void test_visibility(void)
+{
+    printf("\n--- Exported symbols ---\n");
+    void *self = dlopen(NULL, RTLD_NOW);
+    ASSERT_TRUE(self && dlsym(self, "hcal_lunisolar_days") != NULL, "hcal_lunisolar_days exported");
+    ASSERT_TRUE(self && dlsym(self, "gregorian_to_hindu") == NULL, "gregorian_to_hindu hidden");
+    ASSERT_TRUE(self && dlsym(self, "cache_find") == NULL, "cache_find hidden");
+    if (self) dlclose(self);
+}
+
+static hcal_lunisolar_date thread_days[4][DAYS_2012];
+static hcal_solar_date thread_solar[4][DAYS_2012];
+
+/* Lunisolar and Tamil days of 2012 for New Delhi, on the calling thread */
+static void convert_2012(hcal_lunisolar_date *days, hcal_solar_date *solar)
+{
+    hcal_context *ctx = hcal_create(28.6139, 77.2090, 0.0, 5.5);
+    hcal_lunisolar_days(ctx, 2012, 1, 1, DAYS_2012, days);
+    hcal_solar_days(ctx, HCAL_TAMIL, 2012, 1, 1, DAYS_2012, solar);
+    hcal_destroy(ctx);
+}
+
+static void *convert_thread(void *arg)
+{
+    int t = (int)(long)arg;
+    convert_2012(thread_days[t], thread_solar[t]);
+    hcal_thread_release();
+    return NULL;
+}
+
+/* Every thread must agree with the main thread, not just with each other:
+ * the ephemeris backend has per-thread state */
+static void test_threads(void)
+{
+    printf("\n--- One context per thread ---\n");
+    static hcal_lunisolar_date ref_days[DAYS_2012];
+    static hcal_solar_date ref_solar[DAYS_2012];
+    convert_2012(ref_days, ref_solar);
+
+    pthread_t th[4];
+    for (long t = 0; t < 4; t++)
+        pthread_create(&th[t], NULL, convert_thread, (void *)t);
+    for (int t = 0; t < 4; t++)
+        pthread_join(th[t], NULL);
+    for (int t = 0; t < 4; t++) {
+        int bad = 0;
+        for (int i = 0; i < DAYS_2012; i++) {
+            const hcal_solar_date *a = &ref_solar[i], *b = &thread_solar[t][i];
+            bad += a->year != b->year || a->month != b->month || a->day != b->day ||
+                   a->rashi != b->rashi || fabs(a->jd_sankranti - b->jd_sankranti) > 1e-3;
+        }
+        ASSERT_TRUE(memcmp(ref_days, thread_days[t], sizeof(ref_days)) == 0,
+                    "thread lunisolar days equal the main thread's");
+        ASSERT_EQ(bad, 0, "thread solar days differing from the main thread's");
+    }
+}
+
+int main(void)
+{
+    test_known_dates();
+    test_batch_matches_single_days();
+    test_errors();
+    test_events();
+    test_visibility();
+    test_threads();
+
+    hcal_thread_release();
+
+    printf("\n=== Shared library tests: %d/%d passed ===\n", tests_passed, tests_run);
+    return (tests_passed == tests_run) ? 0 : 1;
+}
@@ -0,0 +1,233 @@
+#include "latency.h"
+#include "astro.h"
+#include "masa.h"
+#include "panchang.h"
+#include "solar.h"
+#include "date_utils.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define ASSERT_EQ(actual, expected, msg) do { \
+    tests_run++; \
+    long _a = (actual), _e = (expected); \
+    if (_a == _e) { \
+        tests_passed++; \
+    } else { \
+        printf("  FAIL: %s (got %ld, expected %ld)\n", msg, _a, _e); \
+    } \
+} while (0)
+
+#define TMP_PATH "build/test_latency.json"
+
+/* Both large; kept off the stack */
+static LatencyStats stats;
+static LatencyHistogram hist, hist2;
+
+/* Expected count: n when timing is compiled in, else 0 */
+static long expect(long n)
+{
+    return latency_enabled() ? n : 0;
+}
+
+static void test_histogram(void)
+{
+    printf("\n--- Log-linear buckets ---\n");
+    memset(&hist, 0, sizeof(hist));
+    ASSERT_EQ((long)latency_percentile(&hist, 50.0), 0, "empty histogram");
+
+    for (unsigned long long v = 1; v <= 10; v++)
+        latency_hist_add(&hist, v);
+    ASSERT_EQ((long)hist.total, 10, "total");
+    ASSERT_EQ((long)latency_percentile(&hist, 50.0), 5, "small values are exact");
+    ASSERT_EQ((long)latency_percentile(&hist, 100.0), 10, "p100 is the max");
+    ASSERT_EQ((long)latency_percentile(&hist, 0.0), 1, "p0 is the min");
+
+    /* Every value lands in a bucket no more than 1/16 wide */
+    memset(&hist, 0, sizeof(hist));
+    int within = 1;
+    for (unsigned long long v = 16; v < 100000000ULL; v = v * 3 + 7) {
+        memset(&hist2, 0, sizeof(hist2));
+        latency_hist_add(&hist2, v);
+        latency_hist_add(&hist2, 2 * v);  /* so v is not also the max */
+        unsigned long long p = latency_percentile(&hist2, 50.0);
+        if (p < v || p - v > v / 16) within = 0;
+        latency_hist_add(&hist, v);
+    }
+    ASSERT_EQ(within, 1, "bucket within 6.25% of the value");
+
+    /* A value past 2^LAT_MAX_EXP goes to the last bucket, capped at the max */
+    memset(&hist2, 0, sizeof(hist2));
+    latency_hist_add(&hist2, 1ULL << 50);
+    ASSERT_EQ(latency_percentile(&hist2, 99.0) == (1ULL << 50), 1, "overflow bucket");
+
+    /* p99 of 1000 samples 1..1000 */
+    memset(&hist2, 0, sizeof(hist2));
+    for (unsigned long long v = 1; v <= 1000; v++)
+        latency_hist_add(&hist2, v);
+    unsigned long long p99 = latency_percentile(&hist2, 99.0);
+    ASSERT_EQ(p99 >= 990 && p99 <= 990 + 990 / 16, 1, "p99 of 1..1000");
+    ASSERT_EQ((long)(hist2.sum_ns / hist2.total * 10), 5005, "mean");
+
+    unsigned long total = hist.total;
+    latency_hist_merge(&hist, &hist2);
+    ASSERT_EQ((long)hist.total, (long)total + 1000, "merge adds samples");
+    ASSERT_EQ((long)hist.min_ns, 1, "merge keeps the min");
+}
+
+static int traced[LAT_COUNT][2];
+
+static void tracer(LatencyApi api, int miss, unsigned long long start_ns,
+                   unsigned long long duration_ns, void *ctx)
+{
+    (void)start_ns;
+    (void)duration_ns;
+    (void)ctx;
+    traced[api][miss]++;
+}
+
+static void test_api_timing(void)
+{
+    printf("\n--- Timed API calls ---\n");
+    Location loc = DEFAULT_LOCATION;
+
+    latency_reset();
+    memset(traced, 0, sizeof(traced));
+    latency_set_tracer(tracer, NULL);
+
+    /* A day no earlier test has touched misses, the next one hits */
+    gregorian_to_hindu(1927, 8, 3, &loc);
+    gregorian_to_hindu(1927, 8, 4, &loc);
+    gregorian_to_solar(1927, 8, 3, &loc, SOLAR_CAL_BENGALI);
+    gregorian_to_solar(1927, 8, 4, &loc, SOLAR_CAL_BENGALI);
+    double jd = lunisolar_month_start(SHRAVANA, 1849, 0, LUNISOLAR_AMANTA, &loc);
+    lunisolar_month_start(SHRAVANA, 1849, 0, LUNISOLAR_AMANTA, &loc);
+    sunset_jd(jd, &loc);
+
+    latency_snapshot(&stats);
+    ASSERT_EQ(stats.h[LAT_GREGORIAN_TO_HINDU][LAT_MISS].total, expect(1), "hindu miss");
+    ASSERT_EQ(stats.h[LAT_GREGORIAN_TO_HINDU][LAT_HIT].total, expect(1), "hindu hit");
+    ASSERT_EQ(stats.h[LAT_GREGORIAN_TO_SOLAR][LAT_MISS].total, expect(1), "solar miss");
+    ASSERT_EQ(stats.h[LAT_GREGORIAN_TO_SOLAR][LAT_HIT].total, expect(1), "solar hit");
+    ASSERT_EQ(stats.h[LAT_LUNISOLAR_MONTH_START][LAT_MISS].total, expect(1), "month miss");
+    ASSERT_EQ(stats.h[LAT_LUNISOLAR_MONTH_START][LAT_HIT].total, expect(1), "month hit");
+    ASSERT_EQ(stats.h[LAT_SUNSET][LAT_HIT].total, 0, "sunset never hits");
+    ASSERT_EQ(stats.h[LAT_SUNSET][LAT_MISS].total, expect(1), "sunset");
+    ASSERT_EQ(stats.h[LAT_SUNRISE][LAT_MISS].total > 0, latency_enabled(), "nested sunrises");
+
+    const LatencyHistogram *miss = &stats.h[LAT_GREGORIAN_TO_HINDU][LAT_MISS];
+    const LatencyHistogram *hit = &stats.h[LAT_GREGORIAN_TO_HINDU][LAT_HIT];
+    ASSERT_EQ(miss->max_ns > hit->max_ns, latency_enabled(), "a miss is slower than a hit");
+
+    ASSERT_EQ(traced[LAT_GREGORIAN_TO_HINDU][LAT_HIT], expect(1), "tracer: hit");
+    ASSERT_EQ(traced[LAT_GREGORIAN_TO_HINDU][LAT_MISS], expect(1), "tracer: miss");
+    ASSERT_EQ(traced[LAT_SUNSET][LAT_MISS], expect(1), "tracer: sunset");
+    latency_set_tracer(NULL, NULL);
+    gregorian_to_hindu(1927, 8, 5, &loc);
+    ASSERT_EQ(traced[LAT_GREGORIAN_TO_HINDU][LAT_HIT], expect(1), "tracer removed");
+}
+
+static void *worker(void *arg)
+{
+    const Location *loc = arg;
+    astro_init(NULL);
+    for (int d = 1; d <= 5; d++)
+        gregorian_to_hindu(1975, 2, d, loc);
+    astro_close();
+    return NULL;
+}
+
+static void test_threads(void)
+{
+    printf("\n--- Threads merge their histograms ---\n");
+    Location loc = DEFAULT_LOCATION;
+    latency_reset();
+    gregorian_to_hindu(1975, 2, 1, &loc);
+
+    pthread_t tids[2];
+    for (int t = 0; t < 2; t++)
+        pthread_create(&tids[t], NULL, worker, &loc);
+    for (int t = 0; t < 2; t++)
+        pthread_join(tids[t], NULL);
+    latency_snapshot(&stats);
+    ASSERT_EQ(stats.h[LAT_GREGORIAN_TO_HINDU][LAT_HIT].total +
+              stats.h[LAT_GREGORIAN_TO_HINDU][LAT_MISS].total, expect(11),
+              "own plus merged calls");
+    ASSERT_EQ(stats.h[LAT_GREGORIAN_TO_HINDU][LAT_MISS].total, expect(3),
+              "each thread's first day misses");
+
+    latency_reset();
+    latency_snapshot(&stats);
+    ASSERT_EQ(stats.h[LAT_GREGORIAN_TO_HINDU][LAT_MISS].total, 0, "reset clears merged");
+}
+
+static void test_export(void)
+{
+    printf("\n--- Text and JSON export ---\n");
+    memset(&stats, 0, sizeof(stats));
+    for (unsigned long long v = 1; v <= 100; v++)
+        latency_hist_add(&stats.h[LAT_GREGORIAN_TO_SOLAR][LAT_HIT], v * 1000);
+    latency_hist_add(&stats.h[LAT_SUNRISE][LAT_MISS], 5000);
+
+    FILE *f = tmpfile();
+    ASSERT_EQ(f != NULL, 1, "tmpfile");
+    if (!f) return;
+    ASSERT_EQ(latency_write_text(f, &stats), 0, "write text");
+    rewind(f);
+    char line[256];
+    int lines = 0, solar_row = 0;
+    while (fgets(line, sizeof(line), f)) {
+        lines++;
+        if (strncmp(line, "gregorian_to_solar", 18) == 0 && strstr(line, " hit ") &&
+            strstr(line, " 100 "))
+            solar_row = 1;
+    }
+    fclose(f);
+    ASSERT_EQ(lines, 3, "header plus non-empty histograms");
+    ASSERT_EQ(solar_row, 1, "solar hit row");
+
+    f = fopen(TMP_PATH, "w");
+    ASSERT_EQ(f != NULL, 1, "open output");
+    if (!f) return;
+    ASSERT_EQ(latency_write_json(f, &stats), 0, "write json");
+    fclose(f);
+
+    f = fopen(TMP_PATH, "r");
+    char buf[8192];
+    size_t n = f ? fread(buf, 1, sizeof(buf) - 1, f) : 0;
+    if (f) fclose(f);
+    buf[n] = '\0';
+    ASSERT_EQ(strstr(buf, "\"api\": \"gregorian_to_solar\", \"outcome\": \"hit\", "
+                          "\"count\": 100") != NULL, 1, "solar object");
+    ASSERT_EQ(strstr(buf, "\"p50\": 50") != NULL, 1, "p50 in ns");
+    ASSERT_EQ(strstr(buf, "\"api\": \"sunrise\", \"outcome\": \"miss\"") != NULL, 1,
+              "sunrise object");
+    ASSERT_EQ(strstr(buf, "gregorian_to_hindu") == NULL, 1, "empty histograms left out");
+    int opens = 0, closes = 0;
+    for (char *p = buf; *p; p++) {
+        if (*p == '{' || *p == '[') opens++;
+        if (*p == '}' || *p == ']') closes++;
+    }
+    ASSERT_EQ(opens, closes, "balanced brackets");
+    remove(TMP_PATH);
+}
+
+int main(void)
+{
+    astro_init(NULL);
+
+    printf("Latency timing %s\n", latency_enabled() ? "enabled" : "disabled");
+    test_histogram();
+    test_api_timing();
+    test_threads();
+    test_export();
+
+    astro_close();
+
+    printf("\n=== Latency tests: %d/%d passed ===\n", tests_passed, tests_run);
+    return (tests_passed == tests_run) ? 0 : 1;
+}
@@ -2,6 +2,7 @@
 #include "tithi.h"
 #include "astro.h"
 #include "date_utils.h"
+#include "csvmap.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -231,8 +232,8 @@ static void test_roundtrip(void)
 static void test_csv_regression(void)
 {
     const char *csv_path = "validation/moshier/lunisolar_months.csv";
-    FILE *f = fopen(csv_path, "r");
-    if (!f) {
+    CsvFile csv;
+    if (!csv_open(&csv, csv_path)) {
         printf("\n--- CSV regression: %s not found, skipping ---\n", csv_path);
         return;
     }
@@ -241,16 +242,13 @@ static void test_csv_regression(void)
     Location delhi = DEFAULT_LOCATION;
     int saved_run = tests_run, saved_pass = tests_passed;
 
-    char line[256];
-    /* Skip header */
-    if (fgets(line, sizeof(line), f) == NULL) { fclose(f); return; }
-
-    while (fgets(line, sizeof(line), f)) {
-        int masa_num, is_adhika, saka_year, length, gy, gm, gd;
-        char masa_name[64];
-        if (sscanf(line, "%d,%d,%d,%d,%d,%d,%d,%63s",
-                   &masa_num, &is_adhika, &saka_year, &length,
-                   &gy, &gm, &gd, masa_name) < 7) {
+    while (csv_next(&csv)) {
+        int masa_num, is_adhika, saka_year, length, gy, gm, gd, name_len = 0;
+        const char *masa_name = csv_str(&csv, 7, &name_len);
+        if (!masa_name) masa_name = "";
+        if (!csv_int(&csv, 0, &masa_num) || !csv_int(&csv, 1, &is_adhika) ||
+            !csv_int(&csv, 2, &saka_year) || !csv_int(&csv, 3, &length) ||
+            !csv_int(&csv, 4, &gy) || !csv_int(&csv, 5, &gm) || !csv_int(&csv, 6, &gd)) {
             continue;
         }
 
@@ -263,13 +261,13 @@ static void test_csv_regression(void)
             if (ry == gy && rm == gm && rd == gd) {
                 tests_passed++;
             } else {
-                printf("  FAIL: %s%s %d: expected %04d-%02d-%02d, got %04d-%02d-%02d\n",
-                       is_adhika ? "Adhika " : "", masa_name, saka_year,
+                printf("  FAIL: %s%.*s %d: expected %04d-%02d-%02d, got %04d-%02d-%02d\n",
+                       is_adhika ? "Adhika " : "", name_len, masa_name, saka_year,
                        gy, gm, gd, ry, rm, rd);
             }
         } else {
-            printf("  FAIL: %s%s %d: not found\n",
-                   is_adhika ? "Adhika " : "", masa_name, saka_year);
+            printf("  FAIL: %s%.*s %d: not found\n",
+                   is_adhika ? "Adhika " : "", name_len, masa_name, saka_year);
         }
 
         /* Also verify length */
@@ -281,14 +279,14 @@ static void test_csv_regression(void)
             if (calc_len == length) {
                 tests_passed++;
             } else {
-                printf("  FAIL: %s%s %d length: expected %d, got %d\n",
-                       is_adhika ? "Adhika " : "", masa_name, saka_year,
+                printf("  FAIL: %s%.*s %d length: expected %d, got %d\n",
+                       is_adhika ? "Adhika " : "", name_len, masa_name, saka_year,
                        length, calc_len);
             }
         }
     }
 
-    fclose(f);
+    csv_close(&csv);
     printf("  CSV regression: %d/%d passed\n",
            tests_passed - saved_pass, tests_run - saved_run);
 }
@@ -0,0 +1,201 @@
+#include "muhurta.h"
+#include "astro.h"
+#include "date_utils.h"
+#include <stdio.h>
+#include <math.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define ASSERT_EQ(actual, expected, msg) do { \
+    tests_run++; \
+    int _a = (actual), _e = (expected); \
+    if (_a == _e) { \
+        tests_passed++; \
+    } else { \
+        printf("  FAIL: %s (got %d, expected %d)\n", msg, _a, _e); \
+    } \
+} while (0)
+
+#define ASSERT_NEAR(actual, expected, tolerance, msg) do { \
+    tests_run++; \
+    double _a = (actual), _e = (expected), _t = (tolerance); \
+    if (fabs(_a - _e) <= _t) { \
+        tests_passed++; \
+    } else { \
+        printf("  FAIL: %s (got %.8f, expected %.8f)\n", msg, _a, _e); \
+    } \
+} while (0)
+
+/* 1 millisecond in days */
+#define EPS (1e-3 / 86400.0)
+
+/*
+ * Weekday tables: the Rahu/Yamaganda/Gulika eighth for each weekday.
+ */
+static void test_weekday_segments(void)
+{
+    printf("\n--- Weekday segments (2025-01-06 .. 2025-01-12, Mon..Sun) ---\n");
+    Location delhi = DEFAULT_LOCATION;
+
+    static const int rahu[7] = { 2, 7, 5, 6, 4, 3, 8 };
+    static const int yama[7] = { 4, 3, 2, 1, 7, 6, 5 };
+    static const int gulika[7] = { 6, 5, 4, 3, 2, 1, 7 };
+    static const Choghadiya first_day[7] = {
+        CHOGHADIYA_AMRIT, CHOGHADIYA_ROG, CHOGHADIYA_LABH, CHOGHADIYA_SHUBH,
+        CHOGHADIYA_CHAR, CHOGHADIYA_KAAL, CHOGHADIYA_UDVEG
+    };
+    static const Choghadiya first_night[7] = {
+        CHOGHADIYA_CHAR, CHOGHADIYA_KAAL, CHOGHADIYA_UDVEG, CHOGHADIYA_AMRIT,
+        CHOGHADIYA_ROG, CHOGHADIYA_LABH, CHOGHADIYA_SHUBH
+    };
+
+    MuhurtaDay days[7];
+    generate_muhurta_range(2025, 1, 6, 7, &delhi, days);
+
+    for (int i = 0; i < 7; i++) {
+        const MuhurtaDay *md = &days[i];
+        double part = (md->jd_sunset - md->jd_sunrise) / 8.0;
+        char buf[128];
+
+        snprintf(buf, sizeof(buf), "2025-01-%02d weekday", md->greg_day);
+        ASSERT_EQ(md->weekday, i, buf);
+
+        snprintf(buf, sizeof(buf), "%s Rahu Kalam segment", day_of_week_short(i));
+        ASSERT_EQ((int)floor((md->rahu_kalam.jd_start - md->jd_sunrise) / part + 0.5) + 1,
+                  rahu[i], buf);
+        snprintf(buf, sizeof(buf), "%s Yamaganda segment", day_of_week_short(i));
+        ASSERT_EQ((int)floor((md->yamaganda.jd_start - md->jd_sunrise) / part + 0.5) + 1,
+                  yama[i], buf);
+        snprintf(buf, sizeof(buf), "%s Gulika segment", day_of_week_short(i));
+        ASSERT_EQ((int)floor((md->gulika_kalam.jd_start - md->jd_sunrise) / part + 0.5) + 1,
+                  gulika[i], buf);
+
+        snprintf(buf, sizeof(buf), "%s first day choghadiya", day_of_week_short(i));
+        ASSERT_EQ(md->day_choghadiya[0].name, first_day[i], buf);
+        snprintf(buf, sizeof(buf), "%s last day choghadiya = first", day_of_week_short(i));
+        ASSERT_EQ(md->day_choghadiya[7].name, first_day[i], buf);
+        snprintf(buf, sizeof(buf), "%s first night choghadiya", day_of_week_short(i));
+        ASSERT_EQ(md->night_choghadiya[0].name, first_night[i], buf);
+    }
+
+    /* Sunday day sequence: Udveg Char Labh Amrit Kaal Shubh Rog Udveg */
+    static const Choghadiya sunday_day[8] = {
+        CHOGHADIYA_UDVEG, CHOGHADIYA_CHAR, CHOGHADIYA_LABH, CHOGHADIYA_AMRIT,
+        CHOGHADIYA_KAAL, CHOGHADIYA_SHUBH, CHOGHADIYA_ROG, CHOGHADIYA_UDVEG
+    };
+    /* Sunday night: Shubh Amrit Char Rog Kaal Labh Udveg Shubh */
+    static const Choghadiya sunday_night[8] = {
+        CHOGHADIYA_SHUBH, CHOGHADIYA_AMRIT, CHOGHADIYA_CHAR, CHOGHADIYA_ROG,
+        CHOGHADIYA_KAAL, CHOGHADIYA_LABH, CHOGHADIYA_UDVEG, CHOGHADIYA_SHUBH
+    };
+    for (int i = 0; i < 8; i++) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "Sunday day slot %d = %s",
+                 i + 1, choghadiya_name(sunday_day[i]));
+        ASSERT_EQ(days[6].day_choghadiya[i].name, sunday_day[i], buf);
+        snprintf(buf, sizeof(buf), "Sunday night slot %d = %s",
+                 i + 1, choghadiya_name(sunday_night[i]));
+        ASSERT_EQ(days[6].night_choghadiya[i].name, sunday_night[i], buf);
+    }
+}
+
+/*
+ * Structural invariants over a full year, and agreement between the
+ * range API and the single-day API.
+ */
+static void test_year_invariants(void)
+{
+    printf("\n--- Invariants over 2025 (New Delhi) ---\n");
+    Location delhi = DEFAULT_LOCATION;
+    static MuhurtaDay days[365];
+    generate_muhurta_range(2025, 1, 1, 365, &delhi, days);
+
+    int saved_run = tests_run, saved_pass = tests_passed;
+    for (int i = 0; i < 365; i++) {
+        const MuhurtaDay *md = &days[i];
+        char buf[128];
+        snprintf(buf, sizeof(buf), "%04d-%02d-%02d",
+                 md->greg_year, md->greg_month, md->greg_day);
+
+        ASSERT_EQ(md->is_valid, 1, buf);
+
+        double jd = gregorian_to_jd(md->greg_year, md->greg_month, md->greg_day);
+        ASSERT_NEAR(md->jd_sunrise, sunrise_jd(jd, &delhi), EPS, buf);
+        ASSERT_NEAR(md->jd_sunset, sunset_jd(jd, &delhi), EPS, buf);
+        if (i + 1 < 365)
+            ASSERT_NEAR(md->jd_next_sunrise, days[i + 1].jd_sunrise, EPS, buf);
+
+        /* Choghadiyas tile the day and the night without gaps */
+        ASSERT_NEAR(md->day_choghadiya[0].window.jd_start, md->jd_sunrise, EPS, buf);
+        ASSERT_NEAR(md->day_choghadiya[7].window.jd_end, md->jd_sunset, EPS, buf);
+        ASSERT_NEAR(md->night_choghadiya[0].window.jd_start, md->jd_sunset, EPS, buf);
+        ASSERT_NEAR(md->night_choghadiya[7].window.jd_end, md->jd_next_sunrise, EPS, buf);
+        for (int k = 1; k < 8; k++) {
+            ASSERT_NEAR(md->day_choghadiya[k].window.jd_start,
+                        md->day_choghadiya[k - 1].window.jd_end, EPS, buf);
+            ASSERT_NEAR(md->night_choghadiya[k].window.jd_start,
+                        md->night_choghadiya[k - 1].window.jd_end, EPS, buf);
+        }
+
+        /* Abhijit straddles the midpoint of daytime */
+        double mid = (md->jd_sunrise + md->jd_sunset) / 2.0;
+        tests_run++;
+        if (md->abhijit.jd_start < mid && md->abhijit.jd_end > mid)
+            tests_passed++;
+        else
+            printf("  FAIL: %s Abhijit does not contain midday\n", buf);
+    }
+    printf("  %d/%d invariant checks passed\n",
+           tests_passed - saved_pass, tests_run - saved_run);
+
+    /* Single-day API agrees with the range */
+    MuhurtaDay one = muhurta_for_date(2025, 8, 15, &delhi);
+    const MuhurtaDay *r = &days[226];
+    ASSERT_EQ(r->greg_month * 100 + r->greg_day, 815, "range index 226 = Aug 15");
+    ASSERT_NEAR(one.rahu_kalam.jd_start, r->rahu_kalam.jd_start, EPS,
+                "single-day Rahu Kalam = range Rahu Kalam");
+    ASSERT_NEAR(one.night_choghadiya[7].window.jd_end,
+                r->night_choghadiya[7].window.jd_end, EPS,
+                "single-day last night choghadiya = range");
+}
+
+/*
+ * Precomputed rise/set: pure arithmetic, invalid input rejected.
+ */
+static void test_from_rise_set(void)
+{
+    printf("\n--- muhurta_from_rise_set ---\n");
+
+    /* 06:00 -> 18:00 -> 06:00 (12 h day, 12 h night), Monday */
+    MuhurtaDay md;
+    double sr = 2460000.25, ss = 2460000.75, nsr = 2460001.25;
+    muhurta_from_rise_set(sr, ss, nsr, 0, &md);
+    ASSERT_EQ(md.is_valid, 1, "12h day valid");
+    ASSERT_NEAR(md.rahu_kalam.jd_start, sr + 1.5 / 24.0, EPS,
+                "Monday Rahu Kalam 07:30");
+    ASSERT_NEAR(md.rahu_kalam.jd_end, sr + 3.0 / 24.0, EPS,
+                "Monday Rahu Kalam ends 09:00");
+    ASSERT_NEAR(md.abhijit.jd_start, sr + 7.0 * 12.0 / 15.0 / 24.0, EPS,
+                "Abhijit starts 11:36");
+    ASSERT_NEAR(md.abhijit.jd_end, sr + 8.0 * 12.0 / 15.0 / 24.0, EPS,
+                "Abhijit ends 12:24");
+
+    muhurta_from_rise_set(0.0, ss, nsr, 0, &md);
+    ASSERT_EQ(md.is_valid, 0, "missing sunrise is invalid");
+    ASSERT_NEAR(md.rahu_kalam.jd_start, 0.0, 0.0, "invalid day has zero windows");
+}
+
+int main(void)
+{
+    astro_init(NULL);
+
+    test_weekday_segments();
+    test_year_invariants();
+    test_from_rise_set();
+
+    astro_close();
+
+    printf("\n=== Muhurta tests: %d/%d passed ===\n", tests_passed, tests_run);
+    return (tests_passed == tests_run) ? 0 : 1;
+}
@@ -0,0 +1,80 @@
+#include "annotate.h"
+#include "tithi.h"
+#include "masa.h"
+#include "date_utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * Annotation benchmark: one million sorted timestamps across 2025
+ * (about one every 32 s) through annotate_moment(), against calling
+ * tithi_at_moment() + solar_rashi() per row, plus shuffled input.
+ */
+
+#define N_ROWS   1000000
+#define N_DIRECT 100000
+
+static double elapsed_sec(struct timespec *start, struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+int main(void)
+{
+    double jd0 = gregorian_to_jd(2025, 1, 1);
+    double *jds = malloc(N_ROWS * sizeof(double));
+    for (int i = 0; i < N_ROWS; i++)
+        jds[i] = jd0 + 365.0 * i / N_ROWS;
+
+    printf("=== Annotation Benchmark (2025, %d sorted rows) ===\n\n", N_ROWS);
+
+    struct timespec t0, t1;
+    long sum = 0;
+    Annotator an;
+    annotator_init(&an);
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < N_ROWS; i++) {
+        MomentAnnotation ma;
+        annotate_moment(&an, jds[i], &ma);
+        sum += ma.tithi + ma.rashi;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double t = elapsed_sec(&t0, &t1);
+    printf("%-18s: %7.3fs  (%7.3f us/row, %ld refreshes)\n",
+           "annotate_moment", t, t / N_ROWS * 1e6, an.refreshes);
+
+    /* Direct evaluation on a stride of the same rows */
+    int stride = N_ROWS / N_DIRECT;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < N_ROWS; i += stride)
+        sum += tithi_at_moment(jds[i]) + solar_rashi(jds[i]);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    t = elapsed_sec(&t0, &t1);
+    printf("%-18s: %7.3fs  (%7.3f us/row, %d-row sample)\n",
+           "Direct per row", t, t / N_DIRECT * 1e6, N_DIRECT);
+
+    /* Out of order: every row falls back to a fresh lookup */
+    srand(42);
+    for (int i = N_DIRECT - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        double tmp = jds[i * stride];
+        jds[i * stride] = jds[j * stride];
+        jds[j * stride] = tmp;
+    }
+    annotator_init(&an);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < N_ROWS; i += stride) {
+        MomentAnnotation ma;
+        annotate_moment(&an, jds[i], &ma);
+        sum += ma.tithi;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    t = elapsed_sec(&t0, &t1);
+    printf("%-18s: %7.3fs  (%7.3f us/row, %d-row sample)\n",
+           "Shuffled input", t, t / N_DIRECT * 1e6, N_DIRECT);
+
+    free(jds);
+    return (sum > 0) ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+#include "archive.h"
+#include "panchang.h"
+#include "astro.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * Panchang archive benchmark: ten years of New Delhi panchangs computed
+ * with generate_month_panchang(), packed, then read back from the mmap
+ * year by year, in random day order, and in random day order with the
+ * year cache defeated (a fresh year per lookup).
+ */
+
+#define Y0 2000
+#define Y1 2009
+#define N_LOOKUPS 1000000
+#define ARCHIVE_PATH "build/bench_archive.hcpa"
+
+static double elapsed_sec(struct timespec *start, struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+int main(void)
+{
+    Location loc = DEFAULT_LOCATION;
+    int n_cap = (Y1 - Y0 + 1) * 366, n = 0;
+    PanchangDay *days = malloc(n_cap * sizeof(PanchangDay));
+    static PanchangArchive archive;
+    static PanchangDay year[ARCHIVE_MAX_DAYS];
+    struct timespec t0, t1;
+    double t;
+
+    astro_init(NULL);
+    printf("=== Panchang Archive Benchmark (%d-%d, New Delhi) ===\n\n", Y0, Y1);
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int y = Y0; y <= Y1; y++) {
+        for (int m = 1; m <= 12; m++) {
+            int count;
+            generate_month_panchang(y, m, &loc, days + n, &count);
+            n += count;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    t = elapsed_sec(&t0, &t1);
+    printf("%-26s: %8.3fs  (%10.1f ns/day)\n", "generate_month_panchang", t, t / n * 1e9);
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    long size = archive_write(ARCHIVE_PATH, &loc, days, n, 1);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    t = elapsed_sec(&t0, &t1);
+    if (size < 0 || !archive_open(&archive, ARCHIVE_PATH)) {
+        printf("ERROR: cannot write or open %s\n", ARCHIVE_PATH);
+        return 1;
+    }
+    printf("%-26s: %8.3fs  (%10.1f ns/day)\n", "archive_write", t, t / n * 1e9);
+    printf("%-26s: %ld bytes (%.2f bytes/day, %zu in memory, %.1fx)\n\n", "Archive size",
+           size, (double)size / n, n * sizeof(PanchangDay),
+           (double)(n * sizeof(PanchangDay)) / size);
+
+    /* Sequential: whole years */
+    long decoded = 0, checksum = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int rep = 0; rep < 200; rep++) {
+        for (int y = Y0; y <= Y1; y++) {
+            int count = archive_get_year(&archive, y, year);
+            decoded += count;
+            checksum += year[count - 1].tithi.tithi_num;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    t = elapsed_sec(&t0, &t1);
+    printf("%-26s: %8.3fs  (%10.1f ns/day)\n", "archive_get_year", t, t / decoded * 1e9);
+
+    /* Random days, clustered by year (cache hits) */
+    srand(42);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int k = 0; k < N_LOOKUPS; k++) {
+        const PanchangDay *e = &days[rand() % 365];
+        PanchangDay pd;
+        archive_get_day(&archive, e->greg_year, e->greg_month, e->greg_day, &pd);
+        checksum += pd.tithi.tithi_num;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    t = elapsed_sec(&t0, &t1);
+    printf("%-26s: %8.3fs  (%10.1f ns/lookup)\n", "archive_get_day, same year", t,
+           t / N_LOOKUPS * 1e9);
+
+    /* Random days across all years (mostly cache misses) */
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int k = 0; k < N_LOOKUPS / 10; k++) {
+        const PanchangDay *e = &days[rand() % n];
+        PanchangDay pd;
+        archive_get_day(&archive, e->greg_year, e->greg_month, e->greg_day, &pd);
+        checksum += pd.tithi.tithi_num;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    t = elapsed_sec(&t0, &t1);
+    printf("%-26s: %8.3fs  (%10.1f ns/lookup)\n", "archive_get_day, any year", t,
+           t / (N_LOOKUPS / 10) * 1e9);
+
+    printf("\n(checksum %ld)\n", checksum);
+    archive_close(&archive);
+    remove(ARCHIVE_PATH);
+    free(days);
+    astro_close();
+    return 0;
+}
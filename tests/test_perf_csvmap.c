@@ -0,0 +1,101 @@
+#include "csvmap.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * CSV reader benchmark: every row of ref_1900_2050.csv into seven ints,
+ * with stdio line reads + sscanf (as the tests and tools used to) and
+ * with csvmap.  Each pass opens the file afresh; it stays in the page
+ * cache, so this measures parsing rather than disk reads.
+ */
+
+#define CSV_PATH "validation/moshier/ref_1900_2050.csv"
+#define PASSES 20
+
+static double elapsed_sec(struct timespec *start, struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static long pass_sscanf(long *sum)
+{
+    FILE *f = fopen(CSV_PATH, "r");
+    if (!f) return -1;
+    char line[256];
+    long rows = 0;
+    if (!fgets(line, sizeof(line), f)) line[0] = '\0';
+    while (fgets(line, sizeof(line), f)) {
+        int v[7];
+        if (sscanf(line, "%d,%d,%d,%d,%d,%d,%d", &v[0], &v[1], &v[2], &v[3], &v[4],
+                   &v[5], &v[6]) != 7)
+            continue;
+        for (int i = 0; i < 7; i++) *sum += v[i];
+        rows++;
+    }
+    fclose(f);
+    return rows;
+}
+
+static long pass_csvmap(long *sum)
+{
+    CsvFile c;
+    if (!csv_open(&c, CSV_PATH)) return -1;
+    long rows = 0;
+    while (csv_next(&c)) {
+        int v[7], ok = 1;
+        for (int i = 0; i < 7 && ok; i++) ok = csv_int(&c, i, &v[i]);
+        if (!ok) continue;
+        for (int i = 0; i < 7; i++) *sum += v[i];
+        rows++;
+    }
+    csv_close(&c);
+    return rows;
+}
+
+static long pass_csvmap_jd(long *sum)
+{
+    CsvFile c;
+    if (!csv_open(&c, CSV_PATH)) return -1;
+    int col_tithi = csv_column(&c, "tithi");
+    long rows = 0;
+    while (csv_next(&c)) {
+        double jd;
+        int tithi;
+        if (!csv_date_jd(&c, 0, 1, 2, &jd) || !csv_int(&c, col_tithi, &tithi)) continue;
+        *sum += (long)jd + tithi;
+        rows++;
+    }
+    csv_close(&c);
+    return rows;
+}
+
+static double run(const char *label, long (*pass)(long *), double base)
+{
+    struct timespec t0, t1;
+    long sum = 0, rows = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < PASSES; i++)
+        rows = pass(&sum);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double sec = elapsed_sec(&t0, &t1) / PASSES;
+    printf("%-26s: %7.2f ms/pass  %6.1f ns/row", label, sec * 1e3, sec / rows * 1e9);
+    if (base > 0) printf("  (%.1fx)", base / sec);
+    printf("\n");
+    return sec;
+}
+
+int main(void)
+{
+    long sum = 0, rows = pass_csvmap(&sum);
+    if (rows < 0) {
+        printf("ERROR: cannot open %s\n", CSV_PATH);
+        return 1;
+    }
+    printf("=== CSV Reader Benchmark (%s, %ld rows, %d passes) ===\n\n", CSV_PATH, rows, PASSES);
+
+    double base = run("fgets + sscanf", pass_sscanf, 0);
+    run("csvmap, 7 ints", pass_csvmap, base);
+    run("csvmap, date JD + tithi", pass_csvmap_jd, base);
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include "events.h"
+#include "tithi.h"
+#include "date_utils.h"
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * Event query benchmark: monotonic next_event() iteration over
+ * 1900-2050, random-access queries, and the per-day tithi_at_sunrise()
+ * reconstruction callers use today to find tithi ends.
+ */
+
+static double elapsed_sec(struct timespec *start, struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+typedef struct {
+    const char *name;
+    unsigned mask;
+} BenchEntry;
+
+int main(void)
+{
+    Location loc = DEFAULT_LOCATION;
+    double jd_from = gregorian_to_jd(1900, 1, 1);
+    double jd_to = gregorian_to_jd(2051, 1, 1);
+    int ndays = (int)(jd_to - jd_from);
+
+    BenchEntry entries[] = {
+        {"Tithi",           EVENT_TITHI},
+        {"Nakshatra",       EVENT_NAKSHATRA},
+        {"Sankranti",       EVENT_SANKRANTI},
+        {"New+full moon",   EVENT_NEW_MOON | EVENT_FULL_MOON},
+        {"Sunrise",         EVENT_SUNRISE},
+        {"All kinds",       EVENT_ALL},
+    };
+    int n_entries = (int)(sizeof(entries) / sizeof(entries[0]));
+
+    printf("=== Event Query Benchmark (1900-2050, %d days) ===\n\n", ndays);
+
+    for (int e = 0; e < n_entries; e++) {
+        EventCursor cur;
+        event_cursor_init(&cur, &loc);
+        struct timespec t0, t1;
+        AstroEvent ev;
+        long count = 0;
+        double jd = jd_from;
+
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        while (next_event(&cur, jd, entries[e].mask, &ev) && ev.jd < jd_to) {
+            jd = ev.jd;
+            count++;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+
+        double t = elapsed_sec(&t0, &t1);
+        printf("%-16s: %7ld events in %6.3fs  (%5.2f us/event)\n",
+               entries[e].name, count, t, t / count * 1e6);
+    }
+
+    /* Monotonic "when does the current tithi end" at every sunrise-ish
+     * instant, against tithi_at_sunrise() per day */
+    EventCursor cur;
+    event_cursor_init(&cur, &loc);
+    struct timespec t0, t1;
+    AstroEvent ev;
+    double sum = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < ndays; i++) {
+        next_event(&cur, jd_from + i + 0.05, EVENT_TITHI, &ev);
+        sum += ev.jd;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double t = elapsed_sec(&t0, &t1);
+    printf("\n%-16s: %7d queries in %6.3fs  (%5.2f us/query)\n",
+           "Tithi end/day", ndays, t, t / ndays * 1e6);
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < ndays; i++) {
+        int y, m, d;
+        jd_to_gregorian(jd_from + i, &y, &m, &d);
+        TithiInfo ti = tithi_at_sunrise(y, m, d, &loc);
+        sum += ti.jd_end;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    t = elapsed_sec(&t0, &t1);
+    printf("%-16s: %7d queries in %6.3fs  (%5.2f us/query)  (tithi_at_sunrise)\n",
+           "Tithi end/day", ndays, t, t / ndays * 1e6);
+
+    /* Random access: every query rebuilds the bracket */
+    unsigned seed = 12345;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < 20000; i++) {
+        seed = seed * 1103515245u + 12345u;
+        double jd = jd_from + (seed >> 8) % ndays;
+        next_event(&cur, jd, EVENT_TITHI, &ev);
+        sum += ev.jd;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    t = elapsed_sec(&t0, &t1);
+    printf("%-16s: %7d queries in %6.3fs  (%5.2f us/query)\n",
+           "Tithi random", 20000, t, t / 20000 * 1e6);
+
+    return (sum > 0) ? 0 : 1;
+}
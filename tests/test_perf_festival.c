@@ -0,0 +1,80 @@
+#include "festival.h"
+#include "panchang.h"
+#include "date_utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * Festival search benchmark: 150-year queries with find_tithi_dates() /
+ * find_sankranti_dates(), against the day-by-day gregorian_to_hindu()
+ * scan they replace.
+ */
+
+static double elapsed_sec(struct timespec *start, struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+typedef struct {
+    const char *name;
+    TithiQuery q;
+} QueryEntry;
+
+int main(void)
+{
+    Location loc = DEFAULT_LOCATION;
+    double jd_from = gregorian_to_jd(1900, 1, 1);
+    double jd_to = gregorian_to_jd(2050, 12, 31);
+    int ndays = (int)(jd_to - jd_from) + 1;
+
+    QueryEntry entries[] = {
+        {"Ekadashi",        { 0, -1, -1, 11 }},
+        {"Amavasya",        { 0, -1, KRISHNA_PAKSHA, 15 }},
+        {"Kartika Purnima", { KARTIKA, 0, SHUKLA_PAKSHA, 15 }},
+        {"Every tithi",     { 0, -1, -1, 0 }},
+    };
+    int n_entries = (int)(sizeof(entries) / sizeof(entries[0]));
+
+    printf("=== Festival Search Benchmark (1900-2050, %d days) ===\n\n", ndays);
+
+    TithiOccurrence *occ = malloc(60000 * sizeof(TithiOccurrence));
+    for (int e = 0; e < n_entries; e++) {
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        int n = find_tithi_dates(&entries[e].q, jd_from, jd_to, &loc, occ, 60000);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        printf("%-16s : %6d dates in %7.3fs\n", entries[e].name, n,
+               elapsed_sec(&t0, &t1));
+    }
+    free(occ);
+
+    SankrantiOccurrence sank[2000];
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    int ns = find_sankranti_dates(SOLAR_CAL_TAMIL, 0, jd_from, jd_to, &loc, sank, 2000);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    printf("%-16s : %6d dates in %7.3fs\n", "Tamil sankranti", ns,
+           elapsed_sec(&t0, &t1));
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    ns = find_sankranti_dates(SOLAR_CAL_TAMIL, 10, jd_from, jd_to, &loc, sank, 2000);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    printf("%-16s : %6d dates in %7.3fs\n", "Makara sankranti", ns,
+           elapsed_sec(&t0, &t1));
+
+    /* Baseline: scan every day and filter for Ekadashi */
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    int found = 0;
+    for (double jd = jd_from; jd <= jd_to; jd += 1.0) {
+        int y, m, d;
+        jd_to_gregorian(jd, &y, &m, &d);
+        HinduDate hd = gregorian_to_hindu(y, m, d, &loc);
+        if (hd.tithi == 11 && !hd.is_adhika_tithi) found++;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    printf("\n%-16s : %6d dates in %7.3fs  (day-by-day scan)\n", "Ekadashi",
+           found, elapsed_sec(&t0, &t1));
+
+    return 0;
+}
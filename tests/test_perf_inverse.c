@@ -0,0 +1,105 @@
+#include "panchang.h"
+#include "date_utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * hindu_to_gregorian() throughput: every day of 1900-2050 converted to a
+ * HinduDate and back, in calendar order and shuffled, against the
+ * day-by-day gregorian_to_hindu() scan callers otherwise use.
+ */
+
+#define SCAN_SAMPLE 2000
+
+static double elapsed_sec(struct timespec *start, struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/* Fisher-Yates shuffle */
+static void shuffle(HinduDate *arr, int n, unsigned seed)
+{
+    srand(seed);
+    for (int i = n - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        HinduDate tmp = arr[i];
+        arr[i] = arr[j];
+        arr[j] = tmp;
+    }
+}
+
+static int same_date(const HinduDate *a, const HinduDate *b)
+{
+    return a->year_saka == b->year_saka && a->masa == b->masa &&
+           a->is_adhika_masa == b->is_adhika_masa && a->paksha == b->paksha &&
+           a->tithi == b->tithi && a->is_adhika_tithi == b->is_adhika_tithi;
+}
+
+static double run_inverse(const HinduDate *dates, int n, const Location *loc)
+{
+    struct timespec t0, t1;
+    int y, m, d, misses = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < n; i++) {
+        if (hindu_to_gregorian(&dates[i], LUNISOLAR_AMANTA, loc, &y, &m, &d) ==
+            HINDU_MATCH_NONE)
+            misses++;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    if (misses)
+        printf("  WARNING: %d dates not found\n", misses);
+    return elapsed_sec(&t0, &t1);
+}
+
+int main(void)
+{
+    Location loc = DEFAULT_LOCATION;
+    double jd_from = gregorian_to_jd(1900, 1, 1);
+    double jd_to = gregorian_to_jd(2050, 12, 31);
+    int n = (int)(jd_to - jd_from) + 1;
+
+    HinduDate *dates = malloc(n * sizeof(HinduDate));
+    for (int i = 0; i < n; i++) {
+        int y, m, d;
+        jd_to_gregorian(jd_from + i, &y, &m, &d);
+        dates[i] = gregorian_to_hindu(y, m, d, &loc);
+    }
+
+    printf("=== Hindu -> Gregorian Benchmark (1900-2050, %d dates) ===\n\n", n);
+
+    double t = run_inverse(dates, n, &loc);
+    printf("%-18s: %7.3fs  (%6.1f us/call, %8.0f calls/sec)\n",
+           "Sequential", t, t / n * 1e6, n / t);
+
+    shuffle(dates, n, 42);
+    t = run_inverse(dates, n, &loc);
+    printf("%-18s: %7.3fs  (%6.1f us/call, %8.0f calls/sec)\n",
+           "Random order", t, t / n * 1e6, n / t);
+
+    /* Baseline: scan forward from ~45 days before the month's Gregorian
+     * estimate until gregorian_to_hindu() matches */
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < SCAN_SAMPLE; i++) {
+        const HinduDate *hd = &dates[i];
+        int gm = (int)hd->masa + 3, gy = hd->year_saka + 78;
+        if (gm > 12) { gm -= 12; gy++; }
+        double jd = gregorian_to_jd(gy, gm, 1) - 45.0;
+        for (int k = 0; k < 120; k++, jd += 1.0) {
+            int y, m, d;
+            jd_to_gregorian(jd, &y, &m, &d);
+            HinduDate got = gregorian_to_hindu(y, m, d, &loc);
+            if (same_date(&got, hd)) break;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    t = elapsed_sec(&t0, &t1);
+    printf("%-18s: %7.3fs  (%6.1f us/call, %d-date sample)\n",
+           "Day-by-day scan", t, t / SCAN_SAMPLE * 1e6, SCAN_SAMPLE);
+
+    free(dates);
+    return 0;
+}
@@ -0,0 +1,136 @@
+/*
+ * test_perf_latency.c - Latency percentiles of the public API, by cache
+ * hit and miss
+ *
+ * Runs three workloads with the latency histograms (latency.h) compiled
+ * in: ten years of consecutive days in the lunisolar and four solar
+ * calendars, random days over 1900-2050, and every lunisolar month
+ * start of 1900-2050, each asked twice (computed, then from the LRU).
+ * Prints count/min/p50/p90/p99/p99.9/max/mean per API and outcome,
+ * writes them as JSON with -o, and with -T writes one CSV line per timed
+ * call from the tracer hook.
+ *
+ *   make bench-latency     (builds this in build/latency with USE_LATENCY)
+ *   test_perf_latency [-o RESULTS.json] [-T TRACE.csv]
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "astro.h"
+#include "masa.h"
+#include "solar.h"
+#include "panchang.h"
+#include "date_utils.h"
+#include "latency.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RANDOM_DAYS 5000
+
+static const double JD_1900 = 2415020.5;   /* 1900-01-01 0h UT */
+static const double SPAN_DAYS = 55152.0;   /* 1900-01-01 .. 2050-12-31 */
+
+static LatencyStats stats;
+
+static void trace_csv(LatencyApi api, int miss, unsigned long long start_ns,
+                      unsigned long long duration_ns, void *ctx)
+{
+    fprintf(ctx, "%s,%s,%llu,%llu\n", latency_api_name(api),
+            miss ? "miss" : "hit", start_ns, duration_ns);
+}
+
+static void convert_day(double jd, const Location *loc)
+{
+    int y, m, d;
+    jd_to_gregorian(jd, &y, &m, &d);
+    gregorian_to_hindu(y, m, d, loc);
+    for (int t = SOLAR_CAL_TAMIL; t <= SOLAR_CAL_MALAYALAM; t++)
+        gregorian_to_solar(y, m, d, loc, (SolarCalendarType)t);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *out_path = NULL, *trace_path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (strcmp(argv[i], "-T") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else {
+            fprintf(stderr, "Usage: %s [-o RESULTS.json] [-T TRACE.csv]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (!latency_enabled()) {
+        fprintf(stderr, "ERROR: latency timing not compiled in; run make bench-latency\n");
+        return 1;
+    }
+
+    FILE *trace = NULL;
+    if (trace_path) {
+        trace = fopen(trace_path, "w");
+        if (!trace) {
+            fprintf(stderr, "ERROR: cannot write %s\n", trace_path);
+            return 1;
+        }
+        fprintf(trace, "api,outcome,start_ns,duration_ns\n");
+        latency_set_tracer(trace_csv, trace);
+    }
+
+    astro_init(NULL);
+    Location loc = DEFAULT_LOCATION;
+
+    /* Clock overhead, paid twice per timed call */
+    unsigned long long t0 = latency_now_ns();
+    for (int i = 0; i < 1000000; i++)
+        latency_now_ns();
+    double clock_ns = (latency_now_ns() - t0) / 1e6;
+
+    double jd0 = gregorian_to_jd(2000, 1, 1), jd1 = gregorian_to_jd(2010, 1, 1);
+    for (double jd = jd0; jd < jd1; jd += 1.0)
+        convert_day(jd, &loc);
+
+    unsigned lcg = 12345;
+    for (int i = 0; i < RANDOM_DAYS; i++) {
+        lcg = lcg * 1103515245u + 12345u;
+        convert_day(JD_1900 + (lcg >> 8) % (unsigned)SPAN_DAYS, &loc);
+    }
+
+    for (int saka = 1822; saka <= 1972; saka++)
+        for (int masa = CHAITRA; masa <= PHALGUNA; masa++)
+            for (int pass = 0; pass < 2; pass++)
+                lunisolar_month_start((MasaName)masa, saka, 0, LUNISOLAR_AMANTA, &loc);
+
+    astro_close();
+    latency_snapshot(&stats);
+
+    printf("Latency by API and cache outcome (%s backend, %.0f ns per clock read)\n\n",
+#ifdef USE_SWISSEPH
+           "se",
+#else
+           "moshier",
+#endif
+           clock_ns);
+    latency_write_text(stdout, &stats);
+
+    int rc = 0;
+    if (out_path) {
+        FILE *f = fopen(out_path, "w");
+        if (!f || latency_write_json(f, &stats) != 0 || fclose(f) != 0) {
+            fprintf(stderr, "ERROR: cannot write %s\n", out_path);
+            rc = 1;
+        } else {
+            printf("\nResults: %s\n", out_path);
+        }
+    }
+    if (trace) {
+        latency_set_tracer(NULL, NULL);
+        if (fclose(trace) != 0) {
+            fprintf(stderr, "ERROR: cannot write %s\n", trace_path);
+            rc = 1;
+        } else {
+            printf("Trace: %s\n", trace_path);
+        }
+    }
+    return rc;
+}
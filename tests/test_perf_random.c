@@ -1,6 +1,7 @@
 #include "panchang.h"
 #include "solar.h"
 #include "date_utils.h"
+#include "cache.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
@@ -40,33 +41,9 @@ typedef struct {
     SolarCalendarType solar_type;
 } BenchEntry;
 
-int main(void)
+/* Convert every date in every calendar; returns the total time */
+static double run_pass(const DateEntry *dates, int n, const Location *loc)
 {
-    Location loc = DEFAULT_LOCATION;
-
-    /* Build date array */
-    int capacity = 55200;
-    DateEntry *dates = malloc(capacity * sizeof(DateEntry));
-    int n = 0;
-
-    for (int y = 1900; y <= 2050; y++) {
-        for (int m = 1; m <= 12; m++) {
-            int dim = days_in_month(y, m);
-            for (int d = 1; d <= dim; d++) {
-                if (n >= capacity) {
-                    capacity *= 2;
-                    dates = realloc(dates, capacity * sizeof(DateEntry));
-                }
-                dates[n++] = (DateEntry){y, m, d};
-            }
-        }
-    }
-
-    printf("=== Performance Benchmark (RANDOM order, %d days) ===\n\n", n);
-
-    /* Shuffle with fixed seed for reproducibility */
-    shuffle(dates, n, 42);
-
     BenchEntry entries[] = {
         {"Lunisolar", 0, 0},
         {"Tamil",     1, SOLAR_CAL_TAMIL},
@@ -78,6 +55,7 @@ int main(void)
 
     double total_time = 0.0;
     long total_calls = 0;
+    cache_stats_reset();
 
     for (int e = 0; e < n_entries; e++) {
         struct timespec t0, t1;
@@ -87,10 +65,10 @@ int main(void)
         for (int i = 0; i < n; i++) {
             if (entries[e].is_solar) {
                 gregorian_to_solar(dates[i].year, dates[i].month, dates[i].day,
-                                   &loc, entries[e].solar_type);
+                                   loc, entries[e].solar_type);
             } else {
                 gregorian_to_hindu(dates[i].year, dates[i].month, dates[i].day,
-                                   &loc);
+                                   loc);
             }
         }
 
@@ -105,7 +83,55 @@ int main(void)
         total_calls += n;
     }
 
-    printf("%-10s : %6ld calls in %7.3fs\n", "Total", total_calls, total_time);
+    printf("%-10s : %6ld calls in %7.3fs\n\n", "Total", total_calls, total_time);
+
+    CacheStats stats[CACHE_COUNT];
+    cache_stats(stats);
+    cache_print_stats(stdout, stats);
+    return total_time;
+}
+
+int main(void)
+{
+    Location loc = DEFAULT_LOCATION;
+
+    /* Build date array */
+    int capacity = 55200;
+    DateEntry *dates = malloc(capacity * sizeof(DateEntry));
+    int n = 0;
+
+    for (int y = 1900; y <= 2050; y++) {
+        for (int m = 1; m <= 12; m++) {
+            int dim = days_in_month(y, m);
+            for (int d = 1; d <= dim; d++) {
+                if (n >= capacity) {
+                    capacity *= 2;
+                    dates = realloc(dates, capacity * sizeof(DateEntry));
+                }
+                dates[n++] = (DateEntry){y, m, d};
+            }
+        }
+    }
+
+    printf("=== Performance Benchmark (RANDOM order, %d days) ===\n\n", n);
+
+    /* Shuffle with fixed seed for reproducibility */
+    shuffle(dates, n, 42);
+
+    printf("--- Default cache capacities ---\n");
+    double t_default = run_pass(dates, n, &loc);
+
+    /* Room for every lunation, year start, solar month and day of the
+     * range, so each is computed once (see cache.h) */
+    cache_set_capacity(CACHE_LUNATION, 2048);
+    cache_set_capacity(CACHE_SOLAR_YEAR, 1024);
+    cache_set_capacity(CACHE_SANKRANTI, 8192);
+    cache_set_capacity(CACHE_PREV_DAY, 65536);
+
+    printf("\n--- Capacities for the whole range ---\n");
+    double t_tuned = run_pass(dates, n, &loc);
+
+    printf("\nSpeedup from cache capacities: %.2fx\n", t_default / t_tuned);
 
     free(dates);
     return 0;
@@ -0,0 +1,126 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "shmcache.h"
+#include "panchang.h"
+#include "solar.h"
+#include "astro.h"
+#include "date_utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+ * Shared-memory cache benchmark: N_PROCS processes each look up the
+ * same popular (city, date) set -- lunisolar and Tamil dates for 20
+ * cities over 90 days -- in their own random order, first without the
+ * cache and then attached to one segment.  Then the cost of a single
+ * hit against an uncached call.
+ */
+
+#define N_PROCS 4
+#define N_CITIES 20
+#define N_DAYS 90
+#define SEG_NAME "/hc-bench-shmcache"
+
+static double elapsed_sec(struct timespec *start, struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static Location city(int c)
+{
+    Location loc = { 8.0 + c * 1.25, 70.0 + c * 1.5, 0.0, 5.5 };
+    return loc;
+}
+
+/* One process's pass over the popular set, in shuffled order */
+static void run_worker(unsigned seed)
+{
+    static int order[N_CITIES * N_DAYS];
+    int n = N_CITIES * N_DAYS;
+    for (int i = 0; i < n; i++) order[i] = i;
+    srand(seed);
+    for (int i = n - 1; i > 0; i--) {
+        int j = rand() % (i + 1), tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+    double jd0 = gregorian_to_jd(2025, 1, 1);
+    volatile int sink = 0;
+    for (int k = 0; k < n; k++) {
+        Location loc = city(order[k] / N_DAYS);
+        int y, m, d;
+        jd_to_gregorian(jd0 + order[k] % N_DAYS, &y, &m, &d);
+        sink += gregorian_to_hindu(y, m, d, &loc).tithi;
+        sink += gregorian_to_solar(y, m, d, &loc, SOLAR_CAL_TAMIL).day;
+    }
+    (void)sink;
+}
+
+/* Wall time for N_PROCS forked workers */
+static double run_fleet(int use_cache)
+{
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int p = 0; p < N_PROCS; p++) {
+        if (fork() == 0) {
+            if (use_cache && shmcache_open(SEG_NAME, 0) != 0) _exit(1);
+            run_worker(1000u + (unsigned)p);
+            _exit(0);
+        }
+    }
+    int failed = 0;
+    for (int p = 0; p < N_PROCS; p++) {
+        int status;
+        wait(&status);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) failed = 1;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    return failed ? -1 : elapsed_sec(&t0, &t1);
+}
+
+int main(void)
+{
+    astro_init(NULL);
+    printf("=== Shared Cache Benchmark (%d processes x %d cities x %d days) ===\n\n",
+           N_PROCS, N_CITIES, N_DAYS);
+    long lookups = (long)N_PROCS * N_CITIES * N_DAYS * 2;
+
+    double t_plain = run_fleet(0);
+    printf("%-26s: %8.3fs  (%8.2f us/lookup)\n", "Uncached", t_plain, t_plain / lookups * 1e6);
+
+    shmcache_unlink(SEG_NAME);
+    double t_shared = run_fleet(1);
+    if (t_plain < 0 || t_shared < 0 || shmcache_open(SEG_NAME, 0) != 0) {
+        printf("ERROR: a worker failed\n");
+        return 1;
+    }
+    ShmCacheStats st;
+    shmcache_stats(&st);
+    printf("%-26s: %8.3fs  (%8.2f us/lookup, %.1fx)\n", "Shared cache", t_shared,
+           t_shared / lookups * 1e6, t_plain / t_shared);
+    printf("%-26s: %lu hits, %lu misses, %lu contended\n\n", "Counters",
+           st.hits, st.misses, st.contended);
+
+    /* Single-call cost: every lookup now hits */
+    struct timespec t0, t1;
+    int reps = 5;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int r = 0; r < reps; r++) run_worker(77u + (unsigned)r);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double t_hit = elapsed_sec(&t0, &t1) / (reps * N_CITIES * N_DAYS * 2);
+    shmcache_close();
+    shmcache_unlink(SEG_NAME);
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    run_worker(77u);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double t_miss = elapsed_sec(&t0, &t1) / (N_CITIES * N_DAYS * 2);
+    printf("%-26s: %8.1f ns\n", "Hit", t_hit * 1e9);
+    printf("%-26s: %8.1f ns  (%.0fx)\n", "Uncached call", t_miss * 1e9, t_miss / t_hit);
+
+    astro_close();
+    return 0;
+}
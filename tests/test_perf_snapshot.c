@@ -0,0 +1,120 @@
+#include "snapshot.h"
+#include "panchang.h"
+#include "solar.h"
+#include "astro.h"
+#include "date_utils.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * Warm-start benchmark: random days 1900-2050 at New Delhi, as a freshly
+ * started service would see them.  Each pass runs on a new thread, so
+ * the per-thread caches start empty: cold (store off), while filling the
+ * store, and after snapshot_save() / snapshot_disable() / snapshot_load()
+ * as a restarted process would.
+ */
+
+#define N_QUERIES 3000
+#define SNAP_PATH "build/bench_snapshot.hcs"
+
+static double query_jd[N_QUERIES];
+
+static double elapsed_sec(struct timespec *start, struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+typedef struct {
+    double hindu, solar;  /* seconds */
+} PassTime;
+
+static void *pass_thread(void *arg)
+{
+    PassTime *pt = arg;
+    Location loc = DEFAULT_LOCATION;
+    struct timespec t0, t1;
+    volatile int sink = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < N_QUERIES; i++) {
+        int y, m, d;
+        jd_to_gregorian(query_jd[i], &y, &m, &d);
+        sink += gregorian_to_hindu(y, m, d, &loc).tithi;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    pt->hindu = elapsed_sec(&t0, &t1);
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < N_QUERIES; i++) {
+        int y, m, d;
+        jd_to_gregorian(query_jd[i], &y, &m, &d);
+        sink += gregorian_to_solar(y, m, d, &loc, SOLAR_CAL_TAMIL).day;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    pt->solar = elapsed_sec(&t0, &t1);
+    (void)sink;
+    return NULL;
+}
+
+static void run_pass(const char *label)
+{
+    PassTime pt;
+    pthread_t tid;
+    pthread_create(&tid, NULL, pass_thread, &pt);
+    pthread_join(tid, NULL);
+    printf("%-26s: %8.1f us/day lunisolar  %8.1f us/day Tamil\n", label,
+           pt.hindu / N_QUERIES * 1e6, pt.solar / N_QUERIES * 1e6);
+}
+
+int main(void)
+{
+    astro_init(NULL);
+    printf("=== Warm-Start Snapshot Benchmark (%d random days 1900-2050) ===\n\n", N_QUERIES);
+
+    srand(42);
+    double jd0 = gregorian_to_jd(1900, 1, 1);
+    int span = (int)(gregorian_to_jd(2051, 1, 1) - jd0);
+    for (int i = 0; i < N_QUERIES; i++)
+        query_jd[i] = jd0 + rand() % span;
+
+    run_pass("Cold, store off");
+    snapshot_enable();
+    run_pass("Cold, filling store");
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    long records = snapshot_save(SNAP_PATH);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    SnapshotStats st;
+    snapshot_stats(&st);
+    FILE *f = fopen(SNAP_PATH, "rb");
+    long size = 0;
+    if (f) {
+        fseek(f, 0, SEEK_END);
+        size = ftell(f);
+        fclose(f);
+    }
+    printf("%-26s: %ld records (%ld lunations, %ld sankrantis, %ld month starts,\n"
+           "%-26s  %ld sunrises), %ld bytes, %.2f ms\n", "snapshot_save", records,
+           st.lunations, st.sankrantis, st.month_starts, "", st.sunrises, size,
+           elapsed_sec(&t0, &t1) * 1e3);
+
+    snapshot_disable();
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    if (snapshot_load(SNAP_PATH) != records) {
+        printf("ERROR: cannot reload %s\n", SNAP_PATH);
+        return 1;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    printf("%-26s: %.2f ms\n\n", "snapshot_load", elapsed_sec(&t0, &t1) * 1e3);
+
+    run_pass("Warm start");
+    snapshot_stats(&st);
+    printf("%-26s: %ld hits, %ld misses\n", "Store", st.hits, st.misses);
+
+    remove(SNAP_PATH);
+    astro_close();
+    return 0;
+}
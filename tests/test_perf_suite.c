@@ -0,0 +1,448 @@
+/*
+ * test_perf_suite.c - Layered benchmarks with JSON results and baselines
+ *
+ * Times each layer of the library on its own (ephemeris calls, the root
+ * finders built on them, month-start searches) and the end-to-end
+ * conversions over several workloads.  Inputs walk 1900-2050 in a fixed
+ * order, so the library's caches behave as in a real scan; every
+ * benchmark gets one untimed warmup pass and then -r timed repetitions.
+ * -f keeps the benchmarks whose name contains SUBSTRING or whose layer
+ * is SUBSTRING.
+ *
+ *   test_perf_suite [-r REPS] [-f SUBSTRING] [-o RESULTS.json]
+ *                   [-c BASELINE.json [-t PERCENT]]
+ *
+ * Each round of repetitions also times a fixed floating-point loop, and
+ * every benchmark is reported relative to it as well as in ns/op.  On a
+ * shared or frequency-scaling machine, whole seconds can run 40% slow;
+ * the ratio cancels that, the raw time does not.
+ *
+ * -c compares each benchmark's best and median ratios (repetition
+ * against its round's calibration) with the baseline's and exits with
+ * status 1 if any benchmark is more than -t percent (default 30) slower
+ * on both.  Unchanged code still moves about 20% between runs on a busy
+ * machine, so a smaller threshold flags noise.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "astro.h"
+#include "tithi.h"
+#include "masa.h"
+#include "solar.h"
+#include "panchang.h"
+#include "date_utils.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef USE_SWISSEPH
+#define BACKEND_NAME "se"
+#else
+#define BACKEND_NAME "moshier"
+#endif
+
+#define MAX_BENCH 32
+#define TITHI_INPUTS 500    /* ops of the benchmarks that need tithi_at[] */
+
+static double elapsed_sec(struct timespec *start, struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/* ---- Inputs ---- */
+
+static const double JD_1900 = 2415020.5;   /* 1900-01-01 0h UT */
+static const double SPAN_DAYS = 55152.0;   /* 1900-01-01 .. 2050-12-31 */
+
+static Location delhi = DEFAULT_LOCATION;
+static Location reykjavik = { 64.1466, -21.9426, 0.0, 0.0 };
+static Location locations[4] = {
+    DEFAULT_LOCATION,
+    { 23.1765, 75.7885, 0.0, 5.5 },    /* Ujjain */
+    { 40.7128, -74.0060, 0.0, -5.0 },  /* New York */
+    { 34.0522, -118.2437, 0.0, -8.0 }, /* Los Angeles */
+};
+
+/* Instant i of n spread over 1900-2050, off the 0h grid */
+static double spread_jd(int i, int n)
+{
+    return JD_1900 + 0.37 + (SPAN_DAYS - 1.0) * i / n;
+}
+
+/* Precomputed per-input values, so setup is not timed */
+static int tithi_at[TITHI_INPUTS];   /* tithi at spread_jd(i, TITHI_INPUTS) */
+static int *random_day;      /* shuffled day offsets from 1900-01-01 */
+
+/* ---- Benchmarks: each returns a value folded into a sink ---- */
+
+typedef double (*BenchFn)(int i, int n);
+
+static double b_solar_longitude(int i, int n) { return solar_longitude(spread_jd(i, n)); }
+static double b_lunar_longitude(int i, int n) { return lunar_longitude(spread_jd(i, n)); }
+static double b_ayanamsa(int i, int n)        { return get_ayanamsa(spread_jd(i, n)); }
+
+static double b_sunrise(int i, int n)
+{
+    (void)n;
+    return sunrise_jd(JD_1900 + i, &delhi);
+}
+
+static double b_find_tithi_boundary(int i, int n)
+{
+    /* The next tithi starts within 27 h */
+    double jd = spread_jd(i, n);
+    return find_tithi_boundary(jd, jd + 1.15, tithi_at[i] % 30 + 1);
+}
+
+static double b_new_moon_before(int i, int n)
+{
+    return new_moon_before(spread_jd(i, n), tithi_at[i]);
+}
+
+static double b_sankranti_jd(int i, int n)
+{
+    (void)n;
+    int rashi = i % 12 + 1;
+    int m = 3 + rashi, y = 1900 + i / 12;
+    if (m > 12) { m -= 12; y++; }
+    return sankranti_jd(gregorian_to_jd(y, m, 14), (rashi - 1) * 30.0);
+}
+
+static double b_lunisolar_month_start(int i, int n)
+{
+    (void)n;
+    return lunisolar_month_start((MasaName)(i % 12 + 1), 1822 + i / 12 % 150, 0,
+                                 LUNISOLAR_AMANTA, &delhi);
+}
+
+static double b_solar_month_start(int i, int n)
+{
+    (void)n;
+    return solar_month_start(i % 12 + 1, 1822 + i / 12 % 150, SOLAR_CAL_TAMIL, &delhi);
+}
+
+static double hindu_day(double jd, const Location *loc)
+{
+    int y, m, d;
+    jd_to_gregorian(jd, &y, &m, &d);
+    HinduDate hd = gregorian_to_hindu(y, m, d, loc);
+    return hd.tithi;
+}
+
+static double b_seq_lunisolar(int i, int n)
+{
+    (void)n;
+    return hindu_day(JD_1900 + 36525.0 + i, &delhi);
+}
+
+static double b_seq_solar(int i, int n)
+{
+    (void)n;
+    int y, m, d;
+    jd_to_gregorian(JD_1900 + 36525.0 + i, &y, &m, &d);
+    SolarDate sd = gregorian_to_solar(y, m, d, &delhi, SOLAR_CAL_TAMIL);
+    return sd.day;
+}
+
+static double b_random_lunisolar(int i, int n)
+{
+    (void)n;
+    return hindu_day(JD_1900 + random_day[i], &delhi);
+}
+
+static double b_multi_location(int i, int n)
+{
+    /* Four locations in turn, each walking consecutive days */
+    (void)n;
+    return hindu_day(JD_1900 + 36525.0 + i / 4, &locations[i % 4]);
+}
+
+static double b_high_latitude(int i, int n)
+{
+    (void)n;
+    return hindu_day(JD_1900 + 36525.0 + i, &reykjavik);
+}
+
+typedef struct {
+    const char *name;
+    const char *layer;
+    BenchFn fn;
+    int ops;               /* calls per repetition */
+} Bench;
+
+static const Bench BENCHES[] = {
+    {"solar_longitude",       "ephemeris", b_solar_longitude,        10000},
+    {"lunar_longitude",       "ephemeris", b_lunar_longitude,        10000},
+    {"ayanamsa",              "ephemeris", b_ayanamsa,               20000},
+    {"sunrise",               "ephemeris", b_sunrise,                 2000},
+    {"find_tithi_boundary",   "search",    b_find_tithi_boundary,     TITHI_INPUTS},
+    {"new_moon_before",       "search",    b_new_moon_before,         TITHI_INPUTS},
+    {"sankranti_jd",          "search",    b_sankranti_jd,             906},
+    {"lunisolar_month_start", "month",     b_lunisolar_month_start,    180},
+    {"solar_month_start",     "month",     b_solar_month_start,        900},
+    {"seq_lunisolar",         "workload",  b_seq_lunisolar,           1500},
+    {"seq_solar",             "workload",  b_seq_solar,               2500},
+    {"random_lunisolar",      "workload",  b_random_lunisolar,         300},
+    {"multi_location",        "workload",  b_multi_location,           400},
+    {"high_latitude",         "workload",  b_high_latitude,           1500},
+};
+#define N_BENCHES ((int)(sizeof(BENCHES) / sizeof(BENCHES[0])))
+
+typedef struct {
+    const Bench *bench;
+    double min_ns, median_ns, mean_ns, stddev_ns;
+    double rel_min;        /* best ns/op relative to its round's calibration */
+    double rel_median;     /* median of the same ratios */
+} BenchResult;
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x < y) ? -1 : (x > y);
+}
+
+static volatile double sink;
+
+/* One timed repetition, in ns per call */
+static double time_rep(const Bench *b)
+{
+    struct timespec t0, t1;
+    double acc = 0.0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < b->ops; i++)
+        acc += b->fn(i, b->ops);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    sink = acc;
+    return elapsed_sec(&t0, &t1) * 1e9 / b->ops;
+}
+
+/*
+ * Fixed floating-point loop, ns per iteration.  The fastest of several
+ * short passes: a single pass that gets preempted reads several times
+ * slow and would make every benchmark in its round look that much faster.
+ */
+#define CAL_PASSES 5
+#define CAL_ITERS 40000
+
+static double calibrate(void)
+{
+    double best = 0.0;
+    for (int pass = 0; pass < CAL_PASSES; pass++) {
+        struct timespec t0, t1;
+        double acc = 0.0;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (int i = 0; i < CAL_ITERS; i++)
+            acc += sin(i * 1e-3) * cos(i * 2e-3);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        sink = acc;
+        double t = elapsed_sec(&t0, &t1) * 1e9 / CAL_ITERS;
+        if (pass == 0 || t < best) best = t;
+    }
+    return best;
+}
+
+static double median_of(double *v, int n)
+{
+    qsort(v, n, sizeof(double), cmp_double);
+    return (n % 2) ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2.0;
+}
+
+/* Sorts ns; rel is scratch space for reps ratios */
+static void summarize(const Bench *b, double *ns, const double *cal, int reps,
+                      double *rel, BenchResult *r)
+{
+    for (int k = 0; k < reps; k++) rel[k] = ns[k] / cal[k];
+    r->rel_median = median_of(rel, reps);
+    r->rel_min = rel[0];
+
+    double sum = 0.0, sq = 0.0;
+    for (int k = 0; k < reps; k++) sum += ns[k];
+    r->mean_ns = sum / reps;
+    for (int k = 0; k < reps; k++) sq += (ns[k] - r->mean_ns) * (ns[k] - r->mean_ns);
+    r->stddev_ns = (reps > 1) ? sqrt(sq / (reps - 1)) : 0.0;
+    r->median_ns = median_of(ns, reps);
+    r->min_ns = ns[0];
+    r->bench = b;
+}
+
+/* ---- JSON results: one benchmark object per line ---- */
+
+static int write_json(const char *path, const BenchResult *res, int n, int reps,
+                      double cal_ns)
+{
+    FILE *f = fopen(path, "w");
+    if (!f) return -1;
+    fprintf(f, "{\n  \"backend\": \"%s\",\n  \"reps\": %d,\n"
+            "  \"calibration_ns\": %.2f,\n  \"benchmarks\": [\n",
+            BACKEND_NAME, reps, cal_ns);
+    for (int i = 0; i < n; i++)
+        fprintf(f, "    {\"name\": \"%s\", \"layer\": \"%s\", \"ops\": %d, "
+                "\"min_ns\": %.1f, \"median_ns\": %.1f, \"mean_ns\": %.1f, "
+                "\"stddev_ns\": %.1f, \"rel_min\": %.2f, \"rel_median\": %.2f}%s\n",
+                res[i].bench->name, res[i].bench->layer, res[i].bench->ops,
+                res[i].min_ns, res[i].median_ns, res[i].mean_ns, res[i].stddev_ns,
+                res[i].rel_min, res[i].rel_median, (i + 1 < n) ? "," : "");
+    fprintf(f, "  ]\n}\n");
+    return (fclose(f) == 0) ? 0 : -1;
+}
+
+/* FIELD ("rel_min", "rel_median") of a benchmark in a file written by write_json(), or -1 */
+static double baseline_rel(FILE *f, const char *name, const char *field)
+{
+    char line[512], key[80], fkey[32];
+    snprintf(key, sizeof(key), "\"name\": \"%s\",", name);
+    snprintf(fkey, sizeof(fkey), "\"%s\":", field);
+    rewind(f);
+    while (fgets(line, sizeof(line), f)) {
+        if (!strstr(line, key)) continue;
+        const char *p = strstr(line, fkey);
+        double v;
+        if (p && sscanf(p + strlen(fkey), "%lf", &v) == 1) return v;
+    }
+    return -1.0;
+}
+
+static int compare_baseline(const char *path, const BenchResult *res, int n,
+                            double threshold_pct)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "ERROR: cannot read baseline %s\n", path);
+        return -1;
+    }
+    printf("\n--- Against %s (regression: min and median > +%.0f%%) ---\n",
+           path, threshold_pct);
+    int regressions = 0;
+    for (int i = 0; i < n; i++) {
+        double base = baseline_rel(f, res[i].bench->name, "rel_min");
+        if (base <= 0.0) {
+            printf("%-26s: %10.2f x cal   (not in baseline)\n",
+                   res[i].bench->name, res[i].rel_min);
+            continue;
+        }
+        /* A baseline from before rel_median was recorded compares the best only */
+        double base_med = baseline_rel(f, res[i].bench->name, "rel_median");
+        double change = (res[i].rel_min / base - 1.0) * 100.0;
+        double change_med = (base_med > 0.0)
+            ? (res[i].rel_median / base_med - 1.0) * 100.0 : change;
+        const char *flag = "";
+        if (change > threshold_pct && change_med > threshold_pct) {
+            flag = "  REGRESSION";
+            regressions++;
+        } else if (change < -threshold_pct && change_med < -threshold_pct) {
+            flag = "  faster";
+        }
+        printf("%-26s: %10.2f x cal vs %10.2f  %+6.1f%% (median %+6.1f%%)%s\n",
+               res[i].bench->name, res[i].rel_min, base, change, change_med, flag);
+    }
+    fclose(f);
+    printf("\n%d regression%s\n", regressions, regressions == 1 ? "" : "s");
+    return regressions;
+}
+
+int main(int argc, char *argv[])
+{
+    int reps = 7;
+    double threshold = 30.0;
+    const char *filter = NULL, *out_path = NULL, *base_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            reps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            base_path = argv[++i];
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            threshold = atof(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [-r REPS] [-f SUBSTRING] [-o RESULTS.json] "
+                    "[-c BASELINE.json [-t PERCENT]]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (reps < 1) {
+        fprintf(stderr, "ERROR: -r needs a positive repetition count\n");
+        return 1;
+    }
+
+    astro_init(NULL);
+
+    int max_ops = 0;
+    for (int b = 0; b < N_BENCHES; b++)
+        if (BENCHES[b].ops > max_ops) max_ops = BENCHES[b].ops;
+    random_day = malloc(max_ops * sizeof(int));
+    if (!random_day) return 1;
+    for (int i = 0; i < TITHI_INPUTS; i++)
+        tithi_at[i] = tithi_at_moment(spread_jd(i, TITHI_INPUTS));
+    unsigned lcg = 12345;
+    for (int i = 0; i < max_ops; i++) {
+        lcg = lcg * 1103515245u + 12345u;
+        random_day[i] = (int)((lcg >> 8) % (unsigned)SPAN_DAYS);
+    }
+
+    printf("=== Benchmark suite (%s, %d reps, ns/op) ===\n", BACKEND_NAME, reps);
+    printf("%-26s  %10s %10s %10s %8s %9s\n", "", "min", "median", "mean", "stddev",
+           "x cal");
+
+    const Bench *sel[MAX_BENCH];
+    int n = 0;
+    for (int b = 0; b < N_BENCHES && n < MAX_BENCH; b++)
+        if (!filter || strstr(BENCHES[b].name, filter) || strcmp(BENCHES[b].layer, filter) == 0)
+            sel[n++] = &BENCHES[b];
+
+    /*
+     * Repetitions go round-robin over the benchmarks, so a slow spell on
+     * the machine is spread over all of them rather than landing on one.
+     */
+    double *ns = malloc((size_t)n * reps * sizeof(double));
+    double *cal = malloc(reps * sizeof(double));
+    double *rel = malloc(reps * sizeof(double));
+    if (!ns || !cal || !rel) return 1;
+    for (int j = 0; j < n; j++)
+        time_rep(sel[j]);   /* warmup */
+    double cal_min = 0.0;
+    for (int k = 0; k < reps; k++) {
+        cal[k] = calibrate();
+        for (int j = 0; j < n; j++)
+            ns[j * reps + k] = time_rep(sel[j]);
+        if (k == 0 || cal[k] < cal_min) cal_min = cal[k];
+    }
+
+    BenchResult res[MAX_BENCH];
+    const char *layer = "";
+    for (int j = 0; j < n; j++) {
+        summarize(sel[j], &ns[j * reps], cal, reps, rel, &res[j]);
+        if (strcmp(layer, sel[j]->layer) != 0) {
+            layer = sel[j]->layer;
+            printf("\n--- %s ---\n", layer);
+        }
+        printf("%-26s: %10.1f %10.1f %10.1f %7.1f%% %9.2f\n", sel[j]->name,
+               res[j].min_ns, res[j].median_ns, res[j].mean_ns,
+               100.0 * res[j].stddev_ns / res[j].mean_ns, res[j].rel_min);
+    }
+    printf("\n%-26s: %10.2f ns/iteration\n", "calibration", cal_min);
+    free(ns);
+    free(cal);
+    free(rel);
+
+    int rc = 0;
+    if (out_path) {
+        if (write_json(out_path, res, n, reps, cal_min) != 0) {
+            fprintf(stderr, "ERROR: cannot write %s\n", out_path);
+            rc = 1;
+        } else {
+            printf("\nResults written to %s\n", out_path);
+        }
+    }
+    if (base_path && compare_baseline(base_path, res, n, threshold) != 0)
+        rc = 1;
+
+    free(random_day);
+    astro_close();
+    return rc;
+}
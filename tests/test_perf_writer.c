@@ -0,0 +1,111 @@
+#include "writer.h"
+#include "panchang.h"
+#include "solar.h"
+#include "astro.h"
+#include "date_utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * Output writer benchmark: 2M precomputed records (one year of all five
+ * calendars, repeated) written to /dev/null as CSV, JSON Lines and
+ * binary, against fprintf() of the same CSV row and a per-field printf
+ * style like print_month_panchang().
+ */
+
+#define N_BASE    (366 * CALENDAR_COUNT)
+#define N_ROWS    2000000
+
+static double elapsed_sec(struct timespec *start, struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static const char *month_name(const CalendarRecord *r)
+{
+    return r->calendar == CALENDAR_LUNISOLAR ? MASA_NAMES[r->month]
+         : solar_month_name(r->month, (SolarCalendarType)(r->calendar - 1));
+}
+
+static void report(const char *name, double t)
+{
+    printf("%-20s: %6.3fs  (%9.0f rows/s, %6.1f ns/row)\n",
+           name, t, N_ROWS / t, t / N_ROWS * 1e9);
+}
+
+int main(void)
+{
+    Location loc = DEFAULT_LOCATION;
+    static CalendarRecord base[N_BASE];
+    int n = 0;
+    astro_init(NULL);
+    for (int i = 0; i < 366; i++) {
+        int y, m, d;
+        jd_to_gregorian(gregorian_to_jd(2024, 1, 1) + i, &y, &m, &d);
+        HinduDate hd = gregorian_to_hindu(y, m, d, &loc);
+        calendar_record_lunisolar(&base[n++], y, m, d, &hd);
+        for (int t = 0; t < 4; t++) {
+            SolarDate sd = gregorian_to_solar(y, m, d, &loc, (SolarCalendarType)t);
+            calendar_record_solar(&base[n++], y, m, d, (SolarCalendarType)t, &sd);
+        }
+    }
+
+    FILE *out = fopen("/dev/null", "w");
+    if (!out) return 1;
+    printf("=== Output Writer Benchmark (%d rows to /dev/null) ===\n\n", N_ROWS);
+
+    struct timespec t0, t1;
+
+    /* Baseline 1: several printf calls per row */
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < N_ROWS; i++) {
+        const CalendarRecord *r = &base[i % N_BASE];
+        fprintf(out, "%s,", "Delhi");
+        fprintf(out, "%04d-%02d-%02d,", r->greg_year, r->greg_month, r->greg_day);
+        fprintf(out, "%s,%s,", day_of_week_short(r->weekday), calendar_name(r->calendar));
+        fprintf(out, "%d,%d,%s,", r->year, r->month, month_name(r));
+        fprintf(out, "%d,%s,", r->is_adhika_month,
+                r->calendar ? "" : r->paksha == SHUKLA_PAKSHA ? "Shukla" : "Krishna");
+        fprintf(out, "%d,%d\n", r->day, r->is_adhika_day);
+    }
+    fflush(out);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    report("fprintf per field", elapsed_sec(&t0, &t1));
+
+    /* Baseline 2: one fprintf per row */
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < N_ROWS; i++) {
+        const CalendarRecord *r = &base[i % N_BASE];
+        fprintf(out, "%s,%04d-%02d-%02d,%s,%s,%d,%d,%s,%d,%s,%d,%d\n", "Delhi",
+                r->greg_year, r->greg_month, r->greg_day,
+                day_of_week_short(r->weekday), calendar_name(r->calendar),
+                r->year, r->month, month_name(r), r->is_adhika_month,
+                r->calendar ? "" : r->paksha == SHUKLA_PAKSHA ? "Shukla" : "Krishna",
+                r->day, r->is_adhika_day);
+    }
+    fflush(out);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    report("fprintf per row", elapsed_sec(&t0, &t1));
+
+    const char *names[] = {"writer CSV", "writer JSONL", "writer binary"};
+    OutputFormat formats[] = {OUTPUT_CSV, OUTPUT_JSONL, OUTPUT_BINARY};
+    long total = 0;
+    for (int f = 0; f < 3; f++) {
+        RecordWriter w;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        writer_init(&w, out, formats[f]);
+        writer_set_location(&w, 0, "Delhi");
+        for (int i = 0; i < N_ROWS; i++)
+            writer_record(&w, &base[i % N_BASE]);
+        total += w.records;
+        writer_close(&w);
+        fflush(out);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        report(names[f], elapsed_sec(&t0, &t1));
+    }
+
+    fclose(out);
+    astro_close();
+    return (total > 0) ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+#include "scan.h"
+#include "events.h"
+#include "csvmap.h"
+#include "astro.h"
+#include "date_utils.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define ASSERT_EQ(actual, expected, msg) do { \
+    tests_run++; \
+    long _a = (actual), _e = (expected); \
+    if (_a == _e) { \
+        tests_passed++; \
+    } else { \
+        printf("  FAIL: %s (got %ld, expected %ld)\n", msg, _a, _e); \
+    } \
+} while (0)
+
+#define TMP_PATH "build/test_scan.csv"
+
+/* Minutes from the nearest 0h UT */
+static double midnight_distance(double jd)
+{
+    double day = floor(jd - 0.5) + 0.5;
+    double m = (jd - day) * 1440.0;
+    return (m > 720.0) ? m - 1440.0 : m;
+}
+
+static int near_midnight(const AstroEvent *ev, const Location *loc, void *ctx,
+                         ScanHit *hit)
+{
+    (void)loc;
+    const int *only_value = ctx;
+    if (only_value && ev->value != *only_value) return 0;
+    hit->metric = midnight_distance(ev->jd);
+    snprintf(hit->row, sizeof(hit->row), "%d", ev->value);
+    return 1;
+}
+
+static ScanRequest make_request(int threads, int top_n)
+{
+    ScanRequest req;
+    memset(&req, 0, sizeof(req));
+    req.jd_start = gregorian_to_jd(2020, 1, 1);
+    req.jd_end = gregorian_to_jd(2024, 1, 1);
+    req.event_mask = EVENT_TITHI | EVENT_SANKRANTI;
+    req.loc = (Location)DEFAULT_LOCATION;
+    req.metric = near_midnight;
+    req.top_n = top_n;
+    req.threads = threads;
+    return req;
+}
+
+static int cmp_abs(const void *a, const void *b)
+{
+    double da = fabs(*(const double *)a), db = fabs(*(const double *)b);
+    return (da < db) ? -1 : (da > db);
+}
+
+/* scan_run() against a serial walk of the same events */
+static void test_against_serial(void)
+{
+    printf("\n--- Closest hits match a serial sort ---\n");
+    ScanRequest req = make_request(1, 25);
+
+    EventCursor cur;
+    event_cursor_init(&cur, &req.loc);
+    double *all = malloc(2000 * sizeof(double));
+    int n = 0;
+    AstroEvent ev;
+    double jd = req.jd_start;
+    while (n < 2000 && next_event(&cur, jd, req.event_mask, &ev) && ev.jd <= req.jd_end) {
+        all[n++] = midnight_distance(ev.jd);
+        jd = ev.jd;
+    }
+    qsort(all, n, sizeof(double), cmp_abs);
+
+    ScanResult res;
+    ASSERT_EQ(scan_run(&req, &res), 1, "scan_run");
+    ASSERT_EQ(res.n_events, n, "every event enumerated");
+    ASSERT_EQ(res.n_matched, n, "every event kept by the metric");
+    ASSERT_EQ(res.n_hits, 25, "top_n hits");
+    int same = 0, sorted = 1;
+    for (int i = 0; i < res.n_hits; i++) {
+        if (fabs(res.hits[i].metric - all[i]) < 1e-6) same++;
+        if (i > 0 && fabs(res.hits[i].metric) < fabs(res.hits[i - 1].metric)) sorted = 0;
+    }
+    ASSERT_EQ(same, 25, "same metrics as the full sort");
+    ASSERT_EQ(sorted, 1, "closest first");
+    scan_free(&res);
+    ASSERT_EQ(res.hits == NULL, 1, "free clears the result");
+    free(all);
+}
+
+static void test_threads(void)
+{
+    printf("\n--- Same hits for any thread count ---\n");
+    ScanRequest r1 = make_request(1, 40), r4 = make_request(4, 40);
+    ScanResult a, b;
+    ASSERT_EQ(scan_run(&r1, &a), 1, "1 thread");
+    ASSERT_EQ(scan_run(&r4, &b), 1, "4 threads");
+    ASSERT_EQ(b.n_events, a.n_events, "events");
+    ASSERT_EQ(b.n_hits, a.n_hits, "hits");
+    int same = 0;
+    for (int i = 0; i < a.n_hits && i < b.n_hits; i++)
+        if (a.hits[i].ev.jd == b.hits[i].ev.jd && a.hits[i].ev.type == b.hits[i].ev.type &&
+            strcmp(a.hits[i].row, b.hits[i].row) == 0)
+            same++;
+    ASSERT_EQ(same, a.n_hits, "identical hits in order");
+    scan_free(&a);
+    scan_free(&b);
+}
+
+static void test_predicate(void)
+{
+    printf("\n--- Predicate and limits ---\n");
+    int purnima = 15;
+    ScanRequest req = make_request(2, 1000);
+    req.event_mask = EVENT_TITHI;
+    req.ctx = &purnima;
+    ScanResult res;
+    ASSERT_EQ(scan_run(&req, &res), 1, "scan_run");
+    ASSERT_EQ(res.n_matched >= 48 && res.n_matched <= 50, 1, "one tithi 15 per lunation");
+    ASSERT_EQ(res.n_hits, res.n_matched, "fewer matches than top_n");
+    int all_15 = 1;
+    for (int i = 0; i < res.n_hits; i++)
+        if (res.hits[i].ev.value != 15) all_15 = 0;
+    ASSERT_EQ(all_15, 1, "only matching events kept");
+    scan_free(&res);
+
+    ScanRequest bad = make_request(1, 0);
+    ASSERT_EQ(scan_run(&bad, &res), 0, "top_n 0 refused");
+    bad = make_request(1, 10);
+    bad.event_mask = 0;
+    ASSERT_EQ(scan_run(&bad, &res), 0, "empty mask refused");
+    bad = make_request(1, 10);
+    bad.jd_end = bad.jd_start;
+    ASSERT_EQ(scan_run(&bad, &res), 0, "empty range refused");
+    bad = make_request(1, 10);
+    bad.metric = NULL;
+    ASSERT_EQ(scan_run(&bad, &res), 0, "no metric refused");
+}
+
+static void test_csv(void)
+{
+    printf("\n--- CSV output ---\n");
+    ScanRequest req = make_request(1, 10);
+    req.event_mask = EVENT_SANKRANTI;
+    ScanResult res;
+    ASSERT_EQ(scan_run(&req, &res), 1, "scan_run");
+    ASSERT_EQ(res.n_events, 48, "12 sankrantis a year");
+
+    FILE *f = fopen(TMP_PATH, "w");
+    ASSERT_EQ(f != NULL, 1, "open output");
+    if (!f) return;
+    ASSERT_EQ(scan_write_csv(f, &req, &res, "value_again"), 0, "write");
+    fclose(f);
+
+    CsvFile c;
+    ASSERT_EQ(csv_open(&c, TMP_PATH), 1, "read back");
+    ASSERT_EQ(c.n_columns, 6, "five fixed columns plus the caller's");
+    ASSERT_EQ(csv_column(&c, "metric"), 4, "metric column");
+    ASSERT_EQ(csv_count_rows(&c), 10, "one row per hit");
+    ASSERT_EQ(csv_next(&c) && csv_str_eq(&c, 0, "Sankranti"), 1, "event name");
+    int v = 0, again = -1;
+    ASSERT_EQ(csv_int(&c, 1, &v) && csv_int(&c, 5, &again) && v == again &&
+              v == res.hits[0].ev.value, 1, "value and row");
+    double jd = 0;
+    ASSERT_EQ(csv_double(&c, 2, &jd) && fabs(jd - res.hits[0].ev.jd) < 1e-5, 1, "jd");
+    int len;
+    const char *t = csv_str(&c, 3, &len);
+    ASSERT_EQ(t != NULL && len == 19 && t[10] == ' ', 1, "local time layout");
+    csv_close(&c);
+    scan_free(&res);
+}
+
+int main(void)
+{
+    astro_init(NULL);
+
+    test_against_serial();
+    test_threads();
+    test_predicate();
+    test_csv();
+    remove(TMP_PATH);
+
+    astro_close();
+
+    printf("\n=== Scan tests: %d/%d passed ===\n", tests_passed, tests_run);
+    return (tests_passed == tests_run) ? 0 : 1;
+}
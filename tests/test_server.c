@@ -0,0 +1,387 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "server.h"
+#include "astro.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define ASSERT_EQ(actual, expected, msg) do { \
+    tests_run++; \
+    long _a = (actual), _e = (expected); \
+    if (_a == _e) { \
+        tests_passed++; \
+    } else { \
+        printf("  FAIL: %s (got %ld, expected %ld)\n", msg, _a, _e); \
+    } \
+} while (0)
+
+#define SOCK_PATH "build/test_server.sock"
+#define N_CLIENTS 4
+#define N_PER_CLIENT 60
+
+static void test_parse(void)
+{
+    printf("\n--- server_parse_request ---\n");
+    ServerRequest req;
+    const char *err;
+
+    ASSERT_EQ(server_parse_request("{\"id\":7,\"op\":\"day\",\"date\":\"2025-01-14\"}", &req, &err),
+              1, "day request");
+    ASSERT_EQ(strcmp(req.id, "7"), 0, "numeric id kept as text");
+    ASSERT_EQ(req.op, SERVER_OP_DAY, "op");
+    ASSERT_EQ(req.y0 * 10000 + req.m0 * 100 + req.d0, 20250114, "date");
+    ASSERT_EQ(req.loc.latitude == 28.6139 && req.loc.utc_offset == 5.5, 1, "default location");
+
+    ASSERT_EQ(server_parse_request(" { \"op\" : \"month\", \"year\" : 2024, \"month\" : 2,"
+                                   " \"lat\": 40.7128, \"lon\": -74.006, \"utc_offset\": -5,"
+                                   " \"id\": \"q\\\"1\", \"extra\": [1] } ", &req, &err),
+              0, "nested value rejected");
+    ASSERT_EQ(strcmp(req.id, "\"q\\\"1\""), 0, "string id kept with escapes");
+    ASSERT_EQ(server_parse_request(" { \"op\" : \"month\", \"year\" : 2024, \"month\" : 2,"
+                                   " \"lat\": 40.7128, \"lon\": -74.006, \"utc_offset\": -5,"
+                                   " \"note\": \"x\", \"flag\": true } ", &req, &err),
+              1, "month request with unknown scalar keys");
+    ASSERT_EQ(req.loc.longitude == -74.006 && req.loc.utc_offset == -5.0, 1, "location fields");
+    ASSERT_EQ(req.id[0], '\0', "no id");
+
+    ASSERT_EQ(server_parse_request("{\"op\":\"range\",\"from\":\"2024-01-01\",\"to\":\"2024-12-31\","
+                                   "\"calendars\":\"lunisolar,malayalam\"}", &req, &err),
+              1, "366-day range");
+    ASSERT_EQ(req.calendars, CALSET_LUNISOLAR | CALSET_MALAYALAM, "calendar set");
+    ASSERT_EQ(server_parse_request("{\"op\":\"range\",\"from\":\"2024-01-01\",\"to\":\"2025-01-01\"}",
+                                   &req, &err), 0, "367-day range");
+    ASSERT_EQ(server_parse_request("{\"op\":\"range\",\"from\":\"2024-01-02\",\"to\":\"2024-01-01\"}",
+                                   &req, &err), 0, "reversed range");
+    ASSERT_EQ(server_parse_request("{\"op\":\"solar\",\"date\":\"2025-04-14\",\"calendar\":\"odia\"}",
+                                   &req, &err), 1, "solar request");
+    ASSERT_EQ(req.solar_type, SOLAR_CAL_ODIA, "solar type");
+
+    ASSERT_EQ(server_parse_request("{\"id\":3,\"op\":\"day\",\"date\":\"2025-02-29\"}", &req, &err),
+              0, "invalid date");
+    ASSERT_EQ(strcmp(req.id, "3"), 0, "id kept on error");
+    ASSERT_EQ(server_parse_request("{\"op\":\"month\",\"year\":1000000000,\"month\":1}",
+                                   &req, &err), 0, "year 1000000000 rejected");
+    ASSERT_EQ(strcmp(err, "year out of range (1900-2100)"), 0, "year range error");
+    ASSERT_EQ(server_parse_request("{\"op\":\"day\",\"date\":\"1899-12-31\"}", &req, &err),
+              0, "date before 1900 rejected");
+    ASSERT_EQ(server_parse_request("{\"op\":\"range\",\"from\":\"2100-12-01\",\"to\":\"2101-01-01\"}",
+                                   &req, &err), 0, "range past 2100 rejected");
+    ASSERT_EQ(server_parse_request("{\"op\":\"solar\",\"date\":\"2100-12-31\",\"calendar\":\"tamil\"}",
+                                   &req, &err), 1, "2100-12-31 accepted");
+    ASSERT_EQ(server_parse_request("{\"op\":\"day\"}", &req, &err), 0, "missing date");
+    ASSERT_EQ(server_parse_request("{\"date\":\"2025-01-01\"}", &req, &err), 0, "missing op");
+    ASSERT_EQ(server_parse_request("{\"op\":\"week\"}", &req, &err), 0, "unknown op");
+    ASSERT_EQ(server_parse_request("{\"op\":\"day\",\"date\":\"2025-01-01\",\"lat\":95}",
+                                   &req, &err), 0, "latitude out of range");
+    ASSERT_EQ(server_parse_request("{\"op\":\"day\",\"date\":\"2025-01-01\"", &req, &err),
+              0, "unterminated object");
+    ASSERT_EQ(server_parse_request("{\"op\":\"ping\"} x", &req, &err), 0, "trailing text");
+}
+
+static int connect_unix(void)
+{
+    struct sockaddr_un sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sun_family = AF_UNIX;
+    strcpy(sa.sun_path, SOCK_PATH);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, (struct sockaddr *)&sa, sizeof(sa)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* Send all lines, half-close, read everything back */
+static char *round_trip(const char *lines, size_t *len)
+{
+    int fd = connect_unix();
+    if (fd < 0) return NULL;
+    size_t n = strlen(lines), off = 0;
+    while (off < n) {
+        ssize_t w = write(fd, lines + off, n - off);
+        if (w <= 0) break;
+        off += (size_t)w;
+    }
+    shutdown(fd, SHUT_WR);
+
+    size_t cap = 1 << 16;
+    char *buf = malloc(cap);
+    *len = 0;
+    for (;;) {
+        if (cap - *len < 4096) buf = realloc(buf, cap *= 2);
+        ssize_t r = read(fd, buf + *len, cap - *len - 1);
+        if (r <= 0) break;
+        *len += (size_t)r;
+    }
+    buf[*len] = '\0';
+    close(fd);
+    return buf;
+}
+
+/* Expected response line for a request, computed directly */
+static char *expected_line(const char *request)
+{
+    ServerRequest req;
+    const char *err;
+    char *buf = NULL;
+    size_t len = 0, cap = 0;
+    if (server_parse_request(request, &req, &err))
+        server_execute(&req, &buf, &len, &cap);
+    return buf;
+}
+
+/* Does response text contain exactly this line? */
+static int has_line(const char *text, const char *line)
+{
+    size_t n = strlen(line);
+    for (const char *p = text; (p = strstr(p, line)) != NULL; p++)
+        if (p == text || p[-1] == '\n') return n > 0;
+    return 0;
+}
+
+typedef struct {
+    int index;
+    int mismatches;
+    int lines;
+} ClientJob;
+
+/* Pipelined day requests for two locations and nearby dates */
+static void *client_thread(void *arg)
+{
+    ClientJob *job = arg;
+    static const char *LOCS[] = {"", "\"lat\":13.0827,\"lon\":80.2707,"};
+    size_t cap = N_PER_CLIENT * 128, len = 0;
+    char *lines = malloc(cap);
+    char reqs[N_PER_CLIENT][128];
+
+    for (int i = 0; i < N_PER_CLIENT; i++) {
+        int day = 1 + (i * 17 + job->index * 5) % 28;
+        snprintf(reqs[i], sizeof(reqs[i]),
+                 "{\"id\":%d,\"op\":\"day\",%s\"date\":\"2025-03-%02d\"}",
+                 job->index * 1000 + i, LOCS[(i + job->index) % 2], day);
+        len += (size_t)snprintf(lines + len, cap - len, "%s\n", reqs[i]);
+    }
+
+    size_t out_len;
+    char *out = round_trip(lines, &out_len);
+    for (size_t i = 0; out && i < out_len; i++)
+        if (out[i] == '\n') job->lines++;
+    for (int i = 0; out && i < N_PER_CLIENT; i++) {
+        char *expect = expected_line(reqs[i]);
+        if (!expect || !has_line(out, expect)) job->mismatches++;
+        free(expect);
+    }
+    free(out);
+    free(lines);
+    return NULL;
+}
+
+static void *server_thread(void *arg)
+{
+    int fd = *(int *)arg;
+    ServerConfig cfg = { 2, 16 };
+    static ServerStats st;
+    if (server_run(fd, &cfg, &st) != 0) return NULL;
+    return &st;
+}
+
+static void test_daemon(void)
+{
+    printf("\n--- Daemon over a Unix socket ---\n");
+    int fd = server_listen("unix:" SOCK_PATH);
+    ASSERT_EQ(fd >= 0, 1, "listening");
+    if (fd < 0) return;
+    pthread_t srv;
+    pthread_create(&srv, NULL, server_thread, &fd);
+
+    /* Every op, plus errors, on one connection */
+    const char *reqs[] = {
+        "{\"id\":1,\"op\":\"day\",\"date\":\"2025-01-14\"}",
+        "{\"id\":2,\"op\":\"month\",\"year\":2025,\"month\":2,\"lat\":40.7128,"
+        "\"lon\":-74.006,\"utc_offset\":-5}",
+        "{\"id\":3,\"op\":\"range\",\"from\":\"2024-12-30\",\"to\":\"2025-01-02\","
+        "\"calendars\":\"all\"}",
+        "{\"id\":4,\"op\":\"solar\",\"date\":\"2025-04-14\",\"calendar\":\"tamil\"}",
+        "{\"id\":5,\"op\":\"ping\"}",
+    };
+    char lines[2048] = "";
+    for (int i = 0; i < 5; i++) {
+        strcat(lines, reqs[i]);
+        strcat(lines, "\n");
+    }
+    strcat(lines, "{\"id\":6,\"op\":\"day\",\"date\":\"2025-13-01\"}\nnot json\n");
+
+    size_t len;
+    char *out = NULL;
+    for (int attempt = 0; attempt < 50 && !out; attempt++) {
+        out = round_trip(lines, &len);
+        if (!out) usleep(20000);
+    }
+    ASSERT_EQ(out != NULL, 1, "connected");
+    if (out) {
+        int n_lines = 0;
+        for (size_t i = 0; i < len; i++)
+            if (out[i] == '\n') n_lines++;
+        ASSERT_EQ(n_lines, 7, "one response per request");
+        for (int i = 0; i < 5; i++) {
+            char *expect = expected_line(reqs[i]);
+            ASSERT_EQ(expect && has_line(out, expect), 1, reqs[i]);
+            free(expect);
+        }
+        ASSERT_EQ(has_line(out, "{\"id\":6,\"ok\":false,\"error\":"
+                                "\"invalid date, expected YYYY-MM-DD\"}\n"), 1, "bad date error");
+        ASSERT_EQ(has_line(out, "{\"id\":null,\"ok\":false,\"error\":\"malformed JSON\"}\n"),
+                  1, "malformed line error");
+        ASSERT_EQ(strstr(out, "\"result\":[{\"location\":\"28.6139:77.2090\",\"date\":\"2024-12-30\","
+                              "\"weekday\":\"Mon\",\"calendar\":\"lunisolar\"") != NULL, 1,
+                  "range rows as an array");
+        free(out);
+    }
+
+    /* Concurrent pipelined clients */
+    pthread_t tids[N_CLIENTS];
+    ClientJob jobs[N_CLIENTS];
+    for (int c = 0; c < N_CLIENTS; c++) {
+        jobs[c].index = c;
+        jobs[c].mismatches = jobs[c].lines = 0;
+        pthread_create(&tids[c], NULL, client_thread, &jobs[c]);
+    }
+    int mismatches = 0, n_lines = 0;
+    for (int c = 0; c < N_CLIENTS; c++) {
+        pthread_join(tids[c], NULL);
+        mismatches += jobs[c].mismatches;
+        n_lines += jobs[c].lines;
+    }
+    ASSERT_EQ(n_lines, N_CLIENTS * N_PER_CLIENT, "every pipelined request answered");
+    ASSERT_EQ(mismatches, 0, "responses differing from direct computation");
+
+    out = round_trip("{\"id\":\"s\",\"op\":\"stats\"}\n", &len);
+    ASSERT_EQ(out && strstr(out, "\"connections\":6,\"requests\":248,\"errors\":2,") != NULL,
+              1, "stats counters");
+    free(out);
+
+    server_stop();
+    ServerStats *st = NULL;
+    pthread_join(srv, (void **)&st);
+    ASSERT_EQ(st != NULL, 1, "server returned");
+    if (st) {
+        ASSERT_EQ(st->requests, 8 + N_CLIENTS * N_PER_CLIENT, "requests counted");
+        /* 245 queued requests for two locations come out in fewer batches */
+        ASSERT_EQ(st->batches > 0 && st->batches < 245, 1, "requests batched");
+        printf("  %ld requests in %ld batches\n", st->requests, st->batches);
+    }
+    server_close(fd, "unix:" SOCK_PATH);
+    ASSERT_EQ(access(SOCK_PATH, F_OK), -1, "socket file removed");
+}
+
+/* One client pipelines large requests and never reads; another must
+ * still be answered, and the first must be stopped from sending */
+static void test_backpressure(void)
+{
+    printf("\n--- A client that does not read ---\n");
+    int fd = server_listen("unix:" SOCK_PATH);
+    ASSERT_EQ(fd >= 0, 1, "listening");
+    if (fd < 0) return;
+    pthread_t srv;
+    pthread_create(&srv, NULL, server_thread, &fd);
+
+    int greedy = -1;
+    for (int attempt = 0; attempt < 50 && greedy < 0; attempt++) {
+        greedy = connect_unix();
+        if (greedy < 0) usleep(20000);
+    }
+    ASSERT_EQ(greedy >= 0, 1, "connected");
+    if (greedy < 0) return;
+    fcntl(greedy, F_SETFL, fcntl(greedy, F_GETFL) | O_NONBLOCK);
+
+    /* ~30 KB per response; stop when the server stops taking requests */
+    static const char line[] = "{\"id\":1,\"op\":\"range\",\"from\":\"2025-01-01\","
+                               "\"to\":\"2025-01-31\",\"calendars\":\"all\"}\n";
+    long sent = 0, max_lines = 200000;
+    int blocked = 0;
+    for (int idle = 0; sent < max_lines && idle < 50;) {
+        ssize_t w = write(greedy, line, sizeof(line) - 1);
+        if (w == (ssize_t)sizeof(line) - 1) {
+            sent++;
+            idle = 0;
+        } else if (w < 0 && errno == EAGAIN) {
+            blocked = 1;
+            idle++;
+            usleep(20000);
+        } else {
+            break;  /* partial line: the buffer is full, which is enough */
+        }
+    }
+    ASSERT_EQ(blocked, 1, "flooding client held back");
+    printf("  %ld requests sent before the server stopped reading\n", sent);
+
+    /* Another client is answered promptly */
+    int fd2 = connect_unix();
+    struct timeval tv = {10, 0};
+    setsockopt(fd2, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    const char *req = "{\"id\":2,\"op\":\"day\",\"date\":\"2025-01-14\"}\n";
+    ssize_t w = write(fd2, req, strlen(req));
+    char buf[4096];
+    ssize_t r = (w > 0) ? read(fd2, buf, sizeof(buf) - 1) : -1;
+    char *expect = expected_line("{\"id\":2,\"op\":\"day\",\"date\":\"2025-01-14\"}");
+    if (r > 0) buf[r] = '\0';
+    ASSERT_EQ(r > 0 && expect && strcmp(buf, expect) == 0, 1, "other client answered");
+    free(expect);
+    close(fd2);
+
+    close(greedy);
+    server_stop();
+    ServerStats *st = NULL;
+    pthread_join(srv, (void **)&st);
+    ASSERT_EQ(st != NULL, 1, "server returned");
+    server_close(fd, "unix:" SOCK_PATH);
+}
+
+/* An empty host listens on loopback only */
+static void test_listen_loopback(void)
+{
+    printf("\n--- tcp::PORT ---\n");
+    int fd = server_listen("tcp::0");
+    ASSERT_EQ(fd >= 0, 1, "listening");
+    if (fd < 0) return;
+    struct sockaddr_storage ss;
+    socklen_t len = sizeof(ss);
+    int loopback = 0;
+    if (getsockname(fd, (struct sockaddr *)&ss, &len) == 0) {
+        if (ss.ss_family == AF_INET)
+            loopback = ((struct sockaddr_in *)&ss)->sin_addr.s_addr == htonl(INADDR_LOOPBACK);
+        else if (ss.ss_family == AF_INET6)
+            loopback = IN6_IS_ADDR_LOOPBACK(&((struct sockaddr_in6 *)&ss)->sin6_addr);
+    }
+    ASSERT_EQ(loopback, 1, "bound to loopback");
+    server_close(fd, "tcp::0");
+}
+
+int main(void)
+{
+    astro_init(NULL);
+
+    test_parse();
+    test_daemon();
+    test_backpressure();
+    test_listen_loopback();
+
+    astro_close();
+
+    printf("\n=== Server tests: %d/%d passed ===\n", tests_passed, tests_run);
+    return (tests_passed == tests_run) ? 0 : 1;
+}
@@ -0,0 +1,264 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "shmcache.h"
+#include "astro.h"
+#include "panchang.h"
+#include "solar.h"
+#include "date_utils.h"
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define ASSERT_EQ(actual, expected, msg) do { \
+    tests_run++; \
+    long _a = (actual), _e = (expected); \
+    if (_a == _e) { \
+        tests_passed++; \
+    } else { \
+        printf("  FAIL: %s (got %ld, expected %ld)\n", msg, _a, _e); \
+    } \
+} while (0)
+
+#define N_DAYS 365
+#define N_SOLAR 4
+
+static char seg_name[64];
+
+static const Location DELHI = DEFAULT_LOCATION;
+static const Location CHENNAI = { 13.0827, 80.2707, 0.0, 5.5 };
+
+/* Uncached results for 2025, computed before attaching */
+static HinduDate ref_hindu[2][N_DAYS];
+static SolarDate ref_solar[2][N_SOLAR][N_DAYS];
+
+static int hindu_equal(const HinduDate *a, const HinduDate *b)
+{
+    return a->year_saka == b->year_saka && a->year_vikram == b->year_vikram &&
+           a->masa == b->masa && a->is_adhika_masa == b->is_adhika_masa &&
+           a->paksha == b->paksha && a->tithi == b->tithi &&
+           a->is_adhika_tithi == b->is_adhika_tithi;
+}
+
+/* jd_sankranti varies in its last bits with call order (whether solar.c's
+ * month cache hit), so it is compared to within 1e-6 day */
+static int solar_equal(const SolarDate *a, const SolarDate *b)
+{
+    return a->year == b->year && a->month == b->month && a->day == b->day &&
+           a->rashi == b->rashi && fabs(a->jd_sankranti - b->jd_sankranti) < 1e-6;
+}
+
+static void day_of_2025(int i, int *y, int *m, int *d)
+{
+    jd_to_gregorian(gregorian_to_jd(2025, 1, 1) + i, y, m, d);
+}
+
+/* Number of days in [0, n) whose results differ from the references,
+ * visiting them in a scattered order so the per-thread caches miss */
+static int check_days(int li, int n, int stride)
+{
+    const Location *loc = li ? &CHENNAI : &DELHI;
+    int bad = 0;
+    for (int k = 0; k < n; k++) {
+        int i = (k * stride) % n, y, m, d;
+        day_of_2025(i, &y, &m, &d);
+        HinduDate hd = gregorian_to_hindu(y, m, d, loc);
+        if (!hindu_equal(&hd, &ref_hindu[li][i])) bad++;
+        for (int t = 0; t < N_SOLAR; t++) {
+            SolarDate sd = gregorian_to_solar(y, m, d, loc, (SolarCalendarType)t);
+            if (!solar_equal(&sd, &ref_solar[li][t][i])) bad++;
+        }
+    }
+    return bad;
+}
+
+static void compute_references(void)
+{
+    for (int li = 0; li < 2; li++) {
+        const Location *loc = li ? &CHENNAI : &DELHI;
+        for (int i = 0; i < N_DAYS; i++) {
+            int y, m, d;
+            day_of_2025(i, &y, &m, &d);
+            ref_hindu[li][i] = gregorian_to_hindu(y, m, d, loc);
+            for (int t = 0; t < N_SOLAR; t++)
+                ref_solar[li][t][i] = gregorian_to_solar(y, m, d, loc, (SolarCalendarType)t);
+        }
+    }
+}
+
+static void test_basic(void)
+{
+    printf("\n--- Single process ---\n");
+    ShmCacheStats st;
+    ASSERT_EQ(shmcache_stats(&st), -1, "no stats before attaching");
+    ASSERT_EQ(shmcache_open(seg_name, 10000), 0, "create segment");
+    shmcache_stats(&st);
+    ASSERT_EQ(st.capacity, 16384, "slots rounded up to a power of two");
+    ASSERT_EQ(st.generation, 1, "first generation");
+
+    ASSERT_EQ(check_days(0, N_DAYS, 1), 0, "first pass matches uncached results");
+    shmcache_stats(&st);
+    ASSERT_EQ(st.hits, 0, "first pass: no hits");
+    ASSERT_EQ(st.inserts, N_DAYS * 5, "first pass: every result stored");
+
+    ASSERT_EQ(check_days(0, N_DAYS, 7), 0, "second pass matches uncached results");
+    shmcache_stats(&st);
+    ASSERT_EQ(st.hits, N_DAYS * 5, "second pass: every lookup hits");
+
+    /* A location that does not quantize exactly is never cached */
+    Location odd = { 28.61391234567, 77.2090, 0.0, 5.5 };
+    HinduDate a = gregorian_to_hindu(2025, 3, 1, &odd);
+    HinduDate b = gregorian_to_hindu(2025, 3, 1, &odd);
+    shmcache_stats(&st);
+    ASSERT_EQ(st.bypassed, 2, "sub-micro-degree latitude bypassed");
+    ASSERT_EQ(st.hits, N_DAYS * 5, "no hits for it");
+    ASSERT_EQ(hindu_equal(&a, &b), 1, "bypassed results consistent");
+
+    /* Fractional altitude and a half-hour offset: altitude bypasses */
+    Location alt = { 13.0827, 80.2707, 6.5, 5.5 };
+    gregorian_to_solar(2025, 3, 1, &alt, SOLAR_CAL_TAMIL);
+    shmcache_stats(&st);
+    ASSERT_EQ(st.bypassed, 3, "fractional altitude bypassed");
+
+    unsigned gen = shmcache_invalidate();
+    ASSERT_EQ(gen, 2, "invalidate bumps the generation");
+    ASSERT_EQ(check_days(0, 30, 1), 0, "after invalidate: still correct");
+    shmcache_stats(&st);
+    ASSERT_EQ(st.hits, N_DAYS * 5, "after invalidate: old entries stale");
+    ASSERT_EQ(st.evictions, 0, "stale slots reused without eviction");
+    shmcache_close();
+    ASSERT_EQ(shmcache_stats(&st), -1, "detached");
+}
+
+static void test_processes(void)
+{
+    printf("\n--- Across processes ---\n");
+    ShmCacheStats st;
+    ASSERT_EQ(shmcache_open(seg_name, 0), 0, "reattach");
+    shmcache_stats(&st);
+    ASSERT_EQ(st.capacity, 16384, "existing size kept");
+    unsigned long hits0 = st.hits;
+
+    /* Children fill Chennai; the parent then only reads */
+    pid_t kids[3];
+    for (int k = 0; k < 3; k++) {
+        kids[k] = fork();
+        if (kids[k] == 0) {
+            int rc = shmcache_open(seg_name, 0) == 0 ? check_days(1, N_DAYS, 3 + 2 * k) : 1;
+            shmcache_close();
+            _exit(rc == 0 ? 0 : 1);
+        }
+    }
+    int failed = 0;
+    for (int k = 0; k < 3; k++) {
+        int status;
+        waitpid(kids[k], &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) failed++;
+    }
+    ASSERT_EQ(failed, 0, "concurrent child processes got correct results");
+
+    shmcache_stats(&st);
+    unsigned long hits1 = st.hits;
+    ASSERT_EQ(st.hits > hits0, 1, "children shared entries");
+    ASSERT_EQ(check_days(1, N_DAYS, 11), 0, "parent reads children's entries");
+    shmcache_stats(&st);
+    ASSERT_EQ((long)(st.hits - hits1), N_DAYS * 5, "every parent lookup hits");
+    shmcache_close();
+}
+
+typedef struct {
+    int index;
+    int bad;
+} Worker;
+
+static void *worker_main(void *arg)
+{
+    Worker *w = arg;
+    astro_init(NULL);
+    w->bad = 0;
+    for (int round = 0; round < 3; round++)
+        w->bad += check_days(w->index & 1, N_DAYS, 1 + 4 * w->index + round * 2);
+    astro_close();
+    return NULL;
+}
+
+static void test_eviction(void)
+{
+    printf("\n--- Small table, threads ---\n");
+    char small[80];
+    snprintf(small, sizeof(small), "%s-small", seg_name);
+    shmcache_unlink(small);
+    ASSERT_EQ(shmcache_open(small, 256), 0, "create small segment");
+
+    /* 3,650 keys through 256 slots */
+    pthread_t tids[4];
+    Worker w[4];
+    for (int t = 0; t < 4; t++) {
+        w[t].index = t;
+        pthread_create(&tids[t], NULL, worker_main, &w[t]);
+    }
+    int bad = 0;
+    for (int t = 0; t < 4; t++) {
+        pthread_join(tids[t], NULL);
+        bad += w[t].bad;
+    }
+    ASSERT_EQ(bad, 0, "results correct under eviction");
+
+    ShmCacheStats st;
+    shmcache_stats(&st);
+    ASSERT_EQ(st.evictions > 0, 1, "entries evicted");
+    ASSERT_EQ(st.hits + st.misses, 4L * 3 * N_DAYS * 5, "every lookup counted");
+    printf("  %lu hits, %lu misses, %lu evictions, %lu contended\n",
+           st.hits, st.misses, st.evictions, st.contended);
+    shmcache_close();
+    ASSERT_EQ(shmcache_unlink(small), 0, "unlink small segment");
+}
+
+static void test_rejected(void)
+{
+    printf("\n--- Incompatible segments ---\n");
+    char junk[80];
+    snprintf(junk, sizeof(junk), "%s-junk", seg_name);
+    shmcache_unlink(junk);
+    int fd = shm_open(junk, O_RDWR | O_CREAT, 0600);
+    ASSERT_EQ(fd >= 0, 1, "create junk segment");
+    if (fd < 0) return;
+    char bytes[4096];
+    memset(bytes, 'x', sizeof(bytes));
+    ASSERT_EQ(write(fd, bytes, sizeof(bytes)), (long)sizeof(bytes), "fill junk segment");
+    close(fd);
+    printf("  (one 'not a calendar cache' message expected)\n");
+    fflush(stdout);
+    ASSERT_EQ(shmcache_open(junk, 0), -1, "junk segment refused");
+    HinduDate hd = gregorian_to_hindu(2025, 1, 14, &DELHI);
+    ASSERT_EQ(hindu_equal(&hd, &ref_hindu[0][13]), 1, "works unattached after refusal");
+    ASSERT_EQ(shmcache_unlink(junk), 0, "unlink junk segment");
+    ASSERT_EQ(shmcache_unlink(junk), -1, "second unlink fails");
+}
+
+int main(void)
+{
+    astro_init(NULL);
+    snprintf(seg_name, sizeof(seg_name), "/hc-test-shmcache-%ld", (long)getpid());
+    shmcache_unlink(seg_name);
+
+    compute_references();
+    test_basic();
+    test_processes();
+    test_eviction();
+    test_rejected();
+    shmcache_unlink(seg_name);
+
+    astro_close();
+
+    printf("\n=== Shared cache tests: %d/%d passed ===\n", tests_passed, tests_run);
+    return (tests_passed == tests_run) ? 0 : 1;
+}
@@ -0,0 +1,250 @@
+#include "snapshot.h"
+#include "astro.h"
+#include "panchang.h"
+#include "solar.h"
+#include "date_utils.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define ASSERT_EQ(actual, expected, msg) do { \
+    tests_run++; \
+    long _a = (actual), _e = (expected); \
+    if (_a == _e) { \
+        tests_passed++; \
+    } else { \
+        printf("  FAIL: %s (got %ld, expected %ld)\n", msg, _a, _e); \
+    } \
+} while (0)
+
+#define N_DAYS 400
+#define N_SOLAR 4
+#define SNAP_PATH "build/test_snapshot.hcs"
+#define BAD_PATH "build/test_snapshot_bad.hcs"
+
+static const Location LOCS[2] = {
+    DEFAULT_LOCATION,
+    { 40.7128, -74.0060, 0.0, -5.0 },
+};
+
+/* Random days 1900-2050 at two locations, computed with the store off */
+static double sample_jd[N_DAYS];
+static HinduDate ref_hindu[N_DAYS];
+static SolarDate ref_solar[N_DAYS][N_SOLAR];
+static long n_sunrises;  /* distinct (day, location) sunrises in the sample */
+
+static int hindu_equal(const HinduDate *a, const HinduDate *b)
+{
+    return a->year_saka == b->year_saka && a->year_vikram == b->year_vikram &&
+           a->masa == b->masa && a->is_adhika_masa == b->is_adhika_masa &&
+           a->paksha == b->paksha && a->tithi == b->tithi &&
+           a->is_adhika_tithi == b->is_adhika_tithi;
+}
+
+/* jd_sankranti varies in its last bits with where the search started */
+static int solar_equal(const SolarDate *a, const SolarDate *b)
+{
+    return a->year == b->year && a->month == b->month && a->day == b->day &&
+           a->rashi == b->rashi && fabs(a->jd_sankranti - b->jd_sankranti) < 1e-6;
+}
+
+/* Compute the sample on a new thread (empty per-thread caches, like a
+ * fresh process); the result is the number of mismatches */
+static void *sample_thread(void *arg)
+{
+    long *bad = arg;
+    astro_init(NULL);
+    *bad = 0;
+    for (int i = 0; i < N_DAYS; i++) {
+        int y, m, d;
+        jd_to_gregorian(sample_jd[i], &y, &m, &d);
+        const Location *loc = &LOCS[i % 2];
+        HinduDate hd = gregorian_to_hindu(y, m, d, loc);
+        if (!hindu_equal(&hd, &ref_hindu[i])) (*bad)++;
+        for (int t = 0; t < N_SOLAR; t++) {
+            SolarDate sd = gregorian_to_solar(y, m, d, loc, (SolarCalendarType)t);
+            if (!solar_equal(&sd, &ref_solar[i][t])) (*bad)++;
+        }
+    }
+    astro_close();
+    return NULL;
+}
+
+static long run_fresh_thread(void)
+{
+    pthread_t tid;
+    long bad = -1;
+    pthread_create(&tid, NULL, sample_thread, &bad);
+    pthread_join(tid, NULL);
+    return bad;
+}
+
+static void compute_references(void)
+{
+    srand(36);
+    double jd0 = gregorian_to_jd(1900, 1, 1), span = gregorian_to_jd(2051, 1, 1) - jd0;
+    for (int i = 0; i < N_DAYS; i++) {
+        sample_jd[i] = jd0 + (double)(rand() % (int)span);
+        int y, m, d;
+        jd_to_gregorian(sample_jd[i], &y, &m, &d);
+        ref_hindu[i] = gregorian_to_hindu(y, m, d, &LOCS[i % 2]);
+        for (int t = 0; t < N_SOLAR; t++)
+            ref_solar[i][t] = gregorian_to_solar(y, m, d, &LOCS[i % 2], (SolarCalendarType)t);
+    }
+}
+
+static void test_fill_and_save(void)
+{
+    printf("\n--- Filling and saving ---\n");
+    SnapshotStats st;
+    snapshot_stats(&st);
+    ASSERT_EQ(st.lunations + st.sankrantis + st.sunrises, 0, "store empty while disabled");
+
+    snapshot_enable();
+    ASSERT_EQ(run_fresh_thread(), 0, "results unchanged while filling");
+    snapshot_stats(&st);
+    ASSERT_EQ(st.lunations > N_DAYS / 2 && st.lunations <= N_DAYS, 1, "lunations stored");
+    ASSERT_EQ(st.sankrantis > 0, 1, "sankrantis stored");
+    ASSERT_EQ(st.month_starts > 0, 1, "month starts stored");
+    ASSERT_EQ(st.sunrises > N_DAYS && st.sunrises <= 2 * N_DAYS, 1,
+              "today's and yesterday's sunrises stored");
+    n_sunrises = st.sunrises;
+
+    /* A second fresh thread finds everything */
+    long misses = st.misses;
+    ASSERT_EQ(run_fresh_thread(), 0, "results unchanged from the store");
+    snapshot_stats(&st);
+    ASSERT_EQ(st.misses, misses, "no misses on the second pass");
+
+    long records = st.lunations + st.sankrantis + st.month_starts + st.sunrises;
+    ASSERT_EQ(snapshot_save(SNAP_PATH), records, "every record saved");
+}
+
+static void test_load(void)
+{
+    printf("\n--- Warm start ---\n");
+    SnapshotStats saved, st;
+    snapshot_stats(&saved);
+    snapshot_disable();
+    snapshot_stats(&st);
+    ASSERT_EQ(st.lunations + st.sunrises + st.hits, 0, "disable empties the store");
+
+    long records = saved.lunations + saved.sankrantis + saved.month_starts + saved.sunrises;
+    ASSERT_EQ(snapshot_load(SNAP_PATH), records, "every record loaded");
+    snapshot_stats(&st);
+    ASSERT_EQ(st.lunations, saved.lunations, "lunations restored");
+    ASSERT_EQ(st.sankrantis, saved.sankrantis, "sankrantis restored");
+    ASSERT_EQ(st.month_starts, saved.month_starts, "month starts restored");
+    ASSERT_EQ(st.sunrises, saved.sunrises, "sunrises restored");
+
+    ASSERT_EQ(run_fresh_thread(), 0, "loaded store gives the same results");
+    snapshot_stats(&st);
+    ASSERT_EQ(st.misses, 0, "warm start: no misses");
+    ASSERT_EQ(st.hits > 0, 1, "warm start: hits");
+
+    /* Loading the same file again merges without duplicates */
+    ASSERT_EQ(snapshot_load(SNAP_PATH), records, "reload");
+    snapshot_stats(&st);
+    ASSERT_EQ(st.lunations + st.sankrantis + st.month_starts + st.sunrises, records,
+              "no duplicate records");
+
+    /* Re-saving the loaded store gives a file of the same size */
+    ASSERT_EQ(snapshot_save(BAD_PATH), records, "save again");
+    FILE *a = fopen(SNAP_PATH, "rb"), *b = fopen(BAD_PATH, "rb");
+    long size_a = -1, size_b = -2;
+    if (a && b) {
+        fseek(a, 0, SEEK_END);
+        fseek(b, 0, SEEK_END);
+        size_a = ftell(a);
+        size_b = ftell(b);
+    }
+    if (a) fclose(a);
+    if (b) fclose(b);
+    ASSERT_EQ(size_b, size_a, "same size");
+    ASSERT_EQ(size_a, SNAPSHOT_HEADER_SIZE + saved.lunations * 24 + saved.sankrantis * 16 +
+                      2 * 32 + (saved.month_starts + saved.sunrises) * 24, "documented layout");
+}
+
+/* Write a copy of the snapshot with one byte changed (or truncated) */
+static void write_variant(long offset, int value, long truncate_by)
+{
+    FILE *in = fopen(SNAP_PATH, "rb"), *out = fopen(BAD_PATH, "wb");
+    if (!in || !out) return;
+    fseek(in, 0, SEEK_END);
+    long size = ftell(in);
+    fseek(in, 0, SEEK_SET);
+    for (long i = 0; i < size - truncate_by; i++) {
+        int c = fgetc(in);
+        fputc(i == offset ? value : c, out);
+    }
+    fclose(in);
+    fclose(out);
+}
+
+static void test_rejected(void)
+{
+    printf("\n--- Rejected files (messages expected) ---\n");
+    fflush(stdout);
+    SnapshotStats before, st;
+    snapshot_stats(&before);
+
+    ASSERT_EQ(snapshot_load("build/no_such_snapshot.hcs"), -1, "missing file");
+    write_variant(0, 'X', 0);
+    ASSERT_EQ(snapshot_load(BAD_PATH), -1, "bad magic");
+    write_variant(8, SNAPSHOT_VERSION + 1, 0);
+    ASSERT_EQ(snapshot_load(BAD_PATH), -1, "other layout version");
+    write_variant(12, 3, 0);
+    ASSERT_EQ(snapshot_load(BAD_PATH), -1, "other backend");
+    write_variant(-1, 0, 24);
+    ASSERT_EQ(snapshot_load(BAD_PATH), -1, "truncated");
+    write_variant(SNAPSHOT_HEADER_SIZE + 16, 13, 0);
+    ASSERT_EQ(snapshot_load(BAD_PATH), -1, "rashi out of range");
+
+    snapshot_stats(&st);
+    ASSERT_EQ(st.lunations == before.lunations && st.sunrises == before.sunrises, 1,
+              "store unchanged by rejected files");
+    remove(BAD_PATH);
+}
+
+static void test_threads(void)
+{
+    printf("\n--- Concurrent fill ---\n");
+    snapshot_disable();
+    snapshot_enable();
+    pthread_t tids[4];
+    long bad[4];
+    for (int t = 0; t < 4; t++)
+        pthread_create(&tids[t], NULL, sample_thread, &bad[t]);
+    long total = 0;
+    for (int t = 0; t < 4; t++) {
+        pthread_join(tids[t], NULL);
+        total += bad[t];
+    }
+    ASSERT_EQ(total, 0, "four threads filling one store");
+    SnapshotStats st;
+    snapshot_stats(&st);
+    ASSERT_EQ(st.sunrises, n_sunrises, "each sunrise stored once");
+    snapshot_disable();
+}
+
+int main(void)
+{
+    astro_init(NULL);
+
+    compute_references();
+    test_fill_and_save();
+    test_load();
+    test_rejected();
+    test_threads();
+    remove(SNAP_PATH);
+
+    astro_close();
+
+    printf("\n=== Snapshot tests: %d/%d passed ===\n", tests_passed, tests_run);
+    return (tests_passed == tests_run) ? 0 : 1;
+}
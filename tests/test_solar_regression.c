@@ -1,6 +1,7 @@
 #include "solar.h"
 #include "astro.h"
 #include "date_utils.h"
+#include "csvmap.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -84,29 +85,21 @@ static void test_calendar(SolarCalendarType type, const char *base,
         return;
     }
 
-    FILE *f = fopen(csv_path, "r");
-    if (!f) {
+    CsvFile csv;
+    if (!csv_open(&csv, csv_path)) {
         printf("ERROR: cannot open %s\n", csv_path);
         return;
     }
 
     Location loc = DEFAULT_LOCATION;
-    char line[256];
     int months_checked = 0;
 
-    /* Skip header */
-    if (!fgets(line, sizeof(line), f)) {
-        fclose(f);
-        return;
-    }
-
-    while (fgets(line, sizeof(line), f)) {
+    while (csv_next(&csv)) {
         int exp_month, exp_year, exp_length, gy, gm, gd;
-        char month_name[64];
 
-        if (sscanf(line, "%d,%d,%d,%d,%d,%d,%63s",
-                   &exp_month, &exp_year, &exp_length,
-                   &gy, &gm, &gd, month_name) != 7)
+        if (!csv_int(&csv, 0, &exp_month) || !csv_int(&csv, 1, &exp_year) ||
+            !csv_int(&csv, 2, &exp_length) || !csv_int(&csv, 3, &gy) ||
+            !csv_int(&csv, 4, &gm) || !csv_int(&csv, 5, &gd))
             continue;
 
         char buf[256];
@@ -143,7 +136,7 @@ static void test_calendar(SolarCalendarType type, const char *base,
         months_checked++;
     }
 
-    fclose(f);
+    csv_close(&csv);
     printf("  %s: checked %d months\n", cal_name, months_checked);
 }
 
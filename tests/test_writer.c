@@ -0,0 +1,222 @@
+#include "writer.h"
+#include "panchang.h"
+#include "solar.h"
+#include "astro.h"
+#include "date_utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define ASSERT_EQ(actual, expected, msg) do { \
+    tests_run++; \
+    long _a = (actual), _e = (expected); \
+    if (_a == _e) { \
+        tests_passed++; \
+    } else { \
+        printf("  FAIL: %s (got %ld, expected %ld)\n", msg, _a, _e); \
+    } \
+} while (0)
+
+#define N_DAYS 400
+#define N_RECORDS (N_DAYS * CALENDAR_COUNT)
+
+static CalendarRecord records[N_RECORDS];
+
+/* Every calendar for N_DAYS days from 2023-12-01 at New Delhi */
+static void build_records(void)
+{
+    Location loc = DEFAULT_LOCATION;
+    double jd0 = gregorian_to_jd(2023, 12, 1);
+    int n = 0;
+    for (int i = 0; i < N_DAYS; i++) {
+        int y, m, d;
+        jd_to_gregorian(jd0 + i, &y, &m, &d);
+        HinduDate hd = gregorian_to_hindu(y, m, d, &loc);
+        calendar_record_lunisolar(&records[n++], y, m, d, &hd);
+        for (int t = 0; t < 4; t++) {
+            SolarDate sd = gregorian_to_solar(y, m, d, &loc, (SolarCalendarType)t);
+            calendar_record_solar(&records[n++], y, m, d, (SolarCalendarType)t, &sd);
+        }
+    }
+}
+
+static char *slurp(FILE *f, long *len)
+{
+    fseek(f, 0, SEEK_END);
+    *len = ftell(f);
+    rewind(f);
+    char *s = malloc(*len + 1);
+    if (fread(s, 1, *len, f) != (size_t)*len) *len = -1;
+    s[*len > 0 ? *len : 0] = '\0';
+    return s;
+}
+
+/* Write all records to a temporary stream; returns the bytes */
+static char *write_all(OutputFormat format, const char *name, long *len)
+{
+    FILE *f = tmpfile();
+    RecordWriter w;
+    writer_init(&w, f, format);
+    writer_set_location(&w, 7, name);
+    for (int i = 0; i < N_RECORDS; i++)
+        writer_record(&w, &records[i]);
+    ASSERT_EQ(w.records, N_RECORDS, "records counted");
+    ASSERT_EQ(writer_close(&w), 0, "close succeeds");
+    char *s = slurp(f, len);
+    fclose(f);
+    return s;
+}
+
+/* CSV rows equal the same fields formatted with snprintf() */
+static void test_csv(void)
+{
+    printf("\n--- CSV ---\n");
+    long len;
+    char *s = write_all(OUTPUT_CSV, "Delhi", &len);
+    char *line = strtok(s, "\n");
+    ASSERT_EQ(strcmp(line, "location,date,weekday,calendar,year,month,month_name,"
+                           "adhika_month,paksha,day,adhika_day"), 0, "header");
+
+    int bad = 0, n = 0;
+    while ((line = strtok(NULL, "\n")) != NULL && n < N_RECORDS) {
+        const CalendarRecord *r = &records[n++];
+        int luni = (r->calendar == CALENDAR_LUNISOLAR);
+        char expect[256];
+        snprintf(expect, sizeof(expect), "Delhi,%04d-%02d-%02d,%s,%s,%d,%d,%s,%d,%s,%d,%d",
+                 r->greg_year, r->greg_month, r->greg_day,
+                 day_of_week_short(r->weekday), calendar_name(r->calendar),
+                 r->year, r->month,
+                 luni ? MASA_NAMES[r->month]
+                      : solar_month_name(r->month, (SolarCalendarType)(r->calendar - 1)),
+                 r->is_adhika_month,
+                 !luni ? "" : r->paksha == SHUKLA_PAKSHA ? "Shukla" : "Krishna",
+                 r->day, r->is_adhika_day);
+        if (strcmp(line, expect) != 0) {
+            if (bad == 0) printf("  got    %s\n  expect %s\n", line, expect);
+            bad++;
+        }
+    }
+    ASSERT_EQ(n, N_RECORDS, "all rows present");
+    ASSERT_EQ(bad, 0, "rows differing from snprintf");
+    free(s);
+}
+
+static void test_jsonl(void)
+{
+    printf("\n--- JSON Lines ---\n");
+    long len;
+    char *s = write_all(OUTPUT_JSONL, "Sh\"ri\\nagar", &len);
+    int lines = 0;
+    for (long i = 0; i < len; i++)
+        if (s[i] == '\n') lines++;
+    ASSERT_EQ(lines, N_RECORDS, "one line per record (no header)");
+
+    /* 2024-04-09: Chaitra Shukla 1 (Ugadi), Tamil Panguni 27 */
+    char *ugadi = strstr(s, "\"date\":\"2024-04-09\",\"weekday\":\"Tue\",\"calendar\":\"lunisolar\"");
+    ASSERT_EQ(ugadi != NULL, 1, "Ugadi record present");
+    if (ugadi) {
+        char *end = strchr(ugadi, '\n');
+        *end = '\0';
+        ASSERT_EQ(strcmp(ugadi, "\"date\":\"2024-04-09\",\"weekday\":\"Tue\","
+                                "\"calendar\":\"lunisolar\",\"year\":1946,\"month\":1,"
+                                "\"month_name\":\"Chaitra\",\"adhika_month\":0,"
+                                "\"paksha\":\"Shukla\",\"day\":1,\"adhika_day\":0}"), 0,
+                  "Ugadi record fields");
+        *end = '\n';
+    }
+    ASSERT_EQ(strncmp(s, "{\"location\":\"Sh\\\"ri\\\\nagar\",", 28), 0, "name escaped");
+    ASSERT_EQ(strstr(s, "\"calendar\":\"tamil\",\"year\":1945,\"month\":12,"
+                        "\"month_name\":\"Panguni\",\"adhika_month\":0,"
+                        "\"paksha\":null,\"day\":27,") != NULL, 1, "solar paksha null");
+    free(s);
+}
+
+static void test_binary(void)
+{
+    printf("\n--- Binary ---\n");
+    long len;
+    char *s = write_all(OUTPUT_BINARY, "ignored", &len);
+    ASSERT_EQ(len, WRITER_BINARY_HEADER_SIZE + (long)N_RECORDS * WRITER_BINARY_RECORD_SIZE,
+              "file size");
+    ASSERT_EQ(memcmp(s, "HCALREC\x01\x10\x00", 10), 0, "header magic and record size");
+
+    int bad = 0;
+    for (int i = 0; i < N_RECORDS; i++) {
+        CalendarRecord r;
+        const unsigned char *p = (const unsigned char *)s + WRITER_BINARY_HEADER_SIZE +
+                                 (size_t)i * WRITER_BINARY_RECORD_SIZE;
+        CalendarRecord expect = records[i];
+        expect.location = 7;
+        if (expect.calendar != CALENDAR_LUNISOLAR) expect.paksha = SHUKLA_PAKSHA;
+        if (!calendar_record_decode(p, &r) || memcmp(&r, &expect, sizeof(r)) != 0)
+            bad++;
+    }
+    ASSERT_EQ(bad, 0, "decoded records differ");
+    free(s);
+}
+
+/* In-memory writers appended in order give the same bytes as one stream */
+static void test_append(void)
+{
+    printf("\n--- In-memory writers and append ---\n");
+    OutputFormat formats[] = {OUTPUT_CSV, OUTPUT_JSONL, OUTPUT_BINARY};
+    for (int fi = 0; fi < 3; fi++) {
+        long ref_len;
+        char *ref = write_all(formats[fi], "Delhi", &ref_len);
+
+        FILE *f = tmpfile();
+        RecordWriter w;
+        writer_init(&w, f, formats[fi]);
+        for (int start = 0; start < N_RECORDS; start += 333) {
+            RecordWriter part;
+            writer_init(&part, NULL, formats[fi]);
+            writer_set_location(&part, 7, "Delhi");
+            for (int i = start; i < start + 333 && i < N_RECORDS; i++)
+                writer_record(&part, &records[i]);
+            writer_append(&w, &part);
+            ASSERT_EQ(part.len, 0, "source emptied");
+            writer_close(&part);
+        }
+        ASSERT_EQ(w.records, N_RECORDS, "appended record count");
+        writer_close(&w);
+        long len;
+        char *s = slurp(f, &len);
+        fclose(f);
+        ASSERT_EQ(len == ref_len && memcmp(s, ref, len) == 0, 1, "same bytes as one stream");
+        free(s);
+        free(ref);
+    }
+}
+
+static void test_parse_output_format(void)
+{
+    printf("\n--- parse_output_format ---\n");
+    OutputFormat fmt;
+    ASSERT_EQ(parse_output_format("csv", &fmt), 1, "csv");
+    ASSERT_EQ(fmt, OUTPUT_CSV, "csv value");
+    ASSERT_EQ(parse_output_format("jsonl", &fmt), 1, "jsonl");
+    ASSERT_EQ(fmt, OUTPUT_JSONL, "jsonl value");
+    ASSERT_EQ(parse_output_format("bin", &fmt), 1, "bin");
+    ASSERT_EQ(fmt, OUTPUT_BINARY, "bin value");
+    ASSERT_EQ(parse_output_format("xml", &fmt), 0, "xml rejected");
+}
+
+int main(void)
+{
+    astro_init(NULL);
+    build_records();
+
+    test_csv();
+    test_jsonl();
+    test_binary();
+    test_append();
+    test_parse_output_format();
+
+    astro_close();
+
+    printf("\n=== Writer tests: %d/%d passed ===\n", tests_passed, tests_run);
+    return (tests_passed == tests_run) ? 0 : 1;
+}
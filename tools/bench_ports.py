@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+"""Run one workload through the C, Rust, Java and Swift ports and compare.
+
+Builds each port's port-bench driver whose toolchain is installed (cargo,
+java + gradle wrapper, swift), runs it on the workload file, checks its
+rows against the C rows, and prints throughput, wall time and peak RSS in
+one table.  Throughput counts the conversions only; wall time includes
+start-up (JVM, ephemeris tables) and writing the rows.  Peak RSS is read
+from /proc and shows as "-" elsewhere.  Ports without a toolchain are
+listed as skipped.
+
+Usage: python3 tools/bench_ports.py -c C_DRIVER [-o OUT_DIR] WORKLOAD
+
+  make bench-ports      (builds build/port_bench and runs this)
+
+Exits non-zero if a port fails or its rows differ from the C port's.
+"""
+
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+import time
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+def build_rust():
+    if not shutil.which('cargo'):
+        return None, 'cargo not found'
+    rc = subprocess.call(['cargo', 'build', '--quiet', '--release', '--bin', 'port-bench'],
+                         cwd=os.path.join(ROOT, 'rust'))
+    if rc != 0:
+        return None, 'cargo build failed'
+    return [os.path.join(ROOT, 'rust', 'target', 'release', 'port-bench')], None
+
+
+def build_java():
+    if not shutil.which('java'):
+        return None, 'java not found'
+    java_dir = os.path.join(ROOT, 'java')
+    rc = subprocess.call([os.path.join(java_dir, 'gradlew'), '--quiet', 'classes'], cwd=java_dir)
+    if rc != 0:
+        return None, 'gradle build failed'
+    classes = os.path.join(java_dir, 'build', 'classes', 'java', 'main')
+    return ['java', '-cp', classes, 'com.hindu.calendar.cli.PortBench'], None
+
+
+def build_swift():
+    if not shutil.which('swift'):
+        return None, 'swift not found'
+    swift_dir = os.path.join(ROOT, 'swift')
+    rc = subprocess.call(['swift', 'build', '--quiet', '-c', 'release', '--product', 'port-bench'],
+                         cwd=swift_dir)
+    if rc != 0:
+        return None, 'swift build failed'
+    return [os.path.join(swift_dir, '.build', 'release', 'port-bench')], None
+
+
+def run(cmd, workload, out_path):
+    """Run a driver; returns (rows, compute_s, wall_s, peak_rss_mb) or an error string.
+
+    The drivers report their own peak RSS: getrusage() of a child counts
+    the memory of the process that forked it, i.e. this interpreter.
+    """
+    with open(out_path, 'w') as out:
+        t0 = time.perf_counter()
+        proc = subprocess.run(cmd + [workload], stdout=out, stderr=subprocess.PIPE)
+        wall = time.perf_counter() - t0
+    err = proc.stderr.decode(errors='replace')
+    if proc.returncode != 0:
+        last = err.strip().splitlines()[-1] if err.strip() else ''
+        return 'exit status %d: %s' % (proc.returncode, last)
+    stats = {}
+    for line in err.splitlines():
+        for field in line.split():
+            key, _, value = field.partition('=')
+            if key in ('rows', 'compute_ns', 'peak_rss_kb'):
+                stats[key] = int(value)
+    if len(stats) != 3:
+        return 'no "rows=N compute_ns=T peak_rss_kb=K" line on stderr'
+    return stats['rows'], stats['compute_ns'] / 1e9, wall, stats['peak_rss_kb'] / 1024.0
+
+
+def compare(path, ref_path):
+    """'reference', 'match', or how many rows differ from the C rows."""
+    with open(path) as f, open(ref_path) as g:
+        rows, ref = f.read().splitlines(), g.read().splitlines()
+    if len(rows) != len(ref):
+        return '%d rows, C has %d' % (len(rows), len(ref))
+    bad = [i for i in range(len(rows)) if rows[i] != ref[i]]
+    if not bad:
+        return 'match'
+    return '%d rows differ, first: %s' % (len(bad), rows[bad[0]])
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    ap.add_argument('-c', dest='c_driver', required=True, help='C port-bench binary')
+    ap.add_argument('-o', dest='out_dir', default=os.path.join(ROOT, 'build', 'ports'),
+                    help='directory for each port\'s rows (default: build/ports)')
+    ap.add_argument('workload')
+    args = ap.parse_args()
+
+    os.makedirs(args.out_dir, exist_ok=True)
+    ports = [
+        ('c', lambda: ([os.path.abspath(args.c_driver)], None)),
+        ('rust', build_rust),
+        ('java', build_java),
+        ('swift', build_swift),
+    ]
+
+    print('Workload: %s' % args.workload)
+    print('%-6s %9s %10s %11s %8s %9s  %s' % ('port', 'rows', 'compute s', 'rows/s',
+                                             'wall s', 'RSS MB', 'output'))
+    ref_path = None
+    failed = False
+    for name, build in ports:
+        cmd, why = build()
+        if cmd is None:
+            print('%-6s %9s  skipped: %s' % (name, '-', why))
+            continue
+        out_path = os.path.join(args.out_dir, name + '.csv')
+        result = run(cmd, args.workload, out_path)
+        if isinstance(result, str):
+            print('%-6s %9s  failed: %s' % (name, '-', result))
+            failed = True
+            if name == 'c':
+                break
+            continue
+        rows, compute, wall, rss = result
+        if name == 'c':
+            ref_path, verdict = out_path, 'reference'
+        else:
+            verdict = compare(out_path, ref_path)
+            failed |= verdict != 'match'
+        print('%-6s %9d %10.3f %11.0f %8.2f %9s  %s' % (name, rows, compute,
+                                                       rows / compute if compute else 0,
+                                                       wall, '%.1f' % rss if rss else '-',
+                                                       verdict))
+    print('\nRows per port: %s/{port}.csv' % args.out_dir)
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,386 @@
+/*
+ * gen_web_json - Generate the validation web page's per-month JSON
+ *
+ * Usage:
+ *   gen_web_json [-o DIR] [-r REINGOLD_CSV] [-j THREADS]
+ *
+ * Writes, for 1900-2050 at New Delhi and the compiled-in backend:
+ *   DIR/YYYY-MM.json             lunisolar days (1,812 files)
+ *   DIR/{tamil,bengali,odia,malayalam}/YYYY-MM.json
+ *                                solar days (1,812 files per calendar)
+ *
+ * DIR defaults to validation/web/data/{moshier,se}.  The files are the
+ * ones tools/csv_to_json.py and tools/csv_to_solar_json.py used to
+ * produce from the gen_ref / gen_solar_ref CSVs, byte for byte, but are
+ * computed directly: THREADS workers (default: online CPUs) take one
+ * Gregorian year at a time, walk its days in order so the per-thread
+ * caches stay warm, and write each month as soon as it is formatted.
+ *
+ * Lunisolar days carry Reingold (hindu-lunar-from-fixed) fields where
+ * they differ, from REINGOLD_CSV (default
+ * validation/reingold/reingold_1900_2050.csv; skipped with a warning if
+ * missing).  Solar files only contain days of months that lie wholly
+ * inside the range, as the month CSVs do: the month in progress on
+ * 1900-01-01 and the one in progress on 2050-12-31 are left out.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "astro.h"
+#include "tithi.h"
+#include "masa.h"
+#include "solar.h"
+#include "date_utils.h"
+#include "csvmap.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define MIN_YEAR 1900
+#define MAX_YEAR 2050
+
+#ifdef USE_SWISSEPH
+#define BACKEND_NAME "se"
+#else
+#define BACKEND_NAME "moshier"
+#endif
+
+static const struct { const char *dir, *era; } SOLAR_CALS[] = {
+    [SOLAR_CAL_TAMIL]     = {"tamil",     "Saka"},
+    [SOLAR_CAL_BENGALI]   = {"bengali",   "Bangabda"},
+    [SOLAR_CAL_ODIA]      = {"odia",      "Saka"},
+    [SOLAR_CAL_MALAYALAM] = {"malayalam", "Kollam"},
+};
+#define N_SOLAR_CALS 4
+
+/* Reingold values by day index from MIN_YEAR-01-01 (present = 0: none) */
+typedef struct {
+    signed char present, tithi, masa, adhika;
+} ReingoldDay;
+
+static ReingoldDay *reingold;
+static int n_days;           /* days in MIN_YEAR..MAX_YEAR */
+static double jd_first;      /* MIN_YEAR-01-01 */
+static const char *out_dir;
+
+static int next_year = MIN_YEAR;
+static long files_written, write_errors;
+static pthread_mutex_t work_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static int days_in_month(int year, int month)
+{
+    static const int mdays[] = {0,31,28,31,30,31,30,31,31,30,31,30,31};
+    if (month == 2) {
+        if ((year % 4 == 0 && year % 100 != 0) || year % 400 == 0)
+            return 29;
+    }
+    return mdays[month];
+}
+
+/* mkdir -p */
+static int make_dirs(const char *path)
+{
+    char buf[512];
+    snprintf(buf, sizeof(buf), "%s", path);
+    for (char *p = buf + 1; ; p++) {
+        if (*p != '/' && *p != '\0') continue;
+        char c = *p;
+        *p = '\0';
+        if (mkdir(buf, 0755) != 0 && errno != EEXIST) {
+            fprintf(stderr, "ERROR: cannot create %s\n", buf);
+            return -1;
+        }
+        if (c == '\0') return 0;
+        *p = c;
+    }
+}
+
+static int load_reingold(const char *path)
+{
+    CsvFile csv;
+    if (!csv_open(&csv, path)) {
+        fprintf(stderr, "Warning: Reingold CSV not found at %s, skipping diffs\n", path);
+        return 0;
+    }
+    int col_y = csv_column(&csv, "year"), col_m = csv_column(&csv, "month"),
+        col_d = csv_column(&csv, "day"), col_t = csv_column(&csv, "hl_tithi"),
+        col_masa = csv_column(&csv, "hl_masa"), col_adh = csv_column(&csv, "hl_adhika");
+    if (col_y < 0 || col_m < 0 || col_d < 0 || col_t < 0 || col_masa < 0 || col_adh < 0) {
+        fprintf(stderr, "ERROR: %s: missing year/month/day/hl_tithi/hl_masa/hl_adhika columns\n",
+                path);
+        csv_close(&csv);
+        return -1;
+    }
+    reingold = calloc(n_days, sizeof(ReingoldDay));
+    if (!reingold) {
+        csv_close(&csv);
+        return -1;
+    }
+
+    long loaded = 0;
+    while (csv_next(&csv)) {
+        double jd;
+        int t, masa, adhika;
+        if (!csv_date_jd(&csv, col_y, col_m, col_d, &jd) || !csv_int(&csv, col_t, &t) ||
+            !csv_int(&csv, col_masa, &masa) || !csv_int(&csv, col_adh, &adhika))
+            continue;
+        long i = (long)(jd - jd_first);
+        if (i < 0 || i >= n_days) continue;
+        reingold[i] = (ReingoldDay){1, (signed char)t, (signed char)masa, (signed char)adhika};
+        loaded++;
+    }
+    csv_close(&csv);
+    fprintf(stderr, "Loaded %ld Reingold entries\n", loaded);
+    return 0;
+}
+
+/* Growable output buffer for one month */
+typedef struct {
+    char *data;
+    size_t len, cap;
+} Buf;
+
+static void buf_printf(Buf *b, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+static void buf_printf(Buf *b, const char *fmt, ...)
+{
+    for (;;) {
+        va_list ap;
+        va_start(ap, fmt);
+        int n = vsnprintf(b->data + b->len, b->cap - b->len, fmt, ap);
+        va_end(ap);
+        if (n < 0) return;
+        if ((size_t)n < b->cap - b->len) {
+            b->len += n;
+            return;
+        }
+        size_t cap = b->cap ? 2 * b->cap : 16384;
+        while (cap - b->len <= (size_t)n) cap *= 2;
+        char *grown = realloc(b->data, cap);
+        if (!grown) return;
+        b->data = grown;
+        b->cap = cap;
+    }
+}
+
+static void write_month(const Buf *b, const char *subdir, int year, int month)
+{
+    char path[640];
+    if (subdir)
+        snprintf(path, sizeof(path), "%s/%s/%04d-%02d.json", out_dir, subdir, year, month);
+    else
+        snprintf(path, sizeof(path), "%s/%04d-%02d.json", out_dir, year, month);
+
+    FILE *f = fopen(path, "w");
+    int ok = f && fwrite(b->data, 1, b->len, f) == b->len;
+    if (f && fclose(f) != 0) ok = 0;
+
+    pthread_mutex_lock(&work_lock);
+    if (ok) files_written++;
+    else write_errors++;
+    pthread_mutex_unlock(&work_lock);
+    if (!ok) fprintf(stderr, "ERROR: cannot write %s\n", path);
+}
+
+/* JSON weekday: 0 = Sunday */
+static int json_dow(double jd)
+{
+    return (day_of_week(jd) + 1) % 7;
+}
+
+static const char *tithi_json_name(int t)
+{
+    if (t == 30) return "Amavasya";
+    return TITHI_NAMES[t <= 15 ? t : t - 15];
+}
+
+static void lunisolar_year(int y, const Location *loc, Buf *b)
+{
+    /* Adhika/kshaya compare with the previous day; none before the range */
+    int prev = y > MIN_YEAR ? tithi_at_sunrise(y - 1, 12, 31, loc).tithi_num : 0;
+
+    for (int m = 1; m <= 12; m++) {
+        b->len = 0;
+        buf_printf(b, "[");
+        int nd = days_in_month(y, m);
+        for (int d = 1; d <= nd; d++) {
+            double jd = gregorian_to_jd(y, m, d);
+            int t = tithi_at_sunrise(y, m, d, loc).tithi_num;
+            MasaInfo mi = masa_for_date(y, m, d, loc);
+            int adhika_tithi = prev && t == prev;
+            int kshaya_tithi = prev && t != prev % 30 + 1 && !adhika_tithi;
+            prev = t;
+
+            buf_printf(b, "%s{\"day\":%d,\"dow\":%d,\"tithi\":%d,\"tithi_name\":\"%s\","
+                       "\"paksha\":\"%s\",\"masa\":%d,\"masa_name\":\"%s\",\"adhika\":%d,"
+                       "\"saka\":%d,\"adhika_tithi\":%s,\"kshaya_tithi\":%s",
+                       d > 1 ? "," : "", d, json_dow(jd), t, tithi_json_name(t),
+                       t <= 15 ? "Shukla" : "Krishna", (int)mi.name, MASA_NAMES[mi.name],
+                       mi.is_adhika, mi.year_saka,
+                       adhika_tithi ? "true" : "false", kshaya_tithi ? "true" : "false");
+
+            const ReingoldDay *r = reingold ? &reingold[(long)(jd - jd_first)] : NULL;
+            if (r && r->present) {
+                int differs = 0;
+                if (r->tithi != t) {
+                    buf_printf(b, ",\"hl_tithi\":%d", r->tithi);
+                    differs = 1;
+                }
+                if (r->masa != (int)mi.name) {
+                    buf_printf(b, ",\"hl_masa\":%d", r->masa);
+                    differs = 1;
+                }
+                if (r->adhika != mi.is_adhika) {
+                    buf_printf(b, ",\"hl_adhika\":%d", r->adhika);
+                    differs = 1;
+                }
+                if (differs) buf_printf(b, ",\"hl_diff\":true");
+            }
+            buf_printf(b, "}");
+        }
+        buf_printf(b, "]");
+        write_month(b, NULL, y, m);
+    }
+}
+
+static void solar_year(int y, const Location *loc, SolarCalendarType type, Buf *b)
+{
+    int month[366], year[366];
+    int nd = 0;
+    for (int m = 1; m <= 12; m++)
+        for (int d = 1; d <= days_in_month(y, m); d++, nd++) {
+            SolarDate sd = gregorian_to_solar(y, m, d, loc, type);
+            month[nd] = sd.month;
+            year[nd] = sd.year;
+        }
+
+    /* Day index (possibly negative) on which the month in progress on
+     * 1 January began; the one in progress on MIN_YEAR-01-01 is partial */
+    int run_start = 0, skip_run = (y == MIN_YEAR);
+    if (y > MIN_YEAR) {
+        double jd = gregorian_to_jd(y, 1, 1);
+        for (;;) {
+            int py, pm, pd;
+            jd_to_gregorian(jd - 1, &py, &pm, &pd);
+            SolarDate sd = gregorian_to_solar(py, pm, pd, loc, type);
+            if (sd.month != month[0] || sd.year != year[0]) break;
+            run_start--;
+            jd--;
+        }
+    }
+    /* The month in progress on MAX_YEAR-12-31 is partial too */
+    int last_run = nd - 1;
+    if (y == MAX_YEAR)
+        while (last_run > 0 && month[last_run - 1] == month[nd - 1] &&
+               year[last_run - 1] == year[nd - 1])
+            last_run--;
+    else
+        last_run = nd;
+
+    int i = 0;
+    for (int m = 1; m <= 12; m++) {
+        b->len = 0;
+        buf_printf(b, "[");
+        int first = 1;
+        for (int d = 1; d <= days_in_month(y, m); d++, i++) {
+            if (i > 0 && (month[i] != month[i - 1] || year[i] != year[i - 1])) {
+                run_start = i;
+                skip_run = 0;
+            }
+            if (skip_run || i >= last_run) continue;
+            int solar_day = i - run_start + 1;
+            buf_printf(b, "%s{\"day\":%d,\"dow\":%d,\"solar_month\":%d,"
+                       "\"solar_month_name\":\"%s\",\"solar_day\":%d,\"solar_year\":%d,"
+                       "\"era_name\":\"%s\",\"is_month_start\":%s}",
+                       first ? "" : ",", d, json_dow(gregorian_to_jd(y, m, d)), month[i],
+                       solar_month_name(month[i], type), solar_day, year[i],
+                       SOLAR_CALS[type].era, solar_day == 1 ? "true" : "false");
+            first = 0;
+        }
+        buf_printf(b, "]");
+        write_month(b, SOLAR_CALS[type].dir, y, m);
+    }
+}
+
+static void *worker(void *arg)
+{
+    (void)arg;
+    Location loc = DEFAULT_LOCATION;
+    Buf b = {0};
+
+    astro_init(NULL);
+    for (;;) {
+        pthread_mutex_lock(&work_lock);
+        int y = next_year <= MAX_YEAR ? next_year++ : 0;
+        pthread_mutex_unlock(&work_lock);
+        if (!y) break;
+
+        lunisolar_year(y, &loc, &b);
+        for (int t = 0; t < N_SOLAR_CALS; t++)
+            solar_year(y, &loc, (SolarCalendarType)t, &b);
+    }
+    astro_close();
+    free(b.data);
+    return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *reingold_path = "validation/reingold/reingold_1900_2050.csv";
+    long n_threads = sysconf(_SC_NPROCESSORS_ONLN);
+    out_dir = "validation/web/data/" BACKEND_NAME;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            out_dir = argv[++i];
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            reingold_path = argv[++i];
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            n_threads = atoi(argv[++i]);
+            if (n_threads < 1) {
+                fprintf(stderr, "ERROR: -j needs a positive thread count\n");
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "Usage: %s [-o DIR] [-r REINGOLD_CSV] [-j THREADS]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (n_threads < 1) n_threads = 1;
+
+    jd_first = gregorian_to_jd(MIN_YEAR, 1, 1);
+    n_days = (int)(gregorian_to_jd(MAX_YEAR + 1, 1, 1) - jd_first);
+    if (load_reingold(reingold_path) != 0) return 1;
+
+    if (make_dirs(out_dir) != 0) return 1;
+    for (int t = 0; t < N_SOLAR_CALS; t++) {
+        char path[600];
+        snprintf(path, sizeof(path), "%s/%s", out_dir, SOLAR_CALS[t].dir);
+        if (make_dirs(path) != 0) return 1;
+    }
+
+    pthread_t *tids = malloc(n_threads * sizeof(pthread_t));
+    if (!tids) return 1;
+    long started = 0;
+    for (; started < n_threads; started++)
+        if (pthread_create(&tids[started], NULL, worker, NULL) != 0)
+            break;
+    /* Years are claimed from a shared counter, so the threads that did
+     * start still cover all of them */
+    for (long t = 0; t < started; t++)
+        pthread_join(tids[t], NULL);
+    free(tids);
+    free(reingold);
+    if (started == 0) {
+        fprintf(stderr, "Error: cannot start a worker thread\n");
+        return 1;
+    }
+
+    fprintf(stderr, "[%s] Wrote %ld JSON files to %s (%ld threads)\n",
+            BACKEND_NAME, files_written, out_dir, started);
+    return write_errors ? 1 : 0;
+}
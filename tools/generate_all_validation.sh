@@ -1,32 +1,35 @@
 #!/bin/bash
 # Regenerate all validation data for both backends (Moshier and Swiss Ephemeris).
 # Run from the project root directory.
+#
+# Each backend is built in its own directory (build/validation-{moshier,se}),
+# so the two run side by side and the default build in build/ is untouched.
 set -euo pipefail
 
 cd "$(dirname "$0")/.."
 
-echo "=== Generating Moshier validation data ==="
-make clean && make
-mkdir -p validation/moshier
-./build/gen_ref -o validation/moshier
-./build/gen_solar_ref -o validation/moshier
-python3 tools/extract_adhika_kshaya.py validation/moshier/ref_1900_2050.csv validation/moshier/adhika_kshaya_tithis.csv
-python3 tools/csv_to_json.py --backend moshier
-python3 tools/csv_to_solar_json.py --backend moshier
+gen_backend() {
+    local name=$1 bdir=build/validation-$1
+    shift
+    make BUILDDIR="$bdir" "$@" "$bdir/gen_ref" "$bdir/gen_solar_ref" "$bdir/gen_web_json"
+    mkdir -p "validation/$name"
+    "./$bdir/gen_ref" -o "validation/$name"
+    "./$bdir/gen_solar_ref" -o "validation/$name"
+    python3 tools/extract_adhika_kshaya.py "validation/$name/ref_1900_2050.csv" "validation/$name/adhika_kshaya_tithis.csv"
+    "./$bdir/gen_web_json" -o "validation/web/data/$name"
+}
 
-echo ""
-echo "=== Generating Swiss Ephemeris validation data ==="
-make clean && make USE_SWISSEPH=1
-mkdir -p validation/se
-./build/gen_ref -o validation/se
-./build/gen_solar_ref -o validation/se
-python3 tools/extract_adhika_kshaya.py validation/se/ref_1900_2050.csv validation/se/adhika_kshaya_tithis.csv
-python3 tools/csv_to_json.py --backend se
-python3 tools/csv_to_solar_json.py --backend se
+echo "=== Generating Moshier and Swiss Ephemeris validation data ==="
+mkdir -p build
+gen_backend moshier > build/validation-moshier.log 2>&1 &
+moshier_pid=$!
+gen_backend se USE_SWISSEPH=1 > build/validation-se.log 2>&1 &
+se_pid=$!
 
-echo ""
-echo "=== Rebuilding default (Moshier) ==="
-make clean && make
+status=0
+wait $moshier_pid || { echo "Moshier generation failed, see build/validation-moshier.log"; status=1; }
+wait $se_pid || { echo "Swiss Ephemeris generation failed, see build/validation-se.log"; status=1; }
+[ $status -eq 0 ] || exit $status
 
 echo ""
 echo "=== Done ==="
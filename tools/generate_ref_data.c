@@ -1,7 +1,9 @@
 #include "astro.h"
 #include "tithi.h"
 #include "masa.h"
+#include "panchang.h"
 #include "date_utils.h"
+#include "writer.h"
 #include "dst.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -28,6 +30,8 @@ int main(int argc, char *argv[])
     int have_location = 0;
     double custom_utc = 0;
     int have_utc = 0;
+    int records_mode = 0;  /* -F: full CalendarRecords via writer.h */
+    OutputFormat format = OUTPUT_CSV;
 
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
@@ -43,6 +47,13 @@ int main(int argc, char *argv[])
         } else if (strcmp(argv[i], "-u") == 0 && i + 1 < argc) {
             custom_utc = atof(argv[++i]);
             have_utc = 1;
+        } else if (strcmp(argv[i], "-F") == 0 && i + 1 < argc) {
+            i++;
+            if (!parse_output_format(argv[i], &format)) {
+                fprintf(stderr, "ERROR: -F expects csv, jsonl or bin\n");
+                return 1;
+            }
+            records_mode = 1;
         } else if (strcmp(argv[i], "-tz") == 0 && i + 1 < argc) {
             i++;
             if (strcmp(argv[i], "us_eastern") == 0) {
@@ -80,8 +91,12 @@ int main(int argc, char *argv[])
     FILE *out = stdout;
     if (out_dir) {
         char path[512];
-        snprintf(path, sizeof(path), "%s/ref_1900_2050.csv", out_dir);
-        out = fopen(path, "w");
+        static const char *record_names[] = {
+            "ref_1900_2050_records.csv", "ref_1900_2050.jsonl", "ref_1900_2050.bin"
+        };
+        snprintf(path, sizeof(path), "%s/%s", out_dir,
+                 records_mode ? record_names[format] : "ref_1900_2050.csv");
+        out = fopen(path, records_mode ? "wb" : "w");
         if (!out) {
             fprintf(stderr, "ERROR: cannot open %s for writing\n", path);
             return 1;
@@ -89,6 +104,35 @@ int main(int argc, char *argv[])
         fprintf(stderr, "Writing to %s\n", path);
     }
 
+    if (records_mode) {
+        /* Lunisolar CalendarRecords (with adhika tithi flags) instead of
+         * the legacy reference columns */
+        RecordWriter w;
+        char name[64];
+        if (!writer_init(&w, out, format)) return 1;
+        snprintf(name, sizeof(name), "%.4f:%.4f", loc.latitude, loc.longitude);
+        writer_set_location(&w, 0, name);
+        for (int y = start_year; y <= end_year; y++) {
+            for (int m = 1; m <= 12; m++) {
+                int ndays = days_in_month(y, m);
+                for (int d = 1; d <= ndays; d++) {
+                    if (use_us_eastern)
+                        loc.utc_offset = us_eastern_offset(y, m, d);
+                    HinduDate hd = gregorian_to_hindu(y, m, d, &loc);
+                    CalendarRecord rec;
+                    calendar_record_lunisolar(&rec, y, m, d, &hd);
+                    writer_record(&w, &rec);
+                }
+            }
+            fprintf(stderr, "Generated year %d\n", y);
+        }
+        int rc = writer_close(&w);
+        if (out != stdout)
+            fclose(out);
+        astro_close();
+        return rc == 0 ? 0 : 1;
+    }
+
     fprintf(out, "year,month,day,tithi,masa,adhika,saka\n");
 
     for (int y = start_year; y <= end_year; y++) {
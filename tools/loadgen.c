@@ -0,0 +1,271 @@
+/*
+ * loadgen - Load generator for the calendar daemon (hindu-calendar -D)
+ *
+ * Usage:
+ *   loadgen -a unix:build/hc.sock [-c CONNS] [-n REQUESTS] [-w WINDOW]
+ *           [-m day|month|range|solar|mixed] [-l LOCATIONS] [-s SPREAD]
+ *
+ * Each connection runs on its own thread and keeps up to WINDOW requests
+ * in flight (pipelined), for REQUESTS requests.  Requests pick one of
+ * the first LOCATIONS built-in cities and a date within SPREAD days of
+ * 2025-01-01.  Reports throughput and latency percentiles, measured from
+ * sending a request to reading its response line.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <netdb.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+static const struct { const char *name; double lat, lon, utc; } CITIES[] = {
+    {"Delhi",     28.6139,  77.2090,  5.5},
+    {"Chennai",   13.0827,  80.2707,  5.5},
+    {"Kolkata",   22.5726,  88.3639,  5.5},
+    {"New York",  40.7128, -74.0060, -5.0},
+    {"London",    51.5074,  -0.1278,  0.0},
+    {"Singapore",  1.3521, 103.8198,  8.0},
+};
+#define N_CITIES ((int)(sizeof(CITIES) / sizeof(CITIES[0])))
+
+static const char *address;
+static int n_requests = 1000, window = 16, n_locations = 2, spread = 60;
+static const char *mix = "mixed";
+
+typedef struct {
+    int index;
+    double *latency;    /* seconds, by request id */
+    long errors;
+    int failed;
+} Client;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Connect, retrying for a few seconds while the daemon starts */
+static int connect_to(const char *addr)
+{
+    for (int attempt = 0; attempt < 50; attempt++) {
+        int fd = -1;
+        const char *path = strncmp(addr, "unix:", 5) == 0 ? addr + 5
+                         : strncmp(addr, "tcp:", 4) == 0 ? NULL
+                         : strchr(addr, '/') ? addr : NULL;
+        if (path) {
+            struct sockaddr_un sa;
+            memset(&sa, 0, sizeof(sa));
+            sa.sun_family = AF_UNIX;
+            strncpy(sa.sun_path, path, sizeof(sa.sun_path) - 1);
+            fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd >= 0 && connect(fd, (struct sockaddr *)&sa, sizeof(sa)) == 0)
+                return fd;
+        } else {
+            const char *hp = strncmp(addr, "tcp:", 4) == 0 ? addr + 4 : addr;
+            const char *colon = strrchr(hp, ':');
+            char host[256];
+            struct addrinfo hints, *res;
+            if (!colon || (size_t)(colon - hp) >= sizeof(host)) return -1;
+            memcpy(host, hp, (size_t)(colon - hp));
+            host[colon - hp] = '\0';
+            memset(&hints, 0, sizeof(hints));
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            if (getaddrinfo(host, colon + 1, &hints, &res) == 0) {
+                fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+                int ok = fd >= 0 && connect(fd, res->ai_addr, res->ai_addrlen) == 0;
+                freeaddrinfo(res);
+                if (ok) return fd;
+            }
+        }
+        if (fd >= 0) close(fd);
+        struct timespec ts = {0, 100000000};
+        nanosleep(&ts, NULL);
+    }
+    return -1;
+}
+
+static unsigned next_rand(unsigned *state)
+{
+    *state = *state * 1103515245u + 12345u;
+    return (*state >> 16) & 0x7FFF;
+}
+
+/* Format request id as a JSON line; returns its length */
+static int format_request(char *out, size_t cap, int id, unsigned *rng)
+{
+    static const char *OPS[] = {"day", "month", "range", "solar"};
+    const char *op = mix;
+    if (strcmp(mix, "mixed") == 0) {
+        /* Mostly single days, as a web tier would ask */
+        unsigned r = next_rand(rng) % 10;
+        op = OPS[r < 6 ? 0 : r < 7 ? 1 : r < 8 ? 2 : 3];
+    }
+    int c = (int)(next_rand(rng) % (unsigned)n_locations);
+    int offset = (int)(next_rand(rng) % (unsigned)spread);
+    /* 2025-01-01 + offset */
+    static const int mdays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    int y = 2025, m = 0, d = offset;
+    while (d >= mdays[m]) {
+        d -= mdays[m];
+        if (++m == 12) {
+            m = 0;
+            y++;
+        }
+    }
+    char date[40];  /* room for any int year */
+    snprintf(date, sizeof(date), "%04d-%02d-%02d", y, m + 1, d + 1);
+
+    int n = snprintf(out, cap, "{\"id\":%d,\"op\":\"%s\",\"lat\":%.4f,\"lon\":%.4f,\"utc_offset\":%.1f,",
+                     id, op, CITIES[c].lat, CITIES[c].lon, CITIES[c].utc);
+    if (strcmp(op, "month") == 0)
+        n += snprintf(out + n, cap - n, "\"year\":%d,\"month\":%d}\n", y, m + 1);
+    else if (strcmp(op, "range") == 0)
+        n += snprintf(out + n, cap - n, "\"from\":\"%s\",\"to\":\"%s\",\"calendars\":\"all\"}\n",
+                      date, date);
+    else if (strcmp(op, "solar") == 0)
+        n += snprintf(out + n, cap - n, "\"date\":\"%s\",\"calendar\":\"tamil\"}\n", date);
+    else
+        n += snprintf(out + n, cap - n, "\"date\":\"%s\"}\n", date);
+    return n;
+}
+
+static void *client_main(void *arg)
+{
+    Client *cl = arg;
+    int fd = connect_to(address);
+    if (fd < 0) {
+        cl->failed = 1;
+        return NULL;
+    }
+    double *sent_at = malloc(n_requests * sizeof(double));
+    size_t cap = 1 << 20, len = 0;
+    char *in = malloc(cap);
+    unsigned rng = 12345u + 7919u * (unsigned)cl->index;
+    int sent = 0, done = 0;
+
+    while (sent_at && in && done < n_requests) {
+        while (sent < n_requests && sent - done < window) {
+            char req[512];
+            int n = format_request(req, sizeof(req), sent, &rng);
+            sent_at[sent++] = now_sec();
+            if (write(fd, req, (size_t)n) != n) {
+                cl->failed = 1;
+                goto out;
+            }
+        }
+        if (cap - len < 65536) {
+            char *grown = realloc(in, cap * 2);
+            if (!grown) break;
+            in = grown;
+            cap *= 2;
+        }
+        ssize_t n = read(fd, in + len, cap - len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            cl->failed = 1;
+            break;
+        }
+        double t = now_sec();
+        len += (size_t)n;
+
+        char *line = in, *nl;
+        while ((nl = memchr(line, '\n', len - (size_t)(line - in))) != NULL) {
+            int id = atoi(line + 6);  /* {"id":N,... */
+            if (strncmp(line, "{\"id\":", 6) == 0 && id >= 0 && id < sent) {
+                cl->latency[id] = t - sent_at[id];
+                if (strstr(line, "\"ok\":false")) cl->errors++;
+                done++;
+            }
+            line = nl + 1;
+        }
+        len -= (size_t)(line - in);
+        memmove(in, line, len);
+    }
+out:
+    close(fd);
+    free(sent_at);
+    free(in);
+    return NULL;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char *argv[])
+{
+    int n_conns = 4;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) address = argv[++i];
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) n_conns = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) n_requests = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) window = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) mix = argv[++i];
+        else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc) n_locations = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) spread = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "Usage: %s -a ADDRESS [-c CONNS] [-n REQUESTS] [-w WINDOW]\n"
+                            "       [-m day|month|range|solar|mixed] [-l LOCATIONS] [-s SPREAD]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (!address || n_conns < 1 || n_requests < 1 || window < 1 || spread < 1 ||
+        n_locations < 1 || n_locations > N_CITIES) {
+        fprintf(stderr, "ERROR: need -a ADDRESS; counts must be positive, -l at most %d\n",
+                N_CITIES);
+        return 1;
+    }
+
+    Client *clients = calloc(n_conns, sizeof(Client));
+    pthread_t *tids = malloc(n_conns * sizeof(pthread_t));
+    double *all = malloc((size_t)n_conns * n_requests * sizeof(double));
+    if (!clients || !tids || !all) return 1;
+    for (int c = 0; c < n_conns; c++) {
+        clients[c].index = c;
+        clients[c].latency = all + (size_t)c * n_requests;
+    }
+
+    double t0 = now_sec();
+    for (int c = 0; c < n_conns; c++)
+        pthread_create(&tids[c], NULL, client_main, &clients[c]);
+    for (int c = 0; c < n_conns; c++)
+        pthread_join(tids[c], NULL);
+    double elapsed = now_sec() - t0;
+
+    long errors = 0;
+    int failed = 0;
+    for (int c = 0; c < n_conns; c++) {
+        errors += clients[c].errors;
+        failed |= clients[c].failed;
+    }
+    if (failed) {
+        fprintf(stderr, "ERROR: a connection failed (is the daemon running on %s?)\n", address);
+        return 1;
+    }
+
+    long total = (long)n_conns * n_requests;
+    qsort(all, (size_t)total, sizeof(double), cmp_double);
+    printf("%d connections x %d requests (%s, window %d, %d locations, %d-day spread)\n",
+           n_conns, n_requests, mix, window, n_locations, spread);
+    printf("  %.2f s, %.0f requests/s, %ld errors\n", elapsed, total / elapsed, errors);
+    printf("  latency ms: p50 %.2f  p90 %.2f  p99 %.2f  max %.2f\n",
+           all[total / 2] * 1e3, all[total * 9 / 10] * 1e3,
+           all[total * 99 / 100] * 1e3, all[total - 1] * 1e3);
+
+    free(all);
+    free(tids);
+    free(clients);
+    return errors ? 1 : 0;
+}
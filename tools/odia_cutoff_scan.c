@@ -1,16 +1,31 @@
 /*
- * Scan ALL Odia sankrantis 1900-2050 in the 22:00-22:30 IST range.
+ * Scan ALL Odia sankrantis 1900-2050 in the 21:30-22:30 IST range.
  * For each, compute distance to apparent midnight and show what our
  * code assigns vs what a pure-2h cutoff would give.
- * Sorted by "before apparent midnight" to find the tightest cases.
+ * Sorted by distance to the 2h02m cutoff to find the tightest cases;
+ * runs on scan_run() (scan.h).
+ *
+ * Build:
+ *   make build/odia_cutoff_scan
+ *
+ * Run:
+ *   ./build/odia_cutoff_scan [-j THREADS] [-o CSV]
  */
+#define _POSIX_C_SOURCE 200809L
 
 #include "astro.h"
 #include "solar.h"
+#include "scan.h"
 #include "date_utils.h"
 #include "types.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <math.h>
+#include <unistd.h>
+
+#define CUTOFF_MIN 122.0   /* minutes before apparent midnight */
+#define MAX_HITS   500
 
 static void jd_to_ist_hms(double jd_ut, double *ist_hours)
 {
@@ -34,72 +49,99 @@ typedef struct {
     int our_month, our_day;
 } Entry;
 
-int main(void)
+static void fill_entry(double jd_sank, int rashi, const Location *loc, Entry *e)
 {
-    astro_init(NULL);
-    Location loc = DEFAULT_LOCATION;
+    jd_to_ist_hms(jd_sank, &e->sank_ist);
+
+    /* Get local date */
+    double local_jd = jd_sank + loc->utc_offset / 24.0 + 0.5;
+    jd_to_gregorian(floor(local_jd), &e->gy, &e->gm, &e->gd);
+    double jd_day = gregorian_to_jd(e->gy, e->gm, e->gd);
+
+    /* Apparent midnight */
+    double jd_ss = sunset_jd(jd_day, loc);
+    double jd_sr_next = sunrise_jd(jd_day + 1.0, loc);
+    double jd_app_mid = (jd_ss + jd_sr_next) / 2.0;
+    e->before_am_minutes = (jd_app_mid - jd_sank) * 24.0 * 60.0;
+
+    /* What our code says */
+    SolarDate sd = gregorian_to_solar(e->gy, e->gm, e->gd, loc, SOLAR_CAL_ODIA);
+    e->rashi = rashi;
+    e->our_month = sd.month;
+    e->our_day = sd.day;
+}
+
+/* Scan metric: minutes past the cutoff, for sankrantis in 21:30-22:30 IST */
+static int cutoff_metric(const AstroEvent *ev, const Location *loc, void *ctx,
+                         ScanHit *hit)
+{
+    (void)ctx;
+    double sank_ist;
+    jd_to_ist_hms(ev->jd, &sank_ist);
+    if (sank_ist < 21.5 || sank_ist > 22.5) return 0;
+
+    Entry e;
+    fill_entry(ev->jd, ev->value, loc, &e);
+    hit->metric = e.before_am_minutes - CUTOFF_MIN;
+    snprintf(hit->row, sizeof(hit->row), "%04d-%02d-%02d,%.2f,%d,%d,%s",
+             e.gy, e.gm, e.gd, e.before_am_minutes, e.our_month, e.our_day,
+             (e.before_am_minutes >= CUTOFF_MIN) ? "current" : "next");
+    return 1;
+}
 
-    Entry entries[500];
-    int n = 0;
-
-    for (int gy = 1900; gy <= 2050; gy++) {
-        for (int rashi = 1; rashi <= 12; rashi++) {
-            double target_long = (rashi - 1) * 30.0;
-            int approx_month = 3 + rashi;
-            int approx_year = gy;
-            if (approx_month > 12) { approx_month -= 12; approx_year++; }
-            double jd_est = gregorian_to_jd(approx_year, approx_month, 14);
-            double jd_sank = sankranti_jd(jd_est, target_long);
-
-            double sank_ist;
-            jd_to_ist_hms(jd_sank, &sank_ist);
-
-            /* Only interested in 21:30-22:30 IST range */
-            if (sank_ist < 21.5 || sank_ist > 22.5) continue;
-
-            /* Get local date */
-            double local_jd = jd_sank + loc.utc_offset / 24.0 + 0.5;
-            int ly, lm, ld;
-            jd_to_gregorian(floor(local_jd), &ly, &lm, &ld);
-            double jd_day = gregorian_to_jd(ly, lm, ld);
-
-            /* Apparent midnight */
-            double jd_ss = sunset_jd(jd_day, &loc);
-            double jd_sr_next = sunrise_jd(jd_day + 1.0, &loc);
-            double jd_app_mid = (jd_ss + jd_sr_next) / 2.0;
-
-            double before_am_min = (jd_app_mid - jd_sank) * 24.0 * 60.0;
-
-            /* What our code says */
-            SolarDate sd = gregorian_to_solar(ly, lm, ld, &loc, SOLAR_CAL_ODIA);
-
-            if (n < 500) {
-                entries[n].gy = ly;
-                entries[n].gm = lm;
-                entries[n].gd = ld;
-                entries[n].rashi = rashi;
-                entries[n].sank_ist = sank_ist;
-                entries[n].before_am_minutes = before_am_min;
-                entries[n].our_month = sd.month;
-                entries[n].our_day = sd.day;
-                n++;
+int main(int argc, char *argv[])
+{
+    const char *csv_path = NULL;
+    long n_threads = sysconf(_SC_NPROCESSORS_ONLN);
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            n_threads = atoi(argv[++i]);
+            if (n_threads < 1) {
+                fprintf(stderr, "ERROR: -j needs a positive thread count\n");
+                return 1;
             }
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            csv_path = argv[++i];
+        } else {
+            fprintf(stderr, "Usage: %s [-j THREADS] [-o CSV]\n", argv[0]);
+            return 1;
         }
     }
+    if (n_threads < 1) n_threads = 1;
 
-    /* Sort by before_am_minutes ascending (tightest cases first) */
-    for (int i = 0; i < n - 1; i++) {
-        for (int j = i + 1; j < n; j++) {
-            if (entries[i].before_am_minutes > entries[j].before_am_minutes) {
-                Entry tmp = entries[i];
-                entries[i] = entries[j];
-                entries[j] = tmp;
-            }
+    astro_init(NULL);
+    Location loc = DEFAULT_LOCATION;
+
+    /* Mesha sankranti of 1900 (mid-April) to Meena of 2051 */
+    ScanRequest req;
+    memset(&req, 0, sizeof(req));
+    req.jd_start = gregorian_to_jd(1900, 4, 1);
+    req.jd_end = gregorian_to_jd(2051, 4, 1);
+    req.event_mask = EVENT_SANKRANTI;
+    req.loc = loc;
+    req.metric = cutoff_metric;
+    req.top_n = MAX_HITS;
+    req.threads = (int)n_threads;
+
+    ScanResult res;
+    if (!scan_run(&req, &res)) {
+        fprintf(stderr, "ERROR: scan failed\n");
+        return 1;
+    }
+
+    if (csv_path) {
+        FILE *f = fopen(csv_path, "w");
+        if (!f || scan_write_csv(f, &req, &res,
+                                 "civil_date,before_apparent_midnight_min,"
+                                 "our_month,our_day,assign") != 0 ||
+            fclose(f) != 0) {
+            fprintf(stderr, "ERROR: cannot write %s\n", csv_path);
+            return 1;
         }
     }
 
-    printf("Odia sankrantis 21:30-22:30 IST, sorted by distance to apparent midnight\n");
-    printf("=========================================================================\n");
+    printf("Odia sankrantis 21:30-22:30 IST, sorted by distance to the cutoff\n");
+    printf("==================================================================\n");
     printf("Cutoff = 122.0 min (2h02m) before apparent midnight\n\n");
     printf("%-12s  %-6s  %-10s  %-12s  %-10s  %-8s  %s\n",
            "Date", "Rashi", "Sank IST", "Bef.AppMid", "Our result", "Assign",
@@ -108,20 +150,22 @@ int main(void)
            "----------", "-----", "---------", "-----------", "---------", "-------",
            "----");
 
-    for (int i = 0; i < n; i++) {
-        Entry *e = &entries[i];
+    for (int i = 0; i < res.n_hits; i++) {
+        Entry entry;
+        Entry *e = &entry;
+        fill_entry(res.hits[i].ev.jd, res.hits[i].ev.value, &loc, e);
         int bm_total = (int)e->before_am_minutes;
         int bh = bm_total / 60;
         int bm = bm_total % 60;
         int bs = (int)((e->before_am_minutes - bm_total) * 60.0);
 
-        const char *assign = (e->before_am_minutes >= 122.0) ? "current" : "next";
+        const char *assign = (e->before_am_minutes >= CUTOFF_MIN) ? "current" : "next";
         const char *note = "";
 
         /* Flag cases near the cutoff (within 5 minutes) */
-        if (fabs(e->before_am_minutes - 122.0) < 5.0)
+        if (fabs(e->before_am_minutes - CUTOFF_MIN) < 5.0)
             note = "*** NEAR CUTOFF ***";
-        else if (fabs(e->before_am_minutes - 122.0) < 10.0)
+        else if (fabs(e->before_am_minutes - CUTOFF_MIN) < 10.0)
             note = "* close *";
         /* Flag confirmed cases */
         if (e->gy == 2024 && e->gm == 12 && e->gd == 15)
@@ -136,8 +180,10 @@ int main(void)
         printf("%-8s  %s\n", assign, note);
     }
 
-    printf("\nTotal: %d sankrantis in 21:30-22:30 IST range\n", n);
+    printf("\nTotal: %ld sankrantis in 21:30-22:30 IST range (%ld scanned)\n",
+           res.n_matched, res.n_events);
 
+    scan_free(&res);
     astro_close();
     return 0;
 }
@@ -0,0 +1,206 @@
+/*
+ * pack_archive - Build a packed panchang archive (see src/archive.h)
+ *
+ * Usage:
+ *   pack_archive -i validation/moshier/ref_1900_2050.csv -o ref.hcpa
+ *       Convert a reference CSV (year,month,day,tithi,masa,adhika,saka)
+ *       into a calendar-only archive.  Adhika tithis (same tithi as the
+ *       previous day) and kshaya flags (next tithi skipped) are derived
+ *       from neighbouring rows.
+ *
+ *   pack_archive -y 2000 2030 [-l LAT,LON] [-u OFFSET] -o delhi.hcpa
+ *       Compute full panchangs, with sunrise and tithi boundaries.
+ *
+ * -l/-u give the location stored in the header (default New Delhi).
+ * The archive is read back and compared with the input before exiting.
+ */
+#include "archive.h"
+#include "astro.h"
+#include "panchang.h"
+#include "masa.h"
+#include "csvmap.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Read reference CSV rows into days[]; returns the count, or -1 */
+static int read_ref_csv(const char *path, PanchangDay **out, long *file_size)
+{
+    CsvFile csv;
+    if (!csv_open(&csv, path)) {
+        fprintf(stderr, "ERROR: cannot open %s\n", path);
+        return -1;
+    }
+    int n = 0;
+    PanchangDay *days = malloc((csv_count_rows(&csv) + 1) * sizeof(PanchangDay));
+    if (!days) {
+        csv_close(&csv);
+        return -1;
+    }
+
+    while (csv_next(&csv)) {
+        int y, m, d, t, masa, adhika, saka;
+        if (!csv_int(&csv, 0, &y) || !csv_int(&csv, 1, &m) || !csv_int(&csv, 2, &d) ||
+            !csv_int(&csv, 3, &t) || !csv_int(&csv, 4, &masa) ||
+            !csv_int(&csv, 5, &adhika) || !csv_int(&csv, 6, &saka)) {
+            fprintf(stderr, "ERROR: %s:%ld: expected 7 integer columns\n", path, csv.line);
+            free(days);
+            csv_close(&csv);
+            return -1;
+        }
+        PanchangDay *pd = &days[n++];
+        memset(pd, 0, sizeof(*pd));
+        pd->greg_year = y;
+        pd->greg_month = m;
+        pd->greg_day = d;
+        pd->tithi.tithi_num = t;
+        pd->tithi.paksha = (t <= 15) ? SHUKLA_PAKSHA : KRISHNA_PAKSHA;
+        pd->tithi.paksha_tithi = (t <= 15) ? t : t - 15;
+        pd->hindu_date.year_saka = saka;
+        pd->hindu_date.year_vikram = hindu_year_vikram(saka);
+        pd->hindu_date.masa = (MasaName)masa;
+        pd->hindu_date.is_adhika_masa = adhika;
+        pd->hindu_date.paksha = pd->tithi.paksha;
+        pd->hindu_date.tithi = pd->tithi.paksha_tithi;
+    }
+    *file_size = (long)csv.size;
+    csv_close(&csv);
+
+    for (int i = 0; i < n; i++) {
+        if (i > 0)
+            days[i].hindu_date.is_adhika_tithi =
+                (days[i].tithi.tithi_num == days[i - 1].tithi.tithi_num);
+        if (i + 1 < n)
+            days[i].tithi.is_kshaya =
+                ((days[i + 1].tithi.tithi_num - days[i].tithi.tithi_num + 30) % 30 > 1);
+    }
+    *out = days;
+    return n;
+}
+
+/* Compute whole years y0..y1; returns the count, or -1 */
+static int compute_years(int y0, int y1, const Location *loc, PanchangDay **out)
+{
+    int cap = (y1 - y0 + 1) * 366;
+    PanchangDay *days = malloc(cap * sizeof(PanchangDay));
+    if (!days) return -1;
+    int n = 0;
+    for (int y = y0; y <= y1; y++) {
+        for (int m = 1; m <= 12; m++) {
+            int count;
+            generate_month_panchang(y, m, loc, days + n, &count);
+            n += count;
+        }
+    }
+    *out = days;
+    return n;
+}
+
+/* Compare the archive with the input; returns the number of differing days */
+static int verify(const char *path, const PanchangDay *days, int n, int has_times)
+{
+    PanchangArchive *a = malloc(sizeof(PanchangArchive));
+    if (!a || !archive_open(a, path)) {
+        free(a);
+        return n;
+    }
+    int bad = 0;
+    double max_err = 0;
+    for (int i = 0; i < n; i++) {
+        const PanchangDay *e = &days[i];
+        PanchangDay got;
+        if (!archive_get_day(a, e->greg_year, e->greg_month, e->greg_day, &got) ||
+            memcmp(&got.hindu_date, &e->hindu_date, sizeof(HinduDate)) != 0 ||
+            got.tithi.tithi_num != e->tithi.tithi_num ||
+            got.tithi.paksha != e->tithi.paksha ||
+            got.tithi.paksha_tithi != e->tithi.paksha_tithi ||
+            got.tithi.is_kshaya != e->tithi.is_kshaya) {
+            bad++;
+            continue;
+        }
+        if (has_times) {
+            double err = fabs(got.jd_sunrise - e->jd_sunrise);
+            if (fabs(got.tithi.jd_start - e->tithi.jd_start) > err)
+                err = fabs(got.tithi.jd_start - e->tithi.jd_start);
+            if (fabs(got.tithi.jd_end - e->tithi.jd_end) > err)
+                err = fabs(got.tithi.jd_end - e->tithi.jd_end);
+            if (err > max_err) max_err = err;
+            if (err * 86400.0 > 0.051) bad++;
+        }
+    }
+    if (has_times)
+        printf("Max time error: %.3f s\n", max_err * 86400.0);
+    archive_close(a);
+    free(a);
+    return bad;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *in_path = NULL, *out_path = NULL;
+    Location loc = DEFAULT_LOCATION;
+    int y0 = 0, y1 = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
+            in_path = argv[++i];
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc) {
+            i++;
+            if (sscanf(argv[i], "%lf,%lf", &loc.latitude, &loc.longitude) != 2) {
+                fprintf(stderr, "ERROR: -l expects LAT,LON (e.g., 40.7128,-74.0060)\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-u") == 0 && i + 1 < argc) {
+            loc.utc_offset = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-y") == 0 && i + 2 < argc) {
+            y0 = atoi(argv[++i]);
+            y1 = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s (-i REF.csv | -y START END) [-l LAT,LON] [-u OFFSET] -o OUT\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (!out_path || (!in_path && (y0 == 0 || y1 < y0))) {
+        fprintf(stderr, "ERROR: need -o and either -i or -y START END\n");
+        return 1;
+    }
+
+    PanchangDay *days;
+    long source_size;
+    int has_times = (in_path == NULL);
+    int n;
+    astro_init(NULL);
+    if (in_path) {
+        n = read_ref_csv(in_path, &days, &source_size);
+    } else {
+        n = compute_years(y0, y1, &loc, &days);
+        source_size = (long)n * (long)sizeof(PanchangDay);
+    }
+    if (n <= 0) {
+        astro_close();
+        return 1;
+    }
+
+    long size = archive_write(out_path, &loc, days, n, has_times);
+    if (size < 0) {
+        fprintf(stderr, "ERROR: cannot write %s (input must be whole consecutive years)\n",
+                out_path);
+        free(days);
+        astro_close();
+        return 1;
+    }
+    printf("Wrote %s: %d days, %ld bytes (%.2f bytes/day)\n",
+           out_path, n, size, (double)size / n);
+    printf("%s: %ld bytes, %.1fx smaller\n",
+           in_path ? in_path : "PanchangDay array", source_size, (double)source_size / size);
+
+    int bad = verify(out_path, days, n, has_times);
+    if (bad) fprintf(stderr, "ERROR: %d days differ after reading back\n", bad);
+    free(days);
+    astro_close();
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,218 @@
+/*
+ * port_bench.c — C driver for the cross-port benchmark (make bench-ports).
+ *
+ * Reads a workload file (format in tools/bench_ports.workload), converts
+ * every (location, date) pair in every listed calendar, and writes the
+ * canonical rows that tools/bench_ports.py compares against the Rust,
+ * Java and Swift drivers.  Only the conversions are timed; the rows are
+ * kept in memory and written afterwards, as the other drivers do.  The
+ * peak RSS comes from /proc (a parent's fork shows up in getrusage()).
+ *
+ * Build:
+ *   make build/port_bench
+ *
+ * Run:
+ *   ./build/port_bench WORKLOAD > rows.csv
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "astro.h"
+#include "panchang.h"
+#include "solar.h"
+#include "date_utils.h"
+#include "types.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_LOCATIONS 64
+#define N_CALENDARS   5   /* lunisolar, then SolarCalendarType + 1 */
+
+static const char *CALENDAR_NAMES[N_CALENDARS] = {
+    "lunisolar", "tamil", "bengali", "odia", "malayalam",
+};
+
+typedef struct {
+    double jd0, jd1;
+    Location locs[MAX_LOCATIONS];
+    int n_locs;
+    int calendars[N_CALENDARS];
+    int n_calendars;
+    int random;
+    unsigned seed;
+} Workload;
+
+typedef struct {
+    int loc, y, m, d, calendar;
+    int year, month, adhika, day;
+} Row;
+
+/* Peak resident set of this process in KiB (Linux VmHWM), or 0 */
+static long peak_rss_kb(void)
+{
+    FILE *f = fopen("/proc/self/status", "r");
+    char line[128];
+    long kb = 0;
+    if (!f) return 0;
+    while (fgets(line, sizeof(line), f))
+        if (sscanf(line, "VmHWM: %ld", &kb) == 1) break;
+    fclose(f);
+    return kb;
+}
+
+static int parse_day(const char *s, double *jd)
+{
+    int y, m, d;
+    if (sscanf(s, "%d-%d-%d", &y, &m, &d) != 3 || m < 1 || m > 12 || d < 1 || d > 31)
+        return 0;
+    *jd = gregorian_to_jd(y, m, d);
+    return 1;
+}
+
+/* Returns 0, or the line number of the first bad line */
+static int load_workload(FILE *f, Workload *w)
+{
+    char line[512];
+    int lineno = 0;
+    memset(w, 0, sizeof(*w));
+    w->jd0 = w->jd1 = -1;
+
+    while (fgets(line, sizeof(line), f)) {
+        lineno++;
+        char *tok = strtok(line, " \t\r\n");
+        if (!tok || tok[0] == '#') continue;
+
+        int ok = 1;
+        if (strcmp(tok, "from") == 0 || strcmp(tok, "to") == 0) {
+            char *arg = strtok(NULL, " \t\r\n");
+            ok = arg && parse_day(arg, tok[0] == 'f' ? &w->jd0 : &w->jd1);
+        } else if (strcmp(tok, "location") == 0) {
+            Location *loc = &w->locs[w->n_locs];
+            char *lat = strtok(NULL, " \t\r\n"), *lon = strtok(NULL, " \t\r\n");
+            char *off = strtok(NULL, " \t\r\n");
+            ok = w->n_locs < MAX_LOCATIONS && lat && lon && off;
+            if (ok) {
+                *loc = (Location)DEFAULT_LOCATION;
+                loc->latitude = atof(lat);
+                loc->longitude = atof(lon);
+                loc->utc_offset = atof(off);
+                w->n_locs++;
+            }
+        } else if (strcmp(tok, "calendars") == 0) {
+            while (ok && (tok = strtok(NULL, " \t\r\n"))) {
+                int c = 0;
+                while (c < N_CALENDARS && strcmp(tok, CALENDAR_NAMES[c]) != 0) c++;
+                ok = c < N_CALENDARS && w->n_calendars < N_CALENDARS;
+                if (ok) w->calendars[w->n_calendars++] = c;
+            }
+        } else if (strcmp(tok, "order") == 0) {
+            char *kind = strtok(NULL, " \t\r\n"), *seed = strtok(NULL, " \t\r\n");
+            if (kind && strcmp(kind, "sequential") == 0) {
+                w->random = 0;
+            } else if (kind && strcmp(kind, "random") == 0 && seed) {
+                w->random = 1;
+                w->seed = (unsigned)strtoul(seed, NULL, 10);
+            } else {
+                ok = 0;
+            }
+        } else {
+            ok = 0;
+        }
+        if (!ok) return lineno;
+    }
+    if (w->jd0 < 0 || w->jd1 < w->jd0 || w->n_locs == 0 || w->n_calendars == 0)
+        return lineno + 1;
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s WORKLOAD\n", argv[0]);
+        return 1;
+    }
+    FILE *f = fopen(argv[1], "r");
+    if (!f) {
+        fprintf(stderr, "Error: cannot open '%s'\n", argv[1]);
+        return 1;
+    }
+    Workload w;
+    int bad = load_workload(f, &w);
+    fclose(f);
+    if (bad) {
+        fprintf(stderr, "Error: %s line %d: bad or missing workload entry\n", argv[1], bad);
+        return 1;
+    }
+
+    /* (location, day) pairs, location-major, optionally shuffled */
+    int n_days = (int)(w.jd1 - w.jd0) + 1;
+    int n = n_days * w.n_locs;
+    int *order = malloc(n * sizeof(int));
+    Row *rows = malloc((size_t)n * w.n_calendars * sizeof(Row));
+    if (!order || !rows) {
+        fprintf(stderr, "Error: out of memory\n");
+        return 1;
+    }
+    for (int i = 0; i < n; i++)
+        order[i] = i;
+    if (w.random) {
+        unsigned x = w.seed;
+        for (int i = n - 1; i > 0; i--) {
+            x = x * 1103515245u + 12345u;
+            int j = (int)((x >> 8) % (unsigned)(i + 1));
+            int tmp = order[i];
+            order[i] = order[j];
+            order[j] = tmp;
+        }
+    }
+
+    astro_init(NULL);
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    Row *r = rows;
+    for (int i = 0; i < n; i++) {
+        int loc = order[i] / n_days;
+        int y, m, d;
+        jd_to_gregorian(w.jd0 + order[i] % n_days, &y, &m, &d);
+        for (int c = 0; c < w.n_calendars; c++, r++) {
+            r->loc = loc;
+            r->y = y;
+            r->m = m;
+            r->d = d;
+            r->calendar = w.calendars[c];
+            if (r->calendar == 0) {
+                HinduDate hd = gregorian_to_hindu(y, m, d, &w.locs[loc]);
+                r->year = hd.year_saka;
+                r->month = hd.masa;
+                r->adhika = hd.is_adhika_masa;
+                r->day = hd.tithi + (hd.paksha == KRISHNA_PAKSHA ? 15 : 0);
+            } else {
+                SolarDate sd = gregorian_to_solar(y, m, d, &w.locs[loc],
+                                                  (SolarCalendarType)(r->calendar - 1));
+                r->year = sd.year;
+                r->month = sd.month;
+                r->adhika = 0;
+                r->day = sd.day;
+            }
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    astro_close();
+
+    for (Row *p = rows; p < r; p++)
+        printf("%d,%04d-%02d-%02d,%s,%d,%d,%d,%d\n", p->loc, p->y, p->m, p->d,
+               CALENDAR_NAMES[p->calendar], p->year, p->month, p->adhika, p->day);
+    long long ns = (long long)(t1.tv_sec - t0.tv_sec) * 1000000000LL +
+                   (t1.tv_nsec - t0.tv_nsec);
+    fflush(stdout);
+    fprintf(stderr, "rows=%ld compute_ns=%lld peak_rss_kb=%ld\n", (long)(r - rows), ns,
+            peak_rss_kb());
+
+    free(order);
+    free(rows);
+    return 0;
+}
@@ -2,34 +2,37 @@
  * solar_boundary_scan.c — Find the 100 closest sankrantis to each solar
  * calendar's critical time, for manual verification against drikpanchang.com.
  *
- * Scans all 1,812 sankrantis (12 × 151 years, 1900–2050) for each of the
- * 4 calendars (Tamil, Bengali, Odia, Malayalam).  For each sankranti, computes
- * delta = sankranti_jd − critical_time_jd in minutes.  Sorts by |delta| and
- * outputs two files:
+ * Scans all 1,812 sankrantis (12 × 151 years, Mesha 1900 – Meena 2051) for
+ * each of the 4 calendars (Tamil, Bengali, Odia, Malayalam) with scan_run()
+ * (scan.h).  For each sankranti, the metric is delta = sankranti_jd −
+ * critical_time_jd in minutes; the 100 smallest |delta| per calendar are
+ * written to two files:
  *   1. validation/solar_edge_cases.csv — human-readable for manual verification
  *   2. tests/test_solar_edge.c — compilable test with our predictions pre-filled
  *
  * Build:
- *   make && cc -O2 -Isrc -Ilib/swisseph tools/solar_boundary_scan.c \
- *       build/*.o build/swe/*.o -lm -o build/solar_boundary_scan
+ *   make build/solar_boundary_scan
  *
  * Run:
- *   ./build/solar_boundary_scan
+ *   ./build/solar_boundary_scan [-j THREADS]
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "astro.h"
 #include "solar.h"
+#include "scan.h"
 #include "date_utils.h"
 #include "types.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
+#include <unistd.h>
 
 #define TOP_N        100
 #define YEAR_START   1900
 #define YEAR_END     2050
-#define TOTAL_SANK   ((YEAR_END - YEAR_START + 1) * 12)   /* 1812 */
 
 /* ---- Replicate the 4 critical-time rules from solar.c (they are static) ---- */
 
@@ -104,23 +107,49 @@ static void jd_to_ist(double jd_ut, int *y, int *m, int *d, int *hh, int *mm, in
     *ss = (int)(fmod(secs, 60.0));
 }
 
-static int cmp_by_abs_delta(const void *a, const void *b)
+/* ---- Scan metric: minutes from the critical time of the sankranti's day ---- */
+
+static int delta_metric(const AstroEvent *ev, const Location *loc, void *ctx,
+                        ScanHit *hit)
 {
-    double da = fabs(((const Entry *)a)->delta_min);
-    double db = fabs(((const Entry *)b)->delta_min);
-    if (da < db) return -1;
-    if (da > db) return  1;
-    return 0;
+    SolarCalendarType type = *(const SolarCalendarType *)ctx;
+    int sy, sm, sd, sh, smin, ssec;
+    jd_to_ist(ev->jd, &sy, &sm, &sd, &sh, &smin, &ssec);
+    double jd_crit = critical_time_jd_local(gregorian_to_jd(sy, sm, sd), loc, type);
+    hit->metric = (ev->jd - jd_crit) * 24.0 * 60.0;
+    return 1;
 }
 
-/* ---- Rashi to regional month (replicate from solar.c) ---- */
-
-static int rashi_to_regional_month(int rashi, SolarCalendarType type)
+/* Full entry for one of the closest sankrantis */
+static void fill_entry(const ScanHit *hit, const Location *loc,
+                       SolarCalendarType type, Entry *e)
 {
-    int first_rashi = (type == SOLAR_CAL_MALAYALAM) ? 5 : 1;
-    int m = rashi - first_rashi + 1;
-    if (m <= 0) m += 12;
-    return m;
+    double jd_sank = hit->ev.jd;
+
+    /* Convert sankranti to local date/time (IST) */
+    int sy, sm, sd, sh, smin, ssec;
+    jd_to_ist(jd_sank, &sy, &sm, &sd, &sh, &smin, &ssec);
+
+    /* Critical time for that day, in IST */
+    double jd_crit = critical_time_jd_local(gregorian_to_jd(sy, sm, sd), loc, type);
+    int cy, cm, cd, ch, cmin, csec;
+    jd_to_ist(jd_crit, &cy, &cm, &cd, &ch, &cmin, &csec);
+
+    /* Our assignment: which day is day 1? */
+    int d1y, d1m, d1d;
+    sankranti_to_civil_day_local(jd_sank, loc, type, &d1y, &d1m, &d1d);
+
+    /* Our full conversion for day 1 */
+    SolarDate sdate = gregorian_to_solar(d1y, d1m, d1d, loc, type);
+
+    e->sank_gy = sy;  e->sank_gm = sm;  e->sank_gd = sd;
+    e->sank_hh = sh;  e->sank_mm = smin; e->sank_ss = ssec;
+    e->crit_hh = ch;  e->crit_mm = cmin; e->crit_ss = csec;
+    e->delta_min = hit->metric;
+    e->day1_gy = d1y; e->day1_gm = d1m;  e->day1_gd = d1d;
+    e->our_month = sdate.month;
+    e->our_year = sdate.year;
+    e->rashi = hit->ev.value;
 }
 
 static const char *cal_name(SolarCalendarType type)
@@ -158,14 +187,36 @@ static const char *cal_type_enum(SolarCalendarType type)
 
 /* ---- Main ---- */
 
-int main(void)
+int main(int argc, char *argv[])
 {
+    long n_threads = sysconf(_SC_NPROCESSORS_ONLN);
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            n_threads = atoi(argv[++i]);
+            if (n_threads < 1) {
+                fprintf(stderr, "ERROR: -j needs a positive thread count\n");
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "Usage: %s [-j THREADS]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (n_threads < 1) n_threads = 1;
+
     astro_init(NULL);
     Location loc = DEFAULT_LOCATION;
 
-    /* Allocate entries for all sankrantis */
-    Entry *entries = malloc(TOTAL_SANK * sizeof(Entry));
-    if (!entries) { fprintf(stderr, "malloc failed\n"); return 1; }
+    /* Mesha sankranti of YEAR_START (mid-April) to Meena of YEAR_END + 1 */
+    ScanRequest req;
+    memset(&req, 0, sizeof(req));
+    req.jd_start = gregorian_to_jd(YEAR_START, 4, 1);
+    req.jd_end = gregorian_to_jd(YEAR_END + 1, 4, 1);
+    req.event_mask = EVENT_SANKRANTI;
+    req.loc = loc;
+    req.metric = delta_metric;
+    req.top_n = TOP_N;
+    req.threads = (int)n_threads;
 
     /* Open output files */
     FILE *csv = fopen("validation/solar_edge_cases.csv", "w");
@@ -234,61 +285,17 @@ int main(void)
 
     for (int t = 0; t < 4; t++) {
         SolarCalendarType type = types[t];
-        int nentries = 0;
 
         fprintf(stderr, "Scanning %s...\n", cal_name(type));
 
-        for (int gy = YEAR_START; gy <= YEAR_END; gy++) {
-            for (int rashi = 1; rashi <= 12; rashi++) {
-                double target_long = (rashi - 1) * 30.0;
-
-                /* Approximate Gregorian month for this sankranti */
-                int approx_month = 3 + rashi;
-                int approx_year = gy;
-                if (approx_month > 12) { approx_month -= 12; approx_year++; }
-
-                double jd_est = gregorian_to_jd(approx_year, approx_month, 14);
-                double jd_sank = sankranti_jd(jd_est, target_long);
-
-                /* Convert sankranti to local date/time (IST) */
-                int sy, sm, sd, sh, smin, ssec;
-                jd_to_ist(jd_sank, &sy, &sm, &sd, &sh, &smin, &ssec);
-
-                /* Compute critical time for that day */
-                double jd_day = gregorian_to_jd(sy, sm, sd);
-                double jd_crit = critical_time_jd_local(jd_day, &loc, type);
-
-                /* Critical time in IST */
-                int cy, cm, cd, ch, cmin, csec;
-                jd_to_ist(jd_crit, &cy, &cm, &cd, &ch, &cmin, &csec);
-
-                /* Delta in minutes */
-                double delta_min = (jd_sank - jd_crit) * 24.0 * 60.0;
-
-                /* Our assignment: which day is day 1? */
-                int d1y, d1m, d1d;
-                sankranti_to_civil_day_local(jd_sank, &loc, type, &d1y, &d1m, &d1d);
-
-                /* Our full conversion for day 1 */
-                SolarDate sdate = gregorian_to_solar(d1y, d1m, d1d, &loc, type);
-
-                Entry *e = &entries[nentries];
-                e->sank_gy = sy;  e->sank_gm = sm;  e->sank_gd = sd;
-                e->sank_hh = sh;  e->sank_mm = smin; e->sank_ss = ssec;
-                e->crit_hh = ch;  e->crit_mm = cmin; e->crit_ss = csec;
-                e->delta_min = delta_min;
-                e->day1_gy = d1y; e->day1_gm = d1m;  e->day1_gd = d1d;
-                e->our_month = sdate.month;
-                e->our_year = sdate.year;
-                e->rashi = rashi;
-                nentries++;
-            }
-        }
-
-        /* Sort by |delta| */
-        qsort(entries, nentries, sizeof(Entry), cmp_by_abs_delta);
+        ScanResult res;
+        req.ctx = &type;
+        if (!scan_run(&req, &res)) { fprintf(stderr, "scan failed\n"); return 1; }
 
-        int n = (nentries < TOP_N) ? nentries : TOP_N;
+        int n = res.n_hits;
+        Entry entries[TOP_N];
+        for (int i = 0; i < n; i++)
+            fill_entry(&res.hits[i], &loc, type, &entries[i]);
 
         /* Write CSV section */
         fprintf(csv, "# %s - %d closest sankrantis to critical time (%s)\n",
@@ -336,17 +343,15 @@ int main(void)
                     e->rashi);
         }
 
-        fprintf(stderr, "  %s: %d sankrantis scanned, top %d written\n",
-                cal_name(type), nentries, n);
+        fprintf(stderr, "  %s: %ld sankrantis scanned, top %d written\n",
+                cal_name(type), res.n_events, n);
+        scan_free(&res);
     }
 
     /* Close the struct array in test file */
     fprintf(testf, "};\n\n");
 
     /* Write test functions */
-    const char *test_fn_names[] = {"tamil", "bengali", "odia", "malayalam"};
-    const char *test_fn_labels[] = {"Tamil", "Bengali", "Odia", "Malayalam"};
-
     fprintf(testf, "static void test_edge_cases(void)\n");
     fprintf(testf, "{\n");
     fprintf(testf, "    printf(\"\\n--- Solar edge cases: boundary sankrantis ---\\n\");\n");
@@ -393,7 +398,6 @@ int main(void)
 
     fclose(csv);
     fclose(testf);
-    free(entries);
 
     fprintf(stderr, "\nDone. Files written:\n");
     fprintf(stderr, "  validation/solar_edge_cases.csv\n");